@@ -21,6 +21,7 @@
 
 #include "audio/chip.h"
 #include "audio/mixer.h"
+#include "audio/renderahead.h"
 
 #include "common/timer.h"
 
@@ -97,7 +98,8 @@ EmulatedChip::EmulatedChip() :
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
-	_handle(new Audio::SoundHandle()) { }
+	_handle(new Audio::SoundHandle()),
+	_renderAhead(new RenderAheadBuffer(new Common::Functor2Mem<int16 *, int, int, EmulatedChip>(this, &EmulatedChip::renderSamples))) { }
 
 EmulatedChip::~EmulatedChip() {
 	// Stop callbacks, just in case. If it's still playing at this
@@ -110,6 +112,10 @@ EmulatedChip::~EmulatedChip() {
 }
 
 int EmulatedChip::readBuffer(int16 *buffer, const int numSamples) {
+	return _renderAhead->read(buffer, numSamples);
+}
+
+int EmulatedChip::renderSamples(int16 *buffer, int numSamples) {
 	const int stereoFactor = isStereo() ? 2 : 1;
 	int len = numSamples / stereoFactor;
 	int step;
@@ -142,10 +148,12 @@ int EmulatedChip::getRate() const {
 
 void EmulatedChip::startCallbacks(int timerFrequency) {
 	setCallbackFrequency(timerFrequency);
+	_renderAhead->start(RenderAheadBuffer::getConfiguredLookahead(getRate(), isStereo()), getRate(), isStereo());
 	g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, _handle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 }
 
 void EmulatedChip::stopCallbacks() {
+	_renderAhead->stop();
 	g_system->getMixer()->stopHandle(*_handle);
 }
 
@@ -28,6 +28,7 @@
 #include "audio/audiostream.h"
 
 namespace Audio {
+class RenderAheadBuffer;
 class SoundHandle;
 
 class Chip {
@@ -143,12 +144,20 @@ protected:
 	virtual void generateSamples(int16 *buffer, int numSamples) = 0;
 
 private:
+	/**
+	 * Generate the samples and issue the callbacks in between. Depending on
+	 * the "softsynth_lookahead" config key, this is either run directly by
+	 * readBuffer() or ahead of time by a RenderAheadBuffer.
+	 */
+	int renderSamples(int16 *buffer, int numSamples);
+
 	int _baseFreq;
 
 	int _nextTick;
 	int _samplesPerTick;
 
 	Audio::SoundHandle *_handle;
+	Common::ScopedPtr<RenderAheadBuffer> _renderAhead;
 };
 
 } // End of namespace Audio
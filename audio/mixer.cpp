@@ -21,7 +21,9 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
+#include "common/thread.h"
 #include "common/textconsole.h"
 
 #include "audio/mixer_intern.h"
@@ -42,7 +44,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality);
 	~Channel();
 
 	/**
@@ -54,7 +56,7 @@ public:
 	 *             16 bits, for a total of 40 bytes.
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(st_mix_t *data, uint len);
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -84,7 +86,12 @@ public:
 	/**
 	 * Queries whether the channel is currently paused.
 	 */
-	bool isPaused() const { return (_pauseLevel != 0); }
+	bool isPaused() const { return (_pauseLevel.load() != 0); }
+
+	/**
+	 * Queries how many times the channel has been paused.
+	 */
+	int getPauseLevel() const { return _pauseLevel.load(); }
 
 	/**
 	 * Sets the channel's own volume.
@@ -183,23 +190,9 @@ public:
 	 */
 	Mixer::SoundType getType() const { return _type; }
 
-	/**
-	 * Sets the channel's sound handle.
-	 *
-	 * @param handle new handle
-	 */
-	void setHandle(const SoundHandle handle) { _handle = handle; }
-
-	/**
-	 * Queries the channel's sound handle.
-	 */
-	SoundHandle getHandle() const { return _handle; }
-
 private:
 	const Mixer::SoundType _type;
-	SoundHandle _handle;
 	bool _permanent;
-	int _pauseLevel;
 	int _id;
 
 	byte _volume;
@@ -212,11 +205,19 @@ private:
 
 	Mixer *_mixer;
 
-	uint32 _samplesConsumed;
+	/**
+	 * Playback position, written by the audio thread and read by
+	 * getElapsedTime() on the engine threads. _timingSerial is odd while
+	 * it is being updated.
+	 */
+	Common::Atomic<uint32> _timingSerial;
+	Common::Atomic<int32> _pauseLevel;
+	Common::Atomic<uint32> _samplesConsumed;
+	Common::Atomic<uint32> _mixerTimeStamp;
+	Common::Atomic<uint32> _pauseStartTime;
+	Common::Atomic<uint32> _pauseTime;
+
 	uint32 _samplesDecoded;
-	uint32 _mixerTimeStamp;
-	uint32 _pauseStartTime;
-	uint32 _pauseTime;
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
@@ -227,23 +228,46 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _callbackLocksMutex(false), _callbackThread(0), _rateConverterQuality(kRateConverterFast), _mixBuffer(nullptr), _mixBufferSize(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		_channels[i] = nullptr;
+	if (ConfMan.hasKey("resampler_quality")) {
+		const Common::String quality = ConfMan.get("resampler_quality");
+		if (quality == "high")
+			_rateConverterQuality = kRateConverterHigh;
+		else if (quality != "fast")
+			warning("MixerImpl: Unknown resampler quality '%s'", quality.c_str());
+	}
 }
 
 MixerImpl::~MixerImpl() {
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		delete _channels[i];
+		delete _slots[i].channel;
+
+	delete[] _mixBuffer;
 }
 
-void MixerImpl::setReady(bool ready) {
-	Common::StackLock lock(_mutex);
+Common::Mutex &MixerImpl::mutex() {
+	// Engines lock the mutex to keep mixCallback() away from their streams,
+	// so from now on the callback has to take it as well
+	if (!_callbackLocksMutex.load()) {
+		_callbackLocksMutex.store(true);
 
-	_mixerReady = ready;
+		// Wait for a callback which started without the mutex, unless it is
+		// the one asking
+		const uintptr self = Common::Thread::getCurrentId();
+		uintptr thread;
+		while ((thread = _callbackThread.load()) != 0 && thread != self)
+			g_system->delayMillis(0);
+	}
+
+	return _mutex;
+}
+
+void MixerImpl::setReady(bool ready) {
+	_mixerReady.store(ready);
 }
 
 uint MixerImpl::getOutputRate() const {
@@ -261,7 +285,7 @@ uint MixerImpl::getOutputBufSize() const {
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
+		if (_slots[i].state.load() == kSlotFree) {
 			index = i;
 			break;
 		}
@@ -272,15 +296,140 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
 
-	chan->setHandle(chanHandle);
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	// Publish the channel. The audio thread does not look at free slots, and
+	// readers only trust the snapshot once they see the new handle.
+	ChannelSlot &slot = _slots[index];
+	slot.channel = chan;
+	slot.id.store(chan->getId());
+	slot.type.store(chan->getType());
+	slot.volume.store(chan->getVolume());
+	slot.balance.store(chan->getBalance());
+	slot.faderL.store(chan->getFaderL());
+	slot.faderR.store(chan->getFaderR());
+	slot.rate.store(chan->getRate());
+	slot.nativeRate.store(chan->getRate());
+	slot.pauseLevel.store(0);
+	slot.loop.store(false);
+	slot.appliedSerial = slot.serial.load();
+	slot.handle.store(chanHandle._val);
+	slot.state.store(kSlotIdle);
+}
+
+void MixerImpl::stopChannel(int index, uint32 handle) {
+	ChannelSlot &slot = _slots[index];
+
+	for (;;) {
+		// The channel finished or was stopped in the meantime
+		if (slot.handle.load() != handle)
+			return;
+
+		int32 state = kSlotIdle;
+		if (slot.state.compareExchange(state, kSlotStopping))
+			break;
+
+		// The audio thread is mixing the channel. It does not take long, but
+		// the streams may call back into the mixer, so release _mutex meanwhile.
+		_mutex.unlock();
+		g_system->delayMillis(0);
+		_mutex.lock();
+	}
+
+	slot.handle.store(kInvalidHandle);
+	delete slot.channel;
+	slot.channel = nullptr;
+	slot.state.store(kSlotFree);
+}
+
+void MixerImpl::reapChannels() {
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		ChannelSlot &slot = _slots[i];
+		if (slot.state.load() == kSlotFinished) {
+			delete slot.channel;
+			slot.channel = nullptr;
+			slot.state.store(kSlotFree);
+		}
+	}
+}
+
+MixerImpl::ChannelSlot *MixerImpl::getSlot(SoundHandle handle) {
+	if (handle._val == kInvalidHandle)
+		return nullptr;
+
+	ChannelSlot *slot = &_slots[handle._val % NUM_CHANNELS];
+	if (slot->handle.load() != handle._val)
+		return nullptr;
+
+	return slot;
+}
+
+bool MixerImpl::readChannelParam(SoundHandle handle, Common::Atomic<int32> ChannelSlot::*param, int32 &value) {
+	if (handle._val == kInvalidHandle)
+		return false;
+
+	const ChannelSlot &slot = _slots[handle._val % NUM_CHANNELS];
+	if (slot.handle.load() != handle._val)
+		return false;
+
+	value = (slot.*param).load();
+
+	// Make sure the slot was not reused while reading the value
+	return slot.handle.load() == handle._val;
+}
+
+void MixerImpl::setChannelParam(SoundHandle handle, Common::Atomic<int32> ChannelSlot::*param, int32 value) {
+	Common::StackLock lock(_mutex);
+
+	ChannelSlot *slot = getSlot(handle);
+	if (!slot)
+		return;
+
+	(slot->*param).store(value);
+	slot->serial.fetchAdd(1);
+}
+
+void MixerImpl::notifyGlobalVolChange(SoundType type) {
+	Common::StackLock lock(_mutex);
+
+	for (int i = 0; i != NUM_CHANNELS; ++i) {
+		ChannelSlot &slot = _slots[i];
+		if (slot.handle.load() != kInvalidHandle && slot.type.load() == type)
+			slot.serial.fetchAdd(1);
+	}
+}
+
+void MixerImpl::applySlotChanges(ChannelSlot &slot) {
+	const uint32 serial = slot.serial.load();
+	if (serial == slot.appliedSerial)
+		return;
+
+	slot.appliedSerial = serial;
+
+	// Setting the volume also picks up the volume of the sound type
+	Channel *chan = slot.channel;
+	chan->setFaderL(slot.faderL.load());
+	chan->setFaderR(slot.faderR.load());
+	chan->setBalance(slot.balance.load());
+	chan->setVolume(slot.volume.load());
+
+	const uint32 rate = slot.rate.load();
+	if (chan->getRate() != rate)
+		chan->setRate(rate);
+
+	const int pauseLevel = slot.pauseLevel.load();
+	while (chan->getPauseLevel() < pauseLevel)
+		chan->pause(true);
+	while (chan->getPauseLevel() > pauseLevel)
+		chan->pause(false);
+
+	if (slot.loop.exchange(false))
+		chan->loop();
 }
 
 void MixerImpl::playStream(
@@ -299,12 +448,14 @@ void MixerImpl::playStream(
 	}
 
 
-	assert(_mixerReady);
+	assert(_mixerReady.load());
+
+	reapChannels();
 
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+			if (_slots[i].handle.load() != kInvalidHandle && _slots[i].id.load() == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -322,7 +473,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _rateConverterQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -331,17 +482,20 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	_callbackThread.store(Common::Thread::getCurrentId());
+
+	// Only block on the engine threads if one of them asked for it
+	const bool lockMutex = _callbackLocksMutex.load();
+	if (lockMutex)
+		_mutex.lock();
 
 	int16 *buf = (int16 *)samples;
 
 	// Since the mixer callback has been called, the mixer must be ready...
-	_mixerReady = true;
-
-	//  zero the buf
-	memset(buf, 0, len);
+	_mixerReady.store(true);
 
 	// we store 16-bit samples
+	const uint numSamples = len >> 1;
 	if (_stereo) {
 		assert(len % 4 == 0);
 		len >>= 2;
@@ -350,169 +504,156 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 		len >>= 1;
 	}
 
+	// The channels are mixed into a 32-bit bus, which is only clamped once
+	// at the end
+	if (numSamples > _mixBufferSize) {
+		delete[] _mixBuffer;
+		_mixBuffer = new st_mix_t[numSamples];
+		_mixBufferSize = numSamples;
+	}
+
+	//  zero the bus
+	memset(_mixBuffer, 0, numSamples * sizeof(st_mix_t));
+
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
-			}
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		ChannelSlot &slot = _slots[i];
+
+		// Skip free slots, and channels an engine thread is stopping
+		int32 state = kSlotIdle;
+		if (!slot.state.compareExchange(state, kSlotMixing))
+			continue;
+
+		applySlotChanges(slot);
+
+		Channel *chan = slot.channel;
+		if (chan->isFinished()) {
+			// Leave deleting the channel to the engine threads
+			slot.handle.store(kInvalidHandle);
+			slot.state.store(kSlotFinished);
+			continue;
 		}
 
+		if (!chan->isPaused()) {
+			tmp = chan->mix(_mixBuffer, len);
+
+			if (tmp > res)
+				res = tmp;
+		}
+
+		slot.state.store(kSlotIdle);
+	}
+
+	MixKernel::clamp(_mixBuffer, buf, numSamples);
+
+	if (lockMutex)
+		_mutex.unlock();
+
+	_callbackThread.store(0);
+
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	reapChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+		const uint32 handle = _slots[i].handle.load();
+		if (handle != kInvalidHandle && !_slots[i].channel->isPermanent()) {
+			stopChannel(i, handle);
 		}
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	reapChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+		const uint32 handle = _slots[i].handle.load();
+		if (handle != kInvalidHandle && _slots[i].id.load() == id) {
+			stopChannel(i, handle);
 		}
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reapChannels();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!getSlot(handle))
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	stopChannel(handle._val % NUM_CHANNELS, handle._val);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
+	_soundTypeSettings[type].mute.store(mute);
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	notifyGlobalVolChange(type);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	return _soundTypeSettings[type].mute;
+	return _soundTypeSettings[type].mute.load();
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	setChannelParam(handle, &ChannelSlot::volume, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getVolume();
+	int32 volume;
+	return readChannelParam(handle, &ChannelSlot::volume, volume) ? volume : 0;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	setChannelParam(handle, &ChannelSlot::balance, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getBalance();
+	int32 balance;
+	return readChannelParam(handle, &ChannelSlot::balance, balance) ? balance : 0;
 }
 
 void MixerImpl::setChannelFaderL(SoundHandle handle, uint8 faderL) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setFaderL(faderL);
+	setChannelParam(handle, &ChannelSlot::faderL, faderL);
 }
 
 uint8 MixerImpl::getChannelFaderL(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getFaderL();
+	int32 faderL;
+	return readChannelParam(handle, &ChannelSlot::faderL, faderL) ? faderL : 0;
 }
 
 void MixerImpl::setChannelFaderR(SoundHandle handle, uint8 faderR) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setFaderR(faderR);
+	setChannelParam(handle, &ChannelSlot::faderR, faderR);
 }
 
 uint8 MixerImpl::getChannelFaderR(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getFaderR();
+	int32 faderR;
+	return readChannelParam(handle, &ChannelSlot::faderR, faderR) ? faderR : 0;
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setRate(rate);
+	setChannelParam(handle, &ChannelSlot::rate, rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getRate();
+	int32 rate;
+	return readChannelParam(handle, &ChannelSlot::rate, rate) ? rate : 0;
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelSlot *slot = getSlot(handle);
+	if (!slot)
 		return;
 
-	_channels[index]->resetRate();
+	slot->rate.store(slot->nativeRate.load());
+	slot->serial.fetchAdd(1);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -520,30 +661,33 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
+	// Holding _mutex keeps the channel from being deleted
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const ChannelSlot *slot = getSlot(handle);
+	if (!slot)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return slot->channel->getElapsedTime();
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelSlot *slot = getSlot(handle);
+	if (!slot)
 		return;
 
-	_channels[index]->loop();
+	slot->loop.store(true);
+	slot->serial.fetchAdd(1);
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
+		ChannelSlot &slot = _slots[i];
+		if (slot.handle.load() != kInvalidHandle) {
+			pauseSlot(slot, paused);
 		}
 	}
 }
@@ -551,8 +695,9 @@ void MixerImpl::pauseAll(bool paused) {
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		ChannelSlot &slot = _slots[i];
+		if (slot.handle.load() != kInvalidHandle && slot.id.load() == id) {
+			pauseSlot(slot, paused);
 			return;
 		}
 	}
@@ -562,50 +707,57 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelSlot *slot = getSlot(handle);
+	if (!slot)
 		return;
 
-	_channels[index]->pause(paused);
+	pauseSlot(*slot, paused);
 }
 
-bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
+void MixerImpl::pauseSlot(ChannelSlot &slot, bool paused) {
+	const int32 pauseLevel = slot.pauseLevel.load();
+	if (paused)
+		slot.pauseLevel.store(pauseLevel + 1);
+	else if (pauseLevel > 0)
+		slot.pauseLevel.store(pauseLevel - 1);
+	else
+		return;
+
+	slot.serial.fetchAdd(1);
+}
 
+bool MixerImpl::isSoundIDActive(int id) {
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		const uint32 handle = _slots[i].handle.load();
+		if (handle != kInvalidHandle && _slots[i].id.load() == id && _slots[i].handle.load() == handle)
 			return true;
+	}
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
-	return 0;
+	int32 id;
+	return readChannelParam(handle, &ChannelSlot::id, id) ? id : 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return handle._val != kInvalidHandle && _slots[handle._val % NUM_CHANNELS].handle.load() == handle._val;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		const uint32 handle = _slots[i].handle.load();
+		if (handle != kInvalidHandle && _slots[i].type.load() == type && _slots[i].handle.load() == handle)
 			return true;
+	}
 	return false;
 }
 
@@ -618,19 +770,15 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
-	_soundTypeSettings[type].volume = volume;
+	_soundTypeSettings[type].volume.store(volume);
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	notifyGlobalVolChange(type);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 
-	return _soundTypeSettings[type].volume;
+	return _soundTypeSettings[type].volume.load();
 }
 
 
@@ -639,16 +787,16 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-	  _balance(0), _faderL(255), _faderR(255), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
+	  _balance(0), _faderL(255), _faderR(255), _timingSerial(0), _pauseLevel(0), _samplesConsumed(0), _mixerTimeStamp(0),
+	  _pauseStartTime(0), _pauseTime(0), _samplesDecoded(0), _converter(nullptr), _volL(0), _volR(0),
 	  _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -741,19 +889,24 @@ void Channel::updateChannelVolumes() {
 void Channel::pause(bool paused) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
+	_timingSerial.fetchAdd(1);
+
+	const int pauseLevel = _pauseLevel.load();
 	if (paused) {
-		_pauseLevel++;
+		_pauseLevel.store(pauseLevel + 1);
 
-		if (_pauseLevel == 1)
-			_pauseStartTime = g_system->getMillis(true);
-	} else if (_pauseLevel > 0) {
-		_pauseLevel--;
+		if (pauseLevel == 0)
+			_pauseStartTime.store(g_system->getMillis(true));
+	} else if (pauseLevel > 0) {
+		_pauseLevel.store(pauseLevel - 1);
 
-		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
-			_pauseStartTime = 0;
+		if (pauseLevel == 1) {
+			_pauseTime.store(g_system->getMillis(true) - _pauseStartTime.load());
+			_pauseStartTime.store(0);
 		}
 	}
+
+	_timingSerial.fetchAdd(1);
 }
 
 Timestamp Channel::getElapsedTime() {
@@ -762,17 +915,29 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	// Read a consistent position, retrying while the audio thread updates it
+	uint32 serial, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	bool paused;
+	do {
+		serial = _timingSerial.load();
+		paused = isPaused();
+		samplesConsumed = _samplesConsumed.load();
+		mixerTimeStamp = _mixerTimeStamp.load();
+		pauseStartTime = _pauseStartTime.load();
+		pauseTime = _pauseTime.load();
+	} while ((serial & 1) || serial != _timingSerial.load());
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - mixerTimeStamp - pauseTime;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -793,15 +958,18 @@ void Channel::loop() {
 	}
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(st_mix_t *data, uint len) {
 	assert(_stream);
 	assert(_converter);
 
 	int res = 0;
 	if (!_stream->endOfData() || _converter->needsDraining()) {
-		_samplesConsumed = _samplesDecoded;
-		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
+		_timingSerial.fetchAdd(1);
+		_samplesConsumed.store(_samplesDecoded);
+		_mixerTimeStamp.store(g_system->getMillis(true));
+		_pauseTime.store(0);
+		_timingSerial.fetchAdd(1);
+
 		res = _converter->convert(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
 	}
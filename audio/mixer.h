@@ -94,6 +94,7 @@ public:
 
 	/**
 	 * Return the mixer's internal mutex so that audio players can use it.
+	 * While it is locked, the mixer does not mix any channels.
 	 */
 	virtual Common::Mutex &mutex() = 0;
 
@@ -23,8 +23,10 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/atomic.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -61,33 +63,100 @@ private:
 		NUM_CHANNELS = 32
 	};
 
+	static const uint32 kInvalidHandle = 0xffffffff;
+
+	/**
+	 * Serializes the engine threads. mixCallback() only takes it once an
+	 * engine has asked for it through mutex().
+	 */
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
 	const bool _stereo;
 	const uint _outBufSize;
-	bool _mixerReady;
+	Common::Atomic<bool> _mixerReady;
 	uint32 _handleSeed;
 
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
 
-		bool mute;
-		int volume;
+		Common::Atomic<bool> mute;
+		Common::Atomic<int32> volume;
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
-	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * Ownership of a channel slot. Only the engine threads, with _mutex
+	 * locked, move a slot out of kSlotFree, kSlotStopping or kSlotFinished,
+	 * and only they delete channels. The audio thread owns the channel of
+	 * a slot while it is in kSlotMixing.
+	 */
+	enum SlotState {
+		kSlotFree,
+		kSlotIdle,
+		kSlotMixing,
+		kSlotStopping,
+		kSlotFinished
+	};
+
+	/**
+	 * A channel slot. The channel parameters are a snapshot written by the
+	 * engine threads, which the audio thread applies to the channel when
+	 * the serial changes. Repeated changes between two buffers coalesce.
+	 *
+	 * The handle doubles as the generation of the slot: readers check it
+	 * before and after reading a parameter, so that they never mix up the
+	 * parameters of a recycled slot with those of the channel they asked for.
+	 */
+	struct ChannelSlot {
+		ChannelSlot() : state(kSlotFree), channel(nullptr), handle(kInvalidHandle), serial(0), appliedSerial(0) {}
+
+		Common::Atomic<int32> state;
+		Channel *channel;
+
+		Common::Atomic<uint32> handle;
+		Common::Atomic<int32> id;
+		Common::Atomic<int32> type;
+		Common::Atomic<int32> volume;
+		Common::Atomic<int32> balance;
+		Common::Atomic<int32> faderL;
+		Common::Atomic<int32> faderR;
+		Common::Atomic<int32> rate;
+		Common::Atomic<int32> nativeRate;
+		Common::Atomic<int32> pauseLevel;
+		Common::Atomic<bool> loop;
+
+		/** Incremented by the engine threads after changing the snapshot */
+		Common::Atomic<uint32> serial;
+
+		/** The last serial applied by the audio thread */
+		uint32 appliedSerial;
+	};
+
+	ChannelSlot _slots[NUM_CHANNELS];
+
+	/** Set once an engine locks mutex() to keep mixCallback() out */
+	Common::Atomic<bool> _callbackLocksMutex;
+
+	/** Thread running mixCallback(), or 0 while it is not running */
+	Common::Atomic<uintptr> _callbackThread;
+
+	/** Resampling algorithm for new channels, from the "resampler_quality" config key */
+	RateConverterQuality _rateConverterQuality;
+
+	/** 32-bit bus the channels are mixed into, before it is clamped to the output buffer */
+	st_mix_t *_mixBuffer;
+	uint _mixBufferSize;
 
 public:
 
 	MixerImpl(uint sampleRate, bool stereo = true, uint outBufSize = 0);
 	~MixerImpl();
 
-	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
+	virtual bool isReady() const { return _mixerReady.load(); }
 
-	virtual Common::Mutex &mutex() { return _mutex; }
+	virtual Common::Mutex &mutex();
 
 	virtual void playStream(
 		SoundType type,
@@ -143,6 +212,46 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	/**
+	 * Stop the channel with the given handle, waiting for the audio thread
+	 * if it is mixing it. Must be called with _mutex locked.
+	 */
+	void stopChannel(int index, uint32 handle);
+
+	/**
+	 * Delete the channels which the audio thread found finished.
+	 * Must be called with _mutex locked.
+	 */
+	void reapChannels();
+
+	/**
+	 * Look up the slot of a channel. Must be called with _mutex locked,
+	 * which keeps the slot from being reused.
+	 *
+	 * @return The slot, or nullptr if the handle does not belong to
+	 *         a playing channel.
+	 */
+	ChannelSlot *getSlot(SoundHandle handle);
+
+	/**
+	 * Read a parameter of a channel without locking.
+	 *
+	 * @return False if the handle does not belong to a playing channel.
+	 */
+	bool readChannelParam(SoundHandle handle, Common::Atomic<int32> ChannelSlot::*param, int32 &value);
+
+	/** Change a parameter of a channel for the audio thread to apply */
+	void setChannelParam(SoundHandle handle, Common::Atomic<int32> ChannelSlot::*param, int32 value);
+
+	/** Change the pause level of a channel. Must be called with _mutex locked. */
+	void pauseSlot(ChannelSlot &slot, bool paused);
+
+	/** Make the audio thread update the volumes of all channels of a type */
+	void notifyGlobalVolChange(SoundType type);
+
+	/** Apply the snapshot of a slot to its channel. Audio thread only. */
+	void applySlotChanges(ChannelSlot &slot);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -0,0 +1,103 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/prefetch.h"
+
+namespace Audio {
+
+PrefetchingAudioStream::PrefetchingAudioStream(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint lookahead) :
+	_parent(stream, disposeAfterUse), _lookahead(lookahead), _seekTarget(0, stream->getRate()),
+	_headSize(0), _capturingHead(false), _headComplete(false),
+	_buffer(new Common::Functor2Mem<int16 *, int, int, PrefetchingAudioStream>(this, &PrefetchingAudioStream::readParent),
+	        new Common::Functor0Mem<void, PrefetchingAudioStream>(this, &PrefetchingAudioStream::seekParent)) {
+	const bool stereo = _parent->isStereo();
+	_head.resize((uint)((uint64)_parent->getRate() * _lookahead / 1000) * (stereo ? 2 : 1));
+
+	startPrefetch();
+}
+
+PrefetchingAudioStream::~PrefetchingAudioStream() {
+	// The worker must be gone before the parent stream is destroyed
+	_buffer.stop();
+}
+
+int PrefetchingAudioStream::readBuffer(int16 *buffer, const int numSamples) {
+	return _buffer.read(buffer, numSamples);
+}
+
+int PrefetchingAudioStream::readParent(int16 *buffer, int numSamples) {
+	const int samplesRead = _parent->readBuffer(buffer, numSamples);
+
+	if (_capturingHead) {
+		const uint count = MIN<uint>(MAX(samplesRead, 0), _head.size() - _headSize);
+		if (count)
+			memcpy(&_head[_headSize], buffer, count * sizeof(int16));
+		_headSize += count;
+
+		if (_headSize == _head.size() || samplesRead < numSamples) {
+			_capturingHead = false;
+			_headComplete.store(true);
+		}
+	}
+
+	return samplesRead;
+}
+
+void PrefetchingAudioStream::seekParent() {
+	Timestamp target;
+	{
+		Common::StackLock lock(_seekMutex);
+		target = _seekTarget;
+	}
+
+	_parent->seek(target);
+
+	// Keep the start of the stream for the next time it is rewound
+	_capturingHead = !_headComplete.load() && !_head.empty() && target.totalNumberOfFrames() == 0;
+	if (_capturingHead)
+		_headSize = 0;
+}
+
+bool PrefetchingAudioStream::seek(const Timestamp &where) {
+	if (getLength() < where)
+		return false;
+
+	// Continue after the kept start of the stream, if there is one
+	const bool useHead = where.totalNumberOfFrames() == 0 && _headComplete.load();
+	{
+		Common::StackLock lock(_seekMutex);
+		_seekTarget = useHead ? Timestamp(0, _headSize / (isStereo() ? 2 : 1), getRate()) : where;
+	}
+
+	if (useHead)
+		_buffer.reset(_head.data(), _headSize);
+	else
+		_buffer.reset();
+	return true;
+}
+
+void PrefetchingAudioStream::startPrefetch() {
+	const bool stereo = _parent->isStereo();
+	const uint lookahead = (uint)((uint64)_parent->getRate() * _lookahead / 1000) * (stereo ? 2 : 1);
+	_buffer.start(lookahead, _parent->getRate(), stereo);
+}
+
+} // End of namespace Audio
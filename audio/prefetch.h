@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_PREFETCH_H
+#define AUDIO_PREFETCH_H
+
+#include "audio/audiostream.h"
+#include "audio/renderahead.h"
+
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/types.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_prefetch Prefetching audio stream
+ * @ingroup audio
+ *
+ * @brief Decodes compressed audio streams ahead of the mixer.
+ * @{
+ */
+
+/**
+ * A stream which decodes its parent stream ahead of the mixer.
+ *
+ * Decoders like Vorbis, FLAC or MP3 decode whole frames and read the file
+ * inside readBuffer(), which runs in the mixer thread. Wrapping them in a
+ * PrefetchingAudioStream moves this work to a RenderAheadBuffer, so a large
+ * frame or a slow read no longer stalls the mixer.
+ *
+ * Seeking drops the samples decoded so far, and the worker restarts
+ * decoding at the new position. seek() only signals the worker, so it can
+ * be called from the mixer thread, e.g. by a LoopingAudioStream. To avoid
+ * decoding in the mixer thread at each loop point, the start of the stream
+ * is kept from the first pass and returned right after rewinding, while
+ * the worker continues after it. Like with any other stream, seek() must
+ * not be called while the mixer is reading from the stream.
+ */
+class PrefetchingAudioStream : public SeekableAudioStream {
+public:
+	enum {
+		/** Default amount of audio decoded ahead, in milliseconds */
+		kDefaultLookahead = 250
+	};
+
+	/**
+	 * Create a prefetching audio stream object.
+	 *
+	 * @param stream           The stream to decode ahead.
+	 * @param disposeAfterUse  Destroy the stream after the PrefetchingAudioStream has finished playback.
+	 * @param lookahead        Amount of audio to decode ahead in milliseconds (0 = decode in readBuffer()).
+	 */
+	PrefetchingAudioStream(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES, uint lookahead = kDefaultLookahead);
+	~PrefetchingAudioStream();
+
+	int readBuffer(int16 *buffer, const int numSamples);
+	bool endOfData() const { return _buffer.endOfData(); }
+
+	bool isStereo() const { return _parent->isStereo(); }
+	int getRate() const { return _parent->getRate(); }
+
+	/**
+	 * Seek to the given position. The parent stream is seeked later by the
+	 * worker, so this only fails if the position is beyond the end.
+	 */
+	bool seek(const Timestamp &where);
+	Timestamp getLength() const { return _parent->getLength(); }
+
+private:
+	int readParent(int16 *buffer, int numSamples);
+	void seekParent();
+	void startPrefetch();
+
+	Common::DisposablePtr<SeekableAudioStream> _parent;
+	uint _lookahead;
+
+	/** Guards _seekTarget, which is set by seek() and applied by the worker */
+	Common::Mutex _seekMutex;
+	Timestamp _seekTarget;
+
+	// The samples at the start of the stream. They are written by the
+	// thread which decodes, and not touched anymore once complete.
+	Common::Array<int16> _head;
+	uint _headSize;
+	bool _capturingHead;
+	Common::Atomic<bool> _headComplete;
+
+	RenderAheadBuffer _buffer;
+};
+
+/** @} */
+
+} // End of namespace Audio
+
+#endif
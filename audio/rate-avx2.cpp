@@ -0,0 +1,219 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "common/util.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+// Divides the 32-bit products by kMaxMixerVolume, rounding towards zero
+// like the C division does.
+static FORCEINLINE __m256i avx2_scaleVolume(__m256i p) {
+	return _mm256_srai_epi32(_mm256_add_epi32(p, _mm256_and_si256(_mm256_srai_epi32(p, 31), _mm256_set1_epi32(255))), 8);
+}
+
+// Computes (in * vol) / kMaxMixerVolume for sixteen samples. The unpack
+// and pack instructions both work per 128-bit lane, so the sample order
+// is preserved.
+static FORCEINLINE __m256i avx2_applyVolume(__m256i in, __m256i vol) {
+	__m256i lo = _mm256_mullo_epi16(in, vol);
+	__m256i hi = _mm256_mulhi_epi16(in, vol);
+	__m256i p0 = avx2_scaleVolume(_mm256_unpacklo_epi16(lo, hi));
+	__m256i p1 = avx2_scaleVolume(_mm256_unpackhi_epi16(lo, hi));
+	// With volumes up to kMaxMixerVolume the results always fit in 16 bits
+	return _mm256_packs_epi32(p0, p1);
+}
+
+// Computes (a + b) / 2 on pairs of 32-bit sums, rounding towards zero
+static FORCEINLINE __m256i avx2_halve(__m256i s) {
+	return _mm256_srai_epi32(_mm256_add_epi32(s, _mm256_srli_epi32(s, 31)), 1);
+}
+
+// Adds sixteen samples to a 16-bit output buffer, saturating the result
+static FORCEINLINE void avx2_addSamples(st_sample_t *out, __m256i samples) {
+	__m256i dst = _mm256_loadu_si256((const __m256i *)out);
+	_mm256_storeu_si256((__m256i *)out, _mm256_adds_epi16(dst, samples));
+}
+
+// Adds sixteen samples to the mix bus
+static FORCEINLINE void avx2_addSamples(st_mix_t *out, __m256i samples) {
+	__m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(samples));
+	__m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(samples, 1));
+	_mm256_storeu_si256((__m256i *)out, _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)out), lo));
+	_mm256_storeu_si256((__m256i *)(out + 8), _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(out + 8)), hi));
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo, class T>
+static void mixFramesAVX2(const st_sample_t *&in, T *&out, st_size_t &numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m256i ones = _mm256_set1_epi16(1);
+
+	if (inStereo && outStereo) {
+		// The channels are swapped before applying the volume, so the
+		// volume has to be swapped as well
+		const __m256i vol = reverseStereo ? _mm256_set1_epi32((volL << 16) | volR) : _mm256_set1_epi32((volR << 16) | volL);
+		for (; numFrames >= 8; numFrames -= 8) {
+			__m256i src = _mm256_loadu_si256((const __m256i *)in);
+			if (reverseStereo) {
+				src = _mm256_shufflelo_epi16(src, _MM_SHUFFLE(2, 3, 0, 1));
+				src = _mm256_shufflehi_epi16(src, _MM_SHUFFLE(2, 3, 0, 1));
+			}
+			avx2_addSamples(out, avx2_applyVolume(src, vol));
+			in += 16;
+			out += 16;
+		}
+	} else if (inStereo) {
+		const __m256i vol = _mm256_set1_epi32((volR << 16) | volL);
+		for (; numFrames >= 16; numFrames -= 16) {
+			__m256i src0 = avx2_applyVolume(_mm256_loadu_si256((const __m256i *)in), vol);
+			__m256i src1 = avx2_applyVolume(_mm256_loadu_si256((const __m256i *)(in + 16)), vol);
+			__m256i sum0 = avx2_halve(_mm256_madd_epi16(src0, ones));
+			__m256i sum1 = avx2_halve(_mm256_madd_epi16(src1, ones));
+			// The pack interleaves the 128-bit lanes of both sources
+			__m256i sum = _mm256_permute4x64_epi64(_mm256_packs_epi32(sum0, sum1), _MM_SHUFFLE(3, 1, 2, 0));
+			avx2_addSamples(out, sum);
+			in += 32;
+			out += 16;
+		}
+	} else if (outStereo) {
+		const __m256i vl = _mm256_set1_epi16(volL);
+		const __m256i vr = _mm256_set1_epi16(volR);
+		for (; numFrames >= 16; numFrames -= 16) {
+			__m256i src = _mm256_loadu_si256((const __m256i *)in);
+			__m256i srcL = avx2_applyVolume(src, vl);
+			__m256i srcR = avx2_applyVolume(src, vr);
+			__m256i lo = _mm256_unpacklo_epi16(srcL, srcR);
+			__m256i hi = _mm256_unpackhi_epi16(srcL, srcR);
+			avx2_addSamples(out, _mm256_permute2x128_si256(lo, hi, 0x20));
+			avx2_addSamples(out + 16, _mm256_permute2x128_si256(lo, hi, 0x31));
+			in += 16;
+			out += 32;
+		}
+	} else {
+		const __m256i vl = _mm256_set1_epi16(volL);
+		const __m256i vr = _mm256_set1_epi16(volR);
+		for (; numFrames >= 16; numFrames -= 16) {
+			__m256i src = _mm256_loadu_si256((const __m256i *)in);
+			__m256i srcL = avx2_applyVolume(src, vl);
+			__m256i srcR = avx2_applyVolume(src, vr);
+			__m256i sum0 = avx2_halve(_mm256_madd_epi16(_mm256_unpacklo_epi16(srcL, srcR), ones));
+			__m256i sum1 = avx2_halve(_mm256_madd_epi16(_mm256_unpackhi_epi16(srcL, srcR), ones));
+			avx2_addSamples(out, _mm256_packs_epi32(sum0, sum1));
+			in += 16;
+			out += 16;
+		}
+	}
+}
+
+template<class T>
+static void mixAVX2Impl(const st_sample_t *&in, T *&out, st_size_t &numFrames, st_volume_t volL, st_volume_t volR,
+						bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				mixFramesAVX2<true, true, true>(in, out, numFrames, volL, volR);
+			else
+				mixFramesAVX2<true, true, false>(in, out, numFrames, volL, volR);
+		} else
+			mixFramesAVX2<true, false, false>(in, out, numFrames, volL, volR);
+	} else {
+		if (outStereo)
+			mixFramesAVX2<false, true, false>(in, out, numFrames, volL, volR);
+		else
+			mixFramesAVX2<false, false, false>(in, out, numFrames, volL, volR);
+	}
+}
+
+void MixKernel::mixAVX2(Args<st_sample_t> &args) {
+	mixAVX2Impl(args.in, args.out, args.numFrames, args.volL, args.volR, args.inStereo, args.outStereo, args.reverseStereo);
+
+	// Mix the remaining frames
+	mixGeneric(args);
+}
+
+void MixKernel::mixAVX2(Args<st_mix_t> &args) {
+	mixAVX2Impl(args.in, args.out, args.numFrames, args.volL, args.volR, args.inStereo, args.outStereo, args.reverseStereo);
+
+	// Mix the remaining frames
+	mixGeneric(args);
+}
+
+void MixKernel::clampAVX2(const st_mix_t *in, st_sample_t *out, st_size_t numSamples) {
+	for (; numSamples >= 16; numSamples -= 16) {
+		__m256i lo = _mm256_loadu_si256((const __m256i *)in);
+		__m256i hi = _mm256_loadu_si256((const __m256i *)(in + 8));
+		// The pack interleaves the 128-bit lanes of both sources
+		__m256i samples = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm256_storeu_si256((__m256i *)out, samples);
+		in += 16;
+		out += 16;
+	}
+
+	clampGeneric(in, out, numSamples);
+}
+
+uint SincKernel::convolveAVX2(Args &args) {
+	static_assert(kTaps == 16, "The SIMD convolution is unrolled for 16 taps");
+
+	uint32 pos = args.pos, frac = args.frac;
+	st_sample_t *out = args.out;
+	uint n;
+
+	for (n = 0; n < args.maxFrames && pos + kTaps <= args.historyLen; n++) {
+		const int16 *coefs = args.coefs + (frac >> (32 - kPhaseBits)) * kTaps;
+		const st_sample_t *in = args.history + pos;
+
+		__m256i prod = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)in), _mm256_loadu_si256((const __m256i *)coefs));
+		__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(prod), _mm256_extracti128_si256(prod, 1));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		*out = (st_sample_t)CLIP<int32>((_mm_cvtsi128_si32(sum) + (1 << (kCoefBits - 1))) >> kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		out += args.outStride;
+
+		const uint32 newFrac = frac + args.stepFrac;
+		pos += args.stepInt + (newFrac < frac ? 1 : 0);
+		frac = newFrac;
+	}
+
+	args.pos = pos;
+	args.frac = frac;
+	return n;
+}
+
+} // End of namespace Audio
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
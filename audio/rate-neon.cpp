@@ -0,0 +1,216 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "common/util.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Audio {
+
+// Divides the 32-bit products by kMaxMixerVolume, rounding towards zero
+// like the C division does.
+static FORCEINLINE int32x4_t neon_scaleVolume(int32x4_t p) {
+	return vshrq_n_s32(vaddq_s32(p, vandq_s32(vshrq_n_s32(p, 31), vdupq_n_s32(255))), 8);
+}
+
+// Computes (in * vol) / kMaxMixerVolume for eight samples
+static FORCEINLINE int16x8_t neon_applyVolume(int16x8_t in, int16_t vol) {
+	int32x4_t p0 = neon_scaleVolume(vmull_n_s16(vget_low_s16(in), vol));
+	int32x4_t p1 = neon_scaleVolume(vmull_n_s16(vget_high_s16(in), vol));
+	// With volumes up to kMaxMixerVolume the results always fit in 16 bits
+	return vcombine_s16(vmovn_s32(p0), vmovn_s32(p1));
+}
+
+// Computes (l + r) / 2 for eight samples, rounding towards zero
+static FORCEINLINE int16x8_t neon_average(int16x8_t l, int16x8_t r) {
+	int32x4_t s0 = vaddl_s16(vget_low_s16(l), vget_low_s16(r));
+	int32x4_t s1 = vaddl_s16(vget_high_s16(l), vget_high_s16(r));
+	s0 = vshrq_n_s32(vaddq_s32(s0, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(s0), 31))), 1);
+	s1 = vshrq_n_s32(vaddq_s32(s1, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(s1), 31))), 1);
+	return vcombine_s16(vmovn_s32(s0), vmovn_s32(s1));
+}
+
+// Adds eight frames to a 16-bit stereo output buffer, saturating the result
+static FORCEINLINE void neon_addFrames(st_sample_t *out, int16x8_t l, int16x8_t r) {
+	int16x8x2_t dst = vld2q_s16(out);
+	dst.val[0] = vqaddq_s16(dst.val[0], l);
+	dst.val[1] = vqaddq_s16(dst.val[1], r);
+	vst2q_s16(out, dst);
+}
+
+// Adds eight frames to a stereo mix bus
+static FORCEINLINE void neon_addFrames(st_mix_t *out, int16x8_t l, int16x8_t r) {
+	int32x4x2_t dst0 = vld2q_s32(out);
+	int32x4x2_t dst1 = vld2q_s32(out + 8);
+	dst0.val[0] = vaddw_s16(dst0.val[0], vget_low_s16(l));
+	dst0.val[1] = vaddw_s16(dst0.val[1], vget_low_s16(r));
+	dst1.val[0] = vaddw_s16(dst1.val[0], vget_high_s16(l));
+	dst1.val[1] = vaddw_s16(dst1.val[1], vget_high_s16(r));
+	vst2q_s32(out, dst0);
+	vst2q_s32(out + 8, dst1);
+}
+
+// Adds eight samples to a 16-bit mono output buffer, saturating the result
+static FORCEINLINE void neon_addSamples(st_sample_t *out, int16x8_t samples) {
+	vst1q_s16(out, vqaddq_s16(vld1q_s16(out), samples));
+}
+
+// Adds eight samples to a mono mix bus
+static FORCEINLINE void neon_addSamples(st_mix_t *out, int16x8_t samples) {
+	vst1q_s32(out, vaddw_s16(vld1q_s32(out), vget_low_s16(samples)));
+	vst1q_s32(out + 4, vaddw_s16(vld1q_s32(out + 4), vget_high_s16(samples)));
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo, class T>
+static void mixFramesNEON(const st_sample_t *&in, T *&out, st_size_t &numFrames, st_volume_t volL, st_volume_t volR) {
+	for (; numFrames >= 8; numFrames -= 8) {
+		int16x8_t srcL, srcR;
+		if (inStereo) {
+			int16x8x2_t src = vld2q_s16(in);
+			srcL = neon_applyVolume(src.val[0], volL);
+			srcR = neon_applyVolume(src.val[1], volR);
+			in += 16;
+		} else {
+			int16x8_t src = vld1q_s16(in);
+			srcL = neon_applyVolume(src, volL);
+			srcR = neon_applyVolume(src, volR);
+			in += 8;
+		}
+
+		if (outStereo) {
+			if (reverseStereo)
+				neon_addFrames(out, srcR, srcL);
+			else
+				neon_addFrames(out, srcL, srcR);
+			out += 16;
+		} else {
+			neon_addSamples(out, neon_average(srcL, srcR));
+			out += 8;
+		}
+	}
+}
+
+template<class T>
+static void mixNEONImpl(const st_sample_t *&in, T *&out, st_size_t &numFrames, st_volume_t volL, st_volume_t volR,
+						bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				mixFramesNEON<true, true, true>(in, out, numFrames, volL, volR);
+			else
+				mixFramesNEON<true, true, false>(in, out, numFrames, volL, volR);
+		} else
+			mixFramesNEON<true, false, false>(in, out, numFrames, volL, volR);
+	} else {
+		if (outStereo)
+			mixFramesNEON<false, true, false>(in, out, numFrames, volL, volR);
+		else
+			mixFramesNEON<false, false, false>(in, out, numFrames, volL, volR);
+	}
+}
+
+void MixKernel::mixNEON(Args<st_sample_t> &args) {
+	mixNEONImpl(args.in, args.out, args.numFrames, args.volL, args.volR, args.inStereo, args.outStereo, args.reverseStereo);
+
+	// Mix the remaining frames
+	mixGeneric(args);
+}
+
+void MixKernel::mixNEON(Args<st_mix_t> &args) {
+	mixNEONImpl(args.in, args.out, args.numFrames, args.volL, args.volR, args.inStereo, args.outStereo, args.reverseStereo);
+
+	// Mix the remaining frames
+	mixGeneric(args);
+}
+
+void MixKernel::clampNEON(const st_mix_t *in, st_sample_t *out, st_size_t numSamples) {
+	for (; numSamples >= 8; numSamples -= 8) {
+		int16x4_t lo = vqmovn_s32(vld1q_s32(in));
+		int16x4_t hi = vqmovn_s32(vld1q_s32(in + 4));
+		vst1q_s16(out, vcombine_s16(lo, hi));
+		in += 8;
+		out += 8;
+	}
+
+	clampGeneric(in, out, numSamples);
+}
+
+uint SincKernel::convolveNEON(Args &args) {
+	static_assert(kTaps == 16, "The SIMD convolution is unrolled for 16 taps");
+
+	uint32 pos = args.pos, frac = args.frac;
+	st_sample_t *out = args.out;
+	uint n;
+
+	for (n = 0; n < args.maxFrames && pos + kTaps <= args.historyLen; n++) {
+		const int16 *coefs = args.coefs + (frac >> (32 - kPhaseBits)) * kTaps;
+		const st_sample_t *in = args.history + pos;
+
+		int32x4_t acc = vmull_s16(vld1_s16(in), vld1_s16(coefs));
+		acc = vmlal_s16(acc, vld1_s16(in + 4), vld1_s16(coefs + 4));
+		acc = vmlal_s16(acc, vld1_s16(in + 8), vld1_s16(coefs + 8));
+		acc = vmlal_s16(acc, vld1_s16(in + 12), vld1_s16(coefs + 12));
+		int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+		sum = vpadd_s32(sum, sum);
+
+		*out = (st_sample_t)CLIP<int32>((vget_lane_s32(sum, 0) + (1 << (kCoefBits - 1))) >> kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		out += args.outStride;
+
+		const uint32 newFrac = frac + args.stepFrac;
+		pos += args.stepInt + (newFrac < frac ? 1 : 0);
+		frac = newFrac;
+	}
+
+	args.pos = pos;
+	args.frac = frac;
+	return n;
+}
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,222 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "common/util.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+static_assert(Mixer::kMaxMixerVolume == 256, "The SIMD mixing code assumes a volume shift of 8");
+
+// Divides the 32-bit products by kMaxMixerVolume, rounding towards zero
+// like the C division does.
+static FORCEINLINE __m128i sse2_scaleVolume(__m128i p) {
+	return _mm_srai_epi32(_mm_add_epi32(p, _mm_and_si128(_mm_srai_epi32(p, 31), _mm_set1_epi32(255))), 8);
+}
+
+// Computes (in * vol) / kMaxMixerVolume for eight samples
+static FORCEINLINE __m128i sse2_applyVolume(__m128i in, __m128i vol) {
+	__m128i lo = _mm_mullo_epi16(in, vol);
+	__m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i p0 = sse2_scaleVolume(_mm_unpacklo_epi16(lo, hi));
+	__m128i p1 = sse2_scaleVolume(_mm_unpackhi_epi16(lo, hi));
+	// With volumes up to kMaxMixerVolume the results always fit in 16 bits
+	return _mm_packs_epi32(p0, p1);
+}
+
+// Computes (a + b) / 2 on pairs of 32-bit sums, rounding towards zero
+static FORCEINLINE __m128i sse2_halve(__m128i s) {
+	return _mm_srai_epi32(_mm_add_epi32(s, _mm_srli_epi32(s, 31)), 1);
+}
+
+// Adds eight samples to a 16-bit output buffer, saturating the result
+static FORCEINLINE void sse2_addSamples(st_sample_t *out, __m128i samples) {
+	__m128i dst = _mm_loadu_si128((const __m128i *)out);
+	_mm_storeu_si128((__m128i *)out, _mm_adds_epi16(dst, samples));
+}
+
+// Adds eight samples to the mix bus
+static FORCEINLINE void sse2_addSamples(st_mix_t *out, __m128i samples) {
+	// Sign extend the samples to 32 bits
+	__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+	__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+	_mm_storeu_si128((__m128i *)out, _mm_add_epi32(_mm_loadu_si128((const __m128i *)out), lo));
+	_mm_storeu_si128((__m128i *)(out + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(out + 4)), hi));
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo, class T>
+static void mixFramesSSE2(const st_sample_t *&in, T *&out, st_size_t &numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m128i ones = _mm_set1_epi16(1);
+
+	if (inStereo && outStereo) {
+		// The channels are swapped before applying the volume, so the
+		// volume has to be swapped as well
+		const __m128i vol = reverseStereo ? _mm_set1_epi32((volL << 16) | volR) : _mm_set1_epi32((volR << 16) | volL);
+		for (; numFrames >= 4; numFrames -= 4) {
+			__m128i src = _mm_loadu_si128((const __m128i *)in);
+			if (reverseStereo) {
+				src = _mm_shufflelo_epi16(src, _MM_SHUFFLE(2, 3, 0, 1));
+				src = _mm_shufflehi_epi16(src, _MM_SHUFFLE(2, 3, 0, 1));
+			}
+			sse2_addSamples(out, sse2_applyVolume(src, vol));
+			in += 8;
+			out += 8;
+		}
+	} else if (inStereo) {
+		const __m128i vol = _mm_set1_epi32((volR << 16) | volL);
+		for (; numFrames >= 8; numFrames -= 8) {
+			__m128i src0 = sse2_applyVolume(_mm_loadu_si128((const __m128i *)in), vol);
+			__m128i src1 = sse2_applyVolume(_mm_loadu_si128((const __m128i *)(in + 8)), vol);
+			__m128i sum0 = sse2_halve(_mm_madd_epi16(src0, ones));
+			__m128i sum1 = sse2_halve(_mm_madd_epi16(src1, ones));
+			sse2_addSamples(out, _mm_packs_epi32(sum0, sum1));
+			in += 16;
+			out += 8;
+		}
+	} else if (outStereo) {
+		const __m128i vl = _mm_set1_epi16(volL);
+		const __m128i vr = _mm_set1_epi16(volR);
+		for (; numFrames >= 8; numFrames -= 8) {
+			__m128i src = _mm_loadu_si128((const __m128i *)in);
+			__m128i srcL = sse2_applyVolume(src, vl);
+			__m128i srcR = sse2_applyVolume(src, vr);
+			sse2_addSamples(out, _mm_unpacklo_epi16(srcL, srcR));
+			sse2_addSamples(out + 8, _mm_unpackhi_epi16(srcL, srcR));
+			in += 8;
+			out += 16;
+		}
+	} else {
+		const __m128i vl = _mm_set1_epi16(volL);
+		const __m128i vr = _mm_set1_epi16(volR);
+		for (; numFrames >= 8; numFrames -= 8) {
+			__m128i src = _mm_loadu_si128((const __m128i *)in);
+			__m128i srcL = sse2_applyVolume(src, vl);
+			__m128i srcR = sse2_applyVolume(src, vr);
+			__m128i sum0 = sse2_halve(_mm_madd_epi16(_mm_unpacklo_epi16(srcL, srcR), ones));
+			__m128i sum1 = sse2_halve(_mm_madd_epi16(_mm_unpackhi_epi16(srcL, srcR), ones));
+			sse2_addSamples(out, _mm_packs_epi32(sum0, sum1));
+			in += 8;
+			out += 8;
+		}
+	}
+}
+
+template<class T>
+static void mixSSE2Impl(const st_sample_t *&in, T *&out, st_size_t &numFrames, st_volume_t volL, st_volume_t volR,
+						bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				mixFramesSSE2<true, true, true>(in, out, numFrames, volL, volR);
+			else
+				mixFramesSSE2<true, true, false>(in, out, numFrames, volL, volR);
+		} else
+			mixFramesSSE2<true, false, false>(in, out, numFrames, volL, volR);
+	} else {
+		if (outStereo)
+			mixFramesSSE2<false, true, false>(in, out, numFrames, volL, volR);
+		else
+			mixFramesSSE2<false, false, false>(in, out, numFrames, volL, volR);
+	}
+}
+
+void MixKernel::mixSSE2(Args<st_sample_t> &args) {
+	mixSSE2Impl(args.in, args.out, args.numFrames, args.volL, args.volR, args.inStereo, args.outStereo, args.reverseStereo);
+
+	// Mix the remaining frames
+	mixGeneric(args);
+}
+
+void MixKernel::mixSSE2(Args<st_mix_t> &args) {
+	mixSSE2Impl(args.in, args.out, args.numFrames, args.volL, args.volR, args.inStereo, args.outStereo, args.reverseStereo);
+
+	// Mix the remaining frames
+	mixGeneric(args);
+}
+
+void MixKernel::clampSSE2(const st_mix_t *in, st_sample_t *out, st_size_t numSamples) {
+	for (; numSamples >= 8; numSamples -= 8) {
+		__m128i lo = _mm_loadu_si128((const __m128i *)in);
+		__m128i hi = _mm_loadu_si128((const __m128i *)(in + 4));
+		_mm_storeu_si128((__m128i *)out, _mm_packs_epi32(lo, hi));
+		in += 8;
+		out += 8;
+	}
+
+	clampGeneric(in, out, numSamples);
+}
+
+uint SincKernel::convolveSSE2(Args &args) {
+	static_assert(kTaps == 16, "The SIMD convolution is unrolled for 16 taps");
+
+	uint32 pos = args.pos, frac = args.frac;
+	st_sample_t *out = args.out;
+	uint n;
+
+	for (n = 0; n < args.maxFrames && pos + kTaps <= args.historyLen; n++) {
+		const int16 *coefs = args.coefs + (frac >> (32 - kPhaseBits)) * kTaps;
+		const st_sample_t *in = args.history + pos;
+
+		__m128i sum = _mm_add_epi32(_mm_madd_epi16(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128((const __m128i *)coefs)),
+		                            _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(in + 8)), _mm_loadu_si128((const __m128i *)(coefs + 8))));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		*out = (st_sample_t)CLIP<int32>((_mm_cvtsi128_si32(sum) + (1 << (kCoefBits - 1))) >> kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		out += args.outStride;
+
+		const uint32 newFrac = frac + args.stepFrac;
+		pos += args.stepInt + (newFrac < frac ? 1 : 0);
+		frac = newFrac;
+	}
+
+	args.pos = pos;
+	args.frac = frac;
+	return n;
+}
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
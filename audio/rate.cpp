@@ -30,10 +30,229 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
 
+// Adds a sample to a 16-bit output buffer, saturating the result
+static FORCEINLINE void addSample(st_sample_t &out, int value) {
+	clampedAdd(out, value);
+}
+
+// Adds a sample to the mix bus, which has enough headroom to not saturate
+static FORCEINLINE void addSample(st_mix_t &out, int value) {
+	out += value;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo, class T>
+static void mixFramesGeneric(const st_sample_t *in, T *out, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	for (st_size_t i = 0; i < numFrames; i++) {
+		st_sample_t inL, inR;
+		inL = *in++;
+		inR = (inStereo ? *in++ : inL);
+
+		st_sample_t outL, outR;
+		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+		if (outStereo) {
+			// Output left channel
+			addSample(out[reverseStereo    ], outL);
+
+			// Output right channel
+			addSample(out[reverseStereo ^ 1], outR);
+
+			out += 2;
+		} else {
+			// Output mono channel
+			addSample(out[0], (outL + outR) / 2);
+
+			out += 1;
+		}
+	}
+}
+
+template<class T>
+static void mixGenericImpl(const st_sample_t *in, T *out, st_size_t numFrames, st_volume_t volL, st_volume_t volR,
+						   bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				mixFramesGeneric<true, true, true>(in, out, numFrames, volL, volR);
+			else
+				mixFramesGeneric<true, true, false>(in, out, numFrames, volL, volR);
+		} else
+			mixFramesGeneric<true, false, false>(in, out, numFrames, volL, volR);
+	} else {
+		if (outStereo)
+			mixFramesGeneric<false, true, false>(in, out, numFrames, volL, volR);
+		else
+			mixFramesGeneric<false, false, false>(in, out, numFrames, volL, volR);
+	}
+}
+
+void MixKernel::mixGeneric(Args<st_sample_t> &args) {
+	mixGenericImpl(args.in, args.out, args.numFrames, args.volL, args.volR, args.inStereo, args.outStereo, args.reverseStereo);
+}
+
+void MixKernel::mixGeneric(Args<st_mix_t> &args) {
+	mixGenericImpl(args.in, args.out, args.numFrames, args.volL, args.volR, args.inStereo, args.outStereo, args.reverseStereo);
+}
+
+void MixKernel::clampGeneric(const st_mix_t *in, st_sample_t *out, st_size_t numSamples) {
+	for (st_size_t i = 0; i < numSamples; i++) {
+		st_sample_t sample = (st_sample_t)CLIP<st_mix_t>(in[i], ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		sample ^= 0x8000;
+#endif
+		out[i] = sample;
+	}
+}
+
+// Initialize these to nullptr at the start
+MixKernel::MixFunc MixKernel::mixFunc = nullptr;
+MixKernel::AccumulateFunc MixKernel::accumulateFunc = nullptr;
+MixKernel::ClampFunc MixKernel::clampFunc = nullptr;
+
+// Detects at runtime whether or not the cpu has certain SIMD features
+// enabled, and selects the fastest functions for the ones not set yet.
+void MixKernel::selectFuncs() {
+	MixFunc mix = mixGeneric;
+	AccumulateFunc accumulate = mixGeneric;
+	ClampFunc clampSamples = clampGeneric;
+
+	// The SIMD variants use signed arithmetic
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		mix = mixNEON;
+		accumulate = mixNEON;
+		clampSamples = clampNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		mix = mixSSE2;
+		accumulate = mixSSE2;
+		clampSamples = clampSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		mix = mixAVX2;
+		accumulate = mixAVX2;
+		clampSamples = clampAVX2;
+	}
+#endif
+#endif // OUTPUT_UNSIGNED_AUDIO
+
+	if (!mixFunc)
+		mixFunc = mix;
+	if (!accumulateFunc)
+		accumulateFunc = accumulate;
+	if (!clampFunc)
+		clampFunc = clampSamples;
+}
+
+// These functions are just here to jump to whatever function is in the
+// corresponding function pointer.
+void MixKernel::mix(const st_sample_t *in, st_sample_t *out, st_size_t numFrames,
+					st_volume_t volL, st_volume_t volR,
+					bool inStereo, bool outStereo, bool reverseStereo) {
+	if (numFrames == 0)
+		return;
+
+	// If no function has been selected yet, detect and select
+	if (!mixFunc)
+		selectFuncs();
+
+	Args<st_sample_t> args(in, out, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
+
+	// The SIMD variants rely on the scaled samples fitting into 16 bits
+	if (volL > Audio::Mixer::kMaxMixerVolume || volR > Audio::Mixer::kMaxMixerVolume)
+		mixGeneric(args);
+	else
+		mixFunc(args);
+}
+
+void MixKernel::mix(const st_sample_t *in, st_mix_t *out, st_size_t numFrames,
+					st_volume_t volL, st_volume_t volR,
+					bool inStereo, bool outStereo, bool reverseStereo) {
+	if (numFrames == 0)
+		return;
+
+	if (!accumulateFunc)
+		selectFuncs();
+
+	Args<st_mix_t> args(in, out, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
+
+	if (volL > Audio::Mixer::kMaxMixerVolume || volR > Audio::Mixer::kMaxMixerVolume)
+		mixGeneric(args);
+	else
+		accumulateFunc(args);
+}
+
+void MixKernel::clamp(const st_mix_t *in, st_sample_t *out, st_size_t numSamples) {
+	if (!clampFunc)
+		selectFuncs();
+
+	clampFunc(in, out, numSamples);
+}
+
+uint SincKernel::convolveGeneric(Args &args) {
+	uint32 pos = args.pos, frac = args.frac;
+	st_sample_t *out = args.out;
+	uint n;
+
+	for (n = 0; n < args.maxFrames && pos + kTaps <= args.historyLen; n++) {
+		const int16 *coefs = args.coefs + (frac >> (32 - kPhaseBits)) * kTaps;
+		const st_sample_t *in = args.history + pos;
+
+		int32 sum = 0;
+		for (int i = 0; i < kTaps; i++)
+			sum += in[i] * coefs[i];
+
+		*out = (st_sample_t)CLIP<int32>((sum + (1 << (kCoefBits - 1))) >> kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		out += args.outStride;
+
+		const uint32 newFrac = frac + args.stepFrac;
+		pos += args.stepInt + (newFrac < frac ? 1 : 0);
+		frac = newFrac;
+	}
+
+	args.pos = pos;
+	args.frac = frac;
+	return n;
+}
+
+// Initialize this to nullptr at the start
+SincKernel::ConvolveFunc SincKernel::convolveFunc = nullptr;
+
+// This function is just here to jump to whatever function is in
+// SincKernel::convolveFunc. This way, we can detect at runtime whether or
+// not the cpu has certain SIMD feature enabled or not.
+uint SincKernel::convolve(const st_sample_t *history, uint historyLen, const int16 *coefs,
+						  uint32 &pos, uint32 &frac, uint32 stepInt, uint32 stepFrac,
+						  st_sample_t *out, uint outStride, uint maxFrames) {
+	// If no function has been selected yet, detect and select
+	if (!convolveFunc) {
+		convolveFunc = convolveGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) convolveFunc = convolveNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) convolveFunc = convolveSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) convolveFunc = convolveAVX2;
+#endif
+	}
+
+	Args args(history, historyLen, coefs, pos, frac, stepInt, stepFrac, out, outStride, maxFrames);
+	return convolveFunc(args);
+}
+
 /**
  * The default fractional type in frac.h (with 16 fractional bits) limits
  * the rate conversion code to 65536Hz audio: we need to able to handle
@@ -58,6 +277,12 @@ private:
 	 */
 	st_sample_t _buffer[512];
 
+	/**
+	 * Resampled frames waiting to be mixed into the output buffer. Staging
+	 * them allows the volume and mixing step to be done in blocks.
+	 */
+	st_sample_t _staging[512];
+
 	/** Current position inside the buffer */
 	const st_sample_t *_bufferPos;
 
@@ -76,15 +301,27 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
-	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<class T>
+	int copyConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<class T>
+	int simpleConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<class T>
+	int interpolateConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+
+	template<class T>
+	int convertImpl(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 
 public:
 	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
 	virtual ~RateConverter_Impl() {}
 
-	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override {
+		return convertImpl(input, outBuffer, numSamples, vol_l, vol_r);
+	}
+
+	int convert(AudioStream &input, st_mix_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override {
+		return convertImpl(input, outBuffer, numSamples, vol_l, vol_r);
+	}
 
 	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; }
 	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; }
@@ -96,8 +333,9 @@ public:
 };
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
-	st_sample_t *outStart, *outEnd;
+template<class T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	T *outStart, *outEnd;
 
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
@@ -112,159 +350,140 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStr
 				return (outBuffer - outStart) / (outStereo ? 2 : 1);
 		}
 
-		// Mix the data into the output buffer
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-		_bufferSize -= (inStereo ? 2 : 1);
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
+		// Mix as much of the buffered data as fits into the output buffer
+		st_size_t numFrames = MIN<st_size_t>(_bufferSize / (inStereo ? 2 : 1), (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		MixKernel::mix(_bufferPos, outBuffer, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
 
-			outBuffer += 1;
-		}
+		_bufferPos += numFrames * (inStereo ? 2 : 1);
+		_bufferSize -= numFrames * (inStereo ? 2 : 1);
+		outBuffer += numFrames * (outStereo ? 2 : 1);
 	}
 
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+template<class T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	// How much to increment _outPos by
 	frac_t outPos_inc = _inRate / _outRate;
 
-	st_sample_t *outStart, *outEnd;
+	T *outStart, *outEnd;
 
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
-	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
-			}
+	bool endOfInput = false;
 
-			_bufferSize -= (inStereo ? 2 : 1);
-			_outPos--;
+	while (outBuffer < outEnd && !endOfInput) {
+		// Pick the input frames into the staging buffer, then mix them in one go
+		const st_size_t maxFrames = MIN<st_size_t>(ARRAYSIZE(_staging) / 2, (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		st_sample_t *stagingPos = _staging;
+		st_size_t numFrames = 0;
 
-			if (_outPos >= 0) {
-				_bufferPos += (inStereo ? 2 : 1);
-			}
-		} while (_outPos >= 0);
+		while (numFrames < maxFrames) {
+			// Read enough input samples so that _outPos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
+					if (_bufferSize <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
 
-		// Increment output position
-		_outPos += outPos_inc;
+				_bufferSize -= (inStereo ? 2 : 1);
+				_outPos--;
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+				if (_outPos >= 0) {
+					_bufferPos += (inStereo ? 2 : 1);
+				}
+			} while (_outPos >= 0);
 
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+			if (endOfInput)
+				break;
 
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
+			*stagingPos++ = *_bufferPos++;
+			if (inStereo)
+				*stagingPos++ = *_bufferPos++;
 
-			outBuffer += 1;
+			// Increment output position
+			_outPos += outPos_inc;
+			numFrames++;
 		}
+
+		MixKernel::mix(_staging, outBuffer, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
+		outBuffer += numFrames * (outStereo ? 2 : 1);
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+template<class T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
-	st_sample_t *outStart, *outEnd;
+	T *outStart, *outEnd;
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
-	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPosFrac < 0
-		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	bool endOfInput = false;
+
+	while (outBuffer < outEnd && !endOfInput) {
+		// Interpolate into the staging buffer, then mix it in one go
+		const st_size_t maxFrames = MIN<st_size_t>(ARRAYSIZE(_staging) / 2, (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		st_sample_t *stagingPos = _staging;
+		st_size_t numFrames = 0;
+
+		while (numFrames < maxFrames) {
+			// Read enough input samples so that _outPosFrac < 0
+			while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+					if (_bufferSize <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+
+				_bufferSize -= (inStereo ? 2 : 1);
+				_inLastL = _inCurL;
+				_inCurL = *_bufferPos++;
+
+				if (inStereo) {
+					_inLastR = _inCurR;
+					_inCurR = *_bufferPos++;
+				}
+
+				_outPosFrac -= FRAC_ONE_LOW;
 			}
 
-			_bufferSize -= (inStereo ? 2 : 1);
-			_inLastL = _inCurL;
-			_inCurL = *_bufferPos++;
+			if (endOfInput)
+				break;
 
-			if (inStereo) {
-				_inLastR = _inCurR;
-				_inCurR = *_bufferPos++;
-			}
-
-			_outPosFrac -= FRAC_ONE_LOW;
-		}
+			// Loop as long as the _outPos trails behind, and as long as there is
+			// still space in the staging buffer.
+			while (_outPosFrac < (frac_t)FRAC_ONE_LOW && numFrames < maxFrames) {
+				// Interpolate
+				*stagingPos++ = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				if (inStereo)
+					*stagingPos++ = (st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
-		// Loop as long as the _outPos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
-			// Interpolate
-			st_sample_t inL, inR;
-			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			inR = (inStereo ?
-						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						inL);
-
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
-
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-				outBuffer += 1;
+				// Increment output position
+				_outPosFrac += outPos_inc;
+				numFrames++;
 			}
-
-			// Increment output position
-			_outPosFrac += outPos_inc;
 		}
+
+		MixKernel::mix(_staging, outBuffer, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
+		outBuffer += numFrames * (outStereo ? 2 : 1);
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
@@ -283,7 +502,8 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_bufferPos(nullptr) {}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+template<class T>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convertImpl(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	assert(input.isStereo() == inStereo);
 
 	if (_inRate == _outRate) {
@@ -297,7 +517,229 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 	}
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+/**
+ * High quality rate converter using a windowed-sinc filter.
+ *
+ * The filter is stored as a polyphase table of SincKernel::kPhases phases
+ * with SincKernel::kTaps taps each, so computing an output sample only
+ * takes a single short convolution. When downsampling, the cutoff is lowered
+ * to the output Nyquist frequency.
+ */
+class SincRateConverter : public RateConverter {
+private:
+	enum {
+		kTaps = SincKernel::kTaps,
+		/** Size of the input history per channel, in frames */
+		kHistorySize = 1024,
+		/** Number of frames computed before they are handed to MixKernel */
+		kStagingFrames = 256
+	};
+
+	const bool _inStereo, _outStereo, _reverseStereo;
+
+	/** Input and output rates */
+	st_rate_t _inRate, _outRate;
+
+	/** Rates the current filter table was computed for */
+	st_rate_t _tableInRate, _tableOutRate;
+
+	/** Cutoff frequency of the current filter table, in 1/64ths of the input Nyquist frequency */
+	int _tableCutoff;
+
+	/** Polyphase filter table, kPhases * kTaps coefficients */
+	int16 *_coefs;
+
+	/** Deinterleaved input history of the left and right channels */
+	st_sample_t _history[2][kHistorySize];
+
+	/** Number of valid frames in the history */
+	uint _historyLen;
+
+	/** History index of the first filter tap for the next output frame */
+	uint32 _pos;
+
+	/** Fractional part of the position */
+	uint32 _frac;
+
+	/** Buffer for reading interleaved input */
+	st_sample_t _readBuffer[512];
+
+	/** Computed frames waiting to be mixed into the output buffer */
+	st_sample_t _staging[kStagingFrames * 2];
+
+	void updateTable();
+	bool refill(AudioStream &input);
+
+	template<class T>
+	int convertImpl(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+
+public:
+	SincRateConverter(st_rate_t inputRate, st_rate_t outputRate, bool inStereo, bool outStereo, bool reverseStereo);
+	~SincRateConverter() override;
+
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override {
+		return convertImpl(input, outBuffer, numSamples, vol_l, vol_r);
+	}
+
+	int convert(AudioStream &input, st_mix_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override {
+		return convertImpl(input, outBuffer, numSamples, vol_l, vol_r);
+	}
+
+	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; }
+	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; }
+
+	st_rate_t getInputRate() const override { return _inRate; }
+	st_rate_t getOutputRate() const override { return _outRate; }
+
+	bool needsDraining() const override { return _pos + kTaps <= _historyLen; }
+};
+
+SincRateConverter::SincRateConverter(st_rate_t inputRate, st_rate_t outputRate, bool inStereo, bool outStereo, bool reverseStereo) :
+	_inStereo(inStereo),
+	_outStereo(outStereo),
+	_reverseStereo(reverseStereo),
+	_inRate(inputRate),
+	_outRate(outputRate),
+	_tableInRate(0),
+	_tableOutRate(0),
+	_tableCutoff(0),
+	_coefs(new int16[SincKernel::kPhases * kTaps]),
+	_pos(0),
+	_frac(0) {
+
+	// Start with enough silence that the first output frame is centered
+	// on the first input frame
+	_historyLen = kTaps / 2 - 1;
+	memset(_history, 0, sizeof(_history));
+
+	updateTable();
+}
+
+SincRateConverter::~SincRateConverter() {
+	delete[] _coefs;
+}
+
+void SincRateConverter::updateTable() {
+	_tableInRate = _inRate;
+	_tableOutRate = _outRate;
+
+	// Keep some distance from the Nyquist frequency, the filter is short
+	int cutoff = 58;
+	if (_outRate < _inRate)
+		cutoff = MAX<int>(1, (int)((uint64)cutoff * _outRate / _inRate));
+
+	if (cutoff == _tableCutoff)
+		return;
+	_tableCutoff = cutoff;
+
+	const double fc = cutoff / 64.0;
+	const double center = kTaps / 2 - 1;
+
+	for (int phase = 0; phase < SincKernel::kPhases; phase++) {
+		double taps[kTaps];
+		double sum = 0.0;
+
+		for (int i = 0; i < kTaps; i++) {
+			// Distance of the tap from the interpolated position
+			const double x = i - center - (double)phase / SincKernel::kPhases;
+			const double sinc = (x == 0.0) ? 1.0 : sin(M_PI * fc * x) / (M_PI * fc * x);
+			// Blackman window spanning the filter
+			const double w = (x + kTaps / 2) / kTaps;
+			const double window = 0.42 - 0.5 * cos(2 * M_PI * w) + 0.08 * cos(4 * M_PI * w);
+
+			taps[i] = sinc * window;
+			sum += taps[i];
+		}
+
+		// Normalize each phase to unity gain, and put the rounding error
+		// on the largest tap so the gain is exact
+		int16 *coefs = _coefs + phase * kTaps;
+		int total = 0, largest = 0;
+		for (int i = 0; i < kTaps; i++) {
+			coefs[i] = (int16)floor(taps[i] / sum * (1 << SincKernel::kCoefBits) + 0.5);
+			total += coefs[i];
+			if (ABS(coefs[i]) > ABS(coefs[largest]))
+				largest = i;
+		}
+		coefs[largest] += (1 << SincKernel::kCoefBits) - total;
+	}
+}
+
+bool SincRateConverter::refill(AudioStream &input) {
+	// Drop the frames which are not needed anymore
+	if (_pos > 0) {
+		const uint keep = _historyLen > _pos ? _historyLen - _pos : 0;
+		const uint drop = _historyLen - keep;
+		memmove(_history[0], _history[0] + drop, keep * sizeof(st_sample_t));
+		memmove(_history[1], _history[1] + drop, keep * sizeof(st_sample_t));
+		_historyLen = keep;
+		_pos -= drop;
+	}
+
+	const uint channels = _inStereo ? 2 : 1;
+	const uint space = MIN<uint>(kHistorySize - _historyLen, ARRAYSIZE(_readBuffer) / channels);
+	const int samples = input.readBuffer(_readBuffer, space * channels);
+	if (samples <= 0)
+		return false;
+
+	const uint frames = samples / channels;
+	if (_inStereo) {
+		for (uint i = 0; i < frames; i++) {
+			_history[0][_historyLen + i] = _readBuffer[i * 2];
+			_history[1][_historyLen + i] = _readBuffer[i * 2 + 1];
+		}
+	} else {
+		memcpy(_history[0] + _historyLen, _readBuffer, frames * sizeof(st_sample_t));
+	}
+	_historyLen += frames;
+
+	return true;
+}
+
+template<class T>
+int SincRateConverter::convertImpl(AudioStream &input, T *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	assert(input.isStereo() == _inStereo);
+
+	if (_inRate != _tableInRate || _outRate != _tableOutRate)
+		updateTable();
+
+	// The position increment per output frame, as integer and 32-bit fraction
+	const uint32 stepInt = _inRate / _outRate;
+	const uint32 stepFrac = (uint32)(((uint64)(_inRate % _outRate) << 32) / _outRate);
+
+	st_size_t produced = 0;
+	while (produced < numSamples) {
+		const uint maxFrames = MIN<uint>(kStagingFrames, numSamples - produced);
+		uint frames;
+
+		if (_inStereo) {
+			// Both channels advance identically, so the right channel
+			// starts from a copy of the position
+			uint32 pos = _pos, frac = _frac;
+			SincKernel::convolve(_history[0], _historyLen, _coefs, pos, frac, stepInt, stepFrac, _staging, 2, maxFrames);
+			frames = SincKernel::convolve(_history[1], _historyLen, _coefs, _pos, _frac, stepInt, stepFrac, _staging + 1, 2, maxFrames);
+		} else {
+			frames = SincKernel::convolve(_history[0], _historyLen, _coefs, _pos, _frac, stepInt, stepFrac, _staging, 1, maxFrames);
+		}
+
+		if (frames == 0) {
+			if (!refill(input))
+				break;
+			continue;
+		}
+
+		MixKernel::mix(_staging, outBuffer, frames, volL, volR, _inStereo, _outStereo, _reverseStereo);
+		outBuffer += frames * (_outStereo ? 2 : 1);
+		produced += frames;
+	}
+
+	return produced;
+}
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterQuality quality) {
+	if (quality == kRateConverterHigh)
+		return new SincRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
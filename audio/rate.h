@@ -24,6 +24,9 @@
 
 #include "common/frac.h"
 
+class RateConverterTestSuite;
+class MixerTestSuite;
+
 namespace Audio {
 /**
  * @defgroup audio_rate Sample rate
@@ -36,6 +39,8 @@ namespace Audio {
 class AudioStream;
 
 typedef int16 st_sample_t;
+/** Sample type of the mixer's internal bus, which is only clamped to st_sample_t once all channels have been mixed */
+typedef int32 st_mix_t;
 typedef uint16 st_volume_t;
 typedef uint32 st_size_t;
 typedef uint32 st_rate_t;
@@ -66,6 +71,189 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * Applies the left/right channel volume to a block of sample frames and
+ * adds the result to an output buffer.
+ *
+ * The output can either be a 16-bit buffer, in which case every addition
+ * saturates exactly like clampedAdd(), or a 32-bit mix bus, which keeps the
+ * full headroom and is only clamped once by clamp() after all channels have
+ * been mixed.
+ *
+ * The rate converters stage their resampled frames and hand them over in
+ * blocks, so that the volume and mixing step can be done with SIMD
+ * instructions. The implementation is selected at runtime depending on the
+ * features supported by the CPU.
+ */
+class MixKernel {
+private:
+	template<class T>
+	struct Args {
+		const st_sample_t *in;
+		T *out;
+		st_size_t numFrames;
+		st_volume_t volL, volR;
+		bool inStereo, outStereo, reverseStereo;
+
+		Args(const st_sample_t *in_, T *out_, st_size_t numFrames_,
+			 st_volume_t volL_, st_volume_t volR_,
+			 bool inStereo_, bool outStereo_, bool reverseStereo_) :
+			in(in_), out(out_), numFrames(numFrames_), volL(volL_), volR(volR_),
+			inStereo(inStereo_), outStereo(outStereo_), reverseStereo(reverseStereo_) {}
+	};
+
+#ifdef SCUMMVM_NEON
+	static void mixNEON(Args<st_sample_t> &args);
+	static void mixNEON(Args<st_mix_t> &args);
+	static void clampNEON(const st_mix_t *in, st_sample_t *out, st_size_t numSamples);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void mixSSE2(Args<st_sample_t> &args);
+	static void mixSSE2(Args<st_mix_t> &args);
+	static void clampSSE2(const st_mix_t *in, st_sample_t *out, st_size_t numSamples);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void mixAVX2(Args<st_sample_t> &args);
+	static void mixAVX2(Args<st_mix_t> &args);
+	static void clampAVX2(const st_mix_t *in, st_sample_t *out, st_size_t numSamples);
+#endif
+	static void mixGeneric(Args<st_sample_t> &args);
+	static void mixGeneric(Args<st_mix_t> &args);
+	static void clampGeneric(const st_mix_t *in, st_sample_t *out, st_size_t numSamples);
+
+	typedef void(*MixFunc)(Args<st_sample_t> &);
+	typedef void(*AccumulateFunc)(Args<st_mix_t> &);
+	typedef void(*ClampFunc)(const st_mix_t *, st_sample_t *, st_size_t);
+	static MixFunc mixFunc;
+	static AccumulateFunc accumulateFunc;
+	static ClampFunc clampFunc;
+
+	static void selectFuncs();
+
+	friend class ::RateConverterTestSuite;
+	friend class ::MixerTestSuite;
+
+public:
+	/**
+	 * Mix @p numFrames sample frames from @p in into @p out.
+	 *
+	 * @param in            Source frames, interleaved if @p inStereo is set.
+	 * @param out           Destination frames, interleaved if @p outStereo is set.
+	 * @param numFrames     Number of frames (not samples) to mix.
+	 * @param volL          Volume for left channel, in the range 0 - Mixer::kMaxMixerVolume.
+	 * @param volR          Volume for right channel, in the range 0 - Mixer::kMaxMixerVolume.
+	 * @param inStereo      Whether the source frames are stereo.
+	 * @param outStereo     Whether the destination frames are stereo.
+	 * @param reverseStereo Whether the left and right channels should be swapped.
+	 */
+	static void mix(const st_sample_t *in, st_sample_t *out, st_size_t numFrames,
+					st_volume_t volL, st_volume_t volR,
+					bool inStereo, bool outStereo, bool reverseStereo);
+
+	/**
+	 * Same as above, but adds to a 32-bit mix bus without saturating.
+	 */
+	static void mix(const st_sample_t *in, st_mix_t *out, st_size_t numFrames,
+					st_volume_t volL, st_volume_t volR,
+					bool inStereo, bool outStereo, bool reverseStereo);
+
+	/**
+	 * Convert the contents of a mix bus to output samples, saturating them
+	 * to the range of st_sample_t.
+	 *
+	 * @param in         The mix bus.
+	 * @param out        Where to store the output samples.
+	 * @param numSamples Number of samples (not frames) to convert.
+	 */
+	static void clamp(const st_mix_t *in, st_sample_t *out, st_size_t numSamples);
+};
+
+/**
+ * Computes the output samples of the windowed-sinc resampler for one
+ * channel, by convolving the input history with a polyphase filter table.
+ * Like MixKernel, the implementation is chosen at runtime depending on the
+ * SIMD extensions supported by the CPU.
+ */
+class SincKernel {
+public:
+	enum {
+		/** Number of filter taps per phase. The SIMD variants depend on this. */
+		kTaps = 16,
+		/** Number of bits of the position fraction used to select the phase */
+		kPhaseBits = 8,
+		kPhases = 1 << kPhaseBits,
+		/** Fixed point precision of the filter coefficients */
+		kCoefBits = 14
+	};
+
+private:
+	struct Args {
+		const st_sample_t *history;
+		uint historyLen;
+		const int16 *coefs;
+		uint32 &pos, &frac;
+		uint32 stepInt, stepFrac;
+		st_sample_t *out;
+		uint outStride;
+		uint maxFrames;
+
+		Args(const st_sample_t *history_, uint historyLen_, const int16 *coefs_,
+			 uint32 &pos_, uint32 &frac_, uint32 stepInt_, uint32 stepFrac_,
+			 st_sample_t *out_, uint outStride_, uint maxFrames_) :
+			history(history_), historyLen(historyLen_), coefs(coefs_),
+			pos(pos_), frac(frac_), stepInt(stepInt_), stepFrac(stepFrac_),
+			out(out_), outStride(outStride_), maxFrames(maxFrames_) {}
+	};
+
+#ifdef SCUMMVM_NEON
+	static uint convolveNEON(Args &args);
+#endif
+#ifdef SCUMMVM_SSE2
+	static uint convolveSSE2(Args &args);
+#endif
+#ifdef SCUMMVM_AVX2
+	static uint convolveAVX2(Args &args);
+#endif
+	static uint convolveGeneric(Args &args);
+
+	typedef uint(*ConvolveFunc)(Args &);
+	static ConvolveFunc convolveFunc;
+
+	friend class ::RateConverterTestSuite;
+
+public:
+	/**
+	 * Compute output samples as long as the history holds enough input
+	 * frames for the filter.
+	 *
+	 * @param history    Input samples of a single channel.
+	 * @param historyLen Number of valid samples in @p history.
+	 * @param coefs      Filter table with kPhases * kTaps coefficients.
+	 * @param pos        Index of the first filter tap in @p history; updated.
+	 * @param frac       Fractional part of the position, selecting the phase; updated.
+	 * @param stepInt    Integer part of the position increment per output sample.
+	 * @param stepFrac   Fractional part of the position increment per output sample.
+	 * @param out        Where to store the output samples.
+	 * @param outStride  Distance between two output samples.
+	 * @param maxFrames  Maximum number of samples to compute.
+	 *
+	 * @return The number of samples computed.
+	 */
+	static uint convolve(const st_sample_t *history, uint historyLen, const int16 *coefs,
+						 uint32 &pos, uint32 &frac, uint32 stepInt, uint32 stepFrac,
+						 st_sample_t *out, uint outStride, uint maxFrames);
+};
+
+/**
+ * The resampling algorithms a RateConverter can use.
+ */
+enum RateConverterQuality {
+	/** Copy, nearest neighbour or linear interpolation, depending on the rates */
+	kRateConverterFast,
+	/** Polyphase windowed-sinc filter, which avoids most of the aliasing */
+	kRateConverterHigh
+};
+
 /**
  * Helper class that handles resampling an AudioStream between an input and output
  * sample rate. Its regular use case is upsampling from the native stream rate
@@ -90,6 +278,15 @@ public:
 	 */
 	virtual int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
+	/**
+	 * Convert the provided AudioStream to the target sample rate and add it
+	 * to a 32-bit mix bus. Unlike the 16-bit variant, the samples are not
+	 * saturated, which is left to MixKernel::clamp().
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int convert(AudioStream &input, st_mix_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) = 0;
+
 	virtual void setInputRate(st_rate_t inputRate) = 0;
 	virtual void setOutputRate(st_rate_t outputRate) = 0;
 
@@ -104,7 +301,7 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterQuality quality = kRateConverterFast);
 
 /** @} */
 } // End of namespace Audio
@@ -0,0 +1,198 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/renderahead.h"
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Audio {
+
+RenderAheadBuffer::RenderAheadBuffer(RenderCallback *render, ResetCallback *reset) :
+	_render(render), _reset(reset), _stereo(false), _lookahead(0), _sleepTime(1), _active(false), _quit(false), _endOfData(false),
+	_resetsRequested(0), _resetsDone(0), _prefill(nullptr), _prefillLeft(0) {
+}
+
+RenderAheadBuffer::~RenderAheadBuffer() {
+	stop();
+}
+
+void RenderAheadBuffer::start(uint lookahead, int rate, bool stereo) {
+	stop();
+
+	if (lookahead == 0)
+		return;
+
+	allocate(lookahead, stereo);
+
+	// Check for free space about four times per lookahead, but often
+	// enough that stop() does not keep the mixer waiting for long
+	const uint frames = _lookahead / (_stereo ? 2 : 1);
+	_sleepTime = CLIP<uint>((uint)((uint64)frames * 1000 / 4 / rate), 1, kMaxSleepTime);
+
+	_quit.store(false);
+	_active.store(true);
+	if (!_thread.start(workerProc, this, "ScummVM render ahead")) {
+		debug(1, "RenderAheadBuffer: No thread support, rendering in the mixer thread");
+		_active.store(false);
+	}
+}
+
+void RenderAheadBuffer::stop() {
+	if (_thread.isRunning()) {
+		_quit.store(true);
+		_thread.wait();
+	}
+
+	_active.store(false);
+	_endOfData.store(false);
+}
+
+void RenderAheadBuffer::reset(const int16 *prefill, uint count) {
+	_prefill = prefill;
+	_prefillLeft = prefill ? count : 0;
+	_resetsRequested.fetchAdd(1);
+}
+
+void RenderAheadBuffer::applyPendingReset() {
+	const uint32 requested = _resetsRequested.load();
+	if (requested == _resetsDone.load())
+		return;
+
+	// read() does not touch the ring buffer until the reset is done
+	if (_ring)
+		_ring->skip(_ring->size());
+	_endOfData.store(false);
+
+	if (_reset)
+		(*_reset)();
+
+	// Another reset which was requested meanwhile is applied next time
+	_resetsDone.store(requested);
+}
+
+void RenderAheadBuffer::allocate(uint lookahead, bool stereo) {
+	_stereo = stereo;
+
+	// Only render full frames
+	if (_stereo)
+		lookahead &= ~1;
+	_lookahead = MAX<uint>(lookahead, kChunkSize);
+
+	// Samples which were still buffered when rendering ahead was stopped
+	// are dropped, as the generator has moved on since then
+	_ring.reset(new Common::RingBuffer<int16>(_lookahead));
+}
+
+void RenderAheadBuffer::workerProc(void *data) {
+	RenderAheadBuffer *buffer = (RenderAheadBuffer *)data;
+
+	while (!buffer->_quit.load()) {
+		if (!buffer->fillChunk())
+			g_system->delayMillis(buffer->_sleepTime);
+	}
+}
+
+bool RenderAheadBuffer::fillChunk() {
+	// Wait until a whole chunk fits, instead of calling the generator for
+	// every few samples the mixer has read
+	if (!isResetPending() && (_endOfData.load() || _ring->space() < kChunkSize))
+		return false;
+
+	int16 chunk[kChunkSize];
+	applyPendingReset();
+
+	const int rendered = (*_render)(chunk, kChunkSize);
+	_ring->write(chunk, MAX(rendered, 0));
+
+	// The samples have to be in the ring before the end is signaled
+	if (rendered < kChunkSize)
+		_endOfData.store(true);
+	return rendered > 0;
+}
+
+int RenderAheadBuffer::read(int16 *buffer, int numSamples, int *silence) {
+	int samplesRead = 0;
+
+	if (silence)
+		*silence = 0;
+
+	if (_prefillLeft) {
+		samplesRead = MIN<uint>(numSamples, _prefillLeft);
+		memcpy(buffer, _prefill, samplesRead * sizeof(int16));
+		_prefill += samplesRead;
+		_prefillLeft -= samplesRead;
+	}
+
+	if (!_active.load()) {
+		applyPendingReset();
+
+		if (samplesRead < numSamples && !_endOfData.load()) {
+			const int rendered = (*_render)(buffer + samplesRead, numSamples - samplesRead);
+			if (rendered < numSamples - samplesRead)
+				_endOfData.store(true);
+			samplesRead += MAX(rendered, 0);
+		}
+		return samplesRead;
+	}
+
+	// The worker clears the ring buffer before rendering after a reset
+	if (!isResetPending()) {
+		// The end is only signaled once the last samples are in the ring
+		const bool ended = _endOfData.load();
+		samplesRead += _ring->read(buffer + samplesRead, numSamples - samplesRead);
+		if (ended)
+			return samplesRead;
+	}
+
+	// Never wait for the worker to render a chunk
+	if (samplesRead < numSamples) {
+		memset(buffer + samplesRead, 0, (numSamples - samplesRead) * sizeof(int16));
+		if (silence)
+			*silence = numSamples - samplesRead;
+		samplesRead = numSamples;
+	}
+
+	return samplesRead;
+}
+
+bool RenderAheadBuffer::endOfData() const {
+	if (!_endOfData.load() || _prefillLeft || isResetPending())
+		return false;
+
+	return !_active.load() || _ring->empty();
+}
+
+uint RenderAheadBuffer::getConfiguredLookahead(int rate, bool stereo) {
+	if (!ConfMan.hasKey("softsynth_lookahead"))
+		return 0;
+
+	const int milliseconds = ConfMan.getInt("softsynth_lookahead");
+	if (milliseconds <= 0)
+		return 0;
+
+	return (uint)((uint64)rate * milliseconds / 1000) * (stereo ? 2 : 1);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,208 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RENDERAHEAD_H
+#define AUDIO_RENDERAHEAD_H
+
+#include "common/atomic.h"
+#include "common/func.h"
+#include "common/ptr.h"
+#include "common/ringbuffer.h"
+#include "common/thread.h"
+
+class RenderAheadTestSuite;
+
+namespace Audio {
+
+/**
+ * @defgroup audio_renderahead Render-ahead buffer
+ * @ingroup audio
+ *
+ * @brief Renders emulated synthesizers and decoders ahead of the mixer.
+ * @{
+ */
+
+/**
+ * Runs an expensive sample generator outside of the mixer callback.
+ *
+ * While active, a worker thread keeps a lock-free ring buffer filled with
+ * up to the configured lookahead of samples, and read() only has to copy
+ * them out. The mixer callback never waits for the worker.
+ *
+ * The generator is always called with the samples in order, so timer
+ * callbacks which it issues based on the number of generated samples (like
+ * MidiDriver_Emulated does for the music player) keep their sample exact
+ * timing. Users which receive events from other threads can delay them by
+ * getLatency() frames, to apply them at a fixed offset to the audible
+ * output.
+ *
+ * If the ring buffer runs dry, read() pads the missing samples with
+ * silence, and the worker continues where it left off. An overloaded worker
+ * thus results in short gaps instead of stalling the mixer. On backends
+ * without threads, all samples are rendered by read().
+ *
+ * The generator can be restarted with reset(), e.g. to seek a stream from
+ * the mixer thread. This does not wait for the worker, which applies the
+ * reset the next time it renders.
+ *
+ * Once the generator returns fewer samples than requested, it is assumed
+ * to have reached its end and is not called anymore until the buffer is
+ * restarted.
+ */
+class RenderAheadBuffer {
+public:
+	/**
+	 * Fills the buffer with up to the given number of samples, and returns
+	 * the number of samples actually rendered.
+	 */
+	typedef Common::Functor2<int16 *, int, int> RenderCallback;
+
+	/** Restarts the generator after reset() was called. */
+	typedef Common::Functor0<void> ResetCallback;
+
+	/**
+	 * @param render Generator of the samples. The buffer takes ownership.
+	 * @param reset  Called before the generator is called again after a
+	 *               reset(), or nullptr. The buffer takes ownership.
+	 */
+	explicit RenderAheadBuffer(RenderCallback *render, ResetCallback *reset = nullptr);
+	~RenderAheadBuffer();
+
+	/**
+	 * Start rendering ahead.
+	 *
+	 * @param lookahead Number of samples to render ahead. Nothing is done if this is 0.
+	 * @param rate      Sample rate, used to compute how long the worker sleeps while the buffer is full.
+	 * @param stereo    Whether the samples are stereo. Only full frames are rendered ahead.
+	 *
+	 * This must not be called while another thread is in read(), so it is
+	 * best done before the stream is handed to the mixer.
+	 */
+	void start(uint lookahead, int rate, bool stereo);
+
+	/**
+	 * Stop rendering ahead, and wait for the worker thread to end. Once this
+	 * returns, the generator is only called from read() anymore. Samples
+	 * which were already rendered ahead are dropped.
+	 */
+	void stop();
+
+	/**
+	 * Drop the samples rendered so far, and call the reset callback before
+	 * the generator is called the next time. While the buffer is active,
+	 * both happen on the worker, so this is cheap enough for the mixer
+	 * thread. Until then, read() returns silence after the prefill.
+	 *
+	 * @param prefill Samples which read() returns before the ones rendered
+	 *                after the reset, e.g. the start of a looping stream
+	 *                which was kept from its first pass. They must stay
+	 *                valid until they have been read.
+	 * @param count   Number of samples in prefill.
+	 *
+	 * Must only be called from the thread which calls read().
+	 */
+	void reset(const int16 *prefill = nullptr, uint count = 0);
+
+	/** Return whether samples are being rendered ahead. */
+	bool isActive() const { return _active.load(); }
+
+	/**
+	 * Read samples which were rendered ahead, padding any missing ones with
+	 * silence. If the buffer is not active, all samples are rendered
+	 * directly.
+	 *
+	 * Must only be called from a single thread, usually the mixer thread.
+	 *
+	 * @param silence If not nullptr, set to the number of silent samples
+	 *                which were padded at the end of the buffer.
+	 *
+	 * @return The number of samples read, which is only less than requested
+	 *         once the generator has reached its end.
+	 */
+	int read(int16 *buffer, int numSamples, int *silence = nullptr);
+
+	/**
+	 * Return whether the generator has reached its end, and all samples
+	 * rendered before have been read.
+	 */
+	bool endOfData() const;
+
+	/**
+	 * Return the maximum number of frames the generator is ahead of the
+	 * samples returned by read(), or 0 if the buffer is not active.
+	 */
+	uint getLatency() const { return isActive() ? _lookahead / (_stereo ? 2 : 1) : 0; }
+
+	/**
+	 * Return the number of samples to render ahead, as set by the user with
+	 * the "softsynth_lookahead" config key in milliseconds.
+	 */
+	static uint getConfiguredLookahead(int rate, bool stereo);
+
+private:
+	enum {
+		/** Number of samples rendered with one call to the generator */
+		kChunkSize = 512,
+		/** Longest time the worker sleeps while the buffer is full, in milliseconds */
+		kMaxSleepTime = 5
+	};
+
+	void allocate(uint lookahead, bool stereo);
+	bool fillChunk();
+
+	bool isResetPending() const { return _resetsRequested.load() != _resetsDone.load(); }
+	void applyPendingReset();
+
+	static void workerProc(void *data);
+
+	Common::ScopedPtr<RenderCallback> _render;
+	Common::ScopedPtr<ResetCallback> _reset;
+	bool _stereo;
+
+	Common::ScopedPtr<Common::RingBuffer<int16> > _ring;
+	uint _lookahead;
+
+	Common::Thread _thread;
+	/** How long the worker sleeps while the buffer is full, in milliseconds */
+	uint _sleepTime;
+
+	Common::Atomic<bool> _active;
+	Common::Atomic<bool> _quit;
+	Common::Atomic<bool> _endOfData;
+
+	// Only the thread which calls the generator applies resets, which is
+	// the worker while the buffer is active. While one is pending, read()
+	// leaves the ring buffer alone, so the worker may clear it.
+	Common::Atomic<uint32> _resetsRequested;
+	Common::Atomic<uint32> _resetsDone;
+
+	// Samples read() returns before the ones rendered after a reset
+	const int16 *_prefill;
+	uint _prefillLeft;
+
+	friend class ::RenderAheadTestSuite;
+};
+
+/** @} */
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "audio/softsynth/emumidi.h"
+
+#include "common/thread.h"
+
+int MidiDriver_Emulated::renderSamples(int16 *data, int numSamples) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+	int len = numSamples / stereoFactor;
+	int step;
+
+	_renderThread.store(Common::Thread::getCurrentId());
+
+	do {
+		step = len;
+		if (step > (_nextTick >> FIXP_SHIFT))
+			step = (_nextTick >> FIXP_SHIFT);
+
+		// Split the samples at the queued events
+		const int framesToEvent = applyQueuedEvents();
+		if (step > framesToEvent)
+			step = framesToEvent;
+
+		generateSamples(data, step);
+		_renderedFrames += step;
+
+		_nextTick -= step << FIXP_SHIFT;
+		if (!(_nextTick >> FIXP_SHIFT)) {
+			if (_timerProc)
+				(*_timerProc)(_timerParam);
+
+			onTimer();
+
+			_nextTick += _samplesPerTick;
+		}
+
+		data += step * stereoFactor;
+		len -= step;
+	} while (len);
+
+	_renderThread.store(0);
+
+	return numSamples;
+}
+
+int MidiDriver_Emulated::applyQueuedEvents() {
+	for (;;) {
+		QueuedEvent event;
+		{
+			Common::StackLock lock(_eventMutex);
+			if (_events.empty())
+				return 0x7FFFFFFF;
+
+			const int32 framesToEvent = (int32)(_events.front().frame - _renderedFrames);
+			if (framesToEvent > 0)
+				return framesToEvent;
+
+			event = _events.pop();
+		}
+
+		// The lock is released before calling into the synth, which may
+		// take locks of its own
+		if (event.sysExData.empty())
+			applyEvent(event.msg);
+		else
+			applySysEx(event.sysExData.data(), event.sysExData.size());
+	}
+}
+
+bool MidiDriver_Emulated::isRenderThread() const {
+	return _renderThread.load() == Common::Thread::getCurrentId();
+}
+
+void MidiDriver_Emulated::startRenderAhead() {
+	const bool stereo = isStereo();
+
+	// Nothing reads or renders yet, so the positions can be reset safely
+	_readFrames.store(0);
+	_renderedFrames = 0;
+
+	_renderAhead.start(Audio::RenderAheadBuffer::getConfiguredLookahead(getRate(), stereo), getRate(), stereo);
+}
+
+void MidiDriver_Emulated::stopRenderAhead() {
+	_renderAhead.stop();
+
+	Common::StackLock lock(_eventMutex);
+	_events.clear();
+}
+
+bool MidiDriver_Emulated::queueEvent(uint32 b) {
+	if (!_renderAhead.isActive() || isRenderThread())
+		return false;
+
+	QueuedEvent event;
+	event.frame = _readFrames.load() + _renderAhead.getLatency();
+	event.msg = b;
+
+	Common::StackLock lock(_eventMutex);
+	_events.push(Common::move(event));
+	return true;
+}
+
+bool MidiDriver_Emulated::queueSysEx(const byte *msg, uint16 length) {
+	if (!_renderAhead.isActive() || isRenderThread() || length == 0)
+		return false;
+
+	QueuedEvent event;
+	event.frame = _readFrames.load() + _renderAhead.getLatency();
+	event.msg = 0;
+	event.sysExData.resize(length);
+	memcpy(event.sysExData.data(), msg, length);
+
+	Common::StackLock lock(_eventMutex);
+	_events.push(Common::move(event));
+	return true;
+}
@@ -25,6 +25,12 @@
 #include "audio/audiostream.h"
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
+#include "audio/renderahead.h"
+
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/mutex.h"
+#include "common/queue.h"
 
 class MidiDriver_Emulated : public Audio::AudioStream, public MidiDriver {
 protected:
@@ -43,12 +49,71 @@ private:
 	int _nextTick;
 	int _samplesPerTick;
 
+	Audio::RenderAheadBuffer _renderAhead;
+
+	// An event which was sent by another thread while rendering ahead
+	struct QueuedEvent {
+		uint32 frame; // Frame at which the event takes effect
+		uint32 msg;
+		Common::Array<byte> sysExData; // Empty for short messages
+	};
+
+	Common::Mutex _eventMutex;
+	Common::Queue<QueuedEvent> _events;
+
+	// Frames passed to the mixer, and frames generated so far. Both wrap
+	// around, so they must only be compared by their difference.
+	Common::Atomic<uint32> _readFrames;
+	uint32 _renderedFrames;
+
+	// The thread in renderSamples(), or 0
+	Common::Atomic<uintptr> _renderThread;
+
+	// Generates the samples and issues the timer callbacks and queued
+	// events in between
+	int renderSamples(int16 *data, int numSamples);
+
+	// Applies the events which are due, and returns the number of frames
+	// until the next one
+	int applyQueuedEvents();
+
+	bool isRenderThread() const;
+
 protected:
 	int _baseFreq;
 
 	virtual void generateSamples(int16 *buf, int len) = 0;
 	virtual void onTimer() {}
 
+	/**
+	 * Render the samples ahead of the mixer in a worker, if the user has
+	 * configured a lookahead. This is meant for expensive emulators, and
+	 * must be called after open() but before the driver is handed to the
+	 * mixer. Drivers calling this must call stopRenderAhead() in close(),
+	 * before the synth is shut down, and pass the events they receive
+	 * through queueEvent() and queueSysEx().
+	 */
+	void startRenderAhead();
+	void stopRenderAhead();
+
+	/**
+	 * While rendering ahead, queue an event which was sent by the engine,
+	 * so it is applied with applyEvent() at the mixer time it was sent at,
+	 * delayed by the lookahead just like the samples. Events sent by the
+	 * timer callback take effect right away, as that already runs at the
+	 * right position of the generated samples.
+	 *
+	 * @return True if the event was queued. Otherwise, the caller must
+	 *         apply it right away.
+	 */
+	bool queueEvent(uint32 b);
+	bool queueSysEx(const byte *msg, uint16 length);
+
+	/** Apply an event which was queued by queueEvent(). */
+	virtual void applyEvent(uint32 b) { send(b); }
+	/** Apply a SysEx message which was queued by queueSysEx(). */
+	virtual void applySysEx(const byte *msg, uint16 length) { sysEx(msg, length); }
+
 public:
 	MidiDriver_Emulated(Audio::Mixer *mixer) :
 		_mixer(mixer),
@@ -57,6 +122,10 @@ public:
 		_timerParam(0),
 		_nextTick(0),
 		_samplesPerTick(0),
+		_renderAhead(new Common::Functor2Mem<int16 *, int, int, MidiDriver_Emulated>(this, &MidiDriver_Emulated::renderSamples)),
+		_readFrames(0),
+		_renderedFrames(0),
+		_renderThread(0),
 		_baseFreq(250) {
 	}
 
@@ -88,32 +157,12 @@ public:
 
 	// AudioStream API
 	virtual int readBuffer(int16 *data, const int numSamples) {
-		const int stereoFactor = isStereo() ? 2 : 1;
-		int len = numSamples / stereoFactor;
-		int step;
-
-		do {
-			step = len;
-			if (step > (_nextTick >> FIXP_SHIFT))
-				step = (_nextTick >> FIXP_SHIFT);
-
-			generateSamples(data, step);
-
-			_nextTick -= step << FIXP_SHIFT;
-			if (!(_nextTick >> FIXP_SHIFT)) {
-				if (_timerProc)
-					(*_timerProc)(_timerParam);
-
-				onTimer();
-
-				_nextTick += _samplesPerTick;
-			}
-
-			data += step * stereoFactor;
-			len -= step;
-		} while (len);
-
-		return numSamples;
+		// Queued events are timed against the rendered frames, so silence
+		// from an underrun does not count
+		int silence;
+		const int samplesRead = _renderAhead.read(data, numSamples, &silence);
+		_readFrames.fetchAdd((samplesRead - silence) / (isStereo() ? 2 : 1));
+		return samplesRead;
 	}
 
 	virtual bool endOfData() const {
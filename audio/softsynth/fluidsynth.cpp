@@ -109,6 +109,7 @@ protected:
 	void setStr(const char *name, const char *str);
 
 	void generateSamples(int16 *buf, int len) override;
+	void applyEvent(uint32 b) override;
 
 public:
 	MidiDriver_FluidSynth(Audio::Mixer *mixer);
@@ -501,6 +502,7 @@ int MidiDriver_FluidSynth::open() {
 	}
 
 	MidiDriver_Emulated::open();
+	startRenderAhead();
 
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
@@ -512,6 +514,7 @@ void MidiDriver_FluidSynth::close() {
 		return;
 	_isOpen = false;
 
+	stopRenderAhead();
 	_mixer->stopHandle(_mixerSoundHandle);
 
 	if (_soundFont != -1)
@@ -527,6 +530,11 @@ void MidiDriver_FluidSynth::send(uint32 b) {
 
 	midiDriverCommonSend(b);
 
+	if (!queueEvent(b))
+		applyEvent(b);
+}
+
+void MidiDriver_FluidSynth::applyEvent(uint32 b) {
 	//byte param3 = (byte) ((b >> 24) & 0xFF);
 	uint param2 = (byte) ((b >> 16) & 0xFF);
 	uint param1 = (byte) ((b >>  8) & 0xFF);
@@ -120,6 +120,8 @@ private:
 
 protected:
 	void generateSamples(int16 *buf, int len) override;
+	void applyEvent(uint32 b) override;
+	void applySysEx(const byte *msg, uint16 length) override;
 
 public:
 	MidiDriver_MT32(Audio::Mixer *mixer);
@@ -219,6 +221,7 @@ int MidiDriver_MT32::open() {
 	_outputRate = _service.getActualStereoOutputSamplerate();
 
 	MidiDriver_Emulated::open();
+	startRenderAhead();
 
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
@@ -228,6 +231,11 @@ int MidiDriver_MT32::open() {
 void MidiDriver_MT32::send(uint32 b) {
 	midiDriverCommonSend(b);
 
+	if (!queueEvent(b))
+		applyEvent(b);
+}
+
+void MidiDriver_MT32::applyEvent(uint32 b) {
 	Common::StackLock lock(_mutex);
 	_service.playMsg(b);
 }
@@ -238,13 +246,20 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 	if (range > 24) {
 		warning("setPitchBendRange() called with range > 24: %d", range);
 	}
-	byte benderRangeSysex[4] = { 0, 0, 4, (uint8)range };
-	Common::StackLock lock(_mutex);
-	_service.writeSysex(channel, benderRangeSysex, 4);
+	// A Roland DT1 message, so it is queued along with the notes
+	const byte benderRangeSysex[9] = { 0x41, channel, 0x16, 0x12, 0, 0, 4, (uint8)range, 0 };
+	if (!queueSysEx(benderRangeSysex, sizeof(benderRangeSysex)))
+		applySysEx(benderRangeSysex, sizeof(benderRangeSysex));
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 	midiDriverCommonSysEx(msg, length);
+
+	if (!queueSysEx(msg, length))
+		applySysEx(msg, length);
+}
+
+void MidiDriver_MT32::applySysEx(const byte *msg, uint16 length) {
 	if (msg[0] == 0xf0) {
 		Common::StackLock lock(_mutex);
 		_service.playSysex(msg, length);
@@ -271,6 +286,7 @@ void MidiDriver_MT32::close() {
 	// Detach the player callback handler
 	setTimerCallback(nullptr, nullptr);
 	// Detach the mixer callback handler
+	stopRenderAhead();
 	_mixer->stopHandle(_mixerSoundHandle);
 
 	Common::StackLock lock(_mutex);
@@ -1103,11 +1103,29 @@ static int16_t OPL3_ClipSample(int32_t sample)
     return (int16_t)sample;
 }
 
+/*
+    The envelope and phase of a slot only depend on its own state and the
+    chip wide LFO and envelope timers, but never on the output of another
+    slot. They are therefore updated for all slots in one pass, before the
+    slots are generated in the (possibly delayed) channel order.
+*/
+
+static void OPL3_EnvelopePhaseGenerate(opl3_chip *chip)
+{
+    opl3_slot *slot;
+    uint8_t ii;
+
+    for (ii = 0; ii < 36; ii++)
+    {
+        slot = &chip->slot[ii];
+        OPL3_EnvelopeCalc(slot);
+        OPL3_PhaseGenerate(slot);
+    }
+}
+
 static void OPL3_ProcessSlot(opl3_slot *slot)
 {
     OPL3_SlotCalcFB(slot);
-    OPL3_EnvelopeCalc(slot);
-    OPL3_PhaseGenerate(slot);
     OPL3_SlotGenerate(slot);
 }
 
@@ -1124,6 +1142,8 @@ inline void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4)
     buf4[1] = OPL3_ClipSample(chip->mixbuff[1]);
     buf4[3] = OPL3_ClipSample(chip->mixbuff[3]);
 
+    OPL3_EnvelopePhaseGenerate(chip);
+
 #if OPL_QUIRK_CHANNELSAMPLEDELAY
     for (ii = 0; ii < 15; ii++)
 #else
@@ -1521,14 +1541,95 @@ void OPL3_Generate4ChStream(opl3_chip *chip, int16_t *sndptr1, int16_t *sndptr2,
     }
 }
 
-void OPL3_GenerateStream(opl3_chip *chip, int16_t *sndptr, uint32_t numsamples)
+void OPL3_Generate4ChBlock(opl3_chip *chip, int16_t *buf4, uint32_t numframes)
 {
     uint_fast32_t i;
 
-    for(i = 0; i < numsamples; i++)
+    for (i = 0; i < numframes; i++)
     {
-        OPL3_GenerateResampled(chip, sndptr);
-        sndptr += 2;
+        OPL3_Generate4Ch(chip, buf4);
+        buf4 += 4;
+    }
+}
+
+void OPL3_GenerateStream(opl3_chip *chip, int16_t *sndptr, uint32_t numsamples)
+{
+    int16_t block[OPL_BLOCK_SIZE * 4];
+    const int16_t *oldsamples, *samples;
+    uint32_t outframes, nativeframes, i;
+    int32_t samplecnt;
+
+    /*
+        Same as calling OPL3_GenerateResampled() for every output frame,
+        but all chip frames needed for a chunk of output frames are
+        generated in one go, and only the two channels which are used are
+        resampled.
+    */
+    while (numsamples > 0)
+    {
+        /* Count the chip frames needed for as many output frames as fit */
+        outframes = 0;
+        nativeframes = 0;
+        samplecnt = chip->samplecnt;
+        while (outframes < numsamples)
+        {
+            uint32_t needed = 0;
+            while (samplecnt >= chip->rateratio)
+            {
+                samplecnt -= chip->rateratio;
+                needed++;
+            }
+            if (nativeframes + needed > OPL_BLOCK_SIZE)
+            {
+                break;
+            }
+            nativeframes += needed;
+            samplecnt += 1 << RSM_FRAC;
+            outframes++;
+        }
+
+        /* At very low output rates a single frame may not fit into a block */
+        if (outframes == 0)
+        {
+            OPL3_GenerateResampled(chip, sndptr);
+            sndptr += 2;
+            numsamples--;
+            continue;
+        }
+
+        OPL3_Generate4ChBlock(chip, block, nativeframes);
+
+        oldsamples = chip->oldsamples;
+        samples = chip->samples;
+        nativeframes = 0;
+        for (i = 0; i < outframes; i++)
+        {
+            while (chip->samplecnt >= chip->rateratio)
+            {
+                oldsamples = samples;
+                samples = &block[nativeframes * 4];
+                nativeframes++;
+                chip->samplecnt -= chip->rateratio;
+            }
+            sndptr[0] = (int16_t)((oldsamples[0] * (chip->rateratio - chip->samplecnt)
+                                  + samples[0] * chip->samplecnt) / chip->rateratio);
+            sndptr[1] = (int16_t)((oldsamples[1] * (chip->rateratio - chip->samplecnt)
+                                  + samples[1] * chip->samplecnt) / chip->rateratio);
+            chip->samplecnt += 1 << RSM_FRAC;
+            sndptr += 2;
+        }
+
+        /* Keep the state of the resampler for the next call */
+        if (oldsamples != chip->oldsamples)
+        {
+            memcpy(chip->oldsamples, oldsamples, sizeof(chip->oldsamples));
+        }
+        if (samples != chip->samples)
+        {
+            memcpy(chip->samples, samples, sizeof(chip->samples));
+        }
+
+        numsamples -= outframes;
     }
 }
 
@@ -1627,7 +1728,7 @@ void OPL::dualWrite(uint8 index, uint8 reg, uint8 val) {
 }
 
 void OPL::generateSamples(int16*buffer, int length) {
-	OPL3_GenerateStream(&chip, (int16_t*)buffer, (uint16_t)length / 2);
+	OPL3_GenerateStream(&chip, (int16_t*)buffer, (uint32_t)length / 2);
 }
 
 }
@@ -40,6 +40,7 @@
 
 #define OPL_WRITEBUF_SIZE   1024
 #define OPL_WRITEBUF_DELAY  2
+#define OPL_BLOCK_SIZE      256
 
 namespace OPL {
 namespace NUKED {
@@ -163,6 +164,7 @@ void OPL3_GenerateStream(opl3_chip *chip, int16_t *sndptr, uint32_t numsamples);
 void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4);
 void OPL3_Generate4ChResampled(opl3_chip *chip, int16_t *buf4);
 void OPL3_Generate4ChStream(opl3_chip *chip, int16_t *sndptr1, int16_t *sndptr2, uint32_t numsamples);
+void OPL3_Generate4ChBlock(opl3_chip *chip, int16_t *buf4, uint32_t numframes);
 
 class OPL : public ::OPL::OPL, public Audio::EmulatedChip {
 private:
@@ -172,6 +172,13 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Obtain the size and the time of the last modification of the file
+	 * referred by this node, in seconds since the Unix epoch.
+	 *
+	 * @return bool true on success, false if the information is not available.
+	 */
+	virtual bool getSizeAndModificationTime(int64 &size, int64 &modificationTime) const { return false; }
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -182,6 +189,18 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance for a file which is not written
+	 * to while the stream exists, like game data. Backends may memory map
+	 * such files, in which case an I/O error or truncating the file while
+	 * it is mapped may crash instead of failing to read.
+	 *
+	 * The default implementation calls createReadStream().
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to an alternate
 	 * stream of the file referred by this node. This assumes that the node
@@ -24,6 +24,7 @@
 // Re-enable some forbidden symbols to avoid clashes with stat.h and unistd.h.
 // Also with clock() in sys/time.h in some macOS SDKs.
 #define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_time
 #define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
 #define FORBIDDEN_SYMBOL_EXCEPTION_mkdir
 #define FORBIDDEN_SYMBOL_EXCEPTION_getenv
@@ -34,6 +35,9 @@
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
 #include "common/algorithm.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/mutex.h"
 
 #include <sys/param.h>
 #include <sys/stat.h>
@@ -48,6 +52,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 
 #ifdef __OS2__
@@ -55,6 +60,173 @@
 #include <os2.h>
 #endif
 
+namespace {
+
+struct DirectoryEntry {
+	Common::String name;
+	bool isDirectory;
+};
+
+/**
+ * The entries of a directory, as of the given modification time of the
+ * directory. Adding, removing or renaming an entry updates the modification
+ * time, so the listing can be reused as long as it stays the same.
+ */
+struct DirectoryListing {
+	time_t mtime;
+	Common::Array<DirectoryEntry> entries;
+};
+
+typedef Common::HashMap<Common::String, DirectoryListing> DirectoryListingCache;
+
+enum {
+	/** Maximum number of directories whose listing is kept */
+	kMaxCachedListings = 256
+};
+
+DirectoryListingCache &getListingCache() {
+	static DirectoryListingCache cache;
+	return cache;
+}
+
+// Directory trees may be listed by several threads at once
+Common::Mutex &getListingCacheMutex() {
+	static Common::Mutex mutex;
+	return mutex;
+}
+
+// Strings share their storage with a reference count which isn't atomic, so
+// the entries are deep copied in and out of the cache, which is shared
+// between the threads
+void copyDirectoryEntries(const Common::Array<DirectoryEntry> &src, Common::Array<DirectoryEntry> &dst) {
+	dst.resize(src.size());
+	for (uint i = 0; i < src.size(); ++i) {
+		dst[i].name = Common::String(src[i].name.c_str(), src[i].name.size());
+		dst[i].isDirectory = src[i].isDirectory;
+	}
+}
+
+bool readDirectory(const Common::String &path, Common::Array<DirectoryEntry> &entries) {
+	DIR *dirp = opendir(path.c_str());
+	struct dirent *dp;
+
+	if (dirp == NULL)
+		return false;
+
+	// loop over dir entries using readdir
+	while ((dp = readdir(dirp)) != NULL) {
+		// Skip '.' and '..' to avoid cycles
+		if ((dp->d_name[0] == '.' && dp->d_name[1] == 0) || (dp->d_name[0] == '.' && dp->d_name[1] == '.')) {
+			continue;
+		}
+
+		DirectoryEntry entry;
+		entry.name = dp->d_name;
+
+		Common::String entryPath(path);
+		if (path.lastChar() != '/')
+			entryPath += '/';
+		entryPath += entry.name;
+
+		bool isValid;
+		struct stat st;
+#if defined(SYSTEM_NOT_SUPPORTING_D_TYPE)
+		/* TODO: d_type is not part of POSIX, so it might not be supported
+		 * on some of our targets. For those systems where it isn't supported,
+		 * add this #elif case, which tries to use stat() instead.
+		 *
+		 * The d_type method is used to avoid costly recurrent stat() calls in big
+		 * directories.
+		 */
+		isValid = (0 == stat(entryPath.c_str(), &st));
+		entry.isDirectory = isValid ? S_ISDIR(st.st_mode) : false;
+#else
+		switch (dp->d_type) {
+		case DT_DIR:
+		case DT_REG:
+			isValid = true;
+			entry.isDirectory = (dp->d_type == DT_DIR);
+			break;
+		case DT_LNK:
+			isValid = true;
+			if (stat(entryPath.c_str(), &st) == 0)
+				entry.isDirectory = S_ISDIR(st.st_mode);
+			else
+				entry.isDirectory = false;
+			break;
+		case DT_UNKNOWN:
+		default:
+			// Fall back to stat()
+			//
+			// It's important NOT to limit this to DT_UNKNOWN, because d_type can
+			// be unreliable on some OSes and filesystems; a confirmed example is
+			// macOS 10.4, where d_type can hold bogus values when iterating over
+			// the files of a cddafs mount point (as used by MacOSXAudioCDManager).
+			isValid = (0 == stat(entryPath.c_str(), &st));
+			entry.isDirectory = isValid ? S_ISDIR(st.st_mode) : false;
+			break;
+		}
+#endif
+
+		// Skip files that are invalid for some reason (e.g. because we couldn't
+		// properly stat them).
+		if (!isValid)
+			continue;
+
+		entries.push_back(entry);
+	}
+	closedir(dirp);
+
+	return true;
+}
+
+/**
+ * Get the entries of the given directory, from the cache if it didn't
+ * change since it was last listed.
+ */
+bool getDirectoryEntries(const Common::String &path, Common::Array<DirectoryEntry> &entries) {
+	DirectoryListingCache &cache = getListingCache();
+
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0) {
+		Common::StackLock lock(getListingCacheMutex());
+		cache.erase(path);
+		return false;
+	}
+
+	{
+		Common::StackLock lock(getListingCacheMutex());
+		DirectoryListingCache::iterator it = cache.find(path);
+		if (it != cache.end()) {
+			if (it->_value.mtime == st.st_mtime) {
+				copyDirectoryEntries(it->_value.entries, entries);
+				return true;
+			}
+			cache.erase(it);
+		}
+	}
+
+	if (!readDirectory(path, entries))
+		return false;
+
+	// The modification time only has a resolution of a second on some file
+	// systems, so a directory which was modified in the current second may
+	// still change without its modification time changing.
+	if (st.st_mtime >= time(nullptr) - 1)
+		return true;
+
+	Common::StackLock lock(getListingCacheMutex());
+	if (cache.size() >= kMaxCachedListings)
+		cache.clear();
+
+	DirectoryListing &listing = cache[Common::String(path.c_str(), path.size())];
+	listing.mtime = st.st_mtime;
+	copyDirectoryEntries(entries, listing.entries);
+	return true;
+}
+
+} // End of anonymous namespace
+
 bool POSIXFilesystemNode::exists() const {
 	return access(_path.c_str(), F_OK) == 0;
 }
@@ -67,6 +239,16 @@ bool POSIXFilesystemNode::isWritable() const {
 	return access(_path.c_str(), W_OK) == 0;
 }
 
+bool POSIXFilesystemNode::getSizeAndModificationTime(int64 &size, int64 &modificationTime) const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0)
+		return false;
+
+	size = st.st_size;
+	modificationTime = st.st_mtime;
+	return true;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
@@ -168,80 +350,32 @@ bool POSIXFilesystemNode::getChildren(AbstractFSList &myList, ListMode mode, boo
 	}
 #endif
 
-	DIR *dirp = opendir(_path.c_str());
-	struct dirent *dp;
-
-	if (dirp == NULL)
+	Common::Array<DirectoryEntry> entries;
+	if (!getDirectoryEntries(_path, entries))
 		return false;
 
-	// loop over dir entries using readdir
-	while ((dp = readdir(dirp)) != NULL) {
+	for (const DirectoryEntry &dirEntry : entries) {
 		// Skip 'invisible' files if necessary
-		if (dp->d_name[0] == '.' && !hidden) {
+		if (dirEntry.name.firstChar() == '.' && !hidden) {
 			continue;
 		}
-		// Skip '.' and '..' to avoid cycles
-		if ((dp->d_name[0] == '.' && dp->d_name[1] == 0) || (dp->d_name[0] == '.' && dp->d_name[1] == '.')) {
+
+		// Honor the chosen mode
+		if ((mode == Common::FSNode::kListFilesOnly && dirEntry.isDirectory) ||
+			(mode == Common::FSNode::kListDirectoriesOnly && !dirEntry.isDirectory))
 			continue;
-		}
 
 		// Start with a clone of this node, with the correct path set
-		POSIXFilesystemNode entry(*this);
-		entry._displayName = dp->d_name;
+		POSIXFilesystemNode *entry = new POSIXFilesystemNode(*this);
+		entry->_displayName = dirEntry.name;
 		if (_path.lastChar() != '/')
-			entry._path += '/';
-		entry._path += entry._displayName;
-
-#if defined(SYSTEM_NOT_SUPPORTING_D_TYPE)
-		/* TODO: d_type is not part of POSIX, so it might not be supported
-		 * on some of our targets. For those systems where it isn't supported,
-		 * add this #elif case, which tries to use stat() instead.
-		 *
-		 * The d_type method is used to avoid costly recurrent stat() calls in big
-		 * directories.
-		 */
-		entry.setFlags();
-#else
-		switch (dp->d_type) {
-		case DT_DIR:
-		case DT_REG:
-			entry._isValid = true;
-			entry._isDirectory = (dp->d_type == DT_DIR);
-			break;
-		case DT_LNK:
-			entry._isValid = true;
-			struct stat st;
-			if (stat(entry._path.c_str(), &st) == 0)
-				entry._isDirectory = S_ISDIR(st.st_mode);
-			else
-				entry._isDirectory = false;
-			break;
-		case DT_UNKNOWN:
-		default:
-			// Fall back to stat()
-			//
-			// It's important NOT to limit this to DT_UNKNOWN, because d_type can
-			// be unreliable on some OSes and filesystems; a confirmed example is
-			// macOS 10.4, where d_type can hold bogus values when iterating over
-			// the files of a cddafs mount point (as used by MacOSXAudioCDManager).
-			entry.setFlags();
-			break;
-		}
-#endif
-
-		// Skip files that are invalid for some reason (e.g. because we couldn't
-		// properly stat them).
-		if (!entry._isValid)
-			continue;
+			entry->_path += '/';
+		entry->_path += entry->_displayName;
+		entry->_isValid = true;
+		entry->_isDirectory = dirEntry.isDirectory;
 
-		// Honor the chosen mode
-		if ((mode == Common::FSNode::kListFilesOnly && entry._isDirectory) ||
-			(mode == Common::FSNode::kListDirectoriesOnly && !entry._isDirectory))
-			continue;
-
-		myList.push_back(new POSIXFilesystemNode(entry));
+		myList.push_back(entry);
 	}
-	closedir(dirp);
 
 	return true;
 }
@@ -279,6 +413,18 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), StdioStream::WriteMode_Read);
 }
 
+Common::SeekableReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#ifdef HAS_MMAP
+	// Mapping the file spares copying the data through the stdio buffers,
+	// and allows callers to borrow it with getView()
+	Common::SeekableReadStream *mapped = PosixMappedStream::makeFromPath(getPath());
+	if (mapped)
+		return mapped;
+#endif
+
+	return createReadStream();
+}
+
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStreamForAltStream(Common::AltStreamType altStreamType) {
 #ifdef MACOSX
 	if (altStreamType == Common::AltStreamType::MacResourceFork) {
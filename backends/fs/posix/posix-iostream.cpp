@@ -24,6 +24,11 @@
 #include "backends/fs/posix/posix-iostream.h"
 
 #include <sys/stat.h>
+#ifdef HAS_MMAP
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 PosixIoStream::PosixIoStream(void *handle) :
 		StdioStream(handle) {
@@ -44,3 +49,40 @@ int64 PosixIoStream::size() const {
 
 	return st.st_size;
 }
+
+#ifdef HAS_MMAP
+PosixMappedStream *PosixMappedStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		return nullptr;
+	}
+
+	// Empty files can't be mapped, and MemoryReadStream is limited to 4GB.
+	// On 32-bit systems, big files are read instead of taking up most of
+	// the address space.
+	const uint64 maxSize = sizeof(void *) >= 8 ? 0xFFFFFFFFULL : 0x4000000ULL;
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size <= 0 || (uint64)st.st_size > maxSize) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after closing the descriptor
+	close(fd);
+	if (data == MAP_FAILED) {
+		return nullptr;
+	}
+
+	return new PosixMappedStream(data, st.st_size);
+}
+
+PosixMappedStream::PosixMappedStream(void *data, uint32 size) :
+		Common::MemoryReadStream((const byte *)data, size, DisposeAfterUse::NO),
+		_mapping(data), _mappingSize(size) {
+}
+
+PosixMappedStream::~PosixMappedStream() {
+	munmap(_mapping, _mappingSize);
+}
+#endif
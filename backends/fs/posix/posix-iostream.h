@@ -23,6 +23,7 @@
 #define BACKENDS_FS_POSIX_POSIXIOSTREAM_H
 
 #include "backends/fs/stdiostream.h"
+#include "common/memstream.h"
 
 /**
  * A file input / output stream using POSIX interfaces
@@ -39,4 +40,28 @@ public:
 	int64 size() const override;
 };
 
+#ifdef HAS_MMAP
+/**
+ * A read stream of a memory mapped file. The data is only paged in when it
+ * is accessed, and views of it can be handed out without copying.
+ */
+class PosixMappedStream final : public Common::MemoryReadStream {
+public:
+	/**
+	 * Map the file at the given path.
+	 *
+	 * @return The stream, or nullptr if the file is not a regular file or
+	 *         could not be mapped.
+	 */
+	static PosixMappedStream *makeFromPath(const Common::String &path);
+	~PosixMappedStream() override;
+
+private:
+	PosixMappedStream(void *data, uint32 size);
+
+	void *_mapping;
+	uint32 _mappingSize;
+};
+#endif
+
 #endif
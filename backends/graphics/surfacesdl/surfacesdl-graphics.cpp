@@ -25,6 +25,7 @@
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -117,6 +118,24 @@ static SDL_Surface *createSurface(int width, int height, SDL_Surface *surface) {
 #endif
 }
 
+// Spreads the bands of a scale operation over the cores, or returns nullptr
+// if there is only one. More threads rarely help, since the bands compete
+// for memory bandwidth.
+static ScalerExecutor *createScalerPool() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	const int numCores = SDL_GetNumLogicalCPUCores();
+#elif SDL_VERSION_ATLEAST(2, 0, 0)
+	const int numCores = SDL_GetCPUCount();
+#else
+	const int numCores = 1;
+#endif
+	const int numThreads = MIN(numCores, 8);
+	if (numThreads <= 1)
+		return nullptr;
+
+	return new ParallelScalerExecutor(numThreads);
+}
+
 static const OSystem::GraphicsMode s_supportedGraphicsModes[] = {
 	{"surfacesdl", _s("SDL Surface"), GFX_SURFACESDL},
 	{nullptr, nullptr, 0}
@@ -191,7 +210,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
-	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
+	_scalerPool(nullptr), _scalerPoolCreated(false),
+	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _redrawnPixels(0),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0), _disableMouseKeyColor(false) {
 
@@ -243,6 +263,7 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	unloadGFXMode();
 	delete _scaler;
 	delete _mouseScaler;
+	delete _scalerPool;
 	if (_mouseOrigSurface) {
 		destroySurface(_mouseOrigSurface);
 		if (_mouseOrigSurface == _mouseSurface) {
@@ -719,6 +740,17 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 		_scalerPlugin = &_scalerPlugins[_videoMode.scalerIndex]->get<ScalerPluginObject>();
 		_scaler = _scalerPlugin->createInstance(format);
 
+		// Scale large rects on all cores if the scaler allows it. The
+		// bands are done when scale() returns, so the screen is complete
+		// before it is presented.
+		if (_scalerPlugin->canScaleInBands()) {
+			if (!_scalerPoolCreated) {
+				_scalerPool = createScalerPool();
+				_scalerPoolCreated = true;
+			}
+			_scaler->setExecutor(_scalerPool);
+		}
+
 		if (_mouseScaler != nullptr) {
 			delete _mouseScaler;
 			_mouseScaler = _scalerPlugin->createInstance(_cursorFormat);
@@ -1344,7 +1376,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 	// In case of double buferring partially good version may be on another page,
 	// so we need to fully redraw
-	if (_isDoubleBuf && _numDirtyRects)
+	if (_isDoubleBuf && !_dirtyRegion.isEmpty())
 		_forceRedraw = true;
 
 #if defined(USE_IMGUI) && (defined(USE_IMGUI_SDLRENDERER2) || defined(USE_IMGUI_SDLRENDERER3))
@@ -1354,39 +1386,58 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 #endif
 
 	bool doRedraw = _forceRedraw || (_prevForceRedraw && _isDoubleBuf);
-	int actualDirtyRects = _numDirtyRects;
-	if (_isDoubleBuf && _numPrevDirtyRects > 0) {
-		memcpy(_dirtyRectList + _numDirtyRects, _prevDirtyRectList, _numPrevDirtyRects * sizeof(_dirtyRectList[0]));
-		actualDirtyRects += _numPrevDirtyRects;
+
+	const Common::Array<Common::Rect> &dirtyRects = _dirtyRegion.getRects();
+	_dirtyRectList.resize(dirtyRects.size());
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		int x = dirtyRects[i].left;
+		int y = dirtyRects[i].top;
+		int w = dirtyRects[i].width();
+		int h = dirtyRects[i].height();
+
+#ifdef USE_ASPECT
+		// Merged rects keep the alignment of the rects added, but rects made
+		// of tiles may not start on a line which the stretching leaves alone
+		if (_dirtyRegion.usesTiles() && _videoMode.aspectRatioCorrection && !_overlayInGUI)
+			makeRectStretchable(x, y, w, h, _videoMode.filtering);
+#endif
+
+		_dirtyRectList[i].x = x;
+		_dirtyRectList[i].y = y;
+		_dirtyRectList[i].w = w;
+		_dirtyRectList[i].h = h;
 	}
 
+	const uint numDirtyRects = _dirtyRectList.size();
+	if (_isDoubleBuf)
+		_dirtyRectList.push_back(_prevDirtyRectList);
+
+	_prevForceRedraw = _forceRedraw;
+	if (!_prevForceRedraw && numDirtyRects && _isDoubleBuf)
+		_prevDirtyRectList.assign(_dirtyRectList.begin(), _dirtyRectList.begin() + numDirtyRects);
+
 	// Force a full redraw if requested.
 	// If _useOldSrc, the scaler will do its own partial updates.
 	if (doRedraw) {
-		actualDirtyRects = 1;
+		_dirtyRectList.resize(1);
 		_dirtyRectList[0].x = 0;
 		_dirtyRectList[0].y = 0;
 		_dirtyRectList[0].w = width;
 		_dirtyRectList[0].h = height;
 	}
 
-	_prevForceRedraw = _forceRedraw;
-	if (!_prevForceRedraw && _numDirtyRects && _isDoubleBuf) {
-		memcpy(_prevDirtyRectList, _dirtyRectList, _numDirtyRects * sizeof(_dirtyRectList[0]));
-		_numPrevDirtyRects = _numDirtyRects;
-	}
-
 	// Only draw anything if necessary
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	bool doPresent = false;
 #endif
-	if (actualDirtyRects > 0 || _cursorNeedsRedraw) {
+	_redrawnPixels = 0;
+	if (!_dirtyRectList.empty() || _cursorNeedsRedraw) {
 		SDL_Rect *r;
 		SDL_Rect dst;
 		uint32 bpp, srcPitch, dstPitch;
-		SDL_Rect *lastRect = _dirtyRectList + actualDirtyRects;
+		SDL_Rect *lastRect = _dirtyRectList.data() + _dirtyRectList.size();
 
-		for (r = _dirtyRectList; r != lastRect; ++r) {
+		for (r = _dirtyRectList.data(); r != lastRect; ++r) {
 			dst = *r;
 			dst.x += _maxExtraPixels;	// Shift rect since some scalers need to access the data around
 			dst.y += _maxExtraPixels;	// any pixel to scale it, and we want to avoid mem access crashes.
@@ -1409,7 +1460,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwScreen->pitch;
 
-		for (r = _dirtyRectList; r != lastRect; ++r) {
+		for (r = _dirtyRectList.data(); r != lastRect; ++r) {
 			int src_x = r->x;
 			int src_y = r->y;
 			int dst_x = r->x;
@@ -1455,6 +1506,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
 						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
+				_redrawnPixels += dst_w * dst_h;
 
 				r->x = dst_x;
 				r->y = dst_y;
@@ -1574,9 +1626,11 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		}
 #endif
 
+		debug(9, "SurfaceSdlGraphicsManager: Redrew %u pixels in %u rects", _redrawnPixels, _dirtyRectList.size());
+
 		// Finally, blit all our changes to the screen
 		if (!_displayDisabled) {
-			updateScreen(_dirtyRectList, actualDirtyRects);
+			updateScreen(_dirtyRectList.data(), _dirtyRectList.size());
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 			doPresent = true;
 #endif
@@ -1587,7 +1641,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	if (_scaler)
 		_scaler->setFactor(oldScaleFactor);
 
-	_numDirtyRects = 0;
+	_dirtyRegion.clear();
 	_forceRedraw = false;
 	_cursorNeedsRedraw = false;
 
@@ -1806,11 +1860,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 	if (_forceRedraw)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceRedraw = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!inOverlay && !realCoordinates) {
@@ -1861,14 +1910,8 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 		return;
 	}
 
-	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
-
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
-	}
+	if (w > 0 && h > 0)
+		_dirtyRegion.add(Common::Rect(x, y, x + w, y + h));
 }
 
 int16 SurfaceSdlGraphicsManager::getHeight() const {
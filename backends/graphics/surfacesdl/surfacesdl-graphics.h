@@ -24,6 +24,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirty-region.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
@@ -107,6 +108,10 @@ public:
 	void fillScreen(uint32 col) override;
 	void fillScreen(const Common::Rect &r, uint32 col) override;
 	void updateScreen() override;
+
+	/** The number of pixels which the last update scaled, to measure the cost of redrawing. */
+	uint32 getRedrawnPixels() const { return _redrawnPixels; }
+
 	void setFocusRectangle(const Common::Rect& rect) override;
 	void clearFocusRectangle() override;
 
@@ -343,6 +348,8 @@ protected:
 	const PluginList &_scalerPlugins;
 	ScalerPluginObject *_scalerPlugin;
 	Scaler *_scaler, *_mouseScaler;
+	ScalerExecutor *_scalerPool;
+	bool _scalerPoolCreated;
 	uint _maxExtraPixels;
 	uint _extraPixels;
 
@@ -352,19 +359,22 @@ protected:
 	int _screenChangeCount;
 
 	enum {
-		NUM_DIRTY_RECT = 100,
 		MAX_SCALING = 3
 	};
 
 	// Dirty rect management
+	// The areas changed since the last update, which are merged into the
+	// list of rects to scale and update.
+	Graphics::DirtyRegion _dirtyRegion;
+
 	// When double-buffering we need to redraw both updates from
 	// current frame and previous frame. For convenience we copy
 	// them here before traversing the list.
-	SDL_Rect _dirtyRectList[2 * NUM_DIRTY_RECT];
-	int _numDirtyRects;
+	Common::Array<SDL_Rect> _dirtyRectList;
+	Common::Array<SDL_Rect> _prevDirtyRectList;
 
-	SDL_Rect _prevDirtyRectList[NUM_DIRTY_RECT];
-	int _numPrevDirtyRects;
+	// The number of pixels which were scaled in the last update
+	uint32 _redrawnPixels;
 
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/thread/sdl/sdl-thread.h"
+#include "backends/platform/sdl/sdl-sys.h"
+
+#include "common/textconsole.h"
+
+/**
+ * SDL thread manager implementation
+ */
+class SdlThreadInternal final : public Common::ThreadInternal {
+public:
+	SdlThreadInternal(Common::ThreadProc proc, void *data) : _proc(proc), _data(data), _thread(nullptr) {}
+	~SdlThreadInternal() override { wait(); }
+
+	bool start(const char *name) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		_thread = SDL_CreateThread(threadProc, name, this);
+#else
+		_thread = SDL_CreateThread(threadProc, this);
+#endif
+		if (!_thread)
+			warning("Could not create thread %s: %s", name, SDL_GetError());
+		return _thread != nullptr;
+	}
+
+	void wait() override {
+		if (_thread) {
+			SDL_WaitThread(_thread, nullptr);
+			_thread = nullptr;
+		}
+	}
+
+private:
+	static int SDLCALL threadProc(void *data) {
+		SdlThreadInternal *thread = (SdlThreadInternal *)data;
+		thread->_proc(thread->_data);
+		return 0;
+	}
+
+	Common::ThreadProc _proc;
+	void *_data;
+	SDL_Thread *_thread;
+};
+
+Common::ThreadInternal *createSdlThreadInternal(Common::ThreadProc proc, void *data, const char *name) {
+	SdlThreadInternal *thread = new SdlThreadInternal(proc, data);
+	if (!thread->start(name)) {
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+uintptr getSdlCurrentThreadId() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	return (uintptr)SDL_GetCurrentThreadID();
+#else
+	return (uintptr)SDL_ThreadID();
+#endif
+}
+
+#endif
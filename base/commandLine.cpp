@@ -387,6 +387,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("gui_browser_native", true);
 	ConfMan.registerDefault("gui_return_to_launcher_at_exit", false);
 	ConfMan.registerDefault("gui_launcher_chooser", "list");
+	ConfMan.registerDefault("gui_theme_cache", false);
 	ConfMan.registerDefault("grid_items_per_row", 4);
 	// Specify threshold for scanning directories in the launcher
 	// If number of game entries in scummvm.ini exceeds the specified
@@ -1507,18 +1508,46 @@ static void dumpAllDetectionEntries() {
 	}
 }
 
-/** Display all games in the given directory, or current directory if empty */
-static DetectedGames getGameList(const Common::FSNode &dir) {
-	Common::FSList files;
+/**
+ * List the given directory and, for recursive scans, all directories below
+ * it. The tree is listed one level at a time, with the directories of each
+ * level listed in parallel. The root is the first directory of the tree, and
+ * subdirs holds the indices of the subdirectories of each directory.
+ */
+static void scanDirectoryTree(const Common::FSNode &dir, bool recursive, Common::Array<Common::FSDirectoryListing> &tree, Common::Array<Common::Array<uint> > &subdirs) {
+	tree.push_back(Common::FSDirectoryListing(dir));
+
+	uint levelStart = 0;
+	while (levelStart < tree.size()) {
+		const uint levelEnd = tree.size();
+		Common::listDirectories(tree, levelStart);
+		subdirs.resize(levelEnd);
+
+		if (!recursive)
+			break;
+
+		for (uint i = levelStart; i < levelEnd; ++i) {
+			for (uint j = 0; j < tree[i].files.size(); ++j) {
+				if (!tree[i].files[j].isDirectory())
+					continue;
+
+				subdirs[i].push_back(tree.size());
+				tree.push_back(Common::FSDirectoryListing(tree[i].files[j]));
+			}
+		}
+		levelStart = levelEnd;
+	}
+}
 
-	// Collect all files from directory
-	if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-		printf("Path %s does not exist or is not a directory.\n", dir.getPath().toString(Common::Path::kNativeSeparator).c_str());
+/** Detect the games in a directory of a scanned tree */
+static DetectedGames getGameList(const Common::FSDirectoryListing &dir) {
+	if (!dir.listed) {
+		printf("Path %s does not exist or is not a directory.\n", dir.node.getPath().toString(Common::Path::kNativeSeparator).c_str());
 		return DetectedGames();
 	}
 
 	// detect Games
-	DetectionResults detectionResults = EngineMan.detectGames(files);
+	DetectionResults detectionResults = EngineMan.detectGames(dir.files);
 
 	if (detectionResults.foundUnknownGames()) {
 		Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
@@ -1528,19 +1557,15 @@ static DetectedGames getGameList(const Common::FSNode &dir) {
 	return detectionResults.listRecognizedGames();
 }
 
-static DetectedGames recListGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
-	DetectedGames list = getGameList(dir);
+static DetectedGames recListGames(const Common::Array<Common::FSDirectoryListing> &tree, const Common::Array<Common::Array<uint> > &subdirs, uint index, const Common::String &engineId, const Common::String &gameId) {
+	DetectedGames list = getGameList(tree[index]);
 
-	if (recursive) {
-		Common::FSList files;
-		dir.getChildren(files, Common::FSNode::kListDirectoriesOnly);
-		for (const auto &file : files) {
-			DetectedGames rec = recListGames(file, engineId, gameId, recursive);
-			for (auto &game : rec) {
-				if ((game.engineId == engineId && game.gameId == gameId)
-				    || gameId.empty())
-					list.push_back(game);
-			}
+	for (const auto &subdir : subdirs[index]) {
+		DetectedGames rec = recListGames(tree, subdirs, subdir, engineId, gameId);
+		for (auto &game : rec) {
+			if ((game.engineId == engineId && game.gameId == gameId)
+			    || gameId.empty())
+				list.push_back(game);
 		}
 	}
 
@@ -1552,7 +1577,10 @@ static Common::String detectGames(const Common::Path &path, const Common::String
 	bool noPath = path.empty();
 	//Current directory
 	Common::FSNode dir(path);
-	DetectedGames candidates = recListGames(dir, engineId, gameId, recursive);
+	Common::Array<Common::FSDirectoryListing> tree;
+	Common::Array<Common::Array<uint> > subdirs;
+	scanDirectoryTree(dir, recursive, tree, subdirs);
+	DetectedGames candidates = recListGames(tree, subdirs, 0, engineId, gameId);
 
 	if (candidates.empty()) {
 		printf("WARNING: ScummVM could not find any game in %s\n", dir.getPath().toString(Common::Path::kNativeSeparator).c_str());
@@ -1577,9 +1605,9 @@ static Common::String detectGames(const Common::Path &path, const Common::String
 	return buildQualifiedGameName(candidates[0].engineId, candidates[0].gameId);
 }
 
-static int recAddGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+static int recAddGames(const Common::Array<Common::FSDirectoryListing> &tree, const Common::Array<Common::Array<uint> > &subdirs, uint index, const Common::String &engineId, const Common::String &gameId) {
 	int count = 0;
-	DetectedGames list = getGameList(dir);
+	DetectedGames list = getGameList(tree[index]);
 	for (const auto &v : list) {
 		if ((v.engineId != engineId || v.gameId != gameId)
 		    && !gameId.empty()) {
@@ -1605,14 +1633,8 @@ static int recAddGames(const Common::FSNode &dir, const Common::String &engineId
 		}
 	}
 
-	if (recursive) {
-		Common::FSList files;
-		if (dir.getChildren(files, Common::FSNode::kListDirectoriesOnly)) {
-			for (const auto &file : files) {
-				count += recAddGames(file, engineId, gameId, recursive);
-			}
-		}
-	}
+	for (const auto &subdir : subdirs[index])
+		count += recAddGames(tree, subdirs, subdir, engineId, gameId);
 
 	return count;
 }
@@ -1693,7 +1715,10 @@ static void calcMD5Mac(Common::Path &filePath, int32 length) {
 static bool addGames(const Common::Path &path, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	//Current directory
 	Common::FSNode dir(path);
-	int added = recAddGames(dir, engineId, gameId, recursive);
+	Common::Array<Common::FSDirectoryListing> tree;
+	Common::Array<Common::Array<uint> > subdirs;
+	scanDirectoryTree(dir, recursive, tree, subdirs);
+	int added = recAddGames(tree, subdirs, 0, engineId, gameId);
 	printf("Added %d games\n", added);
 	if (added == 0 && !recursive) {
 		printf("Consider using --recursive to search inside subdirectories\n");
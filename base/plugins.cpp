@@ -668,6 +668,11 @@ QualifiedGameList EngineManager::findGameInLoadedPlugins(const Common::String &g
 DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) {
 	DetectedGames candidates;
 
+	// No detector can find anything in an empty directory, which are common
+	// when scanning whole directory trees
+	if (fslist.empty())
+		return DetectionResults(candidates);
+
 	// MetaEngines are always loaded into memory, so, get them and
 	// run detection for all of them.
 	PluginList plugins = getPlugins(PLUGIN_TYPE_ENGINE_DETECTION);
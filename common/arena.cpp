@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/arena.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Common {
+
+// The data of a block starts at the first 16 byte boundary after the header
+static const size_t kBlockHeaderAlignment = 16;
+
+Arena::Arena(size_t blockSize) : _blockSize(blockSize), _first(nullptr), _current(nullptr) {
+}
+
+Arena::~Arena() {
+	while (_first) {
+		Block *next = _first->next;
+		free(_first);
+		_first = next;
+	}
+}
+
+size_t Arena::getHeaderSize() {
+	return (sizeof(Block) + kBlockHeaderAlignment - 1) & ~(kBlockHeaderAlignment - 1);
+}
+
+Arena::Block *Arena::allocBlock(size_t size) {
+	Block *block = (Block *)malloc(getHeaderSize() + size);
+	if (!block)
+		::error("Common::Arena: failure to allocate %u bytes", (uint)size);
+
+	block->next = nullptr;
+	block->size = size;
+	block->used = 0;
+	return block;
+}
+
+static size_t alignOffset(byte *data, size_t offset, size_t alignment) {
+	const uintptr address = ((uintptr)(data + offset) + alignment - 1) & ~(uintptr)(alignment - 1);
+	return address - (uintptr)data;
+}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+	if (_current) {
+		byte *data = getData(_current);
+		const size_t offset = alignOffset(data, _current->used, alignment);
+		if (offset + size <= _current->size) {
+			_current->used = offset + size;
+			return data + offset;
+		}
+	}
+
+	// Continue with the next block, which is kept from before the last
+	// reset. If it is too small, a new block is put in front of it.
+	const size_t needed = size + (alignment > kBlockHeaderAlignment ? alignment : 0);
+	Block *next = _current ? _current->next : _first;
+	if (!next || next->size < needed) {
+		Block *block = allocBlock(MAX<size_t>(_blockSize, needed));
+		block->next = next;
+		if (_current)
+			_current->next = block;
+		else
+			_first = block;
+		next = block;
+	}
+
+	_current = next;
+	byte *data = getData(_current);
+	const size_t offset = alignOffset(data, 0, alignment);
+	_current->used = offset + size;
+	return data + offset;
+}
+
+void Arena::resetToMark(const Mark &mark) {
+	_current = mark._block;
+	if (_current)
+		_current->used = mark._used;
+}
+
+void Arena::freeUnusedBlocks() {
+	Block **next = _current ? &_current->next : &_first;
+	while (*next) {
+		Block *block = *next;
+		*next = block->next;
+		free(block);
+	}
+}
+
+size_t Arena::getUsedSize() const {
+	if (!_current)
+		return 0;
+
+	size_t used = 0;
+	for (Block *block = _first; block != _current; block = block->next)
+		used += block->used;
+	return used + _current->used;
+}
+
+size_t Arena::getReservedSize() const {
+	size_t size = 0;
+	for (Block *block = _first; block; block = block->next)
+		size += block->size;
+	return size;
+}
+
+} // End of namespace Common
@@ -0,0 +1,184 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ARENA_H
+#define COMMON_ARENA_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_arena Arena allocator
+ * @ingroup common_memory
+ *
+ * @brief API for allocating transient memory from an arena.
+ * @{
+ */
+
+/**
+ * A bump allocator for short-lived allocations of any size.
+ *
+ * Memory is handed out from large blocks by advancing a pointer, which is
+ * much cheaper than malloc(). Single allocations cannot be freed. Instead,
+ * all allocations made since a mark was taken are released at once with
+ * resetToMark(), or all allocations with reset(). The blocks are kept for
+ * reuse, so an arena which is reset every frame or every room stops
+ * allocating memory after a while.
+ *
+ * Destructors of objects placed in the arena are not called. Either use the
+ * arena for trivially destructible data, or destroy the objects before the
+ * arena is reset, like the containers using ArenaAllocator do.
+ */
+class Arena : NonCopyable {
+private:
+	struct Block {
+		Block *next;
+		size_t size; ///< Usable bytes following the header
+		size_t used;
+	};
+
+public:
+	enum {
+		/** Default size of the blocks allocated by the arena */
+		kDefaultBlockSize = 64 * 1024
+	};
+
+	/** Position in the arena, as returned by getMark(). */
+	class Mark {
+		friend class Arena;
+
+		Block *_block;
+		size_t _used;
+
+		Mark(Block *block, size_t used) : _block(block), _used(used) {}
+	};
+
+	/**
+	 * Create an arena. No memory is allocated until the first allocation.
+	 *
+	 * @param blockSize  Size of the blocks to allocate. Larger allocations get their own block.
+	 */
+	explicit Arena(size_t blockSize = kDefaultBlockSize);
+	~Arena();
+
+	/**
+	 * Allocate memory from the arena. The memory stays valid until the
+	 * arena is reset to a mark taken before this allocation, or destroyed.
+	 *
+	 * @param size       Number of bytes to allocate.
+	 * @param alignment  Alignment of the memory, must be a power of two.
+	 */
+	void *allocate(size_t size, size_t alignment = sizeof(void *));
+
+	/** Allocate uninitialized memory for @p count objects of type @p T. */
+	template<class T>
+	T *allocateArray(size_t count) {
+		return (T *)allocate(count * sizeof(T), alignof(T));
+	}
+
+	/** Return the current position in the arena. */
+	Mark getMark() const {
+		return Mark(_current, _current ? _current->used : 0);
+	}
+
+	/** Release all allocations made since @p mark was taken. */
+	void resetToMark(const Mark &mark);
+
+	/** Release all allocations. */
+	void reset() {
+		resetToMark(Mark(nullptr, 0));
+	}
+
+	/** Free the memory of the blocks which are not in use currently. */
+	void freeUnusedBlocks();
+
+	/** Return the number of bytes allocated from the arena, including alignment. */
+	size_t getUsedSize() const;
+
+	/** Return the number of bytes the arena holds from the system. */
+	size_t getReservedSize() const;
+
+private:
+	static size_t getHeaderSize();
+	static byte *getData(Block *block) { return (byte *)block + getHeaderSize(); }
+	Block *allocBlock(size_t size);
+
+	const size_t _blockSize;
+	Block *_first;   ///< All blocks, the ones in use first
+	Block *_current; ///< The block allocations are made from, nullptr before the first allocation
+};
+
+/**
+ * Releases all allocations made from an arena during its lifetime.
+ *
+ * @code
+ * Common::ArenaScope scope(_frameArena);
+ * Common::ArenaAllocator<Common::Rect> allocator(_frameArena);
+ * Common::Array<Common::Rect, Common::ArenaAllocator<Common::Rect> > rects(allocator);
+ * @endcode
+ */
+class ArenaScope : NonCopyable {
+public:
+	explicit ArenaScope(Arena &arena) : _arena(arena), _mark(arena.getMark()) {}
+	~ArenaScope() { _arena.resetToMark(_mark); }
+
+private:
+	Arena &_arena;
+	const Arena::Mark _mark;
+};
+
+/**
+ * An allocator for Array and List which takes the memory from an arena.
+ * Memory is only returned to the arena when the arena is reset.
+ */
+template<class T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+
+	template<class U>
+	struct rebind {
+		typedef ArenaAllocator<U> other;
+	};
+
+	explicit ArenaAllocator(Arena &arena) : _arena(&arena) {}
+	template<class U>
+	ArenaAllocator(const ArenaAllocator<U> &allocator) : _arena(allocator.getArena()) {}
+
+	T *allocate(size_t n) { return _arena->allocateArray<T>(n); }
+	void deallocate(T *p, size_t n) {}
+
+	Arena *getArena() const { return _arena; }
+
+	bool operator==(const ArenaAllocator &allocator) const { return _arena == allocator._arena; }
+	bool operator!=(const ArenaAllocator &allocator) const { return _arena != allocator._arena; }
+
+private:
+	Arena *_arena;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -47,9 +47,13 @@ namespace Common {
  *
  * The container class closest to this in the C++ standard library is
  * std::vector. However, there are some differences.
+ *
+ * The memory for the elements comes from @p Alloc, see DefaultAllocator for
+ * the requirements. Stateful allocators like ArenaAllocator are passed to
+ * the constructor and are copied along with the array.
  */
-template<class T>
-class Array {
+template<class T, class Alloc = DefaultAllocator<T> >
+class Array : private Alloc {
 public:
 	typedef T *iterator; /*!< Array iterator. */
 	typedef const T *const_iterator; /*!< Const-qualified array iterator. */
@@ -61,6 +65,8 @@ public:
 
 	typedef uint size_type; /*!< Size type of the array. */
 
+	typedef Alloc allocator_type; /*!< Allocator of the array. */
+
 protected:
 	size_type _capacity; /*!< Maximum number of elements the array can hold. */
 	size_type _size; /*!< How many elements the array holds. */
@@ -69,6 +75,9 @@ protected:
 public:
 	constexpr Array() : _capacity(0), _size(0), _storage(nullptr) {}
 
+	/** Construct an empty array which takes its memory from @p allocator. */
+	explicit Array(const Alloc &allocator) : Alloc(allocator), _capacity(0), _size(0), _storage(nullptr) {}
+
 	/**
 	 * Construct an array with @p count default-inserted instances of @p T. No
 	 * copies are made.
@@ -93,7 +102,7 @@ public:
 	/**
 	 * Construct an array as a copy of the given @p array.
 	 */
-	Array(const Array<T> &array) : _capacity(array._size), _size(array._size), _storage(nullptr) {
+	Array(const Array &array) : Alloc(array), _capacity(array._size), _size(array._size), _storage(nullptr) {
 		if (array._storage) {
 			allocCapacity(_size);
 			uninitialized_copy(array._storage, array._storage + _size, _storage);
@@ -103,7 +112,7 @@ public:
 	/**
 	 * Construct an array as a copy of the given array using the C++11 move semantic.
 	 */
-	Array(Array<T> &&old) : _capacity(old._capacity), _size(old._size), _storage(old._storage) {
+	Array(Array &&old) : Alloc(Common::move(static_cast<Alloc &>(old))), _capacity(old._capacity), _size(old._size), _storage(old._storage) {
 		old._storage = nullptr;
 		old._capacity = 0;
 		old._size = 0;
@@ -136,7 +145,7 @@ public:
 	}
 
 	~Array() {
-		freeStorage(_storage, _size);
+		freeStorage(_storage, _size, _capacity);
 		_storage = nullptr;
 		_capacity = _size = 0;
 	}
@@ -156,6 +165,7 @@ public:
 			// In the added-in-the-middle case, the copy is required because the parameters
 			// may contain a const ref to the original storage.
 			T *oldStorage = _storage;
+			const size_type oldCapacity = _capacity;
 
 			allocCapacity(roundUpCapacity(_size + 1));
 
@@ -167,7 +177,7 @@ public:
 			uninitialized_move(oldStorage, oldStorage + index, _storage);
 			uninitialized_move(oldStorage + index, oldStorage + _size, _storage + index + 1);
 
-			freeStorage(oldStorage, _size);
+			freeStorage(oldStorage, _size, oldCapacity);
 		}
 
 		_size++;
@@ -190,7 +200,7 @@ public:
 	}
 
 	/** Append an element to the end of the array. */
-	void push_back(const Array<T> &array) {
+	void push_back(const Array &array) {
 		if (_size + array.size() <= _capacity) {
 			uninitialized_copy(array.begin(), array.end(), end());
 			_size += array.size();
@@ -247,7 +257,7 @@ public:
 	}
 
 	/** Insert copies of all the elements from the given array into this array at the given position. */
-	void insert_at(size_type idx, const Array<T> &array) {
+	void insert_at(size_type idx, const Array &array) {
 		assert(idx <= _size);
 		insert_aux(_storage + idx, array.begin(), array.end());
 	}
@@ -285,11 +295,11 @@ public:
 	}
 
 	/** Assign the given @p array to this array. */
-	Array<T> &operator=(const Array<T> &array) {
+	Array &operator=(const Array &array) {
 		if (this == &array)
 			return *this;
 
-		freeStorage(_storage, _size);
+		freeStorage(_storage, _size, _capacity);
 		_size = array._size;
 		allocCapacity(_size);
 		uninitialized_copy(array._storage, array._storage + _size, _storage);
@@ -298,11 +308,22 @@ public:
 	}
 
 	/** Assign the given array to this array using the C++11 move semantic. */
-	Array &operator=(Array<T> &&old) {
+	Array &operator=(Array &&old) {
 		if (this == &old)
 			return *this;
 
-		freeStorage(_storage, _size);
+		// The storage can only be taken over if this array's allocator is
+		// able to free it
+		if (get_allocator() != old.get_allocator()) {
+			freeStorage(_storage, _size, _capacity);
+			_size = old._size;
+			allocCapacity(_size);
+			uninitialized_move(old._storage, old._storage + _size, _storage);
+			old.clear();
+			return *this;
+		}
+
+		freeStorage(_storage, _size, _capacity);
 		_capacity = old._capacity;
 		_size = old._size;
 		_storage = old._storage;
@@ -321,7 +342,7 @@ public:
 
 	/** Clear the array of all its elements. */
 	void clear() {
-		freeStorage(_storage, _size);
+		freeStorage(_storage, _size, _capacity);
 		_storage = nullptr;
 		_size = 0;
 		_capacity = 0;
@@ -356,7 +377,7 @@ public:
 	}
 
 	/** Check whether two arrays are identical. */
-	bool operator==(const Array<T> &other) const {
+	bool operator==(const Array &other) const {
 		if (this == &other)
 			return true;
 		if (_size != other._size)
@@ -369,7 +390,7 @@ public:
 	}
 
 	/** Check if two arrays are different. */
-	bool operator!=(const Array<T> &other) const {
+	bool operator!=(const Array &other) const {
 		return !(*this == other);
 	}
 
@@ -401,12 +422,13 @@ public:
 			return;
 
 		T *oldStorage = _storage;
+		const size_type oldCapacity = _capacity;
 		allocCapacity(newCapacity);
 
 		if (oldStorage) {
 			// Move old data
 			uninitialized_move(oldStorage, oldStorage + _size, _storage);
-			freeStorage(oldStorage, _size);
+			freeStorage(oldStorage, _size, oldCapacity);
 		}
 	}
 
@@ -450,11 +472,17 @@ public:
 	}
 
 	void swap(Array &arr) {
+		SWAP(static_cast<Alloc &>(*this), static_cast<Alloc &>(arr));
 		SWAP(this->_capacity, arr._capacity);
 		SWAP(this->_size, arr._size);
 		SWAP(this->_storage, arr._storage);
 	}
 
+	/** Return the allocator of the array. */
+	const Alloc &get_allocator() const {
+		return *this;
+	}
+
 protected:
 	/** Round up capacity to the next power of 2.
 	  * A minimal capacity of 8 is used.
@@ -470,7 +498,7 @@ protected:
 	void allocCapacity(size_type capacity) {
 		_capacity = capacity;
 		if (capacity) {
-			_storage = (T *)malloc(sizeof(T) * capacity);
+			_storage = Alloc::allocate(capacity);
 			if (!_storage)
 				::error("Common::Array: failure to allocate %u bytes", capacity * (size_type)sizeof(T));
 		} else {
@@ -479,10 +507,11 @@ protected:
 	}
 
 	/** Free the storage used by the array. */
-	void freeStorage(T *storage, const size_type elements) {
+	void freeStorage(T *storage, const size_type elements, const size_type capacity) {
 		for (size_type i = 0; i < elements; ++i)
 			storage[i].~T();
-		free(storage);
+		if (storage)
+			Alloc::deallocate(storage, capacity);
 	}
 
 	/**
@@ -506,6 +535,7 @@ protected:
 			const size_type idx = pos - _storage;
 			if (_size + n > _capacity || (_storage <= first && first <= _storage + _size)) {
 				T *const oldStorage = _storage;
+				const size_type oldCapacity = _capacity;
 
 				// If there is not enough space, allocate more.
 				// Likewise, if this is a self-insert, we allocate new
@@ -521,7 +551,7 @@ protected:
 				// insert.
 				uninitialized_move(oldStorage + idx, oldStorage + _size, _storage + idx + n);
 
-				freeStorage(oldStorage, _size);
+				freeStorage(oldStorage, _size, oldCapacity);
 			} else if (idx + n <= _size) {
 				// Make room for the new elements by shifting back
 				// existing ones.
@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/atom.h"
+#include "common/mutex.h"
+#include "common/system.h"
+
+namespace Common {
+
+Atom::Table *Atom::_table = nullptr;
+
+static Mutex *g_atomTableMutex = nullptr;
+
+static void lockAtomTableMutex() {
+	// Like with the String memory pool, atoms may be created before the
+	// backend is initialized, when there are no other threads yet.
+	if (!g_system || !g_system->backendInitialized())
+		return;
+	if (!g_atomTableMutex)
+		g_atomTableMutex = new Mutex();
+	g_atomTableMutex->lock();
+}
+
+static void unlockAtomTableMutex() {
+	if (g_atomTableMutex)
+		g_atomTableMutex->unlock();
+}
+
+void Atom::releaseTableMutex() {
+	delete g_atomTableMutex;
+	g_atomTableMutex = nullptr;
+}
+
+Atom::Data::Data(const String &str) :
+	_string(str), _hash(str.hash()), _hashIgnoreCase(hashit_lower(str)), _lower(this) {
+}
+
+const Atom::Data *Atom::intern(const String &str) {
+	lockAtomTableMutex();
+	const Data *data = internLocked(str);
+	unlockAtomTableMutex();
+	return data;
+}
+
+const Atom::Data *Atom::internLocked(const String &str) {
+	if (!_table)
+		_table = new Table();
+
+	Data *data = _table->getValOrDefault(str, nullptr);
+	if (data)
+		return data;
+
+	data = new Data(str);
+	_table->setVal(str, data);
+
+	String lower(str);
+	lower.toLowercase();
+	if (!lower.equals(str))
+		data->_lower = internLocked(lower);
+
+	return data;
+}
+
+const Atom::Data *Atom::getEmpty() {
+	static const Data *empty = intern(String());
+	return empty;
+}
+
+} // End of namespace Common
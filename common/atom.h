@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOM_H
+#define COMMON_ATOM_H
+
+#include "common/hash-str.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_atom Interned strings (Atom)
+ * @ingroup common
+ *
+ * @brief Strings which are hashed and compared in constant time.
+ *
+ * @{
+ */
+
+/**
+ * An interned, immutable string.
+ *
+ * All atoms with the same contents share a single copy of the string, which
+ * is created the first time the string is turned into an atom. The hashes
+ * of the string and of its lowercase version are computed at that time as
+ * well. Afterwards comparing atoms, with or without respect to case, only
+ * compares pointers, and hashing them returns the stored hash.
+ *
+ * This makes atoms a good fit for identifiers that are looked up over and
+ * over again, like script symbols or configuration keys. Interned strings
+ * are never freed though, so atoms must not be created from arbitrary,
+ * unbounded input.
+ *
+ * Atoms may be created from several threads.
+ */
+class Atom {
+private:
+	struct Data {
+		String _string;
+		uint _hash;           ///< Case sensitive hash, as returned by String::hash()
+		uint _hashIgnoreCase; ///< Case insensitive hash, as returned by hashit_lower()
+		const Data *_lower;   ///< The atom of the lowercase string, which may be this one
+
+		explicit Data(const String &str);
+	};
+
+	const Data *_data;
+
+	// The interned strings live as long as the program
+	typedef HashMap<String, Data *> Table;
+	static Table *_table;
+
+	explicit Atom(const Data *data) : _data(data) {}
+
+	static const Data *intern(const String &str);
+	static const Data *internLocked(const String &str);
+	static const Data *getEmpty();
+
+public:
+	/** Create the empty atom. */
+	Atom() : _data(getEmpty()) {}
+	explicit Atom(const String &str) : _data(intern(str)) {}
+	explicit Atom(const char *str) : _data(intern(String(str))) {}
+
+	const String &toString() const { return _data->_string; }
+	const char *c_str() const { return _data->_string.c_str(); }
+	uint size() const { return _data->_string.size(); }
+	bool empty() const { return _data->_string.empty(); }
+
+	/** Return the atom of the lowercase version of this string. */
+	Atom lowercase() const { return Atom(_data->_lower); }
+
+	bool operator==(const Atom &x) const { return _data == x._data; }
+	bool operator!=(const Atom &x) const { return _data != x._data; }
+
+	bool equalsIgnoreCase(const Atom &x) const { return _data->_lower == x._data->_lower; }
+
+	/** Return the same hash as String::hash(). */
+	uint hash() const { return _data->_hash; }
+	/** Return the same hash as hashit_lower() and IgnoreCase_Hash. */
+	uint hashIgnoreCase() const { return _data->_hashIgnoreCase; }
+
+	/**
+	 * Free the mutex protecting the table of interned strings. This is
+	 * called when the backend is destroyed.
+	 */
+	static void releaseTableMutex();
+};
+
+/** Case sensitive hash functor for atoms. */
+template<>
+struct Hash<Atom> {
+	uint operator()(const Atom &x) const { return x.hash(); }
+};
+
+/** Case insensitive equality functor for atoms, to be used with Atom_IgnoreCase_Hash. */
+struct Atom_IgnoreCase_EqualTo {
+	bool operator()(const Atom &x, const Atom &y) const { return x.equalsIgnoreCase(y); }
+};
+
+/** Case insensitive hash functor for atoms. */
+struct Atom_IgnoreCase_Hash {
+	uint operator()(const Atom &x) const { return x.hashIgnoreCase(); }
+};
+
+// Atom map -- case insensitive, like StringMap
+typedef HashMap<Atom, String, Atom_IgnoreCase_Hash, Atom_IgnoreCase_EqualTo> AtomStringMap;
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,99 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#include <atomic>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic values
+ * @ingroup common
+ *
+ * @brief Minimal atomic operations for lock-free data exchange between threads.
+ * @{
+ */
+
+/**
+ * An integral or pointer value that can be shared between threads without
+ * a mutex.
+ *
+ * Loads have acquire semantics and stores have release semantics, so data
+ * written before a store() is visible to a thread that observed the stored
+ * value through load(). This is all that is needed for single-producer,
+ * single-consumer hand-over, which is what the audio code uses it for.
+ *
+ * GCC and Clang use their __atomic builtins, other compilers fall back to
+ * std::atomic.
+ */
+template<class T>
+class Atomic : NonCopyable {
+public:
+	Atomic() : _value(T()) {}
+	explicit Atomic(T value) : _value(value) {}
+
+#if defined(__GNUC__) || defined(__clang__)
+	T load() const { return __atomic_load_n(&_value, __ATOMIC_ACQUIRE); }
+	void store(T value) { __atomic_store_n(&_value, value, __ATOMIC_RELEASE); }
+	T exchange(T value) { return __atomic_exchange_n(&_value, value, __ATOMIC_ACQ_REL); }
+	T fetchAdd(T delta) { return __atomic_fetch_add(&_value, delta, __ATOMIC_ACQ_REL); }
+	T fetchSub(T delta) { return __atomic_fetch_sub(&_value, delta, __ATOMIC_ACQ_REL); }
+
+	/**
+	 * Replace the value with @p desired if it is equal to @p expected.
+	 * Otherwise @p expected is updated with the current value.
+	 *
+	 * @return True if the value was replaced.
+	 */
+	bool compareExchange(T &expected, T desired) {
+		return __atomic_compare_exchange_n(&_value, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	}
+
+private:
+	T _value;
+#else
+	T load() const { return _value.load(std::memory_order_acquire); }
+	void store(T value) { _value.store(value, std::memory_order_release); }
+	T exchange(T value) { return _value.exchange(value, std::memory_order_acq_rel); }
+	T fetchAdd(T delta) { return _value.fetch_add(delta, std::memory_order_acq_rel); }
+	T fetchSub(T delta) { return _value.fetch_sub(delta, std::memory_order_acq_rel); }
+
+	bool compareExchange(T &expected, T desired) {
+		return _value.compare_exchange_strong(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire);
+	}
+
+private:
+	std::atomic<T> _value;
+#endif
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
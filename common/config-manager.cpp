@@ -20,9 +20,11 @@
  */
 
 #include "common/config-manager.h"
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/str-view.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -189,21 +191,27 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 	_cloudDomain.clear();
 #endif
 
+	// Parse the file from memory. Only the names, values and comments
+	// which are stored are copied into strings.
+	Array<byte> buffer;
+	stream.readRemainingData(buffer);
+	StringView text((const char *)buffer.data(), buffer.size());
+
+	// Skip UTF-8 byte-order mark if added by a text editor.
+	if (text.hasPrefix(StringView((const char *)UTF8_BOM, sizeof(UTF8_BOM))))
+		text.removePrefix(sizeof(UTF8_BOM));
+
 	// TODO: Detect if a domain occurs multiple times (or likewise, if
 	// a key occurs multiple times inside one domain).
 
-	while (!stream.eos() && !stream.err()) {
+	while (!text.empty()) {
 		lineno++;
 
-		// Read a line
-		String line = stream.readLine();
+		// Read a line, which like a C string ends at a null character
+		StringView line = text.splitLine();
+		line = line.substr(0, line.find('\0'));
 
-		// Skip UTF-8 byte-order mark if added by a text editor.
-		if (lineno == 1 && memcmp(line.c_str(), UTF8_BOM, 3) == 0) {
-			line.erase(0, 3);
-		}
-
-		if (line.size() == 0) {
+		if (line.empty()) {
 			// Do nothing
 		} else if (line[0] == '#') {
 			// Accumulate comments here. Once we encounter either the start
@@ -216,22 +224,22 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			// Determine where the previously accumulated domain goes, if we accumulated anything.
 			addDomain(domainName, domain);
 			domain.clear();
-			const char *p = line.c_str() + 1;
+			uint32 p = 1;
 			// Get the domain name, and check whether it's valid (that
 			// is, verify that it only consists of alphanumerics,
 			// dashes and underscores).
-			while (*p && (isAlnum(*p) || *p == '-' || *p == '_'))
+			while (p < line.size() && (isAlnum(line[p]) || line[p] == '-' || line[p] == '_'))
 				p++;
 
-			if (*p == '\0') {
+			if (p == line.size()) {
 				warning("Config file buggy: missing ] in line %d", lineno);
 				return false;
-			} else if (*p != ']') {
-				warning("Config file buggy: Invalid character '%c' occurred in section name in line %d", *p, lineno);
+			} else if (line[p] != ']') {
+				warning("Config file buggy: Invalid character '%c' occurred in section name in line %d", line[p], lineno);
 				return false;
 			}
 
-			domainName = String(line.c_str() + 1, p);
+			domainName = line.substr(1, p - 1).toString();
 
 			domain.setDomainComment(comment);
 			comment.clear();
@@ -240,12 +248,10 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			// This line should be a line with a 'key=value' pair, or an empty one.
 
 			// Skip leading whitespaces
-			const char *t = line.c_str();
-			while (isSpace(*t))
-				t++;
+			const StringView t = line.trimmedLeft();
 
 			// Skip empty lines / lines with only whitespace
-			if (*t == 0)
+			if (t.empty())
 				continue;
 
 			// If no domain has been set, this config file is invalid!
@@ -255,19 +261,15 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			}
 
 			// Split string at '=' into 'key' and 'value'. First, find the "=" delimeter.
-			const char *p = strchr(t, '=');
-			if (!p) {
-				warning("Config file buggy: Junk found in line %d: '%s'", lineno, t);
+			const uint32 p = t.find('=');
+			if (p == StringView::npos) {
+				warning("Config file buggy: Junk found in line %d: '%s'", lineno, t.toString().c_str());
 				return false;
 			}
 
-			// Extract the key/value pair
-			String key(t, p);
-			String value(p + 1);
-
-			// Trim of spaces
-			key.trim();
-			value.trim();
+			// Extract the key/value pair, without spaces
+			String key = t.substr(0, p).trimmed().toString();
+			String value = t.substr(p + 1).trimmed().toString();
 
 			// Finally, store the key/value pair in the active domain
 			domain.setVal(key, value);
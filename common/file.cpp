@@ -137,6 +137,11 @@ bool File::seek(int64 offs, int whence) {
 	return _handle->seek(offs, whence);
 }
 
+const byte *File::getView(int64 offset, uint32 dataSize) const {
+	assert(_handle);
+	return _handle->getView(offset, dataSize);
+}
+
 uint32 File::read(void *ptr, uint32 len) {
 	assert(_handle);
 	return _handle->read(ptr, len);
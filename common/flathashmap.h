@@ -0,0 +1,662 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The hash map implementation in this file uses open addressing with
+// linear probing and Robin Hood hashing: an entry never stays farther away
+// from its home bucket than the entry it passes, which keeps the probe
+// sequences short, and erased entries are removed by shifting the
+// following entries back instead of leaving tombstones.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/hashmap.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table with inline storage.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val> with the
+ * same interface and the same requirements on the key type, hash and
+ * equality functors.
+ *
+ * Unlike HashMap, which keeps an array of pointers to separately allocated
+ * nodes, the key/value pairs are stored directly in one contiguous table,
+ * each next to a one byte probe distance. A lookup usually touches a single
+ * cache line, and most mismatches are rejected by the probe distance without
+ * calling the equality functor.
+ *
+ * This comes at a price: entries move when the map grows or when another
+ * entry is erased. Pointers and references to values as well as iterators
+ * are therefore invalidated by any insertion or erasure, which is not the
+ * case for HashMap. Large values are better kept in a HashMap, or stored
+ * as pointers.
+ *
+ * The hash values are scrambled before use, so the identity hash of
+ * integers is fine, but a hash function that maps hundreds of different
+ * keys to the very same value triggers an error.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(const Node &node) : _value(node._value), _key(node._key) {}
+		// Only used to relocate entries, the source is destroyed afterwards
+		Node(Node &&node) : _value(Common::move(node._value)), _key(Common::move(const_cast<Key &>(node._key))) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up before being
+		// increased automatically.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4,
+
+		// Probe distances are stored in a byte. The table is grown when
+		// an entry would end up farther away from its home bucket.
+		FLATHASHMAP_MAX_DISTANCE = 254
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	/**
+	 * A bucket of the table. The probe distance is kept next to the entry,
+	 * so that a lookup usually touches a single cache line.
+	 */
+	struct Bucket {
+		byte _distance; ///< Distance of the entry from its home bucket plus one, 0 for free buckets
+		union {
+			Node _node; ///< Only constructed if _distance is non-zero
+		};
+
+		Bucket() {}
+		~Bucket() {}
+	};
+
+	Bucket *_storage;
+	size_type _mask;  ///< Capacity of the FlatHashMap minus one; 0 while no storage is allocated
+	size_type _shift; ///< 32 minus the number of bits of _mask
+	size_type _size;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	void assign(const HM_t &map);
+	void freeStorage();
+	size_type lookup(const Key &key) const;
+	size_type lookup(const Key &key, uint32 hash) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	bool allocateBucket(size_type home, size_type &idx);
+	void eraseAt(size_type idx);
+	void expandStorage(size_type newCapacity);
+
+	size_type capacity() const { return _storage ? _mask + 1 : 0; }
+
+	/**
+	 * Fibonacci hashing: the upper bits of the product are used as the home
+	 * bucket, so that keys which only differ in their upper bits are spread
+	 * over the whole table.
+	 */
+	uint32 scrambledHash(const Key &key) const { return (uint32)(_hash(key) * 2654435769U); }
+	size_type notFound() const { return (size_type)-1; }
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx < _hashmap->capacity());
+			assert(_hashmap->_storage[_idx]._distance != 0);
+			return &_hashmap->_storage[_idx]._node;
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextUsed(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	size_type nextUsed(size_type idx) const {
+		const size_type cap = capacity();
+		while (idx < cap && _storage[idx]._distance == 0)
+			idx++;
+		return idx < cap ? idx : notFound();
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	/**
+	 * Make room for at least @p count entries, so that inserting them does
+	 * not need to grow the table again.
+	 */
+	void reserve(size_type count);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		return iterator(nextUsed(0), this);
+	}
+	iterator	end() {
+		return iterator(notFound(), this);
+	}
+
+	const_iterator	begin() const {
+		return const_iterator(nextUsed(0), this);
+	}
+	const_iterator	end() const {
+		return const_iterator(notFound(), this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap. No storage is allocated until
+ * the first entry is inserted.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() :
+	_defaultVal(), _storage(nullptr), _mask(0), _shift(32), _size(0) {
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) :
+	_defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	_size = map._size;
+	_mask = map._mask;
+	_shift = map._shift;
+	_storage = nullptr;
+	if (!map._storage)
+		return;
+
+	// The layout is copied as is, so there is no need to rehash
+	_storage = (Bucket *)malloc((_mask + 1) * sizeof(Bucket));
+	assert(_storage != nullptr);
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		_storage[ctr]._distance = map._storage[ctr]._distance;
+		if (_storage[ctr]._distance)
+			new ((void *)&_storage[ctr]._node) Node(map._storage[ctr]._node);
+	}
+}
+
+/**
+ * Internal method for destroying all entries and releasing the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr < capacity(); ++ctr) {
+		if (_storage[ctr]._distance)
+			_storage[ctr]._node.~Node();
+	}
+
+	free(_storage);
+	_storage = nullptr;
+	_mask = 0;
+	_shift = 32;
+	_size = 0;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray) {
+		freeStorage();
+		return;
+	}
+
+	for (size_type ctr = 0; ctr < capacity(); ++ctr) {
+		if (_storage[ctr]._distance) {
+			_storage[ctr]._node.~Node();
+			_storage[ctr]._distance = 0;
+		}
+	}
+	_size = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::reserve(size_type count) {
+	size_type newCapacity = MAX<size_type>(capacity(), FLATHASHMAP_MIN_CAPACITY);
+	while (count * FLATHASHMAP_LOADFACTOR_DENOMINATOR > newCapacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		newCapacity *= 2;
+
+	if (newCapacity > capacity())
+		expandStorage(newCapacity);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	assert(newCapacity > capacity());
+
+	const size_type oldCapacity = capacity();
+	Bucket *oldStorage = _storage;
+#ifndef RELEASE_BUILD
+	const size_type oldSize = _size;
+#endif
+
+	// allocate a new array
+	_mask = newCapacity - 1;
+	_shift = 32;
+	for (size_type bits = _mask; bits; bits >>= 1)
+		_shift--;
+	_size = 0;
+	_storage = (Bucket *)malloc(newCapacity * sizeof(Bucket));
+	assert(_storage != nullptr);
+	for (size_type ctr = 0; ctr < newCapacity; ++ctr)
+		_storage[ctr]._distance = 0;
+
+	// Move all the old elements. Since we know that no key exists twice in
+	// the old table, we don't have to look for them first.
+	for (size_type ctr = 0; ctr < oldCapacity; ++ctr) {
+		if (!oldStorage[ctr]._distance)
+			continue;
+
+		Node &node = oldStorage[ctr]._node;
+		size_type idx;
+		if (!allocateBucket(scrambledHash(node._key) >> _shift, idx))
+			error("FlatHashMap: Too many hash collisions");
+		new ((void *)&_storage[idx]._node) Node(Common::move(node));
+		node.~Node();
+	}
+
+#ifndef RELEASE_BUILD
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this hashmap.
+	assert(_size == oldSize);
+#endif
+
+	free(oldStorage);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	if (_size == 0)
+		return notFound();
+
+	return lookup(key, scrambledHash(key));
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key, uint32 hash) const {
+	size_type ctr = hash >> _shift;
+	// All entries in a probe sequence are ordered by their distance from
+	// the home bucket: the key cannot come after an entry which is closer
+	// to its own home bucket. Only entries with the same distance share the
+	// home bucket of the key and need to be compared.
+	for (uint distance = 1; ; distance++) {
+		const uint current = _storage[ctr]._distance;
+		if (current < distance)
+			return notFound();
+		if (current == distance && _equal(_storage[ctr]._node._key, key))
+			return ctr;
+
+		ctr = (ctr + 1) & _mask;
+	}
+}
+
+/**
+ * Internal method for making room for a key which is not in the map yet.
+ * The bucket returned in @p idx is counted as used, but the caller has to
+ * construct the entry in it. Returns false without changing the map if the
+ * key would end up too far away from its home bucket.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocateBucket(size_type home, size_type &idx) {
+	// Find the first bucket which is free or holds an entry that is closer
+	// to its home bucket than the new one would be
+	size_type ctr = home;
+	uint distance = 1;
+	while (_storage[ctr]._distance >= distance) {
+		ctr = (ctr + 1) & _mask;
+		distance++;
+	}
+	if (distance > FLATHASHMAP_MAX_DISTANCE)
+		return false;
+
+	// The entries from there up to the next free bucket move back by one
+	size_type last = ctr;
+	while (_storage[last]._distance) {
+		if (_storage[last]._distance >= FLATHASHMAP_MAX_DISTANCE)
+			return false;
+		last = (last + 1) & _mask;
+	}
+
+	while (last != ctr) {
+		const size_type prev = (last - 1) & _mask;
+		new ((void *)&_storage[last]._node) Node(Common::move(_storage[prev]._node));
+		_storage[prev]._node.~Node();
+		_storage[last]._distance = _storage[prev]._distance + 1;
+		last = prev;
+	}
+
+	_storage[ctr]._distance = distance;
+	_size++;
+
+	idx = ctr;
+	return true;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const uint32 hash = scrambledHash(key);
+	size_type ctr;
+	if (_size != 0) {
+		ctr = lookup(key, hash);
+		if (ctr != notFound())
+			return ctr;
+	}
+
+	// Keep the load factor below a certain threshold.
+	size_type capacity = this->capacity();
+	if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		expandStorage(MAX<size_type>(capacity, FLATHASHMAP_MIN_CAPACITY));
+	}
+
+	// Unlucky keys may produce overly long probe sequences even below the
+	// load factor. Growing the table spreads them out again.
+	if (!allocateBucket(hash >> _shift, ctr)) {
+		expandStorage(this->capacity() * 2);
+		if (!allocateBucket(hash >> _shift, ctr))
+			error("FlatHashMap: Too many hash collisions");
+	}
+
+	new ((void *)&_storage[ctr]._node) Node(key);
+	return ctr;
+}
+
+/**
+ * Internal method for removing an entry. The following entries of the probe
+ * sequence move one bucket closer to their home bucket.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseAt(size_type idx) {
+	_storage[idx]._node.~Node();
+
+	size_type next = (idx + 1) & _mask;
+	while (_storage[next]._distance > 1) {
+		new ((void *)&_storage[idx]._node) Node(Common::move(_storage[next]._node));
+		_storage[next]._node.~Node();
+		_storage[idx]._distance = _storage[next]._distance - 1;
+		idx = next;
+		next = (next + 1) & _mask;
+	}
+
+	_storage[idx]._distance = 0;
+	_size--;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != notFound();
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// The storage may be reallocated, so it must not be read before the lookup
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	return _storage[ctr]._node._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != notFound())
+		return _storage[ctr]._node._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != notFound())
+		return _storage[ctr]._node._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != notFound())
+		return _storage[ctr]._node._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != notFound()) {
+		out = _storage[ctr]._node._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	_storage[ctr]._node._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	assert(entry._idx < capacity());
+	assert(_storage[entry._idx]._distance != 0);
+
+	eraseAt(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != notFound())
+		eraseAt(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -20,11 +20,13 @@
  */
 
 #include "common/formats/ini-file.h"
+#include "common/array.h"
 #include "common/file.h"
 #include "common/savefile.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/macresman.h"
+#include "common/str-view.h"
 
 namespace Common {
 
@@ -98,23 +100,27 @@ bool INIFile::loadFromStream(SeekableReadStream &stream) {
 	int lineno = 0;
 	section.name = _defaultSectionName;
 
+	// Parse the file from memory. Only the names, values and comments
+	// which are stored are copied into strings.
+	Array<byte> buffer;
+	stream.readRemainingData(buffer);
+	StringView text((const char *)buffer.data(), buffer.size());
+
+	// Skip UTF-8 byte-order mark if added by a text editor.
+	if (text.hasPrefix(StringView((const char *)UTF8_BOM, sizeof(UTF8_BOM))))
+		text.removePrefix(sizeof(UTF8_BOM));
+
 	// TODO: Detect if a section occurs multiple times (or likewise, if
 	// a key occurs multiple times inside one section).
 
-	while (!stream.eos() && !stream.err()) {
+	while (!text.empty()) {
 		lineno++;
 
-		// Read a line
-		String line = stream.readLine();
-
-		// Skip UTF-8 byte-order mark if added by a text editor.
-		if (lineno == 1 && memcmp(line.c_str(), UTF8_BOM, 3) == 0) {
-			line.erase(0, 3);
-		}
-
-		line.trim();
+		// Read a line, which like a C string ends at a null character
+		StringView line = text.splitLine();
+		line = line.substr(0, line.find('\0')).trimmed();
 
-		if (line.size() == 0) {
+		if (line.empty()) {
 			// Do nothing
 		} else if (line[0] == '#' || line[0] == ';' || line.hasPrefix("//")) {
 			// Accumulate comments here. Once we encounter either the start
@@ -135,21 +141,21 @@ bool INIFile::loadFromStream(SeekableReadStream &stream) {
 			comment += "\n";
 		} else if (line[0] == '[') {
 			// It's a new section which begins here.
-			const char *p = line.c_str() + 1;
+			uint32 p = 1;
 			// Get the section name, and check whether it's valid (that
 			// is, verify that it only consists of alphanumerics,
 			// periods, dashes and underscores). Mohawk Living Books games
 			// can have periods in their section names.
 			// WinAGI games can have colons in their section names.
-			while (*p && ((_allowNonEnglishCharacters && *p != ']') || isAlnum(*p) || *p == '-' || *p == '_' || *p == '.' || *p == ' ' || *p == ':'))
+			while (p < line.size() && ((_allowNonEnglishCharacters && line[p] != ']') || isAlnum(line[p]) || line[p] == '-' || line[p] == '_' || line[p] == '.' || line[p] == ' ' || line[p] == ':'))
 				p++;
 
-			if (*p == '\0') {
+			if (p == line.size()) {
 				warning("INIFile::loadFromStream: missing ] in line %d", lineno);
 				return false;
 			}
-			else if (*p != ']') {
-				warning("INIFile::loadFromStream: Invalid character '%c' occurred in section name in line %d", *p, lineno);
+			else if (line[p] != ']') {
+				warning("INIFile::loadFromStream: Invalid character '%c' occurred in section name in line %d", line[p], lineno);
 				return false;
 			}
 
@@ -157,7 +163,7 @@ bool INIFile::loadFromStream(SeekableReadStream &stream) {
 			if (!section.name.empty())
 				_sections.push_back(section);
 
-			section.name = String(line.c_str() + 1, p);
+			section.name = line.substr(1, p - 1).toString();
 			section.keys.clear();
 			section.comment = comment;
 			comment.clear();
@@ -176,27 +182,23 @@ bool INIFile::loadFromStream(SeekableReadStream &stream) {
 			}
 
 			// Split string at '=' into 'key' and 'value'. First, find the "=" delimeter.
-			const char *p = strchr(line.c_str(), '=');
-			if (!p) {
+			const uint32 p = line.find('=');
+			if (p == StringView::npos) {
 				if (!_suppressValuelessLineWarning)
-					warning("Config file buggy: Junk found in line %d: '%s'", lineno, line.c_str());
+					warning("Config file buggy: Junk found in line %d: '%s'", lineno, line.toString().c_str());
 
 				// there is no '=' on this line. skip if delimiter is required.
 				if (_requireKeyValueDelimiter)
 					continue;
 
-				kv.key = line;
+				kv.key = line.toString();
 				kv.value.clear();
 			}  else {
-				// Extract the key/value pair
-				kv.key = String(line.c_str(), p);
-				kv.value = String(p + 1);
+				// Extract the key/value pair, without spaces
+				kv.key = line.substr(0, p).trimmed().toString();
+				kv.value = line.substr(p + 1).trimmed().toString();
 			}
 
-			// Trim of spaces
-			kv.key.trim();
-			kv.value.trim();
-
 			// Store comment
 			kv.comment = comment;
 			comment.clear();
@@ -44,6 +44,7 @@
  */
 
 #include "common/formats/json.h"
+#include "common/str-view.h"
 
 #ifdef __MINGW32__
 #define wcsncasecmp wcsnicmp
@@ -145,9 +146,19 @@ bool JSON::skipWhitespace(const char **data) {
 * @return bool Returns true on success, false on failure
 */
 bool JSON::extractString(const char **data, String &str) {
-	str = "";
+	str.clear();
 
 	while (**data != 0) {
+		// Copy the characters up to the next one which needs to be looked
+		// at all at once
+		const char *run = *data;
+		while (**data != 0 && **data != '\\' && **data != '"' && !(**data > 0 && **data < ' ' && **data != '\t'))
+			(*data)++;
+		str += StringView(run, *data);
+
+		if (**data == 0)
+			break;
+
 		// Save the char so we can change it if need be
 		char next_char = **data;
 		uint32 next_uchar = 0;
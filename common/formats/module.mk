@@ -13,7 +13,8 @@ MODULE_OBJS := \
 	winexe.o \
 	winexe_ne.o \
 	winexe_pe.o \
-	xmlparser.o
+	xmlparser.o \
+	xmlreader.o
 
 # Include common rules
 include $(srcdir)/rules.mk
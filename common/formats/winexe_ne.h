@@ -22,6 +22,7 @@
 #ifndef COMMON_WINEXE_NE_H
 #define COMMON_WINEXE_NE_H
 
+#include "common/array.h"
 #include "common/list.h"
 #include "common/str.h"
 #include "common/formats/winexe.h"
@@ -37,7 +38,6 @@ namespace Common {
  * @{
  */
 
-template<class T> class Array;
 class SeekableReadStream;
 
 /**
@@ -22,6 +22,7 @@
 #ifndef COMMON_WINEXE_PE_H
 #define COMMON_WINEXE_PE_H
 
+#include "common/array.h"
 #include "common/hash-str.h"
 #include "common/hashmap.h"
 #include "common/str.h"
@@ -38,7 +39,6 @@ namespace Common {
  * @{
  */
 
-template<class T> class Array;
 class SeekableReadStream;
 
 /**
@@ -22,17 +22,81 @@
 #include "common/formats/xmlparser.h"
 #include "common/archive.h"
 #include "common/fs.h"
-#include "common/memstream.h"
+#include "common/stream.h"
 #include "common/system.h"
 
 namespace Common {
 
+/** Builds the node stack of an XMLParser from the events of the reader. */
+class XMLParser::ReaderHandler : public XMLReader::Handler {
+public:
+	ReaderHandler(XMLParser &parser) : _parser(parser) {}
+
+	bool declaration(const XMLReader::AttributeList &attributes) override {
+		for (const XMLReader::Attribute &attribute : attributes) {
+			if (attribute.name == "version") {
+				if (attribute.value != "1.0")
+					return _parser.parserError("Unsupported XML version.");
+				return true;
+			}
+		}
+
+		return _parser.parserError("Missing XML version in XML header.");
+	}
+
+	bool startElement(const StringView &name, const XMLReader::AttributeList &attributes) override {
+		ParserNode *node = _parser.allocNode();
+		node->name = name.toString();
+		node->ignore = false;
+		node->header = false;
+		node->depth = _parser._activeKey.size();
+		node->layout = nullptr;
+		_parser._activeKey.push(node);
+
+		for (const XMLReader::Attribute &attribute : attributes) {
+			const String key = attribute.name.toString();
+			if (node->values.contains(key))
+				return _parser.parserError("Invalid key value.");
+			node->values.setVal(key, attribute.value.toString());
+		}
+
+		return _parser.parseActiveKey(false);
+	}
+
+	bool endElement(const StringView &name) override {
+		if (!_parser.closeKey()) {
+			if (_parser._state != kParserError)
+				_parser.parserError("Missing data when closing key '" + name.toString() + "'.");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool text(const StringView &text) override {
+		if (!_parser.textCallback(text.toString())) {
+			if (_parser._state != kParserError)
+				_parser.parserError("Failed to process text segment.");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool isValidNameChar(char c) override {
+		return _parser.isValidNameChar(c);
+	}
+
+private:
+	XMLParser &_parser;
+};
+
 XMLParser::~XMLParser() {
 	while (!_activeKey.empty())
 		freeNode(_activeKey.pop());
 
 	delete _XMLkeys;
-	delete _stream;
+	close();
 
 	for (auto *layout : _layoutList)
 		delete layout;
@@ -41,8 +105,7 @@ XMLParser::~XMLParser() {
 }
 
 bool XMLParser::loadFile(const Path &filename) {
-	_stream = SearchMan.createReadStreamForMember(filename);
-	if (!_stream)
+	if (!loadStream(SearchMan.createReadStreamForMember(filename)))
 		return false;
 
 	_fileName = filename;
@@ -50,8 +113,7 @@ bool XMLParser::loadFile(const Path &filename) {
 }
 
 bool XMLParser::loadFile(const FSNode &node) {
-	_stream = node.createReadStream();
-	if (!_stream)
+	if (!loadStream(node.createReadStream()))
 		return false;
 
 	_fileName = node.getName();
@@ -59,72 +121,80 @@ bool XMLParser::loadFile(const FSNode &node) {
 }
 
 bool XMLParser::loadBuffer(const byte *buffer, uint32 size, DisposeAfterUse::Flag disposable) {
-	_stream = new MemoryReadStream(buffer, size, disposable);
+	close();
+
+	_data = buffer;
+	_size = size;
+	_disposeData = disposable;
 	_fileName = "Memory Stream";
 	return true;
 }
 
 bool XMLParser::loadStream(SeekableReadStream *stream, const String &name) {
-	_stream = stream;
+	if (!stream)
+		return false;
+
+	close();
+
+	// Streams of unknown size are read until their end
+	stream->readRemainingData(_streamData);
+	const bool failed = stream->err();
+	delete stream;
+
+	if (failed) {
+		_streamData.clear();
+		return false;
+	}
+
+	// Keep the document null terminated, like the buffers of loadFile()
+	// used to be
+	_size = _streamData.size();
+	_streamData.push_back(0);
+	_data = _streamData.data();
 	_fileName = name;
-	return _stream != nullptr;
+	return true;
 }
 
 void XMLParser::close() {
-	delete _stream;
-	_stream = nullptr;
+	if (_disposeData == DisposeAfterUse::YES)
+		free(const_cast<byte *>(_data));
+
+	_streamData.clear();
+	_data = nullptr;
+	_size = 0;
+	_disposeData = DisposeAfterUse::NO;
 }
 
 bool XMLParser::parserError(const String &errStr) {
 	_state = kParserError;
 
-	const int startPosition = _stream->pos();
-	int currentPosition = startPosition;
-	int lineCount = 1;
-	char c = 0;
+	const char *text = (const char *)_data;
+	const bool compiled = XMLReader::isCompiled(text, _size);
+	const uint32 position = (_reader && !compiled) ? _reader->getPosition() : 0;
 
-	_stream->seek(0, SEEK_SET);
-
-	while (currentPosition--) {
-		c = _stream->readByte();
-
-		if (c == '\n' || c == '\r')
+	int lineCount = 1;
+	for (uint32 i = 0; i < position; ++i) {
+		if (text[i] == '\n' || text[i] == '\r')
 			lineCount++;
 	}
 
-	assert(_stream->pos() == startPosition);
-	currentPosition = startPosition;
-
-	Common::String errorMessage = Common::String::format("\n  File <%s>, line %d:\n", _fileName.toString().c_str(), lineCount);
-
-	if (startPosition > 1) {
-		int keyOpening = 0;
-		int keyClosing = 0;
-
-		while (currentPosition-- && keyOpening == 0) {
-			_stream->seek(-2, SEEK_CUR);
-			c = _stream->readByte();
-
-			if (c == '<')
-				keyOpening = currentPosition - 1;
-			else if (c == '>')
-				keyClosing = currentPosition;
-		}
-
-		_stream->seek(startPosition, SEEK_SET);
-		currentPosition = startPosition;
-		while (keyClosing == 0 && c && currentPosition++) {
-			c = _stream->readByte();
-
-			if (c == '>')
-				keyClosing = currentPosition;
+	Common::String errorMessage;
+	if (compiled)
+		errorMessage = Common::String::format("\n  File <%s> (compiled):\n", _fileName.toString().c_str());
+	else
+		errorMessage = Common::String::format("\n  File <%s>, line %d:\n", _fileName.toString().c_str(), lineCount);
+
+	if (position > 1) {
+		// Print the key in which the error occurred
+		const StringView before(text, position);
+		const StringView after(text + position, _size - position);
+		const uint32 keyOpening = before.rfind('<');
+		const uint32 keyClosing = after.find('>');
+
+		if (keyOpening != StringView::npos) {
+			errorMessage += before.substr(keyOpening);
+			errorMessage += after.substr(0, keyClosing == StringView::npos ? keyClosing : keyClosing + 1);
 		}
-
-		currentPosition = (keyClosing - keyOpening);
-		_stream->seek(keyOpening, SEEK_SET);
-
-		while (currentPosition--)
-			errorMessage += (char)_stream->readByte();
 	}
 
 	errorMessage += "\n\nParser error: ";
@@ -136,54 +206,36 @@ bool XMLParser::parserError(const String &errStr) {
 	return false;
 }
 
-bool XMLParser::parseXMLHeader(ParserNode *node) {
-	assert(node->header);
-
-	if (_activeKey.size() != 1)
-		return parserError("XML Header is expected in the global scope.");
-
-	if (!node->values.contains("version"))
-		return parserError("Missing XML version in XML header.");
-
-	if (node->values["version"] != "1.0")
-		return parserError("Unsupported XML version.");
-
-	return true;
-}
-
 bool XMLParser::parseActiveKey(bool closed) {
 	bool ignore = false;
 	assert(_activeKey.empty() == false);
 
 	ParserNode *key = _activeKey.top();
 
-	if (key->name == "xml" && key->header == true) {
-		assert(closed);
-		return parseXMLHeader(key) && closeKey();
-	}
-
 	XMLKeyLayout *layout = (_activeKey.size() == 1) ? _XMLkeys : getParentNode(key)->layout;
 
 	if (layout->children.contains(key->name)) {
 		key->layout = layout->children[key->name];
 
-		StringMap localMap = key->values;
-		int keyCount = localMap.size();
+		int keyCount = key->values.size();
 
 		for (const auto &prop : key->layout->properties) {
-			if (prop.required && !localMap.contains(prop.name))
-				return parserError("Missing required property '" + prop.name + "' inside key '" + key->name + "'");
-			else if (localMap.contains(prop.name)) {
+			if (key->values.contains(prop.name))
 				keyCount--;
-				localMap.erase(prop.name);
-			}
+			else if (prop.required)
+				return parserError("Missing required property '" + prop.name + "' inside key '" + key->name + "'");
 		}
 
 		if (keyCount > 0) {
 			Common::String missingKeys;
 
-			for (auto i = localMap.begin(); i != localMap.end(); ++i)
-				missingKeys += i->_key + ' ';
+			for (auto i = key->values.begin(); i != key->values.end(); ++i) {
+				bool known = false;
+				for (const auto &prop : key->layout->properties)
+					known = known || prop.name.equalsIgnoreCase(i->_key);
+				if (!known)
+					missingKeys += i->_key + ' ';
+			}
 
 			return parserError(Common::String::format("Unhandled property inside key '%s' (%s, %d items).", key->name.c_str(), missingKeys.c_str(), keyCount));
 		}
@@ -217,37 +269,6 @@ bool XMLParser::parseActiveKey(bool closed) {
 	return true;
 }
 
-bool XMLParser::parseKeyValue(String keyName) {
-	assert(_activeKey.empty() == false);
-
-	if (_activeKey.top()->values.contains(keyName))
-		return false;
-
-	_token.clear();
-	char stringStart;
-
-	if (_char == '"' || _char == '\'') {
-		stringStart = _char;
-		_char = _stream->readByte();
-
-		while (_char && _char != stringStart) {
-			_token += _char;
-			_char = _stream->readByte();
-		}
-
-		if (_char == 0)
-			return false;
-
-		_char = _stream->readByte();
-
-	} else if (!parseToken()) {
-		return false;
-	}
-
-	_activeKey.top()->values[keyName] = _token;
-	return true;
-}
-
 bool XMLParser::parseIntegerKey(const char *key, int count, ...) {
 	bool result;
 	va_list args;
@@ -307,12 +328,9 @@ bool XMLParser::closeKey() {
 }
 
 bool XMLParser::parse() {
-	if (_stream == nullptr)
+	if (_data == nullptr)
 		return false;
 
-	// Make sure we are at the start of the stream.
-	_stream->seek(0, SEEK_SET);
-
 	if (_XMLkeys == nullptr)
 		buildLayout();
 
@@ -321,226 +339,36 @@ bool XMLParser::parse() {
 
 	cleanup();
 
-	bool activeClosure = false;
-	bool activeHeader = false;
-	bool selfClosure;
-
-	_state = kParserNeedHeader;
-	_activeKey.clear();
-
-	_char = _stream->readByte();
-
-	while (_char && _state != kParserError) {
-		if (skipSpaces())
-			continue;
-
-		if (skipComments())
-			continue;
-
-		switch (_state) {
-		case kParserNeedHeader:
-		case kParserNeedKey:
-			if (_char != '<') {
-				if (_allowText) {
-					Common::String text;
-					do {
-						text += _char;
-						_char = _stream->readByte();
-					} while (_char != '<' && _char);
-					if (!_char) {
-						parserError("Unexpected end of file.");
-						break;
-					}
-					if (!textCallback(text)) {
-						parserError("Failed to process text segment.");
-						break;
-					}
-				} else {
-					parserError("Parser expecting key start.");
-					break;
-				}
-			}
-
-			if ((_char = _stream->readByte()) == 0) {
-				parserError("Unexpected end of file.");
-				break;
-			}
-
-			if (_state == kParserNeedHeader) {
-				if (_char != '?') {
-					parserError("Expecting XML header.");
-					break;
-				}
-
-				_char = _stream->readByte();
-				activeHeader = true;
-			} else if (_char == '/') {
-				_char = _stream->readByte();
-				activeClosure = true;
-			} else if (_char == '?') {
-				parserError("Unexpected header. There may only be one XML header per file.");
-				break;
-			}
-
-			_state = kParserNeedKeyName;
-			break;
-
-		case kParserNeedKeyName:
-			if (!parseToken()) {
-				parserError("Invalid key name.");
-				break;
-			}
-
-			if (activeClosure) {
-				if (_activeKey.empty() || _token != _activeKey.top()->name) {
-					parserError("Unexpected closure.");
-					break;
-				}
-			} else {
-				ParserNode *node = allocNode(); // new ParserNode;
-				node->name = _token;
-				node->ignore = false;
-				node->header = activeHeader;
-				node->depth = _activeKey.size();
-				node->layout = nullptr;
-				_activeKey.push(node);
-			}
-
-			_state = kParserNeedPropertyName;
-			break;
-
-		case kParserNeedPropertyName:
-			if (activeClosure) {
-				if (!closeKey()) {
-					parserError("Missing data when closing key '" + _activeKey.top()->name + "'.");
-					break;
-				}
-
-				activeClosure = false;
-
-				if (_char != '>')
-					parserError("Invalid syntax in key closure.");
-				else
-					_state = kParserNeedKey;
-
-				_char = _stream->readByte();
-				break;
-			}
-
-			selfClosure = false;
-
-			if (_char == '/' || (_char == '?' && activeHeader)) {
-				selfClosure = true;
-				_char = _stream->readByte();
-			}
-
-			if (_char == '>') {
-				if (activeHeader && !selfClosure) {
-					parserError("XML Header must be self-closed.");
-				} else if (parseActiveKey(selfClosure)) {
-					_char = _stream->readByte();
-					_state = kParserNeedKey;
-				}
-
-				activeHeader = false;
-				break;
-			}
-
-			if (selfClosure)
-				parserError("Expecting key closure after '/' symbol.");
-			else if (!parseToken())
-				parserError("Error when parsing key value.");
-			else
-				_state = kParserNeedPropertyOperator;
-
-			break;
-
-		case kParserNeedPropertyOperator:
-			if (_char != '=')
-				parserError("Syntax error after key name.");
-			else
-				_state = kParserNeedPropertyValue;
+	XMLReader reader((const char *)_data, _size);
+	ReaderHandler handler(*this);
 
-			_char = _stream->readByte();
-			break;
+	reader.setAllowText(_allowText);
+	_reader = &reader;
+	_state = kParserNeedKey;
 
-		case kParserNeedPropertyValue:
-			if (!parseKeyValue(_token))
-				parserError("Invalid key value.");
-			else
-				_state = kParserNeedPropertyName;
+	if (!reader.parse(handler) && _state != kParserError)
+		parserError(reader.getError());
 
-			break;
+	_reader = nullptr;
 
-		default:
-			break;
-		}
-	}
+	if (_state == kParserError) {
+		// Don't leave the keys of the broken document to the next parse
+		while (!_activeKey.empty())
+			freeNode(_activeKey.pop());
 
-	if (_state == kParserError)
 		return false;
-
-	if (_state != kParserNeedKey || !_activeKey.empty())
-		return parserError("Unexpected end of file.");
+	}
 
 	return true;
 }
 
-bool XMLParser::skipSpaces() {
-	if (!isSpace(_char))
+bool XMLParser::compile(WriteStream &stream) {
+	if (_data == nullptr)
 		return false;
 
-	while (_char && isSpace(_char))
-		_char = _stream->readByte();
-
-	return true;
-}
-
-bool XMLParser::skipComments() {
-	if (_char == '<') {
-		_char = _stream->readByte();
-
-		if (_char != '!') {
-			_stream->seek(-1, SEEK_CUR);
-			_char = '<';
-			return false;
-		}
-
-		if (_stream->readByte() != '-' || _stream->readByte() != '-')
-			return parserError("Malformed comment syntax.");
-
-		_char = _stream->readByte();
-
-		while (_char) {
-			if (_char == '-') {
-				if (_stream->readByte() == '-') {
-
-					if (_stream->readByte() != '>')
-						return parserError("Malformed comment (double-hyphen inside comment body).");
-
-					_char = _stream->readByte();
-					return true;
-				}
-			}
-
-			_char = _stream->readByte();
-		}
-
-		return parserError("Comment has no closure.");
-	}
-
-	return false;
-}
-
-bool XMLParser::parseToken() {
-	_token.clear();
-
-	while (isValidNameChar(_char)) {
-		_token += _char;
-		_char = _stream->readByte();
-	}
-
-	return isSpace(_char) != 0 || _char == '>' || _char == '=' || _char == '/';
+	XMLReader reader((const char *)_data, _size);
+	reader.setAllowText(_allowText);
+	return reader.compile(stream);
 }
 
 } // End of namespace Common
@@ -31,6 +31,7 @@
 #include "common/hash-str.h"
 #include "common/stack.h"
 #include "common/memorypool.h"
+#include "common/formats/xmlreader.h"
 
 
 namespace Common {
@@ -45,6 +46,7 @@ namespace Common {
  */
 
 class SeekableReadStream;
+class WriteStream;
 
 #define MAX_XML_DEPTH 8
 
@@ -100,7 +102,7 @@ public:
 	/**
 	 * Parser constructor.
 	 */
-	XMLParser() : _XMLkeys(nullptr), _stream(nullptr), _allowText(false), _char(0) {}
+	XMLParser() : _XMLkeys(nullptr), _allowText(false), _data(nullptr), _size(0), _disposeData(DisposeAfterUse::NO), _reader(nullptr), _state(kParserNeedHeader) {}
 
 	virtual ~XMLParser();
 
@@ -177,6 +179,9 @@ public:
 	 * Used for loading the default theme fallback directly
 	 * from memory if no themes can be found.
 	 *
+	 * The buffer may also hold a document compiled with
+	 * XMLReader::compile(), which is parsed much faster.
+	 *
 	 * @param buffer Pointer to the buffer.
 	 * @param size Size of the buffer
 	 * @param disposable Sets if the XMLParser owns the buffer,
@@ -185,6 +190,10 @@ public:
 	 */
 	bool loadBuffer(const byte *buffer, uint32 size, DisposeAfterUse::Flag disposable = DisposeAfterUse::NO);
 
+	/**
+	 * Loads the contents of a stream into the parser. The stream is read
+	 * into memory at once and deleted afterwards.
+	 */
 	bool loadStream(SeekableReadStream *stream, const String &name = "File Stream");
 
 	void close();
@@ -195,6 +204,14 @@ public:
 	 */
 	bool parse();
 
+	/**
+	 * Writes the loaded document to a stream in the compiled form of
+	 * XMLReader. When the compiled document is loaded with loadBuffer()
+	 * later, it is parsed much faster than the original one.
+	 * Returns true if the document was valid and could be written.
+	 */
+	bool compile(WriteStream &stream);
+
 	/**
 	 * Returns the active node being parsed (the one on top of
 	 * the node stack).
@@ -287,11 +304,6 @@ protected:
 	 */
 	bool closeKey();
 
-	/**
-	 * Parses the value of a given key. There's no reason to overload this.
-	 */
-	bool parseKeyValue(String keyName);
-
 	/**
 	 * Called once a key has been parsed. It handles the closing/cleanup of the
 	 * node stack and calls the keyCallback.
@@ -305,18 +317,6 @@ protected:
 	 */
 	bool parserError(const String &errStr);
 
-	/**
-	 * Skips spaces/whitelines etc.
-	 * @return true if any spaces were skipped.
-	 */
-	bool skipSpaces();
-
-	/**
-	 * Skips comment blocks and comment lines.
-	 * @return true if any comments were skipped.
-	 */
-	bool skipComments();
-
 	/**
 	 * Check if a given character can be part of a KEY or VALUE name.
 	 * Overload this if you want to support keys with strange characters
@@ -326,11 +326,6 @@ protected:
 		return isAlnum(c) || c == '_';
 	}
 
-	/**
-	 * Parses a the first textual token found.
-	 */
-	bool parseToken();
-
 	/**
 	 * Parses the values inside an integer key.
 	 * The count parameter specifies the number of values inside
@@ -353,8 +348,6 @@ protected:
 	bool parseIntegerKey(const String &keyStr, int count, ...);
 	bool vparseIntegerKey(const char *key, int count, va_list args);
 
-	bool parseXMLHeader(ParserNode *node);
-
 	/**
 	 * Overload if your parser needs to support parsing the same file
 	 * several times, so you can clean up the internal state of the
@@ -374,16 +367,18 @@ protected:
 	List<XMLKeyLayout *> _layoutList;
 
 private:
-	char _char;
+	class ReaderHandler;
+
 	bool _allowText; /** Allow text nodes in the doc (default false) */
-	SeekableReadStream *_stream;
+	const byte *_data; /** The loaded document */
+	uint32 _size;
+	DisposeAfterUse::Flag _disposeData;
+	Array<byte> _streamData; /** The document, if it was read from a stream */
 	Path _fileName;
 
+	XMLReader *_reader; /** The reader of the document while it is parsed */
 	ParserState _state; /** Internal state of the parser */
 
-	String _error; /** Current error message */
-	String _token; /** Current text token */
-
 	Stack<ParserNode *> _activeKey; /** Node stack of the parsed keys */
 };
 
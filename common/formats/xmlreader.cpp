@@ -0,0 +1,488 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/formats/xmlreader.h"
+#include "common/endian.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/memstream.h"
+
+namespace Common {
+
+/*
+ * Compiled documents start with a header:
+ *   uint32 tag, uint32 version, uint32 size of the string table,
+ *   uint32 size of the events
+ * followed by the string table, which holds every name, value and text
+ * once:
+ *   uint32 length, characters, terminating zero
+ * and the events:
+ *   byte event type, event data
+ * Strings are referenced by their offset in the string table. All numbers
+ * are stored in big endian.
+ */
+#define XML_COMPILED_TAG     MKTAG('X', 'M', 'L', 'C')
+#define XML_COMPILED_VERSION 1
+
+enum CompiledEvent {
+	kCompiledDeclaration = 0, // byte attribute count, (uint32 name, uint32 value) per attribute
+	kCompiledStartElement = 1, // uint32 name, byte attribute count, attributes as above
+	kCompiledEndElement = 2,
+	kCompiledText = 3 // uint32 text
+};
+
+namespace {
+
+/** Records the events of a document in the compiled form. */
+class XMLCompiler : public XMLReader::Handler {
+public:
+	XMLCompiler() : _strings(DisposeAfterUse::YES), _events(DisposeAfterUse::YES) {}
+
+	bool declaration(const XMLReader::AttributeList &attributes) override {
+		_events.writeByte(kCompiledDeclaration);
+		return writeAttributes(attributes);
+	}
+
+	bool startElement(const StringView &name, const XMLReader::AttributeList &attributes) override {
+		_events.writeByte(kCompiledStartElement);
+		_events.writeUint32BE(addString(name));
+		return writeAttributes(attributes);
+	}
+
+	bool endElement(const StringView &name) override {
+		_events.writeByte(kCompiledEndElement);
+		return true;
+	}
+
+	bool text(const StringView &text) override {
+		_events.writeByte(kCompiledText);
+		_events.writeUint32BE(addString(text));
+		return true;
+	}
+
+	void write(WriteStream &stream) {
+		stream.writeUint32BE(XML_COMPILED_TAG);
+		stream.writeUint32BE(XML_COMPILED_VERSION);
+		stream.writeUint32BE(_strings.size());
+		stream.writeUint32BE(_events.size());
+		stream.write(_strings.getData(), _strings.size());
+		stream.write(_events.getData(), _events.size());
+	}
+
+private:
+	bool writeAttributes(const XMLReader::AttributeList &attributes) {
+		if (attributes.size() > 0xFF)
+			return false;
+
+		_events.writeByte(attributes.size());
+		for (const XMLReader::Attribute &attribute : attributes) {
+			_events.writeUint32BE(addString(attribute.name));
+			_events.writeUint32BE(addString(attribute.value));
+		}
+		return true;
+	}
+
+	uint32 addString(const StringView &str) {
+		const String key = str.toString();
+		HashMap<String, uint32>::const_iterator i = _offsets.find(key);
+		if (i != _offsets.end())
+			return i->_value;
+
+		const uint32 offset = _strings.size();
+		_strings.writeUint32BE(str.size());
+		_strings.write(str.data(), str.size());
+		_strings.writeByte(0);
+		_offsets[key] = offset;
+		return offset;
+	}
+
+	HashMap<String, uint32> _offsets;
+	MemoryWriteStreamDynamic _strings;
+	MemoryWriteStreamDynamic _events;
+};
+
+/** Reads the parts of a compiled document, checking that they are within the data. */
+class CompiledDataReader {
+public:
+	CompiledDataReader(const byte *data, uint32 size) : _data(data), _size(size), _pos(0), _strings(nullptr), _stringsSize(0) {}
+
+	bool readHeader() {
+		uint32 tag, version, eventsSize;
+		if (!readUint32(tag) || !readUint32(version) || !readUint32(_stringsSize) || !readUint32(eventsSize))
+			return false;
+		if (tag != XML_COMPILED_TAG || version != XML_COMPILED_VERSION)
+			return false;
+		if (_stringsSize > _size - _pos || eventsSize != _size - _pos - _stringsSize)
+			return false;
+
+		_strings = _data + _pos;
+		_pos += _stringsSize;
+		return true;
+	}
+
+	bool atEnd() const { return _pos == _size; }
+
+	bool readByte(byte &value) {
+		if (_pos >= _size)
+			return false;
+		value = _data[_pos++];
+		return true;
+	}
+
+	bool readUint32(uint32 &value) {
+		if (_size - _pos < 4)
+			return false;
+		value = READ_BE_UINT32(_data + _pos);
+		_pos += 4;
+		return true;
+	}
+
+	bool readString(StringView &str) {
+		uint32 offset, length;
+		if (!readUint32(offset) || offset > _stringsSize || _stringsSize - offset < 4)
+			return false;
+		length = READ_BE_UINT32(_strings + offset);
+		if (length >= _stringsSize - offset - 4)
+			return false;
+		str = StringView((const char *)_strings + offset + 4, length);
+		return true;
+	}
+
+	bool readAttributes(XMLReader::AttributeList &attributes) {
+		byte count;
+		if (!readByte(count))
+			return false;
+
+		attributes.resize(count);
+		for (XMLReader::Attribute &attribute : attributes) {
+			if (!readString(attribute.name) || !readString(attribute.value))
+				return false;
+		}
+		return true;
+	}
+
+private:
+	const byte *_data;
+	uint32 _size;
+	uint32 _pos;
+
+	const byte *_strings;
+	uint32 _stringsSize;
+};
+
+} // End of anonymous namespace
+
+XMLReader::XMLReader(const char *data, uint32 size) :
+	_data(data), _end(data + size), _pos(data), _allowText(false) {
+}
+
+bool XMLReader::isCompiled(const char *data, uint32 size) {
+	return size >= 4 && READ_BE_UINT32(data) == XML_COMPILED_TAG;
+}
+
+bool XMLReader::parse(Handler &handler) {
+	_pos = _data;
+	_error.clear();
+	_openElements.clear();
+
+	if (isCompiled(_data, _end - _data))
+		return parseCompiled(handler);
+
+	return parseText(handler);
+}
+
+bool XMLReader::compile(WriteStream &stream) {
+	XMLCompiler compiler;
+	if (!parse(compiler)) {
+		if (_error.empty())
+			_error = "Too many attributes.";
+		return false;
+	}
+
+	compiler.write(stream);
+	return !stream.err();
+}
+
+bool XMLReader::parseText(Handler &handler) {
+	bool needHeader = true;
+
+	while (true) {
+		if (!skipSpacesAndComments())
+			return false;
+
+		if (!peek())
+			break;
+
+		if (peek() != '<') {
+			if (!_allowText)
+				return error("Parser expecting key start.");
+
+			const char *start = _pos;
+			while (peek() && peek() != '<')
+				_pos++;
+
+			if (!peek())
+				return error("Unexpected end of file.");
+
+			if (!handler.text(StringView(start, _pos)))
+				return false;
+		}
+
+		_pos++;
+
+		if (needHeader) {
+			if (peek() != '?')
+				return error("Expecting XML header.");
+
+			_pos++;
+			if (!parseTag(handler, true))
+				return false;
+			needHeader = false;
+		} else if (peek() == '?') {
+			return error("Unexpected header. There may only be one XML header per file.");
+		} else if (peek() == '/') {
+			_pos++;
+			if (!parseClosingTag(handler))
+				return false;
+		} else if (!parseTag(handler, false)) {
+			return false;
+		}
+	}
+
+	if (needHeader || !_openElements.empty())
+		return error("Unexpected end of file.");
+
+	return true;
+}
+
+bool XMLReader::parseCompiled(Handler &handler) {
+	CompiledDataReader reader((const byte *)_data, _end - _data);
+	AttributeList attributes;
+	StringView name;
+	byte event;
+
+	if (!reader.readHeader())
+		return error("Invalid compiled XML data.");
+
+	while (!reader.atEnd()) {
+		if (!reader.readByte(event))
+			return error("Invalid compiled XML data.");
+
+		switch (event) {
+		case kCompiledDeclaration:
+			if (!reader.readAttributes(attributes))
+				return error("Invalid compiled XML data.");
+			if (!handler.declaration(attributes))
+				return false;
+			break;
+
+		case kCompiledStartElement:
+			if (!reader.readString(name) || !reader.readAttributes(attributes))
+				return error("Invalid compiled XML data.");
+			_openElements.push_back(name);
+			if (!handler.startElement(name, attributes))
+				return false;
+			break;
+
+		case kCompiledEndElement:
+			if (_openElements.empty())
+				return error("Invalid compiled XML data.");
+			name = _openElements.back();
+			_openElements.pop_back();
+			if (!handler.endElement(name))
+				return false;
+			break;
+
+		case kCompiledText:
+			if (!reader.readString(name))
+				return error("Invalid compiled XML data.");
+			if (!handler.text(name))
+				return false;
+			break;
+
+		default:
+			return error("Invalid compiled XML data.");
+		}
+	}
+
+	if (!_openElements.empty())
+		return error("Invalid compiled XML data.");
+
+	return true;
+}
+
+bool XMLReader::parseTag(Handler &handler, bool header) {
+	StringView name;
+	AttributeList attributes;
+	bool selfClosed;
+
+	if (!skipSpacesAndComments())
+		return false;
+
+	if (!parseName(handler, name) || (header && name != "xml"))
+		return error(header ? "Expecting XML header." : "Invalid key name.");
+
+	if (!parseAttributes(handler, attributes, header, selfClosed))
+		return false;
+
+	if (header)
+		return handler.declaration(attributes);
+
+	_openElements.push_back(name);
+	if (!handler.startElement(name, attributes))
+		return false;
+
+	if (selfClosed) {
+		_openElements.pop_back();
+		return handler.endElement(name);
+	}
+
+	return true;
+}
+
+bool XMLReader::parseClosingTag(Handler &handler) {
+	StringView name;
+
+	if (!skipSpacesAndComments())
+		return false;
+
+	if (!parseName(handler, name))
+		return error("Invalid key name.");
+
+	if (_openElements.empty() || name != _openElements.back())
+		return error("Unexpected closure.");
+
+	if (!skipSpacesAndComments())
+		return false;
+
+	if (peek() != '>')
+		return error("Invalid syntax in key closure.");
+
+	_pos++;
+	_openElements.pop_back();
+	return handler.endElement(name);
+}
+
+bool XMLReader::parseAttributes(Handler &handler, AttributeList &attributes, bool header, bool &selfClosed) {
+	while (true) {
+		if (!skipSpacesAndComments())
+			return false;
+
+		const char c = peek();
+
+		if (c == '/' || (c == '?' && header)) {
+			_pos++;
+			if (peek() != '>')
+				return error("Expecting key closure after '/' symbol.");
+
+			_pos++;
+			selfClosed = true;
+			return true;
+		}
+
+		if (c == '>') {
+			if (header)
+				return error("XML Header must be self-closed.");
+
+			_pos++;
+			selfClosed = false;
+			return true;
+		}
+
+		if (!c)
+			return error("Unexpected end of file.");
+
+		Attribute attribute;
+		if (!parseName(handler, attribute.name))
+			return error("Error when parsing key value.");
+
+		if (!skipSpacesAndComments())
+			return false;
+
+		if (peek() != '=')
+			return error("Syntax error after key name.");
+
+		_pos++;
+
+		if (!skipSpacesAndComments())
+			return false;
+
+		if (!parseValue(handler, attribute.value))
+			return error("Invalid key value.");
+
+		attributes.push_back(attribute);
+	}
+}
+
+bool XMLReader::parseName(Handler &handler, StringView &name) {
+	const char *start = _pos;
+	while (_pos < _end && handler.isValidNameChar(*_pos))
+		_pos++;
+
+	name = StringView(start, _pos);
+
+	const char c = peek();
+	return !name.empty() && (isSpace(c) || c == '>' || c == '=' || c == '/' || c == '?');
+}
+
+bool XMLReader::parseValue(Handler &handler, StringView &value) {
+	const char quote = peek();
+	if (quote != '"' && quote != '\'')
+		return parseName(handler, value);
+
+	const char *start = ++_pos;
+	while (peek() && peek() != quote)
+		_pos++;
+
+	if (!peek())
+		return false;
+
+	value = StringView(start, _pos);
+	_pos++;
+	return true;
+}
+
+bool XMLReader::skipSpacesAndComments() {
+	while (true) {
+		while (isSpace(peek()))
+			_pos++;
+
+		if (peek() != '<' || peek(1) != '!')
+			return true;
+
+		if (peek(2) != '-' || peek(3) != '-')
+			return error("Malformed comment syntax.");
+
+		_pos += 4;
+		while (peek() != '-' || peek(1) != '-') {
+			if (!peek())
+				return error("Comment has no closure.");
+			_pos++;
+		}
+
+		if (peek(2) != '>')
+			return error("Malformed comment (double-hyphen inside comment body).");
+
+		_pos += 3;
+	}
+}
+
+} // End of namespace Common
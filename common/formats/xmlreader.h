@@ -0,0 +1,158 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_XMLREADER_H
+#define COMMON_XMLREADER_H
+
+#include "common/scummsys.h"
+#include "common/smallarray.h"
+#include "common/str-view.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_xmlreader XML reader
+ * @ingroup common
+ *
+ * @brief Event based reader for XML-like files held in memory.
+ *
+ * @{
+ */
+
+class WriteStream;
+
+/**
+ * XMLReader walks over an XML-like document in memory and reports what it
+ * finds to a Handler, one event per element, end of element and text node.
+ * Names, attributes and texts are passed as views into the document, so no
+ * memory is allocated for them. They are only valid during the callback.
+ *
+ * The reader accepts the same subset of XML as XMLParser: The document must
+ * start with an XML declaration, comments may appear between any two tokens,
+ * and entities are not expanded.
+ *
+ * A document can also be compiled into a binary form with compile(). The
+ * compiled form contains the same events, but can be read back without any
+ * parsing. parse() detects compiled documents and handles both forms.
+ */
+class XMLReader {
+public:
+	struct Attribute {
+		StringView name;
+		StringView value;
+	};
+
+	typedef SmallArray<Attribute, 16> AttributeList;
+
+	/**
+	 * Receives the events of a document. Returning false from any of the
+	 * callbacks stops the reader.
+	 */
+	class Handler {
+	public:
+		virtual ~Handler() {}
+
+		/** Called for the XML declaration at the start of the document. */
+		virtual bool declaration(const AttributeList &attributes) { return true; }
+
+		/** Called for the start tag of an element. */
+		virtual bool startElement(const StringView &name, const AttributeList &attributes) = 0;
+
+		/** Called at the end of an element. Self-closed elements get this right after startElement(). */
+		virtual bool endElement(const StringView &name) = 0;
+
+		/** Called for text between tags, if the reader allows them. */
+		virtual bool text(const StringView &text) { return true; }
+
+		/** Checks if @p c can be part of an element, attribute or unquoted value name. */
+		virtual bool isValidNameChar(char c) { return isAlnum(c) || c == '_'; }
+	};
+
+	/**
+	 * Create a reader for the document in @p data. The data is not copied,
+	 * so it must stay valid as long as the reader is used.
+	 */
+	XMLReader(const char *data, uint32 size);
+
+	/**
+	 * Allow text nodes in the document. By default, all data must be in
+	 * attributes, and text is a syntax error.
+	 */
+	void setAllowText(bool allow) { _allowText = allow; }
+
+	/**
+	 * Read the whole document and pass its contents to @p handler.
+	 *
+	 * @return True if the document was valid and no callback failed.
+	 */
+	bool parse(Handler &handler);
+
+	/**
+	 * Parse the document and write its compiled form to @p stream.
+	 *
+	 * @return True if the document was valid.
+	 */
+	bool compile(WriteStream &stream);
+
+	/** Check if @p data holds a compiled document. */
+	static bool isCompiled(const char *data, uint32 size);
+
+	/** The offset of the character the reader is at, within the document. */
+	uint32 getPosition() const { return _pos - _data; }
+
+	/** The reason parse() failed, or an empty string if a callback stopped it. */
+	const String &getError() const { return _error; }
+
+private:
+	bool parseText(Handler &handler);
+	bool parseCompiled(Handler &handler);
+
+	bool parseTag(Handler &handler, bool header);
+	bool parseClosingTag(Handler &handler);
+	bool parseAttributes(Handler &handler, AttributeList &attributes, bool header, bool &selfClosed);
+	bool parseName(Handler &handler, StringView &name);
+	bool parseValue(Handler &handler, StringView &value);
+	bool skipSpacesAndComments();
+
+	char peek(uint32 offset = 0) const {
+		return (_pos + offset < _end) ? _pos[offset] : 0;
+	}
+
+	bool error(const char *message) {
+		_error = message;
+		return false;
+	}
+
+	const char *_data;
+	const char *_end;
+	const char *_pos;
+
+	bool _allowText;
+	String _error;
+
+	SmallArray<StringView, 16> _openElements;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -23,6 +23,7 @@
 #include "common/debug.h"
 #include "common/punycode.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 #include "backends/fs/abstract-fs.h"
 #include "backends/fs/fs-factory.h"
 
@@ -31,7 +32,7 @@ namespace Common {
 // File-in-directory archive member that captures relative path
 class FSDirectoryFile : public ArchiveMember {
 public:
-	FSDirectoryFile(const Common::Path &pathInDirectory, const FSNode &fsNode);
+	FSDirectoryFile(const Common::Path &pathInDirectory, const FSNode &fsNode, bool mapFile);
 
 	SeekableReadStream *createReadStream() const override;
 	SeekableReadStream *createReadStreamForAltStream(AltStreamType altStreamType) const override;
@@ -45,14 +46,15 @@ public:
 private:
 	Common::Path _pathInDirectory;
 	FSNode _fsNode;
+	bool _mapFile;
 };
 
-FSDirectoryFile::FSDirectoryFile(const Common::Path &pathInDirectory, const FSNode &fsNode)
-	: _pathInDirectory(pathInDirectory), _fsNode(fsNode) {
+FSDirectoryFile::FSDirectoryFile(const Common::Path &pathInDirectory, const FSNode &fsNode, bool mapFile)
+	: _pathInDirectory(pathInDirectory), _fsNode(fsNode), _mapFile(mapFile) {
 }
 
 SeekableReadStream *FSDirectoryFile::createReadStream() const {
-	return _fsNode.createReadStream();
+	return _mapFile ? _fsNode.createMappedReadStream() : _fsNode.createReadStream();
 }
 
 SeekableReadStream *FSDirectoryFile::createReadStreamForAltStream(AltStreamType altStreamType) const {
@@ -95,7 +97,7 @@ void FSDirectoryFile::listChildren(ArchiveMemberList &list, const char *pattern)
 
 		Common::Path subPath = _pathInDirectory.appendComponent(fileName);
 
-		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(subPath, fsNode)));
+		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(subPath, fsNode, _mapFile)));
 	}
 }
 
@@ -233,6 +235,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getSizeAndModificationTime(int64 &size, int64 &modificationTime) const {
+	return _realNode && _realNode->getSizeAndModificationTime(size, modificationTime);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -248,6 +254,21 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createMappedReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createMappedReadStream: '%s' does not exist", getName().c_str());
+		return nullptr;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createMappedReadStream: '%s' is a directory", getName().c_str());
+		return nullptr;
+	}
+
+	return _realNode->createMappedReadStream();
+}
+
 SeekableReadStream *FSNode::createReadStreamForAltStream(AltStreamType altStreamType) const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -291,28 +312,43 @@ bool FSNode::createDirectory() const {
 	return _realNode->createDirectory();
 }
 
+enum {
+	/** Number of threads which list directories at the same time */
+	kListThreads = 4
+};
+
+static void listDirectoryProc(void *data, uint index) {
+	FSDirectoryListing &dir = ((FSDirectoryListing *)data)[index];
+	dir.listed = dir.node.getChildren(dir.files, FSNode::kListAll);
+}
+
+void listDirectories(Array<FSDirectoryListing> &dirs, uint first) {
+	if (first < dirs.size())
+		runParallel(listDirectoryProc, &dirs[first], dirs.size() - first, kListThreads);
+}
+
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 }
 
 FSDirectory::FSDirectory(const Path &prefix, const FSNode &node, int depth, bool flat,
 						 bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 
 	setPrefix(prefix);
 }
 
 FSDirectory::FSDirectory(const Path &name, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 }
 
 FSDirectory::FSDirectory(const Path &prefix, const Path &name, int depth, bool flat,
 						 bool ignoreClashes, bool includeDirectories)
   : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 
 	setPrefix(prefix);
 }
@@ -344,8 +380,9 @@ bool FSDirectory::hasFile(const Path &path) const {
 	if (path.empty() || !_node.isDirectory())
 		return false;
 
-	FSNode *node = lookupCache(_fileCache, path);
-	return node && node->exists();
+	// The cache is filled from directory listings, so there is no need to
+	// query the file system for each of its nodes again
+	return lookupCache(_fileCache, path) != nullptr;
 }
 
 bool FSDirectory::isPathDirectory(const Path &path) const {
@@ -362,7 +399,7 @@ const ArchiveMemberPtr FSDirectory::getMember(const Path &path) const {
 
 	FSNode *node = lookupCache(_fileCache, path);
 
-	if (!node || !node->exists()) {
+	if (!node) {
 		warning("FSDirectory::getMember: '%s' does not exist", Common::toPrintable(path.toString(Common::Path::kNativeSeparator)).c_str());
 		return ArchiveMemberPtr();
 	} else if (node->isDirectory()) {
@@ -370,7 +407,7 @@ const ArchiveMemberPtr FSDirectory::getMember(const Path &path) const {
 		return ArchiveMemberPtr();
 	}
 
-	return ArchiveMemberPtr(new FSDirectoryFile(path, *node));
+	return ArchiveMemberPtr(new FSDirectoryFile(path, *node, _mapFiles));
 }
 
 SeekableReadStream *FSDirectory::createReadStreamForMember(const Path &path) const {
@@ -383,7 +420,7 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const Path &path) con
 
 	debug(5, "FSDirectory::createReadStreamForMember('%s') -> '%s'", path.toString(Common::Path::kNativeSeparator).c_str(), node->getPath().toString(Common::Path::kNativeSeparator).c_str());
 
-	SeekableReadStream *stream = node->createReadStream();
+	SeekableReadStream *stream = _mapFiles ? node->createMappedReadStream() : node->createReadStream();
 	if (!stream)
 		warning("FSDirectory::createReadStreamForMember: Can't create stream for file '%s'", Common::toPrintable(path.toString(Common::Path::kNativeSeparator)).c_str());
 
@@ -420,7 +457,9 @@ FSDirectory *FSDirectory::getSubDirectory(const Path &prefix, const Path &name,
 	if (!node)
 		return nullptr;
 
-	return new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
+	FSDirectory *dir = new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
+	dir->_mapFiles = _mapFiles;
+	return dir;
 }
 
 void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix) const {
@@ -473,6 +512,14 @@ void FSDirectory::ensureCached() const  {
 	_cached = true;
 }
 
+void FSDirectory::invalidateCache() {
+	_fileCache.clear();
+	_subDirCache.clear();
+	_fileMapCache.clear();
+	_dirMapCache.clear();
+	_cached = false;
+}
+
 bool FSDirectory::getChildren(const Common::Path &path, Common::Array<Common::String> &list, ListMode mode, bool hidden) const {
 	if (!_node.isDirectory())
 		return 0;
@@ -530,7 +577,7 @@ int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const Path &patter
 				isMatch = it._key.matchPattern(pattern);
 
 			if (isMatch) {
-				list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it._key, it._value)));
+				list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it._key, it._value, _mapFiles)));
 				++matches;
 			}
 		}
@@ -553,13 +600,13 @@ int FSDirectory::listMembers(ArchiveMemberList &list) const {
 
 	int files = 0;
 	for (const auto &it : _fileCache) {
-		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it._key, it._value)));
+		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it._key, it._value, _mapFiles)));
 		++files;
 	}
 
 	if (_includeDirectories) {
 		for (const auto &it : _subDirCache) {
-			list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it._key, it._value)));
+			list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it._key, it._value, _mapFiles)));
 			++files;
 		}
 	}
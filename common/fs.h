@@ -252,6 +252,18 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Obtain the size and the time of the last modification of the file
+	 * referred by this node, without opening it.
+	 *
+	 * @param size              Size of the file in bytes.
+	 * @param modificationTime  Time of the last modification in seconds since the Unix epoch.
+	 *
+	 * @return True on success, false if the file does not exist or the
+	 *         file system does not provide this information.
+	 */
+	bool getSizeAndModificationTime(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -261,6 +273,17 @@ public:
 	 */
 	SeekableReadStream *createReadStream() const override;
 
+	/**
+	 * Create a SeekableReadStream instance for a file which is not written
+	 * to while the stream exists, like game data. The file may be memory
+	 * mapped, in which case an I/O error or truncating the file while it is
+	 * mapped may crash instead of failing to read. Do not use this for
+	 * savegames or configuration files.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to an alternate stream
 	 * of the file referred by this node. This assumes that the node actually
@@ -295,6 +318,24 @@ public:
 	bool createDirectory() const;
 };
 
+/** A directory along with its entries, as listed by listDirectories(). */
+struct FSDirectoryListing {
+	FSNode node;
+	/** Whether the directory could be listed */
+	bool listed;
+	FSList files;
+
+	explicit FSDirectoryListing(const FSNode &n) : node(n), listed(false) {}
+};
+
+/**
+ * List all entries of the directories from index @p first to the end of
+ * @p dirs, spread over a few threads. On network file systems, listing a
+ * directory mostly waits for the server, so several listings running at
+ * the same time finish much sooner.
+ */
+void listDirectories(Array<FSDirectoryListing> &dirs, uint first = 0);
+
 /**
  * FSDirectory models a directory tree from the file system and allows users
  * to access it through the Archive interface. Searching is case-insensitive,
@@ -344,6 +385,7 @@ class FSDirectory : public Archive {
 	bool _flat;
 	bool _ignoreClashes;
 	bool _includeDirectories;
+	bool _mapFiles;
 
 	Path	_prefix; // string that is prepended to each cache item key
 	void setPrefix(const Path &prefix);
@@ -398,6 +440,20 @@ public:
 	 */
 	FSNode getFSNode() const;
 
+	/**
+	 * Open the files with FSNode::createMappedReadStream(), so they may be
+	 * memory mapped. Only use this for directories of read-only data, like
+	 * the game data. Subdirectories inherit this setting.
+	 */
+	void setMapFiles(bool mapFiles) { _mapFiles = mapFiles; }
+
+	/**
+	 * Drop the cached listing, so the next lookup lists the directory again.
+	 * The members are answered from the listing taken on the first lookup,
+	 * so call this after adding or removing files in the directory.
+	 */
+	void invalidateCache();
+
 	/**
 	 * Create a new FSDirectory pointing to a subdirectory of the instance.
 	 * @return A new FSDirectory instance.
@@ -23,6 +23,7 @@
 #define COMMON_LIST_H
 
 #include "common/list_intern.h"
+#include "common/memory.h"
 
 namespace Common {
 
@@ -39,12 +40,16 @@ namespace Common {
 /**
  * Simple doubly linked list, modeled after the list template of the standard
  * C++ library.
+ *
+ * The nodes are allocated one at a time from @p Alloc rebound to the node
+ * type, see DefaultAllocator for the requirements.
  */
-template<typename t_T>
-class List {
+template<typename t_T, class Alloc = DefaultAllocator<t_T> >
+class List : private Alloc::template rebind<ListInternal::Node<t_T> >::other {
 protected:
 	typedef ListInternal::NodeBase		NodeBase; /*!< @todo Doc required. */
 	typedef ListInternal::Node<t_T>		Node;     /*!< An element of the doubly linked list. */
+	typedef typename Alloc::template rebind<Node>::other	NodeAllocator; /*!< Allocator of the nodes. */
 
 	NodeBase _anchor; /*!< Pointer to the position of the element in the list. */
 
@@ -55,12 +60,18 @@ public:
 	typedef t_T value_type; /*!< Value type of the list. */
 	typedef uint size_type; /*!< Size type of the list. */
 
+	typedef Alloc allocator_type; /*!< Allocator of the list. */
+
 public:
 	/**
 	 * Construct a new empty list.
 	 */
 	constexpr List() : _anchor(&_anchor, &_anchor) {}
-	List(const List<t_T> &list) {  /*!< Construct a new list as a copy of the given @p list. */
+	/**
+	 * Construct a new empty list which allocates its nodes from @p allocator.
+	 */
+	explicit List(const Alloc &allocator) : NodeAllocator(allocator), _anchor(&_anchor, &_anchor) {}
+	List(const List &list) : NodeAllocator(list) {  /*!< Construct a new list as a copy of the given @p list. */
 		_anchor._prev = &_anchor;
 		_anchor._next = &_anchor;
 
@@ -213,7 +224,7 @@ public:
 	}
 
 	/** Assign a given @p list to this list. */
-	List<t_T> &operator=(const List<t_T> &list) {
+	List &operator=(const List &list) {
 		if (this != &list) {
 			iterator i;
 			const iterator e = end();
@@ -247,7 +258,7 @@ public:
 		while (pos != &_anchor) {
 			Node *node = static_cast<Node *>(pos);
 			pos = pos->_next;
-			delete node;
+			destroyNode(node);
 		}
 
 		_anchor._prev = &_anchor;
@@ -301,7 +312,41 @@ public:
 		return const_iterator(const_cast<NodeBase *>(&_anchor));
 	}
 
+	/** Return the allocator of the list. */
+	Alloc get_allocator() const {
+		return Alloc(static_cast<const NodeAllocator &>(*this));
+	}
+
 protected:
+	/**
+	 * Allocate a node and construct it from @p args.
+	 */
+	template<class... TArgs>
+	Node *createNode(TArgs &&...args) {
+		Node *node = NodeAllocator::allocate(1);
+		assert(node);
+		new ((void *)node) Node(Common::forward<TArgs>(args)...);
+		return node;
+	}
+
+	/**
+	 * Destroy a node and free its memory.
+	 */
+	void destroyNode(Node *node) {
+		node->~Node();
+		NodeAllocator::deallocate(node, 1);
+	}
+
+	/**
+	 * Link @p newNode into the list before @p pos.
+	 */
+	static void linkNode(NodeBase *pos, NodeBase *newNode) {
+		newNode->_next = pos;
+		newNode->_prev = pos->_prev;
+		newNode->_prev->_next = newNode;
+		newNode->_next->_prev = newNode;
+	}
+
 	/**
 	 * Erase an element at @p pos.
 	 */
@@ -310,7 +355,7 @@ protected:
 		Node *node = static_cast<Node *>(pos);
 		n._prev->_next = n._next;
 		n._next->_prev = n._prev;
-		delete node;
+		destroyNode(node);
 		return n;
 	}
 
@@ -319,39 +364,21 @@ protected:
 	 */
 	template<class... TArgs>
 	void emplace(NodeBase *pos, TArgs&&... args) {
-		ListInternal::NodeBase *newNode = new Node(Common::forward<TArgs>(args)...);
-		assert(newNode);
-
-		newNode->_next = pos;
-		newNode->_prev = pos->_prev;
-		newNode->_prev->_next = newNode;
-		newNode->_next->_prev = newNode;
+		linkNode(pos, createNode(Common::forward<TArgs>(args)...));
 	}
 
 	/**
 	 * Insert an @p element before @p pos.
 	 */
 	void insert(NodeBase *pos, const t_T &element) {
-		ListInternal::NodeBase *newNode = new Node(element);
-		assert(newNode);
-
-		newNode->_next = pos;
-		newNode->_prev = pos->_prev;
-		newNode->_prev->_next = newNode;
-		newNode->_next->_prev = newNode;
+		linkNode(pos, createNode(element));
 	}
 
 	/**
 	 * Insert an @p element before @p pos.
 	 */
 	void insert(NodeBase *pos, t_T &&element) {
-		ListInternal::NodeBase *newNode = new Node(Common::move(element));
-		assert(newNode);
-
-		newNode->_next = pos;
-		newNode->_prev = pos->_prev;
-		newNode->_prev->_next = newNode;
-		newNode->_next->_prev = newNode;
+		linkNode(pos, createNode(Common::move(element)));
 	}
 };
 
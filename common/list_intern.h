@@ -26,9 +26,6 @@
 
 namespace Common {
 
-template<typename T> class List;
-
-
 namespace ListInternal {
 	struct NodeBase {
 		NodeBase *_prev = nullptr;
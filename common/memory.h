@@ -96,6 +96,37 @@ void uninitialized_fill_n(Type *dst, size_t n, const Value &x) {
 		new ((void *)dst++) Type(x);
 }
 
+/**
+ * The allocator used by Array and List unless another one is given, which
+ * takes the memory from malloc().
+ *
+ * Other allocators for these containers must provide the same members,
+ * including rebind, which is used by List to allocate its nodes. Two
+ * allocators compare equal if memory allocated by one of them can be
+ * deallocated by the other one.
+ */
+template<class T>
+struct DefaultAllocator {
+	typedef T value_type;
+
+	template<class U>
+	struct rebind {
+		typedef DefaultAllocator<U> other;
+	};
+
+	constexpr DefaultAllocator() {}
+	template<class U>
+	constexpr DefaultAllocator(const DefaultAllocator<U> &) {}
+
+	/** Allocate uninitialized memory for @p n objects, or return nullptr. */
+	T *allocate(size_t n) { return (T *)malloc(n * sizeof(T)); }
+	/** Free memory returned by allocate(), @p n must match the number of objects allocated. */
+	void deallocate(T *p, size_t n) { free(p); }
+
+	bool operator==(const DefaultAllocator &) const { return true; }
+	bool operator!=(const DefaultAllocator &) const { return false; }
+};
+
 /** @} */
 
 } // End of namespace Common
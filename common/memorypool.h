@@ -24,6 +24,7 @@
 
 #include "common/scummsys.h"
 #include "common/array.h"
+#include "common/list_intern.h"
 
 
 namespace Common {
@@ -148,6 +149,66 @@ public:
 	}
 };
 
+/**
+ * An allocator for Array and List which takes single objects from a memory
+ * pool, and larger allocations from malloc(). This is meant for the nodes
+ * of lists with a lot of insertions and removals, see ListNodePool.
+ *
+ * Copies of the allocator share the pool, which must outlive all the
+ * containers using it.
+ */
+template<class T>
+class PoolAllocator {
+public:
+	typedef T value_type;
+
+	template<class U>
+	struct rebind {
+		typedef PoolAllocator<U> other;
+	};
+
+	explicit PoolAllocator(MemoryPool &pool) : _pool(&pool) {}
+	template<class U>
+	PoolAllocator(const PoolAllocator<U> &allocator) : _pool(allocator.getPool()) {}
+
+	T *allocate(size_t n) {
+		if (usePool(n))
+			return (T *)_pool->allocChunk();
+		return (T *)malloc(n * sizeof(T));
+	}
+
+	void deallocate(T *p, size_t n) {
+		if (usePool(n))
+			_pool->freeChunk(p);
+		else
+			free(p);
+	}
+
+	MemoryPool *getPool() const { return _pool; }
+
+	bool operator==(const PoolAllocator &allocator) const { return _pool == allocator._pool; }
+	bool operator!=(const PoolAllocator &allocator) const { return _pool != allocator._pool; }
+
+private:
+	bool usePool(size_t n) const { return n == 1 && sizeof(T) <= _pool->getChunkSize(); }
+
+	MemoryPool *_pool;
+};
+
+/**
+ * A memory pool for the nodes of a List<T, PoolAllocator<T> >. Several lists
+ * may share a pool.
+ *
+ * @code
+ * Common::ListNodePool<Common::Rect> pool;
+ * Common::PoolAllocator<Common::Rect> allocator(pool);
+ * Common::List<Common::Rect, Common::PoolAllocator<Common::Rect> > rects(allocator);
+ * @endcode
+ */
+template<class T, size_t NUM_INTERNAL_CHUNKS = 32>
+class ListNodePool : public FixedSizeMemoryPool<sizeof(ListInternal::Node<T>), NUM_INTERNAL_CHUNKS> {
+};
+
 /** @} */
 
 } // End of namespace Common
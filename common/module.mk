@@ -2,6 +2,8 @@ MODULE := common
 
 MODULE_OBJS := \
 	archive.o \
+	arena.o \
+	atom.o \
 	base64.o \
 	btea.o \
 	concatstream.o \
@@ -40,6 +42,7 @@ MODULE_OBJS := \
 	system.o \
 	textconsole.o \
 	text-to-speech.o \
+	thread.o \
 	tokenizer.o \
 	translation.o \
 	unicode-bidi.o \
@@ -0,0 +1,173 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_RINGBUFFER_H
+#define COMMON_RINGBUFFER_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_ringbuffer Ring buffer
+ * @ingroup common
+ *
+ * @brief Lock-free single-producer, single-consumer ring buffer.
+ * @{
+ */
+
+/**
+ * Fixed size ring buffer which can be written by one thread and read by
+ * another one without any locking.
+ *
+ * Only one thread may call the writing methods (push(), write()) and only
+ * one thread may call the reading methods (pop(), read(), skip()) at any
+ * time. If more threads need to write or read, they must be serialized by
+ * the caller.
+ *
+ * The capacity is rounded up to the next power of two.
+ */
+template<class T>
+class RingBuffer : NonCopyable {
+public:
+	explicit RingBuffer(uint capacity) : _readPos(0), _writePos(0) {
+		_capacity = 1;
+		while (_capacity < capacity)
+			_capacity <<= 1;
+		_mask = _capacity - 1;
+		_storage = new T[_capacity];
+	}
+
+	~RingBuffer() {
+		delete[] _storage;
+	}
+
+	/** Return the maximum number of elements the buffer can hold. */
+	uint capacity() const { return _capacity; }
+
+	/** Return the number of elements which can currently be read. */
+	uint size() const { return _writePos.load() - _readPos.load(); }
+
+	/** Return the number of elements which can currently be written. */
+	uint space() const { return _capacity - size(); }
+
+	bool empty() const { return size() == 0; }
+
+	/**
+	 * Append an element. Writer side only.
+	 *
+	 * @return False if the buffer is full.
+	 */
+	bool push(const T &value) {
+		const uint32 writePos = _writePos.load();
+		if (writePos - _readPos.load() == _capacity)
+			return false;
+
+		_storage[writePos & _mask] = value;
+		_writePos.store(writePos + 1);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest element. Reader side only.
+	 *
+	 * @return False if the buffer is empty.
+	 */
+	bool pop(T &value) {
+		const uint32 readPos = _readPos.load();
+		if (_writePos.load() == readPos)
+			return false;
+
+		value = _storage[readPos & _mask];
+		_readPos.store(readPos + 1);
+		return true;
+	}
+
+	/**
+	 * Append up to @p count elements. Writer side only.
+	 *
+	 * @return The number of elements actually written.
+	 */
+	uint write(const T *data, uint count) {
+		const uint32 writePos = _writePos.load();
+		count = MIN<uint>(count, _capacity - (writePos - _readPos.load()));
+
+		const uint offset = writePos & _mask;
+		const uint firstPart = MIN<uint>(count, _capacity - offset);
+		for (uint i = 0; i < firstPart; i++)
+			_storage[offset + i] = data[i];
+		for (uint i = firstPart; i < count; i++)
+			_storage[i - firstPart] = data[i];
+
+		_writePos.store(writePos + count);
+		return count;
+	}
+
+	/**
+	 * Remove up to @p count elements. Reader side only.
+	 *
+	 * @return The number of elements actually read.
+	 */
+	uint read(T *data, uint count) {
+		const uint32 readPos = _readPos.load();
+		count = MIN<uint>(count, _writePos.load() - readPos);
+
+		const uint offset = readPos & _mask;
+		const uint firstPart = MIN<uint>(count, _capacity - offset);
+		for (uint i = 0; i < firstPart; i++)
+			data[i] = _storage[offset + i];
+		for (uint i = firstPart; i < count; i++)
+			data[i] = _storage[i - firstPart];
+
+		_readPos.store(readPos + count);
+		return count;
+	}
+
+	/**
+	 * Discard up to @p count elements. Reader side only.
+	 *
+	 * @return The number of elements actually discarded.
+	 */
+	uint skip(uint count) {
+		const uint32 readPos = _readPos.load();
+		count = MIN<uint>(count, _writePos.load() - readPos);
+		_readPos.store(readPos + count);
+		return count;
+	}
+
+private:
+	T *_storage;
+	uint _capacity;
+	uint _mask;
+
+	// Both positions increase monotonically and wrap around at 2^32, the
+	// difference between them is always the number of stored elements
+	Atomic<uint32> _readPos;
+	Atomic<uint32> _writePos;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
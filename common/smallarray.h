@@ -0,0 +1,457 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SMALLARRAY_H
+#define COMMON_SMALLARRAY_H
+
+#include "common/scummsys.h"
+#include "common/algorithm.h"
+#include "common/textconsole.h" // For error()
+#include "common/memory.h"
+
+#include <initializer_list>
+
+namespace Common {
+
+/**
+ * @defgroup common_smallarray Small arrays
+ * @ingroup common
+ *
+ * @brief Arrays with storage for a few elements inside the array object.
+ * @{
+ */
+
+/**
+ * An array which stores up to @p N elements inside the object itself, and
+ * only allocates memory when it grows beyond that. This makes it cheap to
+ * use for short temporary lists, like the rectangles touched by a single
+ * drawing operation.
+ *
+ * The interface follows Common::Array. The iterators are plain pointers,
+ * so the functions in common/algorithm.h work on small arrays as well.
+ * Note that moving a small array which uses its inline storage moves the
+ * elements one by one, and invalidates pointers to them.
+ */
+template<class T, uint N>
+class SmallArray {
+public:
+	typedef T *iterator; /*!< Small array iterator. */
+	typedef const T *const_iterator; /*!< Const-qualified small array iterator. */
+
+	typedef T value_type; /*!< Value type of the array. */
+
+	typedef uint size_type; /*!< Size type of the array. */
+
+	/** Construct an empty array which uses its inline storage. */
+	SmallArray() : _capacity(N), _size(0), _storage(getInlineStorage()) {}
+
+	/**
+	 * Construct an array with @p count default-inserted instances of @p T.
+	 */
+	explicit SmallArray(size_type count) : _capacity(N), _size(0), _storage(getInlineStorage()) {
+		resize(count);
+	}
+
+	/**
+	 * Construct an array with @p count copies of elements with value @p value.
+	 */
+	SmallArray(size_type count, const T &value) : _capacity(N), _size(0), _storage(getInlineStorage()) {
+		resize(count, value);
+	}
+
+	/** Construct an array by copying data from the given array. */
+	SmallArray(const SmallArray &array) : _capacity(N), _size(0), _storage(getInlineStorage()) {
+		reserve(array._size);
+		uninitialized_copy(array.begin(), array.end(), _storage);
+		_size = array._size;
+	}
+
+	/** Construct an array as a copy of the given @p array using the C++11 move semantic. */
+	SmallArray(SmallArray &&old) : _capacity(N), _size(0), _storage(getInlineStorage()) {
+		takeFrom(old);
+	}
+
+	/**
+	 * Construct an array using list initialization.
+	 * For example:
+	 * @code
+	 * Common::SmallArray<int, 4> myArray = {1, 7, 42};
+	 * @endcode
+	 * constructs an array with 3 elements whose values are 1, 7, and 42 respectively.
+	 */
+	SmallArray(std::initializer_list<T> list) : _capacity(N), _size(0), _storage(getInlineStorage()) {
+		reserve(list.size());
+		uninitialized_copy(list.begin(), list.end(), _storage);
+		_size = list.size();
+	}
+
+	/** Construct an array by copying data from a C array. */
+	template<class T2>
+	SmallArray(const T2 *array, size_type n) : _capacity(N), _size(0), _storage(getInlineStorage()) {
+		reserve(n);
+		uninitialized_copy(array, array + n, _storage);
+		_size = n;
+	}
+
+	~SmallArray() {
+		destroyElements();
+		freeHeapStorage();
+	}
+
+	/** Construct an element into a position in the array. */
+	template<class... TArgs>
+	void emplace(const_iterator pos, TArgs &&...args) {
+		assert(pos >= _storage && pos <= _storage + _size);
+
+		const size_type index = static_cast<size_type>(pos - _storage);
+
+		if (_size == _capacity) {
+			// Construct the new element first, since it may copy-construct
+			// from the original storage
+			T *oldStorage = _storage;
+			const size_type newCapacity = MAX<size_type>(_capacity * 2, _size + 1);
+			T *newStorage = allocStorage(newCapacity);
+			new ((void *)(newStorage + index)) T(Common::forward<TArgs>(args)...);
+
+			uninitialized_move(oldStorage, oldStorage + index, newStorage);
+			uninitialized_move(oldStorage + index, oldStorage + _size, newStorage + index + 1);
+			destroyElements();
+			freeHeapStorage();
+
+			_storage = newStorage;
+			_capacity = newCapacity;
+		} else if (index == _size) {
+			new ((void *)(_storage + index)) T(Common::forward<TArgs>(args)...);
+		} else {
+			// The arguments may refer to an element which is about to be moved
+			T tmp(Common::forward<TArgs>(args)...);
+			new ((void *)(_storage + _size)) T(Common::move(_storage[_size - 1]));
+			move_backward(_storage + index, _storage + _size - 1, _storage + _size);
+			_storage[index] = Common::move(tmp);
+		}
+
+		_size++;
+	}
+
+	/** Construct an element to the end of the array. */
+	template<class... TArgs>
+	void emplace_back(TArgs &&...args) {
+		emplace(end(), Common::forward<TArgs>(args)...);
+	}
+
+	/** Append an element to the end of the array. */
+	void push_back(const T &element) {
+		emplace_back(element);
+	}
+
+	/** Append an element to the end of the array. */
+	void push_back(T &&element) {
+		emplace_back(Common::move(element));
+	}
+
+	/** Remove the last element of the array. */
+	void pop_back() {
+		assert(_size > 0);
+		_size--;
+		_storage[_size].~T();
+	}
+
+	/** Return a pointer to the underlying memory serving as element storage. */
+	const T *data() const {
+		return _storage;
+	}
+
+	/** Return a pointer to the underlying memory serving as element storage. */
+	T *data() {
+		return _storage;
+	}
+
+	/** Return a reference to the first element of the array. */
+	T &front() {
+		assert(_size > 0);
+		return _storage[0];
+	}
+
+	/** Return a reference to the first element of the array. */
+	const T &front() const {
+		assert(_size > 0);
+		return _storage[0];
+	}
+
+	/** Return a reference to the last element of the array. */
+	T &back() {
+		assert(_size > 0);
+		return _storage[_size - 1];
+	}
+
+	/** Return a reference to the last element of the array. */
+	const T &back() const {
+		assert(_size > 0);
+		return _storage[_size - 1];
+	}
+
+	/** Insert an element into the array at the given position. */
+	void insert_at(size_type idx, const T &element) {
+		assert(idx <= _size);
+		emplace(_storage + idx, element);
+	}
+
+	/** Insert an element before @p pos. */
+	void insert(iterator pos, const T &element) {
+		emplace(pos, element);
+	}
+
+	/** Remove an element at the given position from the array and return the value of that element. */
+	T remove_at(size_type idx) {
+		assert(idx < _size);
+		T tmp = Common::move(_storage[idx]);
+		erase(_storage + idx);
+		return tmp;
+	}
+
+	/** Return a reference to the element at the given position in the array. */
+	T &operator[](size_type idx) {
+		assert(idx < _size);
+		return _storage[idx];
+	}
+
+	/** Return a const reference to the element at the given position in the array. */
+	const T &operator[](size_type idx) const {
+		assert(idx < _size);
+		return _storage[idx];
+	}
+
+	/** Assign the given @p array to this array. */
+	SmallArray &operator=(const SmallArray &array) {
+		if (this == &array)
+			return *this;
+
+		destroyElements();
+		_size = 0;
+		reserve(array._size);
+		uninitialized_copy(array.begin(), array.end(), _storage);
+		_size = array._size;
+
+		return *this;
+	}
+
+	/** Assign the given array to this array using the C++11 move semantic. */
+	SmallArray &operator=(SmallArray &&old) {
+		if (this == &old)
+			return *this;
+
+		clear();
+		takeFrom(old);
+
+		return *this;
+	}
+
+	/** Return the size of the array. */
+	size_type size() const {
+		return _size;
+	}
+
+	/** Return the number of elements the array can hold without allocating memory. */
+	size_type capacity() const {
+		return _capacity;
+	}
+
+	/** Check whether the elements are stored inside the array object. */
+	bool isInline() const {
+		return _storage == getInlineStorage();
+	}
+
+	/** Clear the array of all its elements and return to the inline storage. */
+	void clear() {
+		destroyElements();
+		freeHeapStorage();
+		_storage = getInlineStorage();
+		_capacity = N;
+		_size = 0;
+	}
+
+	/** Erase the element at @p pos position and return an iterator pointing to the next element in the array. */
+	iterator erase(iterator pos) {
+		return erase(pos, pos + 1);
+	}
+
+	/** Erase the elements from @p first to @p last and return an iterator pointing to the next element in the array. */
+	iterator erase(iterator first, iterator last) {
+		assert(_storage <= first && first <= last && last <= _storage + _size);
+		move(last, _storage + _size, first);
+
+		const size_type count = last - first;
+		_size -= count;
+
+		for (size_type idx = _size; idx < _size + count; ++idx)
+			_storage[idx].~T();
+
+		return first;
+	}
+
+	/** Check whether the array is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+
+	/** Check whether two arrays are identical. */
+	bool operator==(const SmallArray &other) const {
+		if (this == &other)
+			return true;
+		if (_size != other._size)
+			return false;
+		for (size_type i = 0; i < _size; ++i) {
+			if (_storage[i] != other._storage[i])
+				return false;
+		}
+		return true;
+	}
+
+	/** Check if two arrays are different. */
+	bool operator!=(const SmallArray &other) const {
+		return !(*this == other);
+	}
+
+	/** Return an iterator pointing to the first element in the array. */
+	iterator       begin() {
+		return _storage;
+	}
+
+	/** Return an iterator pointing past the last element in the array. */
+	iterator       end() {
+		return _storage + _size;
+	}
+
+	/** Return a const iterator pointing to the first element in the array. */
+	const_iterator begin() const {
+		return _storage;
+	}
+
+	/** Return a const iterator pointing past the last element in the array. */
+	const_iterator end() const {
+		return _storage + _size;
+	}
+
+	/**
+	 * Reserve enough memory in the array so that it can store at least the
+	 * given number of elements. The current content of the array is not modified.
+	 */
+	void reserve(size_type newCapacity) {
+		if (newCapacity <= _capacity)
+			return;
+
+		T *newStorage = allocStorage(newCapacity);
+		uninitialized_move(_storage, _storage + _size, newStorage);
+		destroyElements();
+		freeHeapStorage();
+
+		_storage = newStorage;
+		_capacity = newCapacity;
+	}
+
+	/** Change the size of the array. */
+	void resize(size_type newSize) {
+		reserve(newSize);
+
+		for (size_type i = newSize; i < _size; ++i)
+			_storage[i].~T();
+		for (size_type i = _size; i < newSize; ++i)
+			new ((void *)&_storage[i]) T();
+
+		_size = newSize;
+	}
+
+	/**
+	 * Change the size of the array and initialize new elements that exceed the
+	 * current array's size with copies of value.
+	 */
+	void resize(size_type newSize, const T value) {
+		reserve(newSize);
+
+		for (size_type i = newSize; i < _size; ++i)
+			_storage[i].~T();
+		if (newSize > _size)
+			uninitialized_fill_n(_storage + _size, newSize - _size, value);
+
+		_size = newSize;
+	}
+
+	void swap(SmallArray &arr) {
+		SmallArray tmp(Common::move(arr));
+		arr = Common::move(*this);
+		*this = Common::move(tmp);
+	}
+
+private:
+	static_assert(N > 0, "SmallArray needs an inline capacity");
+
+	T *getInlineStorage() {
+		return reinterpret_cast<T *>(_inlineStorage);
+	}
+
+	const T *getInlineStorage() const {
+		return reinterpret_cast<const T *>(_inlineStorage);
+	}
+
+	static T *allocStorage(size_type capacity) {
+		T *storage = (T *)malloc(sizeof(T) * capacity);
+		if (!storage)
+			::error("Common::SmallArray: failure to allocate %u bytes", capacity * (size_type)sizeof(T));
+		return storage;
+	}
+
+	void destroyElements() {
+		for (size_type i = 0; i < _size; ++i)
+			_storage[i].~T();
+	}
+
+	void freeHeapStorage() {
+		if (!isInline())
+			free(_storage);
+	}
+
+	/** Move the contents of @p old into this array, which must be empty and inline. */
+	void takeFrom(SmallArray &old) {
+		if (old.isInline()) {
+			uninitialized_move(old.begin(), old.end(), _storage);
+			_size = old._size;
+			old.destroyElements();
+		} else {
+			_storage = old._storage;
+			_capacity = old._capacity;
+			_size = old._size;
+			old._storage = old.getInlineStorage();
+			old._capacity = N;
+		}
+		old._size = 0;
+	}
+
+	size_type _capacity;
+	size_type _size;
+	T *_storage;
+	alignas(T) byte _inlineStorage[N * sizeof(T)];
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,282 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_STR_VIEW_H
+#define COMMON_STR_VIEW_H
+
+#include "common/str.h"
+#include "common/ustr.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_str_view String views
+ * @ingroup common_str
+ *
+ * @brief Non-owning references to parts of strings.
+ * @{
+ */
+
+/**
+ * A reference to a range of characters, which are owned by someone else,
+ * for example a String or a buffer holding a file. Views are cheap to
+ * create and copy, and taking a substring of a view does not allocate any
+ * memory. This makes them useful for parsers, which only need to turn the
+ * parts of the input which are kept into strings.
+ *
+ * A view does not keep the characters alive, so it must not be used after
+ * the string it refers to has been modified or destroyed. The characters of
+ * a view are not null-terminated.
+ *
+ * @p S is the string class the view refers to, and which toString() returns.
+ */
+template<class S>
+class BaseStringView {
+public:
+	typedef typename S::value_type value_type;
+	typedef const value_type *const_iterator;
+	typedef const value_type *iterator;
+
+	static const uint32 npos = 0xFFFFFFFF;
+
+	/** Construct an empty view. */
+	constexpr BaseStringView() : _data(nullptr), _size(0) {}
+	/** Construct a view of @p len characters starting at @p str. */
+	constexpr BaseStringView(const value_type *str, uint32 len) : _data(str), _size(len) {}
+	/** Construct a view of the characters between @p beginP (including) and @p endP (excluding). */
+	BaseStringView(const value_type *beginP, const value_type *endP) : _data(beginP), _size(endP - beginP) {}
+	/** Construct a view of a null-terminated string. */
+	BaseStringView(const value_type *str) : _data(str), _size(0) {
+		while (str[_size])
+			_size++;
+	}
+	/** Construct a view of the whole contents of @p str. */
+	BaseStringView(const S &str) : _data(str.c_str()), _size(str.size()) {}
+
+	const value_type *data() const { return _data; }
+	uint32 size() const { return _size; }
+	bool empty() const { return _size == 0; }
+
+	const_iterator begin() const { return _data; }
+	const_iterator end() const { return _data + _size; }
+
+	value_type operator[](uint32 idx) const {
+		assert(idx < _size);
+		return _data[idx];
+	}
+
+	value_type firstChar() const { return _size ? _data[0] : 0; }
+	value_type lastChar() const { return _size ? _data[_size - 1] : 0; }
+
+	/** Copy the characters of the view into a new string. */
+	S toString() const { return _size ? S(_data, _size) : S(); }
+
+	/** Return a view of at most @p len characters starting at @p pos. */
+	BaseStringView substr(uint32 pos, uint32 len = npos) const {
+		if (pos >= _size)
+			return BaseStringView();
+		return BaseStringView(_data + pos, MIN(len, _size - pos));
+	}
+
+	/** Remove the first @p n characters from the view. */
+	void removePrefix(uint32 n) {
+		n = MIN(n, _size);
+		_data += n;
+		_size -= n;
+	}
+
+	/** Remove the last @p n characters from the view. */
+	void removeSuffix(uint32 n) {
+		_size -= MIN(n, _size);
+	}
+
+	/** Return the view without leading and trailing whitespace. */
+	BaseStringView trimmed() const {
+		return trimmedLeft().trimmedRight();
+	}
+
+	/** Return the view without leading whitespace. */
+	BaseStringView trimmedLeft() const {
+		uint32 first = 0;
+		while (first < _size && isSpace(_data[first]))
+			first++;
+		return BaseStringView(_data + first, _size - first);
+	}
+
+	/** Return the view without trailing whitespace. */
+	BaseStringView trimmedRight() const {
+		uint32 len = _size;
+		while (len > 0 && isSpace(_data[len - 1]))
+			len--;
+		return BaseStringView(_data, len);
+	}
+
+	/** Return the position of the first occurrence of @p c at or after @p pos, or npos. */
+	uint32 find(value_type c, uint32 pos = 0) const {
+		for (uint32 i = pos; i < _size; ++i) {
+			if (_data[i] == c)
+				return i;
+		}
+		return npos;
+	}
+
+	/** Return the position of the first occurrence of @p str at or after @p pos, or npos. */
+	uint32 find(const BaseStringView &str, uint32 pos = 0) const {
+		if (str._size > _size)
+			return npos;
+		for (uint32 i = pos; i + str._size <= _size; ++i) {
+			if (BaseStringView(_data + i, str._size) == str)
+				return i;
+		}
+		return npos;
+	}
+
+	/** Return the position of the last occurrence of @p c, or npos. */
+	uint32 rfind(value_type c) const {
+		for (uint32 i = _size; i > 0; --i) {
+			if (_data[i - 1] == c)
+				return i - 1;
+		}
+		return npos;
+	}
+
+	/** Return the position of the first character which is contained in @p chars, or npos. */
+	uint32 findFirstOf(const BaseStringView &chars, uint32 pos = 0) const {
+		for (uint32 i = pos; i < _size; ++i) {
+			if (chars.contains(_data[i]))
+				return i;
+		}
+		return npos;
+	}
+
+	/** Return the position of the first character which is not contained in @p chars, or npos. */
+	uint32 findFirstNotOf(const BaseStringView &chars, uint32 pos = 0) const {
+		for (uint32 i = pos; i < _size; ++i) {
+			if (!chars.contains(_data[i]))
+				return i;
+		}
+		return npos;
+	}
+
+	bool contains(value_type c) const { return find(c) != npos; }
+	bool contains(const BaseStringView &str) const { return find(str) != npos; }
+
+	bool hasPrefix(const BaseStringView &x) const {
+		return x._size <= _size && BaseStringView(_data, x._size) == x;
+	}
+
+	bool hasSuffix(const BaseStringView &x) const {
+		return x._size <= _size && BaseStringView(_data + _size - x._size, x._size) == x;
+	}
+
+	bool equals(const BaseStringView &x) const {
+		if (_size != x._size)
+			return false;
+		for (uint32 i = 0; i < _size; ++i) {
+			if (_data[i] != x._data[i])
+				return false;
+		}
+		return true;
+	}
+
+	/** Compare with @p x, ignoring the case of ASCII characters. */
+	bool equalsIgnoreCase(const BaseStringView &x) const {
+		if (_size != x._size)
+			return false;
+		for (uint32 i = 0; i < _size; ++i) {
+			if (toLower(_data[i]) != toLower(x._data[i]))
+				return false;
+		}
+		return true;
+	}
+
+	bool operator==(const BaseStringView &x) const { return equals(x); }
+	bool operator!=(const BaseStringView &x) const { return !equals(x); }
+	bool operator==(const value_type *x) const { return equals(BaseStringView(x)); }
+	bool operator!=(const value_type *x) const { return !equals(BaseStringView(x)); }
+	bool operator==(const S &x) const { return equals(BaseStringView(x)); }
+	bool operator!=(const S &x) const { return !equals(BaseStringView(x)); }
+
+	/**
+	 * Split the view at the first occurrence of @p c. The part before it is
+	 * returned, and the view keeps the part after it. If @p c does not occur,
+	 * the whole view is returned and this view becomes empty.
+	 */
+	BaseStringView splitAt(value_type c) {
+		const uint32 pos = find(c);
+		BaseStringView head = substr(0, pos);
+		if (pos == npos)
+			*this = BaseStringView();
+		else
+			removePrefix(pos + 1);
+		return head;
+	}
+
+	/**
+	 * Split off the first line of the view, and return it without the line
+	 * break. LF, CR LF and CR are all accepted as line breaks, like
+	 * SeekableReadStream::readLine() does.
+	 */
+	BaseStringView splitLine() {
+		uint32 len = 0;
+		while (len < _size && _data[len] != '\n' && _data[len] != '\r')
+			len++;
+
+		BaseStringView line(_data, len);
+		if (len < _size)
+			len += (_data[len] == '\r' && len + 1 < _size && _data[len + 1] == '\n') ? 2 : 1;
+		removePrefix(len);
+		return line;
+	}
+
+private:
+	static value_type toLower(value_type c) {
+		return (c >= 'A' && c <= 'Z') ? (value_type)(c - 'A' + 'a') : c;
+	}
+
+	const value_type *_data;
+	uint32 _size;
+};
+
+template<class S>
+const uint32 BaseStringView<S>::npos;
+
+typedef BaseStringView<String> StringView;
+typedef BaseStringView<U32String> U32StringView;
+
+/** Append the characters of @p view to @p str. */
+inline String &operator+=(String &str, const StringView &view) {
+	str.append(view.begin(), view.end());
+	return str;
+}
+
+/** Append the characters of @p view to @p str. */
+inline U32String &operator+=(U32String &str, const U32StringView &view) {
+	str.append(view.begin(), view.end());
+	return str;
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
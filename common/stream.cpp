@@ -228,6 +228,29 @@ char *SeekableReadStream::readLine(char *buf, size_t bufSize, bool handleCR) {
 	return buf;
 }
 
+void SeekableReadStream::readRemainingData(Array<byte> &buffer) {
+	buffer.clear();
+
+	const int64 streamSize = size();
+	if (streamSize >= 0) {
+		buffer.resize(MAX<int64>(streamSize - pos(), 0));
+		buffer.resize(read(buffer.data(), buffer.size()));
+		return;
+	}
+
+	// Grow the buffer geometrically, so that large streams are not copied
+	// over and over again
+	while (!eos() && !err()) {
+		const uint32 oldSize = buffer.size();
+		const uint32 chunkSize = MAX<uint32>(oldSize, 4096);
+		buffer.resize(oldSize + chunkSize);
+		const uint32 bytesRead = read(buffer.data() + oldSize, chunkSize);
+		buffer.resize(oldSize + bytesRead);
+		if (bytesRead == 0)
+			break;
+	}
+}
+
 String SeekableReadStream::readLine(bool handleCR) {
 	// Read a line
 	String line;
@@ -292,6 +315,13 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getView(int64 offset, uint32 dataSize) const {
+	if (offset < 0 || offset > size() || dataSize > size() - offset)
+		return nullptr;
+
+	return _parentStream->getView(_begin + offset, dataSize);
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
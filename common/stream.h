@@ -22,6 +22,7 @@
 #ifndef COMMON_STREAM_H
 #define COMMON_STREAM_H
 
+#include "common/array.h"
 #include "common/endian.h"
 #include "common/ptr.h"
 #include "common/scummsys.h"
@@ -792,6 +793,32 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Return a read-only view of a range of the stream without copying it.
+	 *
+	 * This is only supported by streams which keep their data in memory,
+	 * like a MemoryReadStream or a memory mapped file. The view stays valid
+	 * as long as the stream exists, and does not affect the position
+	 * indicator.
+	 *
+	 * @param offset	Start of the range, relative to the start of the stream.
+	 * @param dataSize	Size of the range in bytes.
+	 *
+	 * @return Pointer to the data, or nullptr if the stream does not support
+	 *         views or the range is not inside of the stream.
+	 */
+	virtual const byte *getView(int64 offset, uint32 dataSize) const { return nullptr; }
+
+	/**
+	 * Read everything from the position indicator to the end of the stream.
+	 *
+	 * Streams which do not know their size are read until end-of-stream
+	 * or an error occurs.
+	 *
+	 * @param buffer	Receives the data, replacing its previous contents.
+	 */
+	void readRemainingData(Array<byte> &buffer);
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
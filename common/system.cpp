@@ -22,6 +22,7 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_exit
 
 #include "common/system.h"
+#include "common/atom.h"
 #include "common/events.h"
 #include "common/fs.h"
 #include "common/file.h"
@@ -123,6 +124,7 @@ void OSystem::initBackend() {
 void OSystem::destroy() {
 	_backendInitialized = false;
 	Common::String::releaseMemoryPoolMutex();
+	Common::Atom::releaseTableMutex();
 	Common::releaseCJKTables();
 	delete this;
 }
@@ -66,6 +66,7 @@ class TaskbarManager;
 class UpdateManager;
 #endif
 class TextToSpeechManager;
+class ThreadInternal;
 #if defined(USE_SYSDIALOGS)
 class DialogManager;
 #endif
@@ -1622,7 +1623,7 @@ public:
 
 
 	/**
-	 * @defgroup common_system_mutex Mutex handling
+	 * @defgroup common_system_mutex Mutex and thread handling
 	 * @ingroup common_system
 	 * @{
 	 *
@@ -1638,6 +1639,11 @@ public:
 	 *
 	 * Hence, backends that do not use threads to implement the timers can simply
 	 * use dummy implementations for these methods.
+	 *
+	 * Work which is too expensive for a timer callback, like rendering an
+	 * emulated synthesizer ahead of the mixer, may still ask for a thread of
+	 * its own with createThread(). Backends are free not to support this, and
+	 * callers then do the work on their own thread.
 	 */
 
 	/**
@@ -1647,6 +1653,24 @@ public:
 	 */
 	virtual Common::MutexInternal *createMutex() = 0;
 
+	/**
+	 * Create a new thread which runs the given function.
+	 *
+	 * Backends implementing this must also implement getCurrentThreadId().
+	 *
+	 * @return The newly created thread, or 0 if the backend has no thread
+	 *         support or an error occurred.
+	 */
+	virtual Common::ThreadInternal *createThread(void (*proc)(void *data), void *data, const char *name) { return nullptr; }
+
+	/**
+	 * Return an identifier of the calling thread, which differs from the
+	 * ones of all other running threads.
+	 *
+	 * @return The identifier, or 0 if the backend has no thread support.
+	 */
+	virtual uintptr getCurrentThreadId() { return 0; }
+
 	/** @} */
 
 
@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/thread.h"
+#include "common/atomic.h"
+#include "common/system.h"
+
+namespace Common {
+
+Thread::Thread() : _thread(nullptr) {
+}
+
+Thread::~Thread() {
+	wait();
+}
+
+bool Thread::start(ThreadProc proc, void *data, const char *name) {
+	assert(g_system);
+	wait();
+	_thread = g_system->createThread(proc, data, name);
+	return _thread != nullptr;
+}
+
+void Thread::wait() {
+	if (!_thread)
+		return;
+
+	_thread->wait();
+	delete _thread;
+	_thread = nullptr;
+}
+
+uintptr Thread::getCurrentId() {
+	assert(g_system);
+	return g_system->getCurrentThreadId();
+}
+
+namespace {
+
+struct ParallelJob {
+	ParallelProc proc;
+	void *data;
+	uint count;
+	Atomic<uint> next;
+};
+
+void parallelWorkerProc(void *data) {
+	ParallelJob *job = (ParallelJob *)data;
+
+	uint index;
+	while ((index = job->next.fetchAdd(1)) < job->count)
+		job->proc(job->data, index);
+}
+
+} // End of anonymous namespace
+
+void runParallel(ParallelProc proc, void *data, uint count, uint numThreads) {
+	ParallelJob job;
+	job.proc = proc;
+	job.data = data;
+	job.count = count;
+
+	// The calling thread is one of the workers
+	const uint numWorkers = MIN(numThreads, count);
+	const uint numExtraThreads = numWorkers > 1 ? numWorkers - 1 : 0;
+	Thread *threads = numExtraThreads ? new Thread[numExtraThreads] : nullptr;
+	for (uint i = 0; i < numExtraThreads; ++i) {
+		if (!threads[i].start(parallelWorkerProc, &job, "ParallelWorker"))
+			break;
+	}
+
+	parallelWorkerProc(&job);
+
+	// Waits for the threads
+	delete[] threads;
+}
+
+} // End of namespace Common
@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Thread
+ * @ingroup common
+ *
+ * @brief API for running work on a thread of its own.
+ * @{
+ */
+
+/** The function run by a thread. The thread ends when it returns. */
+typedef void (*ThreadProc)(void *data);
+
+class ThreadInternal {
+public:
+	virtual ~ThreadInternal() {}
+
+	/** Wait until the thread proc has returned. */
+	virtual void wait() = 0;
+};
+
+/**
+ * Wrapper class around the OSystem thread functions.
+ *
+ * Not every backend can create threads, so users must be prepared for
+ * start() to fail, and do the work on their own thread instead.
+ */
+class Thread : NonCopyable {
+	ThreadInternal *_thread;
+
+public:
+	Thread();
+	/** Waits for the thread to end if it is still running. */
+	~Thread();
+
+	/**
+	 * Run a function on a new thread.
+	 *
+	 * @param proc The function to run.
+	 * @param data Parameter passed to the function.
+	 * @param name Name of the thread, used by debuggers.
+	 *
+	 * @return True if the thread was created.
+	 */
+	bool start(ThreadProc proc, void *data, const char *name);
+
+	/** Wait until the thread has ended. Does nothing if it was not started. */
+	void wait();
+
+	bool isRunning() const { return _thread != nullptr; }
+
+	/**
+	 * Return an identifier of the calling thread, which differs from the
+	 * ones of all other running threads. Backends which cannot create
+	 * threads return 0.
+	 */
+	static uintptr getCurrentId();
+};
+
+/** A function run by runParallel() for one index. */
+typedef void (*ParallelProc)(void *data, uint index);
+
+/**
+ * Call a function once for every index from 0 to count - 1, spread over up to
+ * numThreads threads. The calling thread takes its share of the indices, and
+ * all of them if the backend cannot create threads. Returns once all calls
+ * have returned.
+ *
+ * The calls may run at the same time and in any order, so the function must
+ * not touch state which is shared between the indices.
+ */
+void runParallel(ParallelProc proc, void *data, uint count, uint numThreads);
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
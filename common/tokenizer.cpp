@@ -48,6 +48,11 @@ bool BaseStringTokenizer<T>::empty() const {
 
 template<class T>
 T BaseStringTokenizer<T>::nextToken() {
+	return nextTokenView().toString();
+}
+
+template<class T>
+BaseStringView<T> BaseStringTokenizer<T>::nextTokenView() {
 	// Skip delimiters when present at the beginning, to point to the next token
 	// For example, the below loop will set _tokenBegin & _tokenEnd to 'H' for the string -> "!!--=Hello World"
 	// And subsequently, skip all delimiters in the beginning of the next word.
@@ -59,16 +64,16 @@ T BaseStringTokenizer<T>::nextToken() {
 	// Loop and advance _tokenEnd until we find a delimiter at the end of a word/string
 	while (_tokenBegin != _str.end() && _tokenEnd != _str.end()) {
 		if (_delimiters.contains(*_tokenEnd)) {
-			return T(_tokenBegin, _tokenEnd);
+			return BaseStringView<T>(_tokenBegin, _tokenEnd);
 		}
 		_tokenEnd++;
 	}
 
 	// Returning the last word if _tokenBegin iterator isn't at the end.
 	if (_tokenBegin != _str.end())
-		return T(_tokenBegin, _tokenEnd);
+		return BaseStringView<T>(_tokenBegin, _tokenEnd);
 	else
-		return T();
+		return BaseStringView<T>();
 }
 
 template<class T>
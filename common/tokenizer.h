@@ -24,6 +24,7 @@
 
 #include "common/scummsys.h"
 #include "common/str-array.h"
+#include "common/str-view.h"
 
 namespace Common {
 
@@ -55,6 +56,7 @@ public:
 	void reset();       ///< Resets the tokenizer to its initial state, i.e points boten token iterators to the beginning
 	bool empty() const; ///< Returns true if there are no more tokens left in the string, false otherwise
 	T nextToken(); ///< Returns the next token from the string (Or an empty string if there are no more tokens)
+	BaseStringView<T> nextTokenView(); ///< Like nextToken(), but returns a view into the tokenizer's copy of the string, which stays valid as long as the tokenizer
 	Array<T> split(); ///< Returns an Array with all tokens. Beware of the memory usage
 
 	T delimitersAtTokenBegin() const; ///< Returns a String with all delimiters between the current and previous token
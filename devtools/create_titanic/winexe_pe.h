@@ -25,12 +25,12 @@
 #include "file.h"
 #include "hash-str.h"
 #include "hashmap.h"
+#include "common/array.h"
 #include "common/str.h"
 #include "winexe.h"
 
 namespace Common {
 
-template<class T> class Array;
 class SeekableReadStream;
 
 /**
@@ -30,6 +30,7 @@
 #include "common/punycode.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 #include "common/compression/clickteam.h"
@@ -475,6 +476,119 @@ namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+/* Persistent fingerprint cache */
+
+static const uint32 kFingerprintCacheTag = MKTAG('A', 'D', 'F', 'C');
+static const uint32 kFingerprintCacheVersion = 1;
+
+Common::Path AdvancedDetectorCacheManager::getFingerprintCachePath() {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	return configFile.getParent().appendComponent("detection.cache");
+}
+
+void AdvancedDetectorCacheManager::loadFingerprints() {
+	fingerprintsLoaded = true;
+
+	Common::FSNode node(getFingerprintCachePath());
+	Common::ScopedPtr<Common::SeekableReadStream> in(node.exists() ? node.createReadStream() : nullptr);
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != kFingerprintCacheTag || in->readUint32LE() != kFingerprintCacheVersion) {
+		debugC(2, kDebugGlobalDetection, "Ignoring outdated detection cache");
+		return;
+	}
+
+	const uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count && !in->eos() && !in->err(); i++) {
+		Common::String key = in->readString(0, in->readUint32LE());
+		Fingerprint &fingerprint = fingerprintHashMap[key];
+		fingerprint.size = in->readSint64LE();
+		fingerprint.modificationTime = in->readSint64LE();
+		fingerprint.md5 = in->readString(0, in->readByte());
+		fingerprint.used = false;
+	}
+
+	// Drop everything if the file was truncated
+	if (in->eos() || in->err()) {
+		warning("Detection cache '%s' is corrupt, ignoring it", getFingerprintCachePath().toString(Common::Path::kNativeSeparator).c_str());
+		fingerprintHashMap.clear();
+	}
+}
+
+bool AdvancedDetectorCacheManager::getFingerprint(const Common::String &key, int64 size, int64 modificationTime, Common::String &md5) {
+	if (!fingerprintsLoaded)
+		loadFingerprints();
+
+	FingerprintHashMap::iterator it = fingerprintHashMap.find(key);
+	if (it == fingerprintHashMap.end())
+		return false;
+
+	if (it->_value.size != size || it->_value.modificationTime != modificationTime) {
+		fingerprintHashMap.erase(it);
+		fingerprintsChanged = true;
+		return false;
+	}
+
+	it->_value.used = true;
+	md5 = it->_value.md5;
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setFingerprint(const Common::String &key, int64 size, int64 modificationTime, const Common::String &md5) {
+	if (!fingerprintsLoaded)
+		loadFingerprints();
+
+	Fingerprint &fingerprint = fingerprintHashMap[key];
+	fingerprint.size = size;
+	fingerprint.modificationTime = modificationTime;
+	fingerprint.md5 = md5;
+	fingerprint.used = true;
+	fingerprintsChanged = true;
+}
+
+void AdvancedDetectorCacheManager::saveFingerprints() {
+	if (!fingerprintsChanged)
+		return;
+
+	Common::FSNode node(getFingerprintCachePath());
+	Common::ScopedPtr<Common::SeekableWriteStream> out(node.createWriteStream());
+	if (!out) {
+		warning("Could not write detection cache '%s'", getFingerprintCachePath().toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	// When the cache is full, the files which were used during this session
+	// are kept first
+	const uint32 count = MIN<uint32>(fingerprintHashMap.size(), kMaxFingerprints);
+	out->writeUint32BE(kFingerprintCacheTag);
+	out->writeUint32LE(kFingerprintCacheVersion);
+	out->writeUint32LE(count);
+
+	uint32 written = 0;
+	for (int pass = 0; pass < 2; pass++) {
+		const bool used = (pass == 0);
+		for (FingerprintHashMap::const_iterator it = fingerprintHashMap.begin(); it != fingerprintHashMap.end() && written < count; ++it) {
+			if (it->_value.used != used)
+				continue;
+
+			out->writeUint32LE(it->_key.size());
+			out->writeString(it->_key);
+			out->writeSint64LE(it->_value.size);
+			out->writeSint64LE(it->_value.modificationTime);
+			out->writeByte(it->_value.md5.size());
+			out->writeString(it->_value.md5);
+			written++;
+		}
+	}
+
+	out->finalize();
+	fingerprintsChanged = false;
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -534,30 +648,158 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 }
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
+static void computeFileProperties(uint md5Bytes, MD5Properties md5prop, Common::SeekableReadStream &stream, FileProperties &fileProps);
 
-bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
-	Common::String hashname = md5PropToCachePrefix(md5prop);
-		hashname += ':';
-		hashname += fname.toString('/');
-		hashname += ':';
-		hashname += Common::String::format("%d", _md5Bytes);
-
-	if (ADCacheMan.containsMD5(hashname)) {
-		fileProps.md5 = ADCacheMan.getMD5(hashname);
-		fileProps.size = ADCacheMan.getSize(hashname);
+namespace {
+
+enum {
+	/** Number of threads which compute the MD5s of the files of a directory */
+	kFileHashThreads = 4
+};
+
+/** The keys of a file in the caches of ADCacheMan */
+struct FileCacheKeys {
+	Common::String hashname;
+	/** Only set for plain files, which are kept in the persistent cache */
+	Common::String fingerprintKey;
+	int64 fileSize;
+	int64 modificationTime;
+
+	FileCacheKeys() : fileSize(0), modificationTime(0) {}
+};
+
+/** A plain file whose MD5s are computed on a thread of the pool */
+struct FileHashJob {
+	const Common::FSNode *node;
+	uint md5Bytes;
+	bool opened;
+	/** The requests for this file, which may differ in whether they hash the head or tail */
+	Common::Array<uint> requests;
+	Common::Array<MD5Properties> md5props;
+	Common::Array<FileProperties> results;
+};
+
+bool lookupFileProperties(uint md5Bytes, const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileCacheKeys &keys, FileProperties &fileProps) {
+	keys.hashname = md5PropToCachePrefix(md5prop);
+		keys.hashname += ':';
+		keys.hashname += fname.toString('/');
+		keys.hashname += ':';
+		keys.hashname += Common::String::format("%d", md5Bytes);
+
+	if (ADCacheMan.containsMD5(keys.hashname)) {
+		fileProps.md5 = ADCacheMan.getMD5(keys.hashname);
+		fileProps.size = ADCacheMan.getSize(keys.hashname);
 		return true;
 	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+	// Plain files are looked up in the persistent cache, keyed by their full path
+	if (!(md5prop & (kMD5MacMask | kMD5Archive)) && allFiles.contains(fname) &&
+	    allFiles[fname].getSizeAndModificationTime(keys.fileSize, keys.modificationTime)) {
+		keys.fingerprintKey = Common::String::format("%s:%s:%d", md5PropToCachePrefix(md5prop).c_str(),
+		                                             allFiles[fname].getPath().toString('/').c_str(), md5Bytes);
+
+		if (ADCacheMan.getFingerprint(keys.fingerprintKey, keys.fileSize, keys.modificationTime, fileProps.md5)) {
+			fileProps.size = keys.fileSize;
+			fileProps.md5prop = (MD5Properties)(md5prop & kMD5Tail);
+			ADCacheMan.setMD5(keys.hashname, fileProps.md5);
+			ADCacheMan.setSize(keys.hashname, fileProps.size);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void cacheFileProperties(const FileCacheKeys &keys, const FileProperties &fileProps) {
+	ADCacheMan.setMD5(keys.hashname, fileProps.md5);
+	ADCacheMan.setSize(keys.hashname, fileProps.size);
+
+	if (!keys.fingerprintKey.empty() && fileProps.size == keys.fileSize)
+		ADCacheMan.setFingerprint(keys.fingerprintKey, keys.fileSize, keys.modificationTime, fileProps.md5);
+}
 
-	if (res) {
-		ADCacheMan.setMD5(hashname, fileProps.md5);
-		ADCacheMan.setSize(hashname, fileProps.size);
+void fileHashProc(void *data, uint index) {
+	FileHashJob &job = ((FileHashJob *)data)[index];
+
+	Common::File file;
+	job.opened = file.open(*job.node);
+	if (!job.opened)
+		return;
+
+	for (uint i = 0; i < job.md5props.size(); ++i) {
+		file.seek(0);
+		computeFileProperties(job.md5Bytes, job.md5props[i], file, job.results[i]);
 	}
+}
+
+} // End of anonymous namespace
+
+bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
+	FileCacheKeys keys;
+	if (lookupFileProperties(_md5Bytes, allFiles, md5prop, fname, keys, fileProps))
+		return true;
+
+	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+
+	if (res)
+		cacheFileProperties(keys, fileProps);
 
 	return res;
 }
 
+void AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles, Common::Array<FilePropertiesRequest> &requests) const {
+	Common::Array<FileCacheKeys> keys(requests.size());
+	Common::Array<FileHashJob> jobs;
+	// Jobs by the path of their file, as several requests may be for one file
+	Common::HashMap<Common::String, uint> jobIndices;
+
+	for (uint i = 0; i < requests.size(); ++i) {
+		FilePropertiesRequest &request = requests[i];
+		if (lookupFileProperties(_md5Bytes, allFiles, request.md5prop, request.fname, keys[i], request.fileProps)) {
+			request.found = true;
+			continue;
+		}
+
+		// Forks and archives are opened through the shared caches of
+		// ADCacheMan, so only plain files are hashed in parallel
+		if ((request.md5prop & (kMD5MacMask | kMD5Archive)) || !allFiles.contains(request.fname)) {
+			request.found = getFilePropertiesIntern(_md5Bytes, allFiles, request.md5prop, request.fname, request.fileProps);
+			if (request.found)
+				cacheFileProperties(keys[i], request.fileProps);
+			continue;
+		}
+
+		const Common::FSNode &node = allFiles[request.fname];
+		const Common::String path = node.getPath().toString('/');
+		if (!jobIndices.contains(path)) {
+			jobIndices[path] = jobs.size();
+			jobs.push_back(FileHashJob());
+			jobs.back().node = &node;
+			jobs.back().md5Bytes = _md5Bytes;
+			jobs.back().opened = false;
+		}
+
+		FileHashJob &job = jobs[jobIndices[path]];
+		job.requests.push_back(i);
+		job.md5props.push_back(request.md5prop);
+		job.results.push_back(FileProperties());
+	}
+
+	Common::runParallel(fileHashProc, jobs.data(), jobs.size(), kFileHashThreads);
+
+	for (uint i = 0; i < jobs.size(); ++i) {
+		if (!jobs[i].opened)
+			continue;
+
+		for (uint j = 0; j < jobs[i].requests.size(); ++j) {
+			const uint index = jobs[i].requests[j];
+			requests[index].found = true;
+			requests[index].fileProps = jobs[i].results[j];
+			cacheFileProperties(keys[index], requests[index].fileProps);
+		}
+	}
+}
+
 bool AdvancedMetaEngineBase::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	return getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps);
 }
@@ -658,15 +900,19 @@ static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngineBase:
 			return false;
 	}
 
+	computeFileProperties(md5Bytes, md5prop, *testFile, fileProps);
+	return true;
+}
+
+static void computeFileProperties(uint md5Bytes, MD5Properties md5prop, Common::SeekableReadStream &stream, FileProperties &fileProps) {
 	if (md5prop & kMD5Tail) {
-		if (testFile->size() > md5Bytes)
-			testFile->seek(-(int64)md5Bytes, SEEK_END);
+		if (stream.size() > md5Bytes)
+			stream.seek(-(int64)md5Bytes, SEEK_END);
 	}
 
-	fileProps.size = testFile->size();
-	fileProps.md5 = Common::computeStreamMD5AsString(*testFile.get(), md5Bytes);
+	fileProps.size = stream.size();
+	fileProps.md5 = Common::computeStreamMD5AsString(stream, md5Bytes);
 	fileProps.md5prop = (MD5Properties) (md5prop & kMD5Tail);
-	return true;
 }
 
 void AdvancedMetaEngineDetectionBase::dumpDetectionEntries() const {
@@ -706,7 +952,9 @@ void AdvancedMetaEngineDetectionBase::dumpDetectionEntries() const {
 }
 
 ADDetectedGames AdvancedMetaEngineDetectionBase::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra, uint32 skipADFlags, bool skipIncomplete) {
-	CachedPropertiesMap filesProps;
+	Common::HashMap<Common::Atom, FileProperties, Common::Atom_IgnoreCase_Hash, Common::Atom_IgnoreCase_EqualTo> filesProps;
+	Common::Array<FilePropertiesRequest> requests;
+	Common::Array<Common::Atom> requestKeys;
 	ADDetectedGames matched;
 
 	const ADGameFileDescription *fileDesc;
@@ -719,30 +967,34 @@ ADDetectedGames AdvancedMetaEngineDetectionBase::detectGame(const Common::FSNode
 
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
+	uint k = 0;
 	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
 		g = (const ADGameDescription *)descPtr;
 
-		for (fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
-			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
-			Common::String fname = fileDesc->fileName;
-			Common::String key = md5PropToCachePrefix(md5prop);
-				key += ':';
-				key += fname;
+		for (fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++, k++) {
+			const Common::Atom &key = _fileKeys[k];
 
 			if (filesProps.contains(key))
 				continue;
 
-			FileProperties tmp;
-			if (getFileProperties(allFiles, md5prop, Common::Path(fname), tmp)) {
-				debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld", key.c_str(), tmp.md5.c_str(), long(tmp.size));
-			}
-
 			// Both positive and negative results are cached to avoid
 			// repeatedly checking for files.
-			filesProps[key] = tmp;
+			filesProps[key] = FileProperties();
+			requestKeys.push_back(key);
+			requests.push_back(FilePropertiesRequest(gameFileToMD5Props(fileDesc, g->flags), Common::Path(fileDesc->fileName)));
 		}
 	}
 
+	getFileProperties(allFiles, requests);
+
+	for (uint i = 0; i < requests.size(); ++i) {
+		if (requests[i].found) {
+			debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld", requestKeys[i].c_str(), requests[i].fileProps.md5.c_str(), long(requests[i].fileProps.size));
+		}
+
+		filesProps[requestKeys[i]] = requests[i].fileProps;
+	}
+
 	int maxFilesMatched = 0;
 	bool gotAnyMatchesWithAllFiles = false;
 
@@ -773,12 +1025,10 @@ ADDetectedGames AdvancedMetaEngineDetectionBase::detectGame(const Common::FSNode
 		int curFilesMatched = 0;
 
 		// Try to match all files for this game
-		for (fileDesc = game.desc->filesDescriptions; fileDesc->fileName; fileDesc++) {
+		k = _firstFileKeys[i];
+		for (fileDesc = game.desc->filesDescriptions; fileDesc->fileName; fileDesc++, k++) {
 			Common::String tstr = fileDesc->fileName;
-			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
-			Common::String key = md5PropToCachePrefix(md5prop);
-				key += ':';
-				key += tstr;
+			const Common::Atom &key = _fileKeys[k];
 
 			if (!filesProps.contains(key) || filesProps[key].size == -1) {
 				allFilesPresent = false;
@@ -986,6 +1236,13 @@ void AdvancedMetaEngineDetectionBase::preprocessDescriptions() {
 	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
 		const ADGameDescription *g = (const ADGameDescription *)descPtr;
 
+		// Intern the file property keys, so that every scan does not rebuild and hash them
+		_firstFileKeys.push_back(_fileKeys.size());
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
+			_fileKeys.push_back(Common::Atom(md5PropToCachePrefix(md5prop) + ':' + fileDesc->fileName));
+		}
+
 		// Scan for potential directory globs
 		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
 			if (strchr(fileDesc->fileName, '/')) {
@@ -25,6 +25,7 @@
 #include "engines/metaengine.h"
 #include "engines/engine.h"
 
+#include "common/atom.h"
 #include "common/hash-str.h"
 
 #include "common/gui_options.h" // Keep it here, so detection tables can refer to them
@@ -554,6 +555,10 @@ private:
 private:
 	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _grayListMap;
 	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _globsMap;
+	/** Cache key of every file description, in the order of the detection tables. */
+	Common::Array<Common::Atom> _fileKeys;
+	/** Index in _fileKeys of the first file of each detection entry. */
+	Common::Array<uint> _firstFileKeys;
 	bool _hashMapsInited;
 
 protected:
@@ -598,6 +603,22 @@ protected:
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const;
 
+	/** A file whose properties are requested from the batch getFileProperties(). */
+	struct FilePropertiesRequest {
+		MD5Properties md5prop;
+		Common::Path fname;
+		bool found;
+		FileProperties fileProps;
+
+		FilePropertiesRequest(MD5Properties p, const Common::Path &f) : md5prop(p), fname(f), found(false) {}
+	};
+
+	/**
+	 * Get the properties of several files. The MD5s of plain files which
+	 * are not cached yet are computed in parallel.
+	 */
+	void getFileProperties(const FileMap &allFiles, Common::Array<FilePropertiesRequest> &requests) const;
+
 	/** Convert an AD game description into the shared game description format. */
 	virtual DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo = nullptr) const;
 
@@ -778,7 +799,25 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/**
+	 * Look up the MD5 of a file in the persistent fingerprint cache, which is
+	 * kept in the config directory across detection runs. The entry is only
+	 * used if the size and modification time of the file did not change
+	 * since it was stored.
+	 */
+	bool getFingerprint(const Common::String &key, int64 size, int64 modificationTime, Common::String &md5);
+
+	/** Store the MD5 of a file in the persistent fingerprint cache. */
+	void setFingerprint(const Common::String &key, int64 size, int64 modificationTime, const Common::String &md5);
+
+	/**
+	 * Write the persistent fingerprint cache, if it changed. Detection only
+	 * updates the cache in memory, so this is called once a scan is done,
+	 * and at shutdown.
+	 */
+	void saveFingerprints();
+
+	AdvancedDetectorCacheManager() : fingerprintsLoaded(false), fingerprintsChanged(false) {
 		clear();
 	}
 
@@ -804,6 +843,27 @@ private:
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	struct Fingerprint {
+		int64 size;
+		int64 modificationTime;
+		Common::String md5;
+		bool used;
+	};
+
+	enum {
+		/** Maximum number of files kept in the fingerprint cache */
+		kMaxFingerprints = 50000
+	};
+
+	void loadFingerprints();
+	static Common::Path getFingerprintCachePath();
+
+	// The keys contain the full path, which may be case sensitive
+	typedef Common::HashMap<Common::String, Fingerprint> FingerprintHashMap;
+	FingerprintHashMap fingerprintHashMap;
+	bool fingerprintsLoaded;
+	bool fingerprintsChanged;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
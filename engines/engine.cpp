@@ -27,6 +27,7 @@
 #include "common/config-manager.h"
 #include "common/events.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/system.h"
 #include "common/str.h"
 #include "common/ustr.h"
@@ -227,7 +228,14 @@ Engine::~Engine() {
 }
 
 void Engine::initializePath(const Common::FSNode &gamePath) {
-	SearchMan.addDirectory(gamePath, 0, 4);
+	if (!gamePath.exists() || !gamePath.isDirectory())
+		error("Failed to add directory %s", gamePath.getPath().toString().c_str());
+
+	// The game data is not written to while the game runs, so its files
+	// may be memory mapped
+	Common::FSDirectory *dir = new Common::FSDirectory(gamePath, 4, false, SearchMan.getIgnoreClashes());
+	dir->setMapFiles(true);
+	SearchMan.add(gamePath.getPath().toString(), dir, 0);
 }
 
 bool Engine::enhancementEnabled(int32 cls) {
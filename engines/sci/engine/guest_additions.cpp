@@ -88,7 +88,7 @@ void GuestAdditions::invokeSelector(const reg_t objId, const Selector selector,
 
 bool GuestAdditions::shouldSyncAudioToScummVM() const {
 	const SciGameId gameId = g_sci->getGameId();
-	Common::List<ExecStack>::const_iterator it;
+	ExecStackList::const_iterator it;
 	for (it = _state->_executionStack.begin(); it != _state->_executionStack.end(); ++it) {
 		const ExecStack &call = *it;
 		const Common::String objName = _segMan->getObjectName(call.sendp);
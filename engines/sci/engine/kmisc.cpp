@@ -999,7 +999,7 @@ reg_t kStub(EngineState *s, int argc, reg_t *argv) {
 	int kernelCallNr = -1;
 	int kernelSubCallNr = -1;
 
-	Common::List<ExecStack>::const_iterator callIterator = s->_executionStack.end();
+	ExecStackList::const_iterator callIterator = s->_executionStack.end();
 	if (callIterator != s->_executionStack.begin()) {
 		callIterator--;
 		ExecStack lastCall = *callIterator;
@@ -1117,7 +1117,7 @@ void logBacktrace() {
 	EngineState *s = g_sci->getEngineState();
 
 	con->debugPrintf("Call stack (current base: 0x%x):\n", s->executionStackBase);
-	Common::List<ExecStack>::const_iterator iter;
+	ExecStackList::const_iterator iter;
 	uint i = 0;
 
 
@@ -69,7 +69,8 @@ static const uint16 s_halfWidthSJISMap[256] = {
 EngineState::EngineState(SegManager *segMan) :
 	_segMan(segMan),
 	_msgState(nullptr),
-	_dirseeker() {
+	_dirseeker(),
+	_executionStack(Common::PoolAllocator<ExecStack>(_executionStackPool)) {
 
 	reset(false);
 }
@@ -193,7 +194,7 @@ void EngineState::shrinkStackToBase() {
 	if (_executionStack.size() > 0) {
 		uint size = executionStackBase + 1;
 		assert(_executionStack.size() >= size);
-		Common::List<ExecStack>::iterator iter = _executionStack.begin();
+		ExecStackList::iterator iter = _executionStack.begin();
 		for (uint i = 0; i < size; ++i)
 			++iter;
 		_executionStack.erase(iter, _executionStack.end());
@@ -412,7 +413,7 @@ SciCallOrigin EngineState::getCurrentCallOrigin() const {
 
 	if (xs->debugLocalCallOffset != -1) {
 		// if lastcall was actually a local call search back for a real call
-		Common::List<ExecStack>::const_iterator callIterator = _executionStack.end();
+		ExecStackList::const_iterator callIterator = _executionStack.end();
 		while (callIterator != _executionStack.begin()) {
 			callIterator--;
 			const ExecStack &loopCall = *callIterator;
@@ -443,7 +444,7 @@ SciCallOrigin EngineState::getCurrentCallOrigin() const {
 }
 
 bool EngineState::callInStack(const reg_t object, const Selector selector) const {
-	Common::List<ExecStack>::const_iterator it;
+	ExecStackList::const_iterator it;
 	for (it = _executionStack.begin(); it != _executionStack.end(); ++it) {
 		const ExecStack &call = *it;
 		if (call.sendp == object && call.debugSelector == selector) {
@@ -24,6 +24,7 @@
 
 #include "common/scummsys.h"
 #include "common/array.h"
+#include "common/memorypool.h"
 #include "common/serializer.h"
 #include "common/str-array.h"
 
@@ -97,6 +98,12 @@ struct SciCallOrigin {
 	}
 };
 
+/**
+ * The execution stack. A frame is pushed and popped for every call, so the
+ * nodes come from a pool.
+ */
+typedef Common::List<ExecStack, Common::PoolAllocator<ExecStack> > ExecStackList;
+
 struct EngineState : public Common::Serializable {
 	EngineState(SegManager *segMan);
 	~EngineState() override;
@@ -144,7 +151,8 @@ struct EngineState : public Common::Serializable {
 
 	/* VM Information */
 
-	Common::List<ExecStack> _executionStack; /**< The execution stack */
+	Common::ListNodePool<ExecStack> _executionStackPool;
+	ExecStackList _executionStack; /**< The execution stack */
 	/**
 	 * When called from kernel functions, the vm is re-started recursively on
 	 * the same stack. This variable contains the stack base for the current vm.
@@ -248,7 +248,7 @@ ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPt
 	int activeBreakpointTypes = g_sci->_debugState._activeBreakpointTypes;
 	ObjVarRef varp;
 
-	Common::List<ExecStack>::iterator prevElementIterator = s->_executionStack.end();
+	ExecStackList::iterator prevElementIterator = s->_executionStack.end();
 
 	while (framesize > 0) {
 		selector = argp->requireUint16();
@@ -210,18 +210,22 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
+	_dataBorrowed = false;
 }
 
 Resource::~Resource() {
-	delete[] _data;
+	if (!_dataBorrowed)
+		delete[] _data;
 	delete[] _header;
 	if (_source && _source->getSourceType() == kSourcePatch)
 		delete _source;
 }
 
 void Resource::unalloc() {
-	delete[] _data;
+	if (!_dataBorrowed)
+		delete[] _data;
 	_data = nullptr;
+	_dataBorrowed = false;
 	delete[] _header;
 	_header = nullptr;
 	_status = kResStatusNoMalloc;
@@ -314,18 +318,38 @@ ResourceSource *ResourceManager::findVolume(ResourceSource *map, int volume_nr)
 
 // Resource manager constructors and operations
 
+/**
+ * Point the resource at its data in a memory mapped volume file, instead of
+ * reading it into a buffer. The data starts at the position of @p file.
+ *
+ * @return True if the data was borrowed, false if it has to be read.
+ */
+bool Resource::borrowData(Common::SeekableReadStream *file) {
+	// Only volume files which stay open for as long as the resource
+	// manager exists may lend their data
+	if (!_resMan->isMappedVolumeFile(file))
+		return false;
+
+	const byte *view = file->getView(file->pos(), size());
+	if (!view)
+		return false;
+
+	_data = view;
+	_dataBorrowed = true;
+	file->skip(size());
+	_status = kResStatusAllocated;
+	return true;
+}
+
 bool Resource::loadPatch(Common::SeekableReadStream *file) {
 	// We assume that the resource type matches `type`
 	//  We also assume that the current file position is right at the actual data (behind resourceid/headersize byte)
 
-	byte *ptr = new byte[size()];
-	_data = ptr;
-
 	if (_headerSize > 0)
 		_header = new byte[_headerSize];
 
-	if (data() == nullptr || (_headerSize > 0 && _header == nullptr)) {
-		error("Can't allocate %u bytes needed for loading %s", size() + _headerSize, _id.toString().c_str());
+	if (_headerSize > 0 && _header == nullptr) {
+		error("Can't allocate %u bytes needed for loading %s", _headerSize, _id.toString().c_str());
 	}
 
 	uint32 bytesRead;
@@ -335,6 +359,16 @@ bool Resource::loadPatch(Common::SeekableReadStream *file) {
 			error("Read %d bytes from %s but expected %d", bytesRead, _id.toString().c_str(), _headerSize);
 	}
 
+	if (borrowData(file))
+		return true;
+
+	byte *ptr = new byte[size()];
+	_data = ptr;
+
+	if (data() == nullptr) {
+		error("Can't allocate %u bytes needed for loading %s", size(), _id.toString().c_str());
+	}
+
 	bytesRead = file->read(ptr, size());
 	if (bytesRead != size())
 		error("Read %d bytes from %s but expected %u", bytesRead, _id.toString().c_str(), size());
@@ -386,9 +420,21 @@ Common::SeekableReadStream *ResourceManager::getVolumeFile(ResourceSource *sourc
 		}
 		++it;
 	}
+	for (it = _mappedVolumeFiles.begin(); it != _mappedVolumeFiles.end(); ++it) {
+		if (scumm_stricmp((*it)->getName(), filename.c_str()) == 0)
+			return *it;
+	}
 	// adding a new file
 	file = new Common::File;
 	if (file->open(source->getLocationName())) {
+		// Mapped files do not keep a file descriptor open, so they are not
+		// limited like the others. They stay open as long as the resource
+		// manager, since resources borrow their data.
+		if (file->getView(0, 0)) {
+			_mappedVolumeFiles.push_front(file);
+			return file;
+		}
+
 		if (_volumeFiles.size() == MAX_OPENED_VOLUMES) {
 			it = --_volumeFiles.end();
 			delete *it;
@@ -420,6 +466,14 @@ void ResourceManager::disposeVolumeFileStream(Common::SeekableReadStream *fileSt
 	// deleted from _volumeFiles
 }
 
+bool ResourceManager::isMappedVolumeFile(const Common::SeekableReadStream *fileStream) const {
+	for (Common::List<Common::File *>::const_iterator it = _mappedVolumeFiles.begin(); it != _mappedVolumeFiles.end(); ++it) {
+		if (*it == fileStream)
+			return true;
+	}
+	return false;
+}
+
 void ResourceManager::loadResource(Resource *res) {
 	res->_source->loadResource(this, res);
 	if (_patcher) {
@@ -1121,6 +1175,10 @@ ResourceManager::~ResourceManager() {
 		delete *it;
 		++it;
 	}
+
+	// The resources borrowing from these are gone now
+	for (it = _mappedVolumeFiles.begin(); it != _mappedVolumeFiles.end(); ++it)
+		delete *it;
 }
 
 void ResourceManager::removeFromLRU(Resource *res) {
@@ -40,6 +40,8 @@ class WriteStream;
 class SeekableReadStream;
 }
 
+class SciResourceTestSuite;
+
 namespace Sci {
 
 enum {
@@ -267,6 +269,7 @@ class Resource : public SciSpan<const byte> {
 #ifdef ENABLE_SCI32
 	friend class ChunkResourceSource;
 #endif
+	friend class ::SciResourceTestSuite;
 
 protected:
 	/**
@@ -277,6 +280,12 @@ protected:
 	byte *_header;
 	uint32 _headerSize;
 
+	/**
+	 * Whether _data points into a memory mapped volume file instead of a
+	 * buffer of its own. Such data is read-only and must not be freed.
+	 */
+	bool _dataBorrowed;
+
 public:
 	Resource(ResourceManager *resMan, ResourceId id);
 	~Resource();
@@ -312,6 +321,7 @@ protected:
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
+	bool borrowData(Common::SeekableReadStream *file);
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
 	bool loadFromWaveFile(Common::SeekableReadStream *file);
@@ -340,6 +350,7 @@ class ResourceManager {
 #ifdef ENABLE_SCI32
 	friend class ChunkResourceSource;
 #endif
+	friend class ::SciResourceTestSuite;
 
 public:
 	/**
@@ -364,6 +375,12 @@ public:
 	 */
 	void addAppropriateSourcesForDetection(const Common::FSList &fslist);	// TODO: Switch from FSList to Common::Archive?
 
+	/**
+	 * Checks whether a volume file stream is memory mapped and stays open
+	 * as long as the resource manager, so resources may borrow its data.
+	 */
+	bool isMappedVolumeFile(const Common::SeekableReadStream *fileStream) const;
+
 	/**
 	 * Looks up a resource's data.
 	 * @param id	The resource type to look for
@@ -504,6 +521,7 @@ protected:
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
+	Common::List<Common::File *> _mappedVolumeFiles; ///< memory mapped volume files, resources may borrow their data
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
 	ResVersion _volVersion; ///< resource.0xx version
 	ResVersion _mapVersion; ///< resource.map version
@@ -82,6 +82,9 @@ AudioVolumeResourceSource::AudioVolumeResourceSource(ResourceManager *resMan, co
 }
 
 bool Resource::loadFromWaveFile(Common::SeekableReadStream *file) {
+	if (borrowData(file))
+		return true;
+
 	byte *ptr = new byte[_size];
 	_data = ptr;
 
@@ -145,6 +148,9 @@ bool Resource::loadFromAudioVolumeSCI11(Common::SeekableReadStream *file) {
 }
 
 bool Resource::loadFromAudioVolumeSCI1(Common::SeekableReadStream *file) {
+	if (borrowData(file))
+		return true;
+
 	byte *ptr = new byte[size()];
 	_data = ptr;
 
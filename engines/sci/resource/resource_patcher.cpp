@@ -574,19 +574,22 @@ void ResourcePatcher::patchResource(Resource &resource, const GameResourcePatch
 		return;
 	}
 
-	if (size.delta != 0) {
+	// Borrowed data is a read-only mapping of the volume file, so it is
+	// patched into a copy
+	if (size.delta != 0 || resource._dataBorrowed) {
 		// In the future it should be possible to have a negative size delta for
 		// resources that need to be truncated, but for now just keep it
 		// positive until there's a need for truncation
-		assert(size.delta > 0);
+		assert(size.delta >= 0);
 
 		const int32 newSize = resource.size() + size.delta;
 		assert(newSize > 0);
 
 		target = new byte[newSize];
 
-		oldData = resource._data;
+		oldData = resource._dataBorrowed ? nullptr : resource._data;
 		resource._data = target;
+		resource._dataBorrowed = false;
 		resource._size = newSize;
 	} else {
 		target = const_cast<byte *>(source);
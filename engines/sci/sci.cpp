@@ -785,7 +785,7 @@ void SciEngine::errorString(const char *buf_input, char *buf_output, int buf_out
 				function = Common::String::format("k%s", _kernel->getKernelName(call.debugKernelFunction, call.debugKernelSubFunction).c_str());
 			}
 			// Kernel calls do not have a pc. walk the stack back to the most recent for script number.
-			Common::List<ExecStack>::const_iterator it;
+			ExecStackList::const_iterator it;
 			for (it = s->_executionStack.reverse_begin(); it != s->_executionStack.end(); --it) {
 				if (it->type != EXEC_STACK_TYPE_KERNEL) {
 					pc = it->addr.pc;
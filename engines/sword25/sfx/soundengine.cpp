@@ -38,6 +38,7 @@
 #include "audio/audiostream.h"
 #include "audio/decoders/vorbis.h"
 #include "audio/mididrv.h"
+#include "audio/prefetch.h"
 
 #include "common/system.h"
 #include "common/config-manager.h"
@@ -241,6 +242,10 @@ uint SoundEngine::playSoundEx(const Common::String &fileName, SOUND_TYPES type,
 
 	Audio::SeekableAudioStream *stream = Audio::makeVorbisStream(in, DisposeAfterUse::YES);
 
+	// Music tracks are long enough to be worth decoding outside the mixer
+	if (stream && type == MUSIC)
+		stream = new Audio::PrefetchingAudioStream(stream);
+
 	if (loop) {
 		Audio::AudioStream *audio = new Audio::LoopingAudioStream(stream, 0, DisposeAfterUse::YES);
 
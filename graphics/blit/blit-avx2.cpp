@@ -22,6 +22,8 @@
 #include "common/scummsys.h"
 
 #include "graphics/blit/blit-alpha.h"
+#include "graphics/blit/blit-fast.h"
+#include "graphics/blit/blit-scale.h"
 #include "graphics/pixelformat.h"
 
 #include <immintrin.h>
@@ -321,6 +323,163 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_AVX2>(args, blendMode, alphaType);
 }
 
+class FastBlitImpl_AVX2 : public FastBlitImpl_Base {
+	template<int sr, int sg, int sb, int sa, int dr, int dg, int db, int da>
+	static inline __m256i swizzleMask() {
+		const int from[4] = { sr, sg, sb, sa };
+		const int to[4] = { dr, dg, db, da };
+
+		// Bytes with the top bit set are cleared by the shuffle
+		int8 bytes[32];
+		memset(bytes, 0x80, sizeof(bytes));
+		for (int p = 0; p < 8; ++p) {
+			for (int c = 0; c < 4; ++c) {
+				if (from[c] >= 0 && to[c] >= 0)
+					bytes[p * 4 + to[c] / 8] = (p & 3) * 4 + from[c] / 8;
+			}
+		}
+		return _mm256_loadu_si256((const __m256i *)bytes);
+	}
+
+public:
+	template<int sr, int sg, int sb, int sa, int dr, int dg, int db, int da>
+	static void swizzle(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h) {
+		const __m256i mask = swizzleMask<sr, sg, sb, sa, dr, dg, db, da>();
+		const __m256i alpha = _mm256_set1_epi32((sa < 0 && da >= 0) ? 0xFFu << (da & 31) : 0);
+
+		for (uint y = 0; y < h; ++y) {
+			const uint32 *s = (const uint32 *)(src + y * srcPitch);
+			uint32 *d = (uint32 *)(dst + y * dstPitch);
+
+			uint x = 0;
+			for (; x + 8 <= w; x += 8) {
+				const __m256i in = _mm256_loadu_si256((const __m256i *)(s + x));
+				_mm256_storeu_si256((__m256i *)(d + x), _mm256_or_si256(_mm256_shuffle_epi8(in, mask), alpha));
+			}
+			for (; x < w; ++x)
+				d[x] = swizzlePixel<sr, sg, sb, sa, dr, dg, db, da>(s[x]);
+		}
+	}
+
+	template<int dr, int dg, int db, int da>
+	static void expand565(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h) {
+		const __m256i rbMask = _mm256_set1_epi32(0xF8);
+		const __m256i gMask = _mm256_set1_epi32(0xFC);
+		const __m256i alpha = _mm256_set1_epi32(da >= 0 ? 0xFFu << (da & 31) : 0);
+
+		for (uint y = h; y-- > 0;) {
+			const uint16 *s = (const uint16 *)(src + y * srcPitch);
+			uint32 *d = (uint32 *)(dst + y * dstPitch);
+
+			uint x = w;
+			for (; x >= 8; x -= 8) {
+				const __m256i in = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(s + x - 8)));
+
+				const __m256i r = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(in, 8), rbMask), _mm256_srli_epi32(in, 13));
+				const __m256i g = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(in, 3), gMask), _mm256_and_si256(_mm256_srli_epi32(in, 9), _mm256_set1_epi32(3)));
+				const __m256i b = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(in, 3), rbMask), _mm256_and_si256(_mm256_srli_epi32(in, 2), _mm256_set1_epi32(7)));
+
+				const __m256i out = _mm256_or_si256(
+					_mm256_or_si256(_mm256_slli_epi32(r, dr), _mm256_slli_epi32(g, dg)),
+					_mm256_or_si256(_mm256_slli_epi32(b, db), alpha));
+				_mm256_storeu_si256((__m256i *)(d + x - 8), out);
+			}
+			expandTail565<dr, dg, db, da>(d, s, 0, x);
+		}
+	}
+
+	template<typename DstColor>
+	static void map(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h, const uint32 *map) {
+		const uint step = 32 / sizeof(DstColor);
+
+		for (uint y = h; y-- > 0;) {
+			const byte *s = src + y * srcPitch;
+			DstColor *d = (DstColor *)(dst + y * dstPitch);
+
+			uint x = w;
+			for (; x >= step; x -= step) {
+				const byte *p = s + x - step;
+				const __m256i lo = _mm256_i32gather_epi32((const int *)map, _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p)), 4);
+				if (sizeof(DstColor) == 4) {
+					_mm256_storeu_si256((__m256i *)(d + x - step), lo);
+				} else {
+					// The map only contains 16 bit values, so packing does not saturate
+					const __m256i hi = _mm256_i32gather_epi32((const int *)map, _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p + 8))), 4);
+					const __m256i out = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+					_mm256_storeu_si256((__m256i *)(d + x - step), out);
+				}
+			}
+			mapTail<DstColor>(d, s, 0, x, map);
+		}
+	}
+};
+
+FastBlitFunc getFastBlitFuncAVX2(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	return getFastBlitFuncT<FastBlitImpl_AVX2>(dstFmt, srcFmt);
+}
+
+FastBlitMapFunc getFastBlitMapFuncAVX2(uint bytesPerPixel) {
+	return getFastBlitMapFuncT<FastBlitImpl_AVX2>(bytesPerPixel);
+}
+
+class BilinearImpl_AVX2 : public BilinearImpl_Base {
+	static FORCEINLINE __m256i gather(const byte *src, const int32 *off) {
+		return _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)off), 1);
+	}
+
+	// Each factor in both 16 bit halves of its 32 bit lane
+	static FORCEINLINE __m256i loadFactors(const int32 *e) {
+		const __m256i in = _mm256_loadu_si256((const __m256i *)e);
+		return _mm256_or_si256(in, _mm256_slli_epi32(in, 16));
+	}
+
+	// a + (((b - a) * e) >> 16) in 16 bit lanes. _mm256_mulhi_epi16 treats
+	// factors of 32768 and above as negative, which adding (b - a) corrects.
+	static FORCEINLINE __m256i lerp(__m256i a, __m256i b, __m256i e) {
+		const __m256i d = _mm256_sub_epi16(b, a);
+		const __m256i hi = _mm256_add_epi16(_mm256_mulhi_epi16(d, e), _mm256_and_si256(d, _mm256_srai_epi16(e, 15)));
+		return _mm256_add_epi16(hi, a);
+	}
+
+	static FORCEINLINE __m256i interpolateVector(__m256i c00, __m256i c01, __m256i c10, __m256i c11, __m256i ex, __m256i ey) {
+		return lerp(lerp(c00, c01, ex), lerp(c10, c11, ex), ey);
+	}
+
+public:
+	static void interpolate(uint32 *dst, const byte *src0, const byte *src1,
+	                        const int32 *off0, const int32 *off1,
+	                        const int32 *ex, const int32 *ey, uint count, uint32 mask) {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i maskv = _mm256_set1_epi32(mask);
+
+		uint x = 0;
+		for (; x + 8 <= count; x += 8) {
+			const __m256i c00 = gather(src0, off0 + x);
+			const __m256i c01 = gather(src0, off1 + x);
+			const __m256i c10 = gather(src1, off0 + x);
+			const __m256i c11 = gather(src1, off1 + x);
+			const __m256i exv = loadFactors(ex + x);
+			const __m256i eyv = loadFactors(ey + x);
+
+			// The unpacks work within the 128 bit halves, so lo holds the
+			// pixels 0, 1, 4 and 5, and hi the pixels 2, 3, 6 and 7. Packing
+			// them again restores the order.
+			const __m256i lo = interpolateVector(_mm256_unpacklo_epi8(c00, zero), _mm256_unpacklo_epi8(c01, zero),
+			                                     _mm256_unpacklo_epi8(c10, zero), _mm256_unpacklo_epi8(c11, zero),
+			                                     _mm256_unpacklo_epi32(exv, exv), _mm256_unpacklo_epi32(eyv, eyv));
+			const __m256i hi = interpolateVector(_mm256_unpackhi_epi8(c00, zero), _mm256_unpackhi_epi8(c01, zero),
+			                                     _mm256_unpackhi_epi8(c10, zero), _mm256_unpackhi_epi8(c11, zero),
+			                                     _mm256_unpackhi_epi32(exv, exv), _mm256_unpackhi_epi32(eyv, eyv));
+			_mm256_storeu_si256((__m256i *)(dst + x), _mm256_and_si256(_mm256_packus_epi16(lo, hi), maskv));
+		}
+		interpolateTail(dst, src0, src1, off0, off1, ex, ey, x, count, mask);
+	}
+};
+
+void bilinearInterpolateAVX2(uint32 *dst, const byte *src0, const byte *src1, const int32 *off0, const int32 *off1, const int32 *ex, const int32 *ey, uint count, uint32 mask) {
+	BilinearImpl_AVX2::interpolate(dst, src0, src1, off0, off1, ex, ey, count, mask);
+}
+
 } // End of namespace Graphics
 
 #if defined(__clang__)
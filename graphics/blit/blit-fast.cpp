@@ -20,8 +20,10 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit/blit-fast.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
+#include "common/system.h"
 
 namespace Graphics {
 
@@ -87,7 +89,42 @@ static const FastBlitLookup fastBlitFuncs_4to4[] = {
 	{ swapBlit<true,  24>, Graphics::PixelFormat(4, 8, 8, 8, 8,  8, 16, 24,  0), Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16,  8,  0) }  // BGRA8888 -> RGBA8888
 };
 
+FastBlitLookupFunc FastBlitSIMD::lookupFunc = nullptr;
+FastBlitMapLookupFunc FastBlitSIMD::lookupMapFunc = nullptr;
+
+void FastBlitSIMD::select() {
+	lookupFunc = lookupNone;
+	lookupMapFunc = lookupMapNone;
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		lookupFunc = getFastBlitFuncNEON;
+		lookupMapFunc = getFastBlitMapFuncNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		lookupFunc = getFastBlitFuncSSE2;
+		lookupMapFunc = getFastBlitMapFuncSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		lookupFunc = getFastBlitFuncAVX2;
+		lookupMapFunc = getFastBlitMapFuncAVX2;
+	}
+#endif
+}
+
 FastBlitFunc getFastBlitFunc(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	// Prefer the SIMD routines if the CPU supports them
+	if (!FastBlitSIMD::lookupFunc)
+		FastBlitSIMD::select();
+
+	FastBlitFunc func = FastBlitSIMD::lookupFunc(dstFmt, srcFmt);
+	if (func)
+		return func;
+
 	const uint dstBpp = dstFmt.bytesPerPixel;
 	const uint srcBpp = srcFmt.bytesPerPixel;
 	const FastBlitLookup *table = nullptr;
@@ -111,4 +148,11 @@ FastBlitFunc getFastBlitFunc(const PixelFormat &dstFmt, const PixelFormat &srcFm
 	return nullptr;
 }
 
+FastBlitMapFunc getFastBlitMapFunc(uint bytesPerPixel) {
+	if (!FastBlitSIMD::lookupMapFunc)
+		FastBlitSIMD::select();
+
+	return FastBlitSIMD::lookupMapFunc(bytesPerPixel);
+}
+
 } // End of namespace Graphics
@@ -0,0 +1,200 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_BLIT_FAST_H
+#define GRAPHICS_BLIT_FAST_H
+
+#include "graphics/blit.h"
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * Converts a rectangle of CLUT8 pixels using a map, like crossBlitMap().
+ * The map must contain colors of the size the function was looked up for.
+ */
+typedef void (*FastBlitMapFunc)(byte *, const byte *, const uint, const uint, const uint, const uint, const uint32 *);
+
+/**
+ * Look up an optimised routine for crossBlitMap() without a key or mask.
+ *
+ * @return A function pointer, or nullptr if none is available for
+ *         @p bytesPerPixel on this CPU.
+ */
+FastBlitMapFunc getFastBlitMapFunc(uint bytesPerPixel);
+
+typedef FastBlitFunc (*FastBlitLookupFunc)(const PixelFormat &, const PixelFormat &);
+typedef FastBlitMapFunc (*FastBlitMapLookupFunc)(uint);
+
+/**
+ * The SIMD lookups used by getFastBlitFunc() and getFastBlitMapFunc().
+ * They are chosen for the CPU on first use; tests may set them beforehand.
+ */
+struct FastBlitSIMD {
+	static FastBlitLookupFunc lookupFunc;
+	static FastBlitMapLookupFunc lookupMapFunc;
+
+	/** Lookups for CPUs without a supported instruction set. */
+	static FastBlitFunc lookupNone(const PixelFormat &dstFmt, const PixelFormat &srcFmt) { return nullptr; }
+	static FastBlitMapFunc lookupMapNone(uint bytesPerPixel) { return nullptr; }
+
+	static void select();
+};
+
+/**
+ * The SIMD implementations of getFastBlitFunc() and getFastBlitMapFunc().
+ * They must only be called if the CPU supports the instruction set.
+ */
+#ifdef SCUMMVM_NEON
+FastBlitFunc getFastBlitFuncNEON(const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+FastBlitMapFunc getFastBlitMapFuncNEON(uint bytesPerPixel);
+#endif
+#ifdef SCUMMVM_SSE2
+FastBlitFunc getFastBlitFuncSSE2(const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+FastBlitMapFunc getFastBlitMapFuncSSE2(uint bytesPerPixel);
+#endif
+#ifdef SCUMMVM_AVX2
+FastBlitFunc getFastBlitFuncAVX2(const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+FastBlitMapFunc getFastBlitMapFuncAVX2(uint bytesPerPixel);
+#endif
+
+/**
+ * Scalar versions of the conversions done by the SIMD implementations, for
+ * the pixels which do not fill a whole vector.
+ *
+ * The channel positions are given as shifts, with -1 for a missing alpha
+ * channel. All 32 bpp channels have 8 bits.
+ */
+class FastBlitImpl_Base {
+protected:
+	template<int from, int to>
+	static inline uint32 moveChannel(uint32 col) {
+		if (to < 0)
+			return 0;
+		if (from < 0)
+			return 0xFFu << (to & 31);
+		return ((col >> (from & 31)) & 0xFF) << (to & 31);
+	}
+
+	template<int sr, int sg, int sb, int sa, int dr, int dg, int db, int da>
+	static inline uint32 swizzlePixel(uint32 col) {
+		return moveChannel<sr, dr>(col) | moveChannel<sg, dg>(col) |
+		       moveChannel<sb, db>(col) | moveChannel<sa, da>(col);
+	}
+
+	template<int dr, int dg, int db, int da>
+	static inline uint32 expandPixel565(uint16 col) {
+		const uint32 r = ColorComponent<5>::expand(col >> 11);
+		const uint32 g = ColorComponent<6>::expand(col >> 5);
+		const uint32 b = ColorComponent<5>::expand(col);
+		return (r << dr) | (g << dg) | (b << db) | (da >= 0 ? 0xFFu << (da & 31) : 0);
+	}
+
+	/**
+	 * Convert the pixels @p x to @p end - 1 of a row from the right to the
+	 * left, as the pixels which are left over by a vector loop.
+	 */
+	template<int dr, int dg, int db, int da>
+	static inline void expandTail565(uint32 *dst, const uint16 *src, uint x, uint end) {
+		while (end > x) {
+			end--;
+			dst[end] = expandPixel565<dr, dg, db, da>(src[end]);
+		}
+	}
+
+	template<typename DstColor>
+	static inline void mapTail(DstColor *dst, const byte *src, uint x, uint end, const uint32 *map) {
+		while (end > x) {
+			end--;
+			dst[end] = map[src[end]];
+		}
+	}
+};
+
+/**
+ * The format pairs with SIMD routines. Each implementation provides the
+ * template functions
+ *
+ *   swizzle<sr, sg, sb, sa, dr, dg, db, da>  32 bpp to 32 bpp
+ *   expand565<dr, dg, db, da>                RGB565 to 32 bpp
+ *   map<DstColor>                            CLUT8 to 16 or 32 bpp
+ *
+ * Conversions to a larger pixel size run from the bottom right to the top
+ * left, so they can convert a surface in place, like crossBlit() does.
+ */
+template<class Impl>
+FastBlitFunc getFastBlitFuncT(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	static const PixelFormat rgb565   (2, 5, 6, 5, 0, 11,  5,  0,  0);
+	static const PixelFormat rgba8888 (4, 8, 8, 8, 8, 24, 16,  8,  0);
+	static const PixelFormat argb8888 (4, 8, 8, 8, 8, 16,  8,  0, 24);
+	static const PixelFormat abgr8888 (4, 8, 8, 8, 8,  0,  8, 16, 24);
+	static const PixelFormat bgra8888 (4, 8, 8, 8, 8,  8, 16, 24,  0);
+	static const PixelFormat xrgb8888 (4, 8, 8, 8, 0, 16,  8,  0,  0);
+	static const PixelFormat xbgr8888 (4, 8, 8, 8, 0,  0,  8, 16,  0);
+
+	static const struct {
+		FastBlitFunc func;
+		const PixelFormat &srcFmt, &dstFmt;
+	} table[] = {
+		{ Impl::template expand565<24, 16,  8,  0>, rgb565, rgba8888 },
+		{ Impl::template expand565<16,  8,  0, 24>, rgb565, argb8888 },
+		{ Impl::template expand565< 0,  8, 16, 24>, rgb565, abgr8888 },
+		{ Impl::template expand565< 8, 16, 24,  0>, rgb565, bgra8888 },
+		{ Impl::template expand565<16,  8,  0, -1>, rgb565, xrgb8888 },
+		{ Impl::template expand565< 0,  8, 16, -1>, rgb565, xbgr8888 },
+
+		{ Impl::template swizzle<24, 16,  8,  0, 16,  8,  0, 24>, rgba8888, argb8888 },
+		{ Impl::template swizzle<24, 16,  8,  0,  0,  8, 16, 24>, rgba8888, abgr8888 },
+		{ Impl::template swizzle<24, 16,  8,  0,  8, 16, 24,  0>, rgba8888, bgra8888 },
+		{ Impl::template swizzle<16,  8,  0, 24, 24, 16,  8,  0>, argb8888, rgba8888 },
+		{ Impl::template swizzle<16,  8,  0, 24,  0,  8, 16, 24>, argb8888, abgr8888 },
+		{ Impl::template swizzle<16,  8,  0, 24,  8, 16, 24,  0>, argb8888, bgra8888 },
+		{ Impl::template swizzle< 0,  8, 16, 24, 24, 16,  8,  0>, abgr8888, rgba8888 },
+		{ Impl::template swizzle< 0,  8, 16, 24, 16,  8,  0, 24>, abgr8888, argb8888 },
+		{ Impl::template swizzle< 0,  8, 16, 24,  8, 16, 24,  0>, abgr8888, bgra8888 },
+		{ Impl::template swizzle< 8, 16, 24,  0, 24, 16,  8,  0>, bgra8888, rgba8888 },
+		{ Impl::template swizzle< 8, 16, 24,  0, 16,  8,  0, 24>, bgra8888, argb8888 },
+		{ Impl::template swizzle< 8, 16, 24,  0,  0,  8, 16, 24>, bgra8888, abgr8888 },
+		{ Impl::template swizzle<16,  8,  0, -1, 24, 16,  8,  0>, xrgb8888, rgba8888 },
+		{ Impl::template swizzle<16,  8,  0, -1, 16,  8,  0, 24>, xrgb8888, argb8888 },
+		{ Impl::template swizzle< 0,  8, 16, -1, 24, 16,  8,  0>, xbgr8888, rgba8888 },
+		{ Impl::template swizzle< 0,  8, 16, -1,  0,  8, 16, 24>, xbgr8888, abgr8888 }
+	};
+
+	for (uint i = 0; i < ARRAYSIZE(table); i++) {
+		if (srcFmt == table[i].srcFmt && dstFmt == table[i].dstFmt)
+			return table[i].func;
+	}
+	return nullptr;
+}
+
+template<class Impl>
+FastBlitMapFunc getFastBlitMapFuncT(uint bytesPerPixel) {
+	if (bytesPerPixel == 2)
+		return Impl::template map<uint16>;
+	if (bytesPerPixel == 4)
+		return Impl::template map<uint32>;
+	return nullptr;
+}
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_BLIT_FAST_H
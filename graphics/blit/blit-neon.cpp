@@ -24,6 +24,8 @@
 #ifdef SCUMMVM_NEON
 
 #include "graphics/blit/blit-alpha.h"
+#include "graphics/blit/blit-fast.h"
+#include "graphics/blit/blit-scale.h"
 #include "graphics/pixelformat.h"
 
 #include <arm_neon.h>
@@ -324,6 +326,157 @@ void BlendBlit::blitNEON(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_NEON>(args, blendMode, alphaType);
 }
 
+class FastBlitImpl_NEON : public FastBlitImpl_Base {
+	template<int from, int to>
+	static inline uint32x4_t moveChannels(uint32x4_t src) {
+		if (to < 0)
+			return vdupq_n_u32(0);
+		if (from < 0)
+			return vdupq_n_u32(0xFFu << (to & 31));
+		// Negative shifts move to the right
+		return vandq_u32(vshlq_u32(src, vdupq_n_s32(to - from)), vdupq_n_u32(0xFFu << (to & 31)));
+	}
+
+	template<int dr, int dg, int db, int da>
+	static inline uint32x4_t combine565(uint16x4_t r, uint16x4_t g, uint16x4_t b) {
+		uint32x4_t out = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(r), vdupq_n_s32(dr)), vshlq_u32(vmovl_u16(g), vdupq_n_s32(dg))),
+		                           vshlq_u32(vmovl_u16(b), vdupq_n_s32(db)));
+		if (da >= 0)
+			out = vorrq_u32(out, vdupq_n_u32(0xFFu << (da & 31)));
+		return out;
+	}
+
+public:
+	template<int sr, int sg, int sb, int sa, int dr, int dg, int db, int da>
+	static void swizzle(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h) {
+		for (uint y = 0; y < h; ++y) {
+			const uint32 *s = (const uint32 *)(src + y * srcPitch);
+			uint32 *d = (uint32 *)(dst + y * dstPitch);
+
+			uint x = 0;
+			for (; x + 4 <= w; x += 4) {
+				const uint32x4_t in = vld1q_u32(s + x);
+				const uint32x4_t out = vorrq_u32(
+					vorrq_u32(moveChannels<sr, dr>(in), moveChannels<sg, dg>(in)),
+					vorrq_u32(moveChannels<sb, db>(in), moveChannels<sa, da>(in)));
+				vst1q_u32(d + x, out);
+			}
+			for (; x < w; ++x)
+				d[x] = swizzlePixel<sr, sg, sb, sa, dr, dg, db, da>(s[x]);
+		}
+	}
+
+	template<int dr, int dg, int db, int da>
+	static void expand565(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h) {
+		const uint16x8_t rbMask = vdupq_n_u16(0xF8);
+		const uint16x8_t gMask = vdupq_n_u16(0xFC);
+
+		for (uint y = h; y-- > 0;) {
+			const uint16 *s = (const uint16 *)(src + y * srcPitch);
+			uint32 *d = (uint32 *)(dst + y * dstPitch);
+
+			uint x = w;
+			for (; x >= 8; x -= 8) {
+				const uint16x8_t in = vld1q_u16(s + x - 8);
+
+				// Expand the components to 8 bits in the 16 bit lanes
+				const uint16x8_t r = vorrq_u16(vandq_u16(vshrq_n_u16(in, 8), rbMask), vshrq_n_u16(in, 13));
+				const uint16x8_t g = vorrq_u16(vandq_u16(vshrq_n_u16(in, 3), gMask), vandq_u16(vshrq_n_u16(in, 9), vdupq_n_u16(3)));
+				const uint16x8_t b = vorrq_u16(vandq_u16(vshlq_n_u16(in, 3), rbMask), vandq_u16(vshrq_n_u16(in, 2), vdupq_n_u16(7)));
+
+				const uint32x4_t lo = combine565<dr, dg, db, da>(vget_low_u16(r), vget_low_u16(g), vget_low_u16(b));
+				const uint32x4_t hi = combine565<dr, dg, db, da>(vget_high_u16(r), vget_high_u16(g), vget_high_u16(b));
+				vst1q_u32(d + x - 4, hi);
+				vst1q_u32(d + x - 8, lo);
+			}
+			expandTail565<dr, dg, db, da>(d, s, 0, x);
+		}
+	}
+
+	template<typename DstColor>
+	static void map(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h, const uint32 *map) {
+		// NEON has no gather instruction, but storing whole vectors still
+		// beats writing each pixel on its own
+		const uint step = 16 / sizeof(DstColor);
+
+		for (uint y = h; y-- > 0;) {
+			const byte *s = src + y * srcPitch;
+			DstColor *d = (DstColor *)(dst + y * dstPitch);
+
+			uint x = w;
+			for (; x >= step; x -= step) {
+				const byte *p = s + x - step;
+				if (sizeof(DstColor) == 4) {
+					uint32x4_t out = vdupq_n_u32(map[p[0]]);
+					out = vsetq_lane_u32(map[p[1]], out, 1);
+					out = vsetq_lane_u32(map[p[2]], out, 2);
+					out = vsetq_lane_u32(map[p[3]], out, 3);
+					vst1q_u32((uint32 *)(d + x - step), out);
+				} else {
+					uint16x8_t out = vdupq_n_u16(map[p[0]]);
+					out = vsetq_lane_u16(map[p[1]], out, 1);
+					out = vsetq_lane_u16(map[p[2]], out, 2);
+					out = vsetq_lane_u16(map[p[3]], out, 3);
+					out = vsetq_lane_u16(map[p[4]], out, 4);
+					out = vsetq_lane_u16(map[p[5]], out, 5);
+					out = vsetq_lane_u16(map[p[6]], out, 6);
+					out = vsetq_lane_u16(map[p[7]], out, 7);
+					vst1q_u16((uint16 *)(d + x - step), out);
+				}
+			}
+			mapTail<DstColor>(d, s, 0, x, map);
+		}
+	}
+};
+
+FastBlitFunc getFastBlitFuncNEON(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	return getFastBlitFuncT<FastBlitImpl_NEON>(dstFmt, srcFmt);
+}
+
+FastBlitMapFunc getFastBlitMapFuncNEON(uint bytesPerPixel) {
+	return getFastBlitMapFuncT<FastBlitImpl_NEON>(bytesPerPixel);
+}
+
+class BilinearImpl_NEON : public BilinearImpl_Base {
+	// The channels of a pixel in 32 bit lanes
+	static inline int32x4_t expand(uint32 col) {
+		return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vcreate_u8(col)))));
+	}
+
+	static inline int32x4_t lerp(int32x4_t a, int32x4_t b, int32x4_t e) {
+		return vaddq_s32(vshrq_n_s32(vmulq_s32(vsubq_s32(b, a), e), 16), a);
+	}
+
+	static inline uint16x4_t interpolateVector(const byte *src0, const byte *src1, int32 off0, int32 off1, int32 ex, int32 ey) {
+		const int32x4_t exv = vdupq_n_s32(ex);
+		const int32x4_t t1 = lerp(expand(READ_UINT32(src0 + off0)), expand(READ_UINT32(src0 + off1)), exv);
+		const int32x4_t t2 = lerp(expand(READ_UINT32(src1 + off0)), expand(READ_UINT32(src1 + off1)), exv);
+		return vmovn_u32(vreinterpretq_u32_s32(lerp(t1, t2, vdupq_n_s32(ey))));
+	}
+
+public:
+	static void interpolate(uint32 *dst, const byte *src0, const byte *src1,
+	                        const int32 *off0, const int32 *off1,
+	                        const int32 *ex, const int32 *ey, uint count, uint32 mask) {
+		const uint32x4_t maskv = vdupq_n_u32(mask);
+
+		uint x = 0;
+		for (; x + 4 <= count; x += 4) {
+			const uint16x4_t p0 = interpolateVector(src0, src1, off0[x + 0], off1[x + 0], ex[x + 0], ey[x + 0]);
+			const uint16x4_t p1 = interpolateVector(src0, src1, off0[x + 1], off1[x + 1], ex[x + 1], ey[x + 1]);
+			const uint16x4_t p2 = interpolateVector(src0, src1, off0[x + 2], off1[x + 2], ex[x + 2], ey[x + 2]);
+			const uint16x4_t p3 = interpolateVector(src0, src1, off0[x + 3], off1[x + 3], ex[x + 3], ey[x + 3]);
+			const uint8x16_t out = vcombine_u8(vmovn_u16(vcombine_u16(p0, p1)), vmovn_u16(vcombine_u16(p2, p3)));
+			vst1q_u32(dst + x, vandq_u32(vreinterpretq_u32_u8(out), maskv));
+		}
+		interpolateTail(dst, src0, src1, off0, off1, ex, ey, x, count, mask);
+	}
+};
+
+void bilinearInterpolateNEON(uint32 *dst, const byte *src0, const byte *src1, const int32 *off0, const int32 *off1, const int32 *ex, const int32 *ey, uint count, uint32 mask) {
+	BilinearImpl_NEON::interpolate(dst, src0, src1, off0, off1, ex, ey, count, mask);
+}
+
 } // end of namespace Graphics
 
 #if !defined(__aarch64__) && !defined(__ARM_NEON)
@@ -25,15 +25,39 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit/blit-scale.h"
 #include "graphics/pixelformat.h"
 #include "graphics/transform_struct.h"
 
 #include "common/endian.h"
 #include "common/rect.h"
+#include "common/system.h"
 #include "math/utils.h"
 
 namespace Graphics {
 
+BilinearFunc BilinearSIMD::interpolateFunc = nullptr;
+bool BilinearSIMD::selected = false;
+
+void BilinearSIMD::select() {
+	interpolateFunc = nullptr;
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		interpolateFunc = bilinearInterpolateNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		interpolateFunc = bilinearInterpolateSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		interpolateFunc = bilinearInterpolateAVX2;
+#endif
+
+	selected = true;
+}
+
 namespace {
 
 static void scaleVertical(byte *dst, const byte *src,
@@ -226,6 +250,111 @@ void scaleBlitBilinearInterpolate(byte *dp, const byte *c01, const byte *c00, co
 	setPixel<Color, Size>(dp, fmt.ARGBToColorT<ColorMask>(dp_a, dp_r, dp_g, dp_b));
 }
 
+/**
+ * Look up the SIMD interpolation for a format. It interpolates the bytes of
+ * the pixels on their own, which is only right for 32 bpp formats with 8 bit
+ * channels. The source offsets must fit into 32 bits.
+ */
+BilinearFunc getBilinearFunc(const Graphics::PixelFormat &fmt, const uint srcPitch, const uint srcH) {
+	if (fmt.bytesPerPixel != 4 || fmt.rLoss || fmt.gLoss || fmt.bLoss || (fmt.aLoss != 0 && fmt.aLoss != 8))
+		return nullptr;
+	if ((fmt.rShift & 7) || (fmt.gShift & 7) || (fmt.bShift & 7) || (fmt.aLoss == 0 && (fmt.aShift & 7)))
+		return nullptr;
+	if ((uint64)srcPitch * srcH > 0x7FFFFFFF)
+		return nullptr;
+
+	if (!BilinearSIMD::selected)
+		BilinearSIMD::select();
+	return BilinearSIMD::interpolateFunc;
+}
+
+/**
+ * Collects runs of adjacent destination pixels, and interpolates them with
+ * a BilinearFunc.
+ */
+class BilinearBatch {
+public:
+	BilinearBatch(BilinearFunc func, const byte *src0, const byte *src1, uint32 mask)
+		: _func(func), _src0(src0), _src1(src1), _mask(mask), _dst(nullptr), _count(0) {}
+
+	void add(byte *dp, int32 off0, int32 off1, int32 ex, int32 ey) {
+		if (_count && dp != (byte *)(_dst + _count))
+			flush();
+		if (!_count)
+			_dst = (uint32 *)dp;
+
+		_off0[_count] = off0;
+		_off1[_count] = off1;
+		_ex[_count] = ex;
+		_ey[_count] = ey;
+		if (++_count == kSize)
+			flush();
+	}
+
+	void flush() {
+		if (_count)
+			_func(_dst, _src0, _src1, _off0, _off1, _ex, _ey, _count, _mask);
+		_count = 0;
+	}
+
+private:
+	static const uint kSize = 64;
+
+	BilinearFunc _func;
+	const byte *_src0, *_src1;
+	uint32 _mask;
+
+	uint32 *_dst;
+	uint _count;
+	int32 _off0[kSize], _off1[kSize];
+	int32 _ex[kSize], _ey[kSize];
+};
+
+void scaleBlitBilinearSIMD(BilinearFunc func, byte *dst, const byte *src,
+						   const uint dstPitch, const uint srcPitch,
+						   const uint dstW, const uint dstH,
+						   const uint srcW, const uint srcH,
+						   const Graphics::PixelFormat &fmt,
+						   const int *sax, const int *say, byte flip) {
+	const bool flipx = flip & FLIP_H;
+	const bool flipy = flip & FLIP_V;
+
+	const int spixelw = (srcW - 1);
+	const int spixelh = (srcH - 1);
+	const uint32 mask = fmt.ARGBToColor(255, 255, 255, 255);
+
+	// The source columns and their weights are the same in all rows
+	int32 *off0 = new int32[dstW * 4];
+	int32 *off1 = off0 + dstW;
+	int32 *ex = off1 + dstW;
+	int32 *ey = ex + dstW;
+
+	for (uint x = 0; x < dstW; x++) {
+		const int cx = (sax[x] >> 16);
+		off0[x] = (flipx ? spixelw - cx : cx) * 4;
+		off1[x] = off0[x];
+		if (cx < spixelw)
+			off1[x] += (flipx ? -4 : 4);
+		ex[x] = (sax[x] & 0xffff);
+	}
+
+	for (uint y = 0; y < dstH; y++) {
+		const int cy = (say[y] >> 16);
+		const byte *src0 = src + (flipy ? spixelh - cy : cy) * srcPitch;
+		const byte *src1 = src0;
+		if (cy < spixelh)
+			src1 += (flipy ? -(int)srcPitch : (int)srcPitch);
+
+		const int32 fy = (say[y] & 0xffff);
+		for (uint x = 0; x < dstW; x++)
+			ey[x] = fy;
+
+		func((uint32 *)(dst + dstPitch * y), src0, src1, off0, off1, ex, ey, dstW, mask);
+	}
+
+	delete[] off0;
+}
+
 template <typename ColorMask, typename Color, int Size>
 void scaleBlitBilinearLogic(byte *dst, const byte *src,
 							const uint dstPitch, const uint srcPitch,
@@ -326,7 +455,8 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 						const uint srcW, const uint srcH,
 						const Graphics::PixelFormat &fmt,
 						const TransformStruct &transform,
-						const Common::Point &newHotspot) {
+						const Common::Point &newHotspot,
+						BilinearFunc func = nullptr) {
 	const bool flipx = transform._flip & FLIP_H;
 	const bool flipy = transform._flip & FLIP_V;
 
@@ -358,6 +488,12 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 
 	byte *pc = dst;
 
+	// The SIMD interpolation reads the four source pixels from offsets,
+	// with the flips applied to the base pointers
+	const byte *src0 = src + (flipx ? Size : 0) + (flipy ? srcPitch : 0);
+	const byte *src1 = src0 + (flipy ? -(int)srcPitch : (int)srcPitch);
+	BilinearBatch batch(func, src0, src1, fmt.ARGBToColor(255, 255, 255, 255));
+
 	for (uint y = 0; y < dstH; y++) {
 		int t = cy - y;
 		int sdx = ax + (isinx * t) + xd;
@@ -372,7 +508,12 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 				dy = sh - dy;
 			}
 
-			if (filtering) {
+			if (filtering && func) {
+				if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
+					const int32 off = dy * srcPitch + dx * Size;
+					batch.add(pc, off, off + (flipx ? -Size : Size), (sdx & 0xffff), (sdy & 0xffff));
+				}
+			} else if (filtering) {
 				if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
 					const byte *sp = src + dy * srcPitch + dx * Size;
 					const byte *c00, *c01, *c10, *c11;
@@ -413,6 +554,8 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 			pc += Size;
 		}
 	}
+
+	batch.flush();
 }
 
 } // End of anonymous namespace
@@ -470,7 +613,10 @@ bool scaleBlitBilinear(byte *dst, const byte *src,
 		}
 	}
 
-	if (fmt == createPixelFormat<8888>()) {
+	BilinearFunc func = getBilinearFunc(fmt, srcPitch, srcH);
+	if (func) {
+		scaleBlitBilinearSIMD(func, dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say, flip);
+	} else if (fmt == createPixelFormat<8888>()) {
 		scaleBlitBilinearLogic<ColorMasks<8888>, uint32, 4>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say, flip);
 	} else if (fmt == createPixelFormat<888>()) {
 		scaleBlitBilinearLogic<ColorMasks<888>,  uint32, 4>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say, flip);
@@ -527,7 +673,10 @@ bool rotoscaleBlitBilinear(byte *dst, const byte *src,
 						   const Graphics::PixelFormat &fmt,
 						   const TransformStruct &transform,
 						   const Common::Point &newHotspot) {
-	if (fmt == createPixelFormat<8888>()) {
+	BilinearFunc func = getBilinearFunc(fmt, srcPitch, srcH);
+	if (func) {
+		rotoscaleBlitLogic<ColorMasks<0>,    uint32, 4, true>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot, func);
+	} else if (fmt == createPixelFormat<8888>()) {
 		rotoscaleBlitLogic<ColorMasks<8888>, uint32, 4, true>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
 	} else if (fmt == createPixelFormat<888>()) {
 		rotoscaleBlitLogic<ColorMasks<888>,  uint32, 4, true>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_BLIT_SCALE_H
+#define GRAPHICS_BLIT_SCALE_H
+
+#include "common/scummsys.h"
+#include "common/endian.h"
+
+namespace Graphics {
+
+/**
+ * Interpolates @p count pixels for the bilinear scale and rotoscale blits,
+ * for 32 bpp formats with 8 bit channels.
+ *
+ * The four source pixels of pixel i are read from src0 + off0[i],
+ * src0 + off1[i], src1 + off0[i] and src1 + off1[i]. ex[i] and ey[i] are the
+ * 16 bit fractions of the source position. The result is masked with
+ * @p mask, to clear the bits which are not part of a channel.
+ */
+typedef void (*BilinearFunc)(uint32 *dst, const byte *src0, const byte *src1,
+                             const int32 *off0, const int32 *off1,
+                             const int32 *ex, const int32 *ey, uint count, uint32 mask);
+
+/**
+ * The SIMD interpolation used by scaleBlitBilinear() and
+ * rotoscaleBlitBilinear(), or nullptr if the CPU supports none. It is chosen
+ * on first use; tests may set it beforehand.
+ */
+struct BilinearSIMD {
+	static BilinearFunc interpolateFunc;
+	static bool selected;
+
+	static void select();
+};
+
+#ifdef SCUMMVM_NEON
+void bilinearInterpolateNEON(uint32 *dst, const byte *src0, const byte *src1, const int32 *off0, const int32 *off1, const int32 *ex, const int32 *ey, uint count, uint32 mask);
+#endif
+#ifdef SCUMMVM_SSE2
+void bilinearInterpolateSSE2(uint32 *dst, const byte *src0, const byte *src1, const int32 *off0, const int32 *off1, const int32 *ex, const int32 *ey, uint count, uint32 mask);
+#endif
+#ifdef SCUMMVM_AVX2
+void bilinearInterpolateAVX2(uint32 *dst, const byte *src0, const byte *src1, const int32 *off0, const int32 *off1, const int32 *ex, const int32 *ey, uint count, uint32 mask);
+#endif
+
+/**
+ * The scalar interpolation, for the pixels which do not fill a whole
+ * vector. It gives the same results as the generic bilinear blits.
+ */
+class BilinearImpl_Base {
+protected:
+	static inline uint32 interpolatePixel(uint32 c00, uint32 c01, uint32 c10, uint32 c11, int ex, int ey) {
+		uint32 out = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			const int p00 = (c00 >> shift) & 0xFF;
+			const int p01 = (c01 >> shift) & 0xFF;
+			const int p10 = (c10 >> shift) & 0xFF;
+			const int p11 = (c11 >> shift) & 0xFF;
+			const int t1 = (((p01 - p00) * ex) >> 16) + p00;
+			const int t2 = (((p11 - p10) * ex) >> 16) + p10;
+			out |= (uint32)((((t2 - t1) * ey) >> 16) + t1) << shift;
+		}
+		return out;
+	}
+
+	static inline void interpolateTail(uint32 *dst, const byte *src0, const byte *src1,
+	                                   const int32 *off0, const int32 *off1,
+	                                   const int32 *ex, const int32 *ey, uint x, uint count, uint32 mask) {
+		for (; x < count; ++x) {
+			dst[x] = interpolatePixel(READ_UINT32(src0 + off0[x]), READ_UINT32(src0 + off1[x]),
+			                          READ_UINT32(src1 + off0[x]), READ_UINT32(src1 + off1[x]),
+			                          ex[x], ey[x]) & mask;
+		}
+	}
+};
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_BLIT_SCALE_H
@@ -22,6 +22,8 @@
 #include "common/scummsys.h"
 
 #include "graphics/blit/blit-alpha.h"
+#include "graphics/blit/blit-fast.h"
+#include "graphics/blit/blit-scale.h"
 #include "graphics/pixelformat.h"
 
 #include <emmintrin.h>
@@ -326,6 +328,165 @@ void BlendBlit::blitSSE2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_SSE2>(args, blendMode, alphaType);
 }
 
+class FastBlitImpl_SSE2 : public FastBlitImpl_Base {
+	template<int from, int to>
+	static FORCEINLINE __m128i moveChannels(__m128i src) {
+		if (to < 0)
+			return _mm_setzero_si128();
+		if (from < 0)
+			return _mm_set1_epi32(0xFFu << (to & 31));
+		const __m128i moved = (from > to) ? _mm_srli_epi32(src, from - to) : _mm_slli_epi32(src, to - from);
+		return _mm_and_si128(moved, _mm_set1_epi32(0xFFu << (to & 31)));
+	}
+
+	template<int dr, int dg, int db, int da>
+	static FORCEINLINE __m128i combine565(__m128i r, __m128i g, __m128i b) {
+		__m128i out = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, dr), _mm_slli_epi32(g, dg)), _mm_slli_epi32(b, db));
+		if (da >= 0)
+			out = _mm_or_si128(out, _mm_set1_epi32(0xFFu << (da & 31)));
+		return out;
+	}
+
+public:
+	template<int sr, int sg, int sb, int sa, int dr, int dg, int db, int da>
+	static void swizzle(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h) {
+		for (uint y = 0; y < h; ++y) {
+			const uint32 *s = (const uint32 *)(src + y * srcPitch);
+			uint32 *d = (uint32 *)(dst + y * dstPitch);
+
+			uint x = 0;
+			for (; x + 4 <= w; x += 4) {
+				const __m128i in = _mm_loadu_si128((const __m128i *)(s + x));
+				const __m128i out = _mm_or_si128(
+					_mm_or_si128(moveChannels<sr, dr>(in), moveChannels<sg, dg>(in)),
+					_mm_or_si128(moveChannels<sb, db>(in), moveChannels<sa, da>(in)));
+				_mm_storeu_si128((__m128i *)(d + x), out);
+			}
+			for (; x < w; ++x)
+				d[x] = swizzlePixel<sr, sg, sb, sa, dr, dg, db, da>(s[x]);
+		}
+	}
+
+	template<int dr, int dg, int db, int da>
+	static void expand565(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h) {
+		const __m128i rbMask = _mm_set1_epi16(0xF8);
+		const __m128i gMask = _mm_set1_epi16(0xFC);
+
+		for (uint y = h; y-- > 0;) {
+			const uint16 *s = (const uint16 *)(src + y * srcPitch);
+			uint32 *d = (uint32 *)(dst + y * dstPitch);
+
+			uint x = w;
+			for (; x >= 8; x -= 8) {
+				const __m128i in = _mm_loadu_si128((const __m128i *)(s + x - 8));
+
+				// Expand the components to 8 bits in the 16 bit lanes
+				const __m128i r = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(in, 8), rbMask), _mm_srli_epi16(in, 13));
+				const __m128i g = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(in, 3), gMask), _mm_and_si128(_mm_srli_epi16(in, 9), _mm_set1_epi16(3)));
+				const __m128i b = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(in, 3), rbMask), _mm_and_si128(_mm_srli_epi16(in, 2), _mm_set1_epi16(7)));
+
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i lo = combine565<dr, dg, db, da>(_mm_unpacklo_epi16(r, zero), _mm_unpacklo_epi16(g, zero), _mm_unpacklo_epi16(b, zero));
+				const __m128i hi = combine565<dr, dg, db, da>(_mm_unpackhi_epi16(r, zero), _mm_unpackhi_epi16(g, zero), _mm_unpackhi_epi16(b, zero));
+				_mm_storeu_si128((__m128i *)(d + x - 4), hi);
+				_mm_storeu_si128((__m128i *)(d + x - 8), lo);
+			}
+			expandTail565<dr, dg, db, da>(d, s, 0, x);
+		}
+	}
+
+	template<typename DstColor>
+	static void map(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h, const uint32 *map) {
+		// SSE2 has no gather instruction, but storing whole vectors still
+		// beats writing each pixel on its own
+		const uint step = 16 / sizeof(DstColor);
+
+		for (uint y = h; y-- > 0;) {
+			const byte *s = src + y * srcPitch;
+			DstColor *d = (DstColor *)(dst + y * dstPitch);
+
+			uint x = w;
+			for (; x >= step; x -= step) {
+				const byte *p = s + x - step;
+				__m128i out;
+				if (sizeof(DstColor) == 4) {
+					out = _mm_setr_epi32(map[p[0]], map[p[1]], map[p[2]], map[p[3]]);
+				} else {
+					out = _mm_setr_epi16(map[p[0]], map[p[1]], map[p[2]], map[p[3]],
+					                     map[p[4]], map[p[5]], map[p[6]], map[p[7]]);
+				}
+				_mm_storeu_si128((__m128i *)(d + x - step), out);
+			}
+			mapTail<DstColor>(d, s, 0, x, map);
+		}
+	}
+};
+
+FastBlitFunc getFastBlitFuncSSE2(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	return getFastBlitFuncT<FastBlitImpl_SSE2>(dstFmt, srcFmt);
+}
+
+FastBlitMapFunc getFastBlitMapFuncSSE2(uint bytesPerPixel) {
+	return getFastBlitMapFuncT<FastBlitImpl_SSE2>(bytesPerPixel);
+}
+
+class BilinearImpl_SSE2 : public BilinearImpl_Base {
+	static FORCEINLINE __m128i gather(const byte *src, const int32 *off) {
+		return _mm_setr_epi32(*(const uint32 *)(src + off[0]), *(const uint32 *)(src + off[1]),
+		                      *(const uint32 *)(src + off[2]), *(const uint32 *)(src + off[3]));
+	}
+
+	// Each factor in both 16 bit halves of its 32 bit lane
+	static FORCEINLINE __m128i loadFactors(const int32 *e) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)e);
+		return _mm_or_si128(in, _mm_slli_epi32(in, 16));
+	}
+
+	// a + (((b - a) * e) >> 16) in 16 bit lanes. _mm_mulhi_epi16 treats
+	// factors of 32768 and above as negative, which adding (b - a) corrects.
+	static FORCEINLINE __m128i lerp(__m128i a, __m128i b, __m128i e) {
+		const __m128i d = _mm_sub_epi16(b, a);
+		const __m128i hi = _mm_add_epi16(_mm_mulhi_epi16(d, e), _mm_and_si128(d, _mm_srai_epi16(e, 15)));
+		return _mm_add_epi16(hi, a);
+	}
+
+	static FORCEINLINE __m128i interpolateVector(__m128i c00, __m128i c01, __m128i c10, __m128i c11, __m128i ex, __m128i ey) {
+		return lerp(lerp(c00, c01, ex), lerp(c10, c11, ex), ey);
+	}
+
+public:
+	static void interpolate(uint32 *dst, const byte *src0, const byte *src1,
+	                        const int32 *off0, const int32 *off1,
+	                        const int32 *ex, const int32 *ey, uint count, uint32 mask) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i maskv = _mm_set1_epi32(mask);
+
+		uint x = 0;
+		for (; x + 4 <= count; x += 4) {
+			const __m128i c00 = gather(src0, off0 + x);
+			const __m128i c01 = gather(src0, off1 + x);
+			const __m128i c10 = gather(src1, off0 + x);
+			const __m128i c11 = gather(src1, off1 + x);
+			const __m128i exv = loadFactors(ex + x);
+			const __m128i eyv = loadFactors(ey + x);
+
+			// Two pixels with 16 bit channels in each half
+			const __m128i lo = interpolateVector(_mm_unpacklo_epi8(c00, zero), _mm_unpacklo_epi8(c01, zero),
+			                                     _mm_unpacklo_epi8(c10, zero), _mm_unpacklo_epi8(c11, zero),
+			                                     _mm_unpacklo_epi32(exv, exv), _mm_unpacklo_epi32(eyv, eyv));
+			const __m128i hi = interpolateVector(_mm_unpackhi_epi8(c00, zero), _mm_unpackhi_epi8(c01, zero),
+			                                     _mm_unpackhi_epi8(c10, zero), _mm_unpackhi_epi8(c11, zero),
+			                                     _mm_unpackhi_epi32(exv, exv), _mm_unpackhi_epi32(eyv, eyv));
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_and_si128(_mm_packus_epi16(lo, hi), maskv));
+		}
+		interpolateTail(dst, src0, src1, off0, off1, ex, ey, x, count, mask);
+	}
+};
+
+void bilinearInterpolateSSE2(uint32 *dst, const byte *src0, const byte *src1, const int32 *off0, const int32 *off1, const int32 *ex, const int32 *ey, uint count, uint32 mask) {
+	BilinearImpl_SSE2::interpolate(dst, src0, src1, off0, off1, ex, ey, count, mask);
+}
+
 } // End of namespace Graphics
 
 #if !defined(__x86_64__)
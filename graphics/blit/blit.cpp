@@ -20,6 +20,7 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit/blit-fast.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
 
@@ -322,7 +323,7 @@ bool crossBlit(byte *dst, const byte *src,
 	}
 
 	// Attempt to use a faster method if possible
-	FastBlitFunc blitFunc = getFastBlitFunc(dstFmt, dstFmt);
+	FastBlitFunc blitFunc = getFastBlitFunc(dstFmt, srcFmt);
 	if (blitFunc) {
 		blitFunc(dst, src, dstPitch, srcPitch, w, h);
 		return true;
@@ -471,6 +472,13 @@ bool crossBlitMap(byte *dst, const byte *src,
 	if (!bytesPerPixel)
 		return false;
 
+	// Attempt to use a faster method if possible
+	FastBlitMapFunc blitFunc = getFastBlitMapFunc(bytesPerPixel);
+	if (blitFunc) {
+		blitFunc(dst, src, dstPitch, srcPitch, w, h, map);
+		return true;
+	}
+
 	return crossBlitMapHelperLogic<false, false>(dst, src, nullptr, w, h, bytesPerPixel, map, srcPitch, dstPitch, 0, 0);
 }
 
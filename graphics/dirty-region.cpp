@@ -0,0 +1,164 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/dirty-region.h"
+
+namespace Graphics {
+
+static inline int64 rectArea(const Common::Rect &r) {
+	return (int64)r.width() * r.height();
+}
+
+DirtyRegion::DirtyRegion(uint rectCost, uint maxRects)
+	: _rectCost(rectCost), _maxRects(maxRects), _useTiles(false), _tilesChanged(false), _tilesW(0), _tilesH(0) {
+}
+
+void DirtyRegion::add(const Common::Rect &r) {
+	Common::Rect rect(MAX<int16>(r.left, 0), MAX<int16>(r.top, 0), r.right, r.bottom);
+	if (rect.isEmpty())
+		return;
+
+	if (_useTiles) {
+		markTiles(rect);
+		return;
+	}
+
+	// A merged rect may be worth merging with rects which were checked
+	// before, so start over after each merge
+	for (uint i = 0; i < _rects.size();) {
+		if (shouldMerge(_rects[i], rect)) {
+			rect.extend(_rects[i]);
+			_rects[i] = _rects.back();
+			_rects.pop_back();
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+	_rects.push_back(rect);
+
+	if (_rects.size() > _maxRects)
+		switchToTiles();
+}
+
+void DirtyRegion::clear() {
+	_rects.clear();
+	_useTiles = false;
+	_tilesChanged = false;
+	_extent = Common::Rect();
+}
+
+const Common::Array<Common::Rect> &DirtyRegion::getRects() {
+	if (_tilesChanged)
+		tilesToRects();
+	return _rects;
+}
+
+bool DirtyRegion::shouldMerge(const Common::Rect &a, const Common::Rect &b) const {
+	Common::Rect bounds = a;
+	bounds.extend(b);
+
+	const int64 covered = rectArea(a) + rectArea(b) - rectArea(a.findIntersectingRect(b));
+	return rectArea(bounds) - covered <= _rectCost;
+}
+
+void DirtyRegion::switchToTiles() {
+	_useTiles = true;
+
+	// Only the tiles are kept from now on, until the region is cleared
+	if (!_tiles.empty())
+		memset(_tiles.data(), 0, _tiles.size());
+	for (uint i = 0; i < _rects.size(); ++i)
+		markTiles(_rects[i]);
+	_rects.clear();
+}
+
+void DirtyRegion::markTiles(const Common::Rect &r) {
+	if (_extent.isEmpty())
+		_extent = r;
+	else
+		_extent.extend(r);
+
+	const uint right = (r.right + kTileSize - 1) / kTileSize;
+	const uint bottom = (r.bottom + kTileSize - 1) / kTileSize;
+
+	// Grow the grid to the rects which were added, as their bounds are not
+	// known beforehand
+	if (right > _tilesW || bottom > _tilesH) {
+		const uint newW = MAX(right, _tilesW), newH = MAX(bottom, _tilesH);
+		Common::Array<byte> tiles(newW * newH);
+		memset(tiles.data(), 0, tiles.size());
+		for (uint y = 0; y < _tilesH; ++y)
+			memcpy(&tiles[y * newW], &_tiles[y * _tilesW], _tilesW);
+		_tiles.swap(tiles);
+		_tilesW = newW;
+		_tilesH = newH;
+	}
+
+	for (uint y = r.top / kTileSize; y < bottom; ++y)
+		memset(&_tiles[y * _tilesW + r.left / kTileSize], 1, right - r.left / kTileSize);
+	_tilesChanged = true;
+}
+
+void DirtyRegion::tilesToRects() {
+	_rects.clear();
+
+	// Rects which end at the current row of tiles, and may be extended by
+	// a run of tiles with the same columns in it
+	Common::Array<uint> open, nextOpen;
+
+	for (uint ty = 0; ty < _tilesH; ++ty) {
+		const byte *row = &_tiles[ty * _tilesW];
+		nextOpen.clear();
+
+		for (uint tx = 0; tx < _tilesW;) {
+			if (!row[tx]) {
+				tx++;
+				continue;
+			}
+
+			const uint start = tx;
+			while (tx < _tilesW && row[tx])
+				tx++;
+
+			Common::Rect rect(start * kTileSize, ty * kTileSize, tx * kTileSize, (ty + 1) * kTileSize);
+			rect.clip(_extent);
+
+			uint i = 0;
+			while (i < open.size() && (_rects[open[i]].left != rect.left || _rects[open[i]].right != rect.right))
+				i++;
+
+			if (i < open.size()) {
+				_rects[open[i]].bottom = rect.bottom;
+				nextOpen.push_back(open[i]);
+			} else {
+				nextOpen.push_back(_rects.size());
+				_rects.push_back(rect);
+			}
+		}
+
+		open.swap(nextOpen);
+	}
+
+	_tilesChanged = false;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,103 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTY_REGION_H
+#define GRAPHICS_DIRTY_REGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_dirty_region Dirty region
+ * @ingroup graphics
+ *
+ * @brief Tracking of the screen areas which need to be redrawn.
+ * @{
+ */
+
+/**
+ * A set of rectangles which need to be redrawn.
+ *
+ * Rects which are added are merged with the ones already in the region when
+ * that is cheaper than redrawing them separately. Each rect is assumed to
+ * cost as much as redrawing a number of pixels, so two rects are merged if
+ * their bounding box adds at most that many pixels to the ones they cover.
+ * Overlapping and adjacent rects which line up are always merged.
+ *
+ * When an update is too fragmented to keep a short list of rects, the
+ * region switches to marking tiles of a fixed size instead. The rects are
+ * then built from runs of marked tiles.
+ */
+class DirtyRegion {
+public:
+	enum {
+		/** The default cost of a rect, in pixels. */
+		kDefaultRectCost = 512,
+		/** The default number of rects above which tiles are used. */
+		kDefaultMaxRects = 64,
+		/** The width and height of a tile. */
+		kTileSize = 16
+	};
+
+	DirtyRegion(uint rectCost = kDefaultRectCost, uint maxRects = kDefaultMaxRects);
+
+	/** Add a rect to the region. Parts left or above of the origin are ignored. */
+	void add(const Common::Rect &r);
+
+	/** Remove all rects from the region. */
+	void clear();
+
+	bool isEmpty() const { return _rects.empty() && !_tilesChanged; }
+
+	/** Whether the region switched to tiles since it was last cleared. */
+	bool usesTiles() const { return _useTiles; }
+
+	/**
+	 * The rects to redraw. They cover all rects which were added, but no
+	 * pixels beyond the bounding box of those.
+	 */
+	const Common::Array<Common::Rect> &getRects();
+
+private:
+	bool shouldMerge(const Common::Rect &a, const Common::Rect &b) const;
+	void switchToTiles();
+	void markTiles(const Common::Rect &r);
+	void tilesToRects();
+
+	uint _rectCost;
+	uint _maxRects;
+
+	Common::Array<Common::Rect> _rects;
+
+	bool _useTiles;
+	bool _tilesChanged;
+	Common::Array<byte> _tiles;
+	uint _tilesW, _tilesH;
+	Common::Rect _extent;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
@@ -105,6 +105,14 @@ int getStringWidthImpl(const Font &font, const StringType &str) {
 	return space;
 }
 
+static const Surface *getDrawSurface(const Surface *dst) {
+	return dst;
+}
+
+static const Surface *getDrawSurface(const ManagedSurface *dst) {
+	return &dst->rawSurface();
+}
+
 template<class SurfaceType, class StringType>
 void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool alpha) {
 	// The logic in getBoundingImpl is the same as we use here. In case we
@@ -120,6 +128,10 @@ void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, i
 		x = x + w - width;
 	x += deltax;
 
+	// Characters which end right of the text area are not drawn
+	if (!alpha)
+		font.beginDrawString(getDrawSurface(dst), Common::Rect(x, y, MAX(x, MIN(x + width, rightX)), y + font.getFontHeight()));
+
 	typename StringType::unsigned_type last = 0;
 	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
 		const typename StringType::unsigned_type cur = *i;
@@ -138,6 +150,9 @@ void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, i
 
 		x += font.getCharWidth(cur);
 	}
+
+	if (!alpha)
+		font.endDrawString();
 }
 
 template<class StringType>
@@ -22,14 +22,11 @@
 #ifndef GRAPHICS_FONT_H
 #define GRAPHICS_FONT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/ustr.h"
 #include "common/rect.h"
 
-namespace Common {
-template<class T> class Array;
-}
-
 namespace Graphics {
 
 /**
@@ -241,6 +238,19 @@ public:
 	virtual void drawAlphaChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const;
 	virtual void drawAlphaChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const;
 
+	/**
+	 * Called by drawString() before it draws the characters of a string,
+	 * with the area of @p dst which the string is expected to cover.
+	 * Characters may still be drawn outside of it.
+	 *
+	 * Fonts can use this to check the surface once per string instead of
+	 * once per character.
+	 */
+	virtual void beginDrawString(const Surface *dst, const Common::Rect &area) const {}
+
+	/** Called by drawString() after the characters were drawn. */
+	virtual void endDrawString() const {}
+
 	/** @overload */
 
 	/**
@@ -0,0 +1,196 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/fonts/glyph-atlas.h"
+#include "graphics/blit.h"
+
+namespace Graphics {
+
+// The height of a new atlas, and the granularity of the shelf heights
+static const uint kInitialHeight = 32;
+static const uint kShelfAlignment = 4;
+
+GlyphAtlas::GlyphAtlas()
+	: _width(0), _usedHeight(0), _maxHeight(0), _nextGeneration(1), _clock(0), _evictions(0) {
+}
+
+GlyphAtlas::~GlyphAtlas() {
+	free();
+}
+
+void GlyphAtlas::create(uint width, uint maxHeight) {
+	free();
+
+	_width = width;
+	_maxHeight = maxHeight;
+}
+
+void GlyphAtlas::free() {
+	_surface.free();
+	_blendSurface.free();
+	_shelves.clear();
+	_usedHeight = 0;
+}
+
+void GlyphAtlas::add(const byte *src, int pitch, uint w, uint h, Location &loc) {
+	assert(w > 0 && h > 0);
+
+	if (w > _width) {
+		// Start over with an atlas which is wide enough for the glyph
+		_width = (w + 63) & ~63;
+		clear();
+		_surface.free();
+		_blendSurface.free();
+	}
+
+	if (h > _maxHeight)
+		_maxHeight = h;
+
+	int shelf = findShelf(w, h);
+	if (shelf < 0)
+		shelf = addShelf(h);
+	if (shelf < 0)
+		shelf = evictShelf(h);
+	if (shelf < 0) {
+		// All shelves are too low for the glyph
+		_evictions += _shelves.size();
+		clear();
+		shelf = addShelf(h);
+	}
+
+	Shelf &s = _shelves[shelf];
+	loc.x = s.used;
+	loc.y = s.y;
+	loc.shelf = shelf;
+	loc.generation = s.generation;
+
+	s.used += w;
+	s.lastUse = ++_clock;
+
+	byte *dst = (byte *)_surface.getBasePtr(loc.x, loc.y);
+	for (uint y = 0; y < h; ++y) {
+		memcpy(dst, src, w);
+		dst += _surface.pitch;
+		src += pitch;
+	}
+
+	updateBlendSurface(loc, w, h);
+}
+
+const Surface &GlyphAtlas::getBlendSurface() {
+	if (!_blendSurface.getPixels() && _surface.getPixels()) {
+		_blendSurface.create(_surface.w, _surface.h, BlendBlit::getSupportedPixelFormat());
+
+		Location all;
+		updateBlendSurface(all, _surface.w, _surface.h);
+	}
+
+	return _blendSurface;
+}
+
+int GlyphAtlas::findShelf(uint w, uint h) {
+	// Use the lowest shelf with room for the glyph, but do not put small
+	// glyphs into much higher shelves
+	int best = -1;
+	for (uint i = 0; i < _shelves.size(); ++i) {
+		const Shelf &s = _shelves[i];
+		if (s.height < h || s.height > h + h / 2 + kShelfAlignment || _width - s.used < w)
+			continue;
+		if (best < 0 || s.height < _shelves[best].height)
+			best = i;
+	}
+	return best;
+}
+
+int GlyphAtlas::addShelf(uint h) {
+	const uint height = MIN<uint>((h + kShelfAlignment - 1) & ~(kShelfAlignment - 1), _maxHeight);
+	if (_usedHeight + height > _maxHeight)
+		return -1;
+
+	if (_usedHeight + height > (uint)_surface.h) {
+		uint newHeight = MAX<uint>(_surface.h, kInitialHeight);
+		while (newHeight < _usedHeight + height)
+			newHeight *= 2;
+		resize(_width, MIN(newHeight, _maxHeight));
+	}
+
+	Shelf s;
+	s.y = _usedHeight;
+	s.height = height;
+	s.used = 0;
+	s.generation = _nextGeneration++;
+	s.lastUse = 0;
+	_shelves.push_back(s);
+
+	_usedHeight += height;
+	return _shelves.size() - 1;
+}
+
+int GlyphAtlas::evictShelf(uint h) {
+	int oldest = -1;
+	for (uint i = 0; i < _shelves.size(); ++i) {
+		if (_shelves[i].height < h)
+			continue;
+		if (oldest < 0 || _shelves[i].lastUse < _shelves[oldest].lastUse)
+			oldest = i;
+	}
+
+	if (oldest >= 0) {
+		// A new generation invalidates all locations in the shelf
+		_shelves[oldest].used = 0;
+		_shelves[oldest].generation = _nextGeneration++;
+		_evictions++;
+	}
+	return oldest;
+}
+
+void GlyphAtlas::clear() {
+	_shelves.clear();
+	_usedHeight = 0;
+}
+
+void GlyphAtlas::resize(uint width, uint height) {
+	Surface newSurface;
+	newSurface.create(width, height, PixelFormat::createFormatCLUT8());
+	if (_surface.getPixels()) {
+		newSurface.copyRectToSurface(_surface, 0, 0, Common::Rect(MIN<int>(_surface.w, width), MIN<int>(_surface.h, height)));
+		_surface.free();
+	}
+	_surface = newSurface;
+
+	// Recreated on the next use
+	_blendSurface.free();
+}
+
+void GlyphAtlas::updateBlendSurface(const Location &loc, uint w, uint h) {
+	if (!_blendSurface.getPixels())
+		return;
+
+	const PixelFormat &format = _blendSurface.format;
+	for (uint y = 0; y < h; ++y) {
+		const byte *src = (const byte *)_surface.getBasePtr(loc.x, loc.y + y);
+		uint32 *dst = (uint32 *)_blendSurface.getBasePtr(loc.x, loc.y + y);
+		for (uint x = 0; x < w; ++x)
+			dst[x] = format.ARGBToColor(src[x], 255, 255, 255);
+	}
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,138 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_FONTS_GLYPH_ATLAS_H
+#define GRAPHICS_FONTS_GLYPH_ATLAS_H
+
+#include "common/array.h"
+#include "graphics/surface.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_glyph_atlas Glyph atlas
+ * @ingroup graphics
+ *
+ * @brief Packed storage for rasterized glyphs.
+ * @{
+ */
+
+/**
+ * A glyph atlas keeps the coverage bitmaps of many glyphs in one 8 bit
+ * surface. Glyphs are packed into horizontal shelves, which are as high as
+ * the glyphs placed in them.
+ *
+ * The atlas starts small and doubles its height when it runs out of space,
+ * up to the maximum height given to create(). When the atlas is full, the
+ * least recently used shelf is emptied and reused. Glyphs which were stored
+ * in it become invalid, and must be added again before they can be drawn.
+ */
+class GlyphAtlas {
+public:
+	/** The position of a glyph in the atlas. */
+	struct Location {
+		Location() : x(0), y(0), shelf(0), generation(0) {}
+
+		uint16 x, y;
+		uint16 shelf;
+		uint32 generation;
+	};
+
+	GlyphAtlas();
+	~GlyphAtlas();
+
+	/**
+	 * Set up an empty atlas.
+	 *
+	 * @param width      The width of the atlas. Wider glyphs make the atlas grow.
+	 * @param maxHeight  The height at which the atlas starts evicting shelves.
+	 */
+	void create(uint width, uint maxHeight);
+
+	/** Release all memory used by the atlas. */
+	void free();
+
+	/**
+	 * Store a glyph in the atlas. This may evict other glyphs.
+	 *
+	 * @param src     The coverage values of the glyph, one byte per pixel.
+	 * @param pitch   The number of bytes per row in @p src.
+	 * @param w, h    The size of the glyph. Both must be greater than zero.
+	 * @param loc     Receives the position of the glyph.
+	 */
+	void add(const byte *src, int pitch, uint w, uint h, Location &loc);
+
+	/** Check if the glyph at @p loc is still stored in the atlas. */
+	bool contains(const Location &loc) const {
+		return loc.shelf < _shelves.size() && _shelves[loc.shelf].generation == loc.generation;
+	}
+
+	/** Mark the shelf of the glyph at @p loc as used, to keep it from being evicted. */
+	void touch(const Location &loc) {
+		_shelves[loc.shelf].lastUse = ++_clock;
+	}
+
+	/** The coverage values of all glyphs. */
+	const Surface &getSurface() const { return _surface; }
+
+	/**
+	 * The glyphs as white pixels in BlendBlit::getSupportedPixelFormat(),
+	 * with the coverage values in the alpha channel. This surface is
+	 * created on first use, and kept up to date after that.
+	 */
+	const Surface &getBlendSurface();
+
+	/** The number of shelves which were evicted so far. */
+	uint getEvictionCount() const { return _evictions; }
+
+private:
+	struct Shelf {
+		uint16 y, height;
+		uint16 used;
+		uint32 generation;
+		uint32 lastUse;
+	};
+
+	int findShelf(uint w, uint h);
+	int addShelf(uint h);
+	int evictShelf(uint h);
+	void clear();
+	void resize(uint width, uint height);
+	void updateBlendSurface(const Location &loc, uint w, uint h);
+
+	Surface _surface;
+	Surface _blendSurface;
+
+	Common::Array<Shelf> _shelves;
+	uint _width;
+	uint _usedHeight;
+	uint _maxHeight;
+
+	uint32 _nextGeneration;
+	uint32 _clock;
+	uint _evictions;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
@@ -27,6 +27,8 @@
 #ifdef USE_FREETYPE2
 
 #include "graphics/fonts/ttf.h"
+#include "graphics/fonts/glyph-atlas.h"
+#include "graphics/blit.h"
 #include "graphics/font.h"
 #include "graphics/surface.h"
 #include "graphics/managed_surface.h"
@@ -182,6 +184,9 @@ public:
 	void drawAlphaChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const override;
 	void drawAlphaChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const override;
 
+	void beginDrawString(const Surface *dst, const Common::Rect &area) const override;
+	void endDrawString() const override;
+
 private:
 	bool _initialized;
 	FT_StreamRec_ _stream;
@@ -194,17 +199,29 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
-		Surface image;
 		int xOffset, yOffset;
+		int width, height;
 		int advance;
 		FT_UInt slot;
+		GlyphAtlas::Location location;
 	};
 
 	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
+	bool rasterizeGlyph(Glyph &glyph) const;
 	typedef Common::HashMap<uint32, Glyph> GlyphCache;
 	mutable GlyphCache _glyphs;
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
+	const Glyph *getDrawableGlyph(uint32 chr) const;
+
+	// The bitmaps of all cached glyphs. Glyphs evicted from it are
+	// rasterized again when they are drawn.
+	mutable GlyphAtlas _atlas;
+
+	// The area of the surface which drawString() found to be opaque, so
+	// glyphs inside it can be drawn with the blending code
+	mutable const Surface *_opaqueSurface;
+	mutable Common::Rect _opaqueArea;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
@@ -224,7 +241,7 @@ private:
 
 TTFFont::TTFFont()
 	: _initialized(false), _stream(), _face(), _ttfFile(0), _width(0), _height(0), _ascent(0),
-	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
+	  _descent(0), _glyphs(), _opaqueSurface(nullptr), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
 	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false),
 	  _disposeAfterUse(DisposeAfterUse::NO) {
 }
@@ -237,8 +254,7 @@ TTFFont::~TTFFont() {
 			delete _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
+		_atlas.free();
 
 		_initialized = false;
 	}
@@ -362,6 +378,13 @@ bool TTFFont::load(Common::SeekableReadStream *ttfFile, DisposeAfterUse::Flag di
 		_loadFlags |= FT_LOAD_NO_BITMAP;
 	}
 
+	// Make room for a few rows of glyphs in the atlas, but limit its size
+	// for huge fonts, which evict their least recently drawn glyphs instead.
+	uint atlasWidth = 256;
+	while (atlasWidth < (uint)_width * 16 && atlasWidth < 2048)
+		atlasWidth *= 2;
+	_atlas.create(atlasWidth, atlasWidth);
+
 	if (!mapping) {
 		// Allow loading of all unicode characters.
 		_allowLateCaching = true;
@@ -594,10 +617,8 @@ Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
 	if (glyphEntry == _glyphs.end()) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		const Glyph &glyph = glyphEntry->_value;
+		return Common::Rect(glyph.xOffset, glyph.yOffset, glyph.xOffset + glyph.width, glyph.yOffset + glyph.height);
 	}
 }
 
@@ -670,8 +691,39 @@ static void renderAlphaGlyph(uint8 *dstPos, const int dstPitch, const uint8 *src
 	}
 }
 
+static bool isOpaque(const Surface &surface, const Common::Rect &area) {
+	const uint32 aMask = 0xFF << surface.format.aShift;
+
+	for (int y = area.top; y < area.bottom; ++y) {
+		const uint32 *rDst = (const uint32 *)surface.getBasePtr(area.left, y);
+
+		for (int x = 0; x < area.width(); ++x) {
+			if ((rDst[x] & aMask) != aMask)
+				return false;
+		}
+	}
+
+	return true;
+}
+
 } // End of anonymous namespace
 
+void TTFFont::beginDrawString(const Surface *dst, const Common::Rect &area) const {
+	_opaqueSurface = nullptr;
+
+	if (dst->format != BlendBlit::getSupportedPixelFormat())
+		return;
+
+	_opaqueArea = area;
+	_opaqueArea.clip(Common::Rect(dst->w, dst->h));
+	if (!_opaqueArea.isEmpty() && isOpaque(*dst, _opaqueArea))
+		_opaqueSurface = dst;
+}
+
+void TTFFont::endDrawString() const {
+	_opaqueSurface = nullptr;
+}
+
 void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const {
 	drawCharIntern(dst, chr, x, y, color, nullptr, false);
 }
@@ -703,29 +755,27 @@ void TTFFont::drawAlphaChar(ManagedSurface *dst, uint32 chr, int x, int y, uint3
 
 void TTFFont::drawCharIntern(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		const uint32 *transparentColor, bool alpha) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyph = getDrawableGlyph(chr);
+	if (!glyph)
 		return;
 
-	const Glyph &glyph = glyphEntry->_value;
-
-	x += glyph.xOffset;
-	y += glyph.yOffset;
+	x += glyph->xOffset;
+	y += glyph->yOffset;
 
 	if (x > dst->w)
 		return;
 	if (y > dst->h)
 		return;
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+	int w = glyph->width;
+	int h = glyph->height;
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+	int srcX = glyph->location.x;
+	int srcY = glyph->location.y;
 
 	// Make sure we are not drawing outside the screen bounds
 	if (x < 0) {
-		srcPos -= x;
+		srcX -= x;
 		w += x;
 		x = 0;
 	}
@@ -737,7 +787,7 @@ void TTFFont::drawCharIntern(Surface * dst, uint32 chr, int x, int y, uint32 col
 		return;
 
 	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
+		srcY -= y;
 		h += y;
 		y = 0;
 	}
@@ -748,15 +798,17 @@ void TTFFont::drawCharIntern(Surface * dst, uint32 chr, int x, int y, uint32 col
 	if (h <= 0)
 		return;
 
+	const Surface &atlas = _atlas.getSurface();
+	const uint8 *srcPos = (const uint8 *)atlas.getBasePtr(srcX, srcY);
 	uint8 *dstPos = (uint8 *)dst->getBasePtr(x, y);
 
 	if (alpha) {
 		if (dst->format.bytesPerPixel == 1) {
-			renderAlphaGlyph<uint8>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+			renderAlphaGlyph<uint8>(dstPos, dst->pitch, srcPos, atlas.pitch, w, h, color, dst->format);
 		} else if (dst->format.bytesPerPixel == 2) {
-			renderAlphaGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+			renderAlphaGlyph<uint16>(dstPos, dst->pitch, srcPos, atlas.pitch, w, h, color, dst->format);
 		} else if (dst->format.bytesPerPixel == 4) {
-			renderAlphaGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+			renderAlphaGlyph<uint32>(dstPos, dst->pitch, srcPos, atlas.pitch, w, h, color, dst->format);
 		}
 	} else {
 		if (dst->format.isCLUT8()) {
@@ -775,14 +827,25 @@ void TTFFont::drawCharIntern(Surface * dst, uint32 chr, int x, int y, uint32 col
 				}
 
 				dstPos += dst->pitch;
-				srcPos += glyph.image.pitch;
+				srcPos += atlas.pitch;
 			}
+		} else if (!transparentColor && dst == _opaqueSurface && _opaqueArea.contains(Common::Rect(x, y, x + w, y + h))) {
+			// Opaque 32bpp surfaces can use the optimized blending code,
+			// with the text color as color modulation of white glyphs
+			const Surface &blendAtlas = _atlas.getBlendSurface();
+			uint8 r, g, b;
+			dst->format.colorToRGB(color, r, g, b);
+
+			BlendBlit::blit(dstPos, (const byte *)blendAtlas.getBasePtr(srcX, srcY),
+				dst->pitch, blendAtlas.pitch, 0, 0, w, h,
+				BlendBlit::SCALE_THRESHOLD, BlendBlit::SCALE_THRESHOLD, 0, 0,
+				MS_ARGB(255, r, g, b), FLIP_NONE, BLEND_NORMAL, ALPHA_FULL);
 		} else if (dst->format.bytesPerPixel == 1) {
-			renderGlyph<uint8>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+			renderGlyph<uint8>(dstPos, dst->pitch, srcPos, atlas.pitch, w, h, color, dst->format, transparentColor);
 		} else if (dst->format.bytesPerPixel == 2) {
-			renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+			renderGlyph<uint16>(dstPos, dst->pitch, srcPos, atlas.pitch, w, h, color, dst->format, transparentColor);
 		} else if (dst->format.bytesPerPixel == 4) {
-			renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+			renderGlyph<uint32>(dstPos, dst->pitch, srcPos, atlas.pitch, w, h, color, dst->format, transparentColor);
 		}
 	}
 }
@@ -793,11 +856,14 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		return false;
 
 	glyph.slot = slot;
+	return rasterizeGlyph(glyph);
+}
 
+bool TTFFont::rasterizeGlyph(Glyph &glyph) const {
 	// We use the light target and render mode to improve the looks of the
 	// glyphs. It is most noticeable in FreeSansBold.ttf, where otherwise the
 	// 't' glyph looks like it is cut off on the right side.
-	if (FT_Load_Glyph(_face, slot, _loadFlags))
+	if (FT_Load_Glyph(_face, glyph.slot, _loadFlags))
 		return false;
 
 	if (FT_Render_Glyph(_face->glyph, _renderMode))
@@ -851,8 +917,8 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		bitmap = &_face->glyph->bitmap;
 	}
 
-
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	glyph.width = bitmap->width;
+	glyph.height = bitmap->rows;
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -861,10 +927,13 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
+	Common::Array<uint8> expanded;
 
 	switch (bitmap->pixel_mode) {
-	case FT_PIXEL_MODE_MONO:
+	case FT_PIXEL_MODE_MONO: {
+		expanded.resize(bitmap->width * bitmap->rows);
+		uint8 *dst = expanded.data();
+
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			const uint8 *curSrc = src;
 			uint8 mask = 0;
@@ -873,8 +942,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 				if ((x % 8) == 0)
 					mask = *curSrc++;
 
-				if (mask & 0x80)
-					*dst = 255;
+				*dst = (mask & 0x80) ? 255 : 0;
 
 				mask <<= 1;
 				++dst;
@@ -882,22 +950,23 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 
 			src += srcPitch;
 		}
+
+		src = expanded.data();
+		srcPitch = bitmap->width;
 		break;
+	}
 
 	case FT_PIXEL_MODE_GRAY:
-		for (int y = 0; y < (int)bitmap->rows; ++y) {
-			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
-			src += srcPitch;
-		}
 		break;
 
 	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
+		warning("TTFFont::rasterizeGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
 		return false;
 	}
 
+	if (glyph.width > 0 && glyph.height > 0)
+		_atlas.add(src, srcPitch, glyph.width, glyph.height, glyph.location);
+
 #if FAKE_BOLD == 1
 	if (_fakeBold) {
 		FT_Bitmap_Done(_face->glyph->library, &ownBitmap);
@@ -918,6 +987,23 @@ void TTFFont::assureCached(uint32 chr) const {
 	}
 }
 
+const TTFFont::Glyph *TTFFont::getDrawableGlyph(uint32 chr) const {
+	assureCached(chr);
+	GlyphCache::iterator glyphEntry = _glyphs.find(chr);
+	if (glyphEntry == _glyphs.end())
+		return nullptr;
+
+	Glyph &glyph = glyphEntry->_value;
+	if (glyph.width <= 0 || glyph.height <= 0)
+		return nullptr;
+
+	if (!_atlas.contains(glyph.location) && !rasterizeGlyph(glyph))
+		return nullptr;
+
+	_atlas.touch(glyph.location);
+	return &glyph;
+}
+
 Font *loadTTFFont(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, int size, TTFSizeMode sizeMode, uint xdpi, uint ydpi, TTFRenderMode renderMode, const uint32 *mapping, bool stemDarkening) {
 	TTFFont *font = new TTFFont();
 
@@ -9,6 +9,7 @@ MODULE_OBJS := \
 	blit/blit-scale.o \
 	color_quantizer.o \
 	cursorman.o \
+	dirty-region.o \
 	font.o \
 	fontman.o \
 	fonts/amigafont.o \
@@ -16,6 +17,7 @@ MODULE_OBJS := \
 	fonts/consolefont.o \
 	fonts/dosfont.o \
 	fonts/freetype.o \
+	fonts/glyph-atlas.o \
 	fonts/macfont.o \
 	fonts/newfont_big.o \
 	fonts/newfont.o \
@@ -131,6 +133,19 @@ MODULE_OBJS += \
 	scaler/hq3x_i386.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	scaler/hq-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	scaler/hq-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	scaler/hq-avx2.o
+endif
+
 endif
 
 ifdef USE_EDGE_SCALERS
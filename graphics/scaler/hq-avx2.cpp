@@ -0,0 +1,89 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/hq-classify.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+/**
+ * Compare eight pairs of YUV values like diffYUV(). The lanes of the result
+ * are all ones where the values are similar.
+ */
+static FORCEINLINE __m256i avx2_sameYUV(__m256i a, __m256i b) {
+	// The top byte is not part of the YUV value, so it is always ignored
+	const __m256i threshold = _mm256_set1_epi32((int)0xFF300706);
+	const __m256i diff = _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+	return _mm256_cmpeq_epi32(_mm256_subs_epu8(diff, threshold), _mm256_setzero_si256());
+}
+
+static FORCEINLINE __m256i avx2_addCode(__m256i code, __m256i a, __m256i b, int bit) {
+	return _mm256_or_si256(code, _mm256_andnot_si256(avx2_sameYUV(a, b), _mm256_set1_epi32(bit)));
+}
+
+void hqClassifyAVX2(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width) {
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const __m256i w1 = _mm256_loadu_si256((const __m256i *)(above + x));
+		const __m256i w2 = _mm256_loadu_si256((const __m256i *)(above + x + 1));
+		const __m256i w3 = _mm256_loadu_si256((const __m256i *)(above + x + 2));
+		const __m256i w4 = _mm256_loadu_si256((const __m256i *)(row + x));
+		const __m256i w5 = _mm256_loadu_si256((const __m256i *)(row + x + 1));
+		const __m256i w6 = _mm256_loadu_si256((const __m256i *)(row + x + 2));
+		const __m256i w7 = _mm256_loadu_si256((const __m256i *)(below + x));
+		const __m256i w8 = _mm256_loadu_si256((const __m256i *)(below + x + 1));
+		const __m256i w9 = _mm256_loadu_si256((const __m256i *)(below + x + 2));
+
+		__m256i code = _mm256_setzero_si256();
+		code = avx2_addCode(code, w5, w1, 0x0001);
+		code = avx2_addCode(code, w5, w2, 0x0002);
+		code = avx2_addCode(code, w5, w3, 0x0004);
+		code = avx2_addCode(code, w5, w4, 0x0008);
+		code = avx2_addCode(code, w5, w6, 0x0010);
+		code = avx2_addCode(code, w5, w7, 0x0020);
+		code = avx2_addCode(code, w5, w8, 0x0040);
+		code = avx2_addCode(code, w5, w9, 0x0080);
+		code = avx2_addCode(code, w2, w6, kHQDiff26);
+		code = avx2_addCode(code, w4, w2, kHQDiff42);
+		code = avx2_addCode(code, w6, w8, kHQDiff68);
+		code = avx2_addCode(code, w8, w4, kHQDiff84);
+
+		const __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(code), _mm256_extracti128_si256(code, 1));
+		_mm_storeu_si128((__m128i *)(codes + x), packed);
+	}
+
+	for (; x < width; ++x)
+		codes[x] = hqClassifyPixel(above + x, row + x, below + x);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_HQ_CLASSIFY_H
+#define GRAPHICS_SCALER_HQ_CLASSIFY_H
+
+#include "graphics/scaler/intern.h"
+
+/**
+ * The bits above the pattern in the codes of HQClassifyFunc. They tell if
+ * two of the pixels next to the center one differ, which some of the
+ * patterns check.
+ */
+enum {
+	kHQDiff26 = 1 << 8,
+	kHQDiff42 = 1 << 9,
+	kHQDiff68 = 1 << 10,
+	kHQDiff84 = 1 << 11
+};
+
+/**
+ * Compute the codes of @p width pixels for the hq scalers. The low 8 bits
+ * are the pattern of neighbours which differ from the center pixel.
+ *
+ * The rows hold the YUV values of the pixels above, at and below the
+ * pixels to classify. They start with the pixel to the left of the first
+ * one, and hold width + 2 values.
+ */
+typedef void (*HQClassifyFunc)(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width);
+
+/**
+ * The classification used by the hq scalers. It is chosen on first use;
+ * tests may set it beforehand.
+ */
+struct HQClassify {
+	static HQClassifyFunc classifyFunc;
+
+	static void select();
+	static void classifyGeneric(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width);
+};
+
+#ifdef SCUMMVM_NEON
+void hqClassifyNEON(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width);
+#endif
+#ifdef SCUMMVM_SSE2
+void hqClassifySSE2(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width);
+#endif
+#ifdef SCUMMVM_AVX2
+void hqClassifyAVX2(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width);
+#endif
+
+/**
+ * Classify the pixel at row[1], for the pixels which do not fill a whole
+ * vector.
+ */
+static inline uint16 hqClassifyPixel(const uint32 *above, const uint32 *row, const uint32 *below) {
+	const int yuv5 = row[1];
+	int code = 0;
+	if (diffYUV(yuv5, above[0])) code |= 0x0001;
+	if (diffYUV(yuv5, above[1])) code |= 0x0002;
+	if (diffYUV(yuv5, above[2])) code |= 0x0004;
+	if (diffYUV(yuv5, row[0]))   code |= 0x0008;
+	if (diffYUV(yuv5, row[2]))   code |= 0x0010;
+	if (diffYUV(yuv5, below[0])) code |= 0x0020;
+	if (diffYUV(yuv5, below[1])) code |= 0x0040;
+	if (diffYUV(yuv5, below[2])) code |= 0x0080;
+
+	if (diffYUV(above[1], row[2]))   code |= kHQDiff26;
+	if (diffYUV(row[0], above[1]))   code |= kHQDiff42;
+	if (diffYUV(row[2], below[1]))   code |= kHQDiff68;
+	if (diffYUV(below[1], row[0]))   code |= kHQDiff84;
+	return code;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/scaler/hq-classify.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+/**
+ * Compare four pairs of YUV values like diffYUV(). The lanes of the result
+ * are all ones where the values are similar.
+ */
+static FORCEINLINE uint32x4_t neon_sameYUV(uint32x4_t a, uint32x4_t b) {
+	// The top byte is not part of the YUV value, so it is always ignored
+	const uint8x16_t threshold = vreinterpretq_u8_u32(vdupq_n_u32(0xFF300706));
+	const uint8x16_t diff = vabdq_u8(vreinterpretq_u8_u32(a), vreinterpretq_u8_u32(b));
+	return vceqq_u32(vreinterpretq_u32_u8(vqsubq_u8(diff, threshold)), vdupq_n_u32(0));
+}
+
+static FORCEINLINE uint32x4_t neon_addCode(uint32x4_t code, uint32x4_t a, uint32x4_t b, uint32 bit) {
+	return vorrq_u32(code, vbicq_u32(vdupq_n_u32(bit), neon_sameYUV(a, b)));
+}
+
+void hqClassifyNEON(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width) {
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const uint32x4_t w1 = vld1q_u32(above + x);
+		const uint32x4_t w2 = vld1q_u32(above + x + 1);
+		const uint32x4_t w3 = vld1q_u32(above + x + 2);
+		const uint32x4_t w4 = vld1q_u32(row + x);
+		const uint32x4_t w5 = vld1q_u32(row + x + 1);
+		const uint32x4_t w6 = vld1q_u32(row + x + 2);
+		const uint32x4_t w7 = vld1q_u32(below + x);
+		const uint32x4_t w8 = vld1q_u32(below + x + 1);
+		const uint32x4_t w9 = vld1q_u32(below + x + 2);
+
+		uint32x4_t code = vdupq_n_u32(0);
+		code = neon_addCode(code, w5, w1, 0x0001);
+		code = neon_addCode(code, w5, w2, 0x0002);
+		code = neon_addCode(code, w5, w3, 0x0004);
+		code = neon_addCode(code, w5, w4, 0x0008);
+		code = neon_addCode(code, w5, w6, 0x0010);
+		code = neon_addCode(code, w5, w7, 0x0020);
+		code = neon_addCode(code, w5, w8, 0x0040);
+		code = neon_addCode(code, w5, w9, 0x0080);
+		code = neon_addCode(code, w2, w6, kHQDiff26);
+		code = neon_addCode(code, w4, w2, kHQDiff42);
+		code = neon_addCode(code, w6, w8, kHQDiff68);
+		code = neon_addCode(code, w8, w4, kHQDiff84);
+
+		vst1_u16(codes + x, vmovn_u32(code));
+	}
+
+	for (; x < width; ++x)
+		codes[x] = hqClassifyPixel(above + x, row + x, below + x);
+}
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
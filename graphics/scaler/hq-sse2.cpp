@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/hq-classify.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+/**
+ * Compare four pairs of YUV values like diffYUV(). The lanes of the result
+ * are all ones where the values are similar.
+ */
+static FORCEINLINE __m128i sse2_sameYUV(__m128i a, __m128i b) {
+	// The top byte is not part of the YUV value, so it is always ignored
+	const __m128i threshold = _mm_set1_epi32((int)0xFF300706);
+	const __m128i diff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+	return _mm_cmpeq_epi32(_mm_subs_epu8(diff, threshold), _mm_setzero_si128());
+}
+
+static FORCEINLINE __m128i sse2_addCode(__m128i code, __m128i a, __m128i b, int bit) {
+	return _mm_or_si128(code, _mm_andnot_si128(sse2_sameYUV(a, b), _mm_set1_epi32(bit)));
+}
+
+void hqClassifySSE2(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width) {
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const __m128i w1 = _mm_loadu_si128((const __m128i *)(above + x));
+		const __m128i w2 = _mm_loadu_si128((const __m128i *)(above + x + 1));
+		const __m128i w3 = _mm_loadu_si128((const __m128i *)(above + x + 2));
+		const __m128i w4 = _mm_loadu_si128((const __m128i *)(row + x));
+		const __m128i w5 = _mm_loadu_si128((const __m128i *)(row + x + 1));
+		const __m128i w6 = _mm_loadu_si128((const __m128i *)(row + x + 2));
+		const __m128i w7 = _mm_loadu_si128((const __m128i *)(below + x));
+		const __m128i w8 = _mm_loadu_si128((const __m128i *)(below + x + 1));
+		const __m128i w9 = _mm_loadu_si128((const __m128i *)(below + x + 2));
+
+		__m128i code = _mm_setzero_si128();
+		code = sse2_addCode(code, w5, w1, 0x0001);
+		code = sse2_addCode(code, w5, w2, 0x0002);
+		code = sse2_addCode(code, w5, w3, 0x0004);
+		code = sse2_addCode(code, w5, w4, 0x0008);
+		code = sse2_addCode(code, w5, w6, 0x0010);
+		code = sse2_addCode(code, w5, w7, 0x0020);
+		code = sse2_addCode(code, w5, w8, 0x0040);
+		code = sse2_addCode(code, w5, w9, 0x0080);
+		code = sse2_addCode(code, w2, w6, kHQDiff26);
+		code = sse2_addCode(code, w4, w2, kHQDiff42);
+		code = sse2_addCode(code, w6, w8, kHQDiff68);
+		code = sse2_addCode(code, w8, w4, kHQDiff84);
+
+		_mm_storel_epi64((__m128i *)(codes + x), _mm_packs_epi32(code, code));
+	}
+
+	for (; x < width; ++x)
+		codes[x] = hqClassifyPixel(above + x, row + x, below + x);
+}
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
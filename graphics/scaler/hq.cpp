@@ -19,8 +19,11 @@
  */
 
 #include "graphics/scaler/hq.h"
+#include "graphics/scaler/hq-classify.h"
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
+#include "common/array.h"
+#include "common/system.h"
 
 // RGB-to-YUV lookup table
 
@@ -173,8 +176,6 @@ void HQScaler::initLUT(Graphics::PixelFormat format) {
 #define PIXEL11_90	*(q+1+nextlineDst) = interpolate_2_3_3(w5, w6, w8);
 #define PIXEL11_100	*(q+1+nextlineDst) = interpolate_14_1_1(w5, w6, w8);
 
-#define YUV(x)	(sizeof(Pixel) == 2 ? RGBtoYUV[w ## x] : ConvertYUV<ColorMask>(w ## x, RGBtoYUV))
-
 /**
  * Convert 32 bit RGB values to Yuv
  */
@@ -193,13 +194,45 @@ static inline uint32 ConvertYUV(uint32 x, const uint32 *RGBtoYUV) {
 	return RGBtoYUV[r | g | b];
 }
 
+/**
+ * Convert a row of pixels to Yuv, for the classification of the hq scalers
+ */
+template<typename ColorMask>
+static void convertYUVRow(uint32 *dst, const typename ColorMask::PixelType *src, int count, const uint32 *RGBtoYUV) {
+	for (int i = 0; i < count; ++i)
+		dst[i] = (sizeof(typename ColorMask::PixelType) == 2) ? RGBtoYUV[src[i]] : ConvertYUV<ColorMask>(src[i], RGBtoYUV);
+}
+
+HQClassifyFunc HQClassify::classifyFunc = nullptr;
+
+void HQClassify::select() {
+	classifyFunc = classifyGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		classifyFunc = hqClassifyNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		classifyFunc = hqClassifySSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		classifyFunc = hqClassifyAVX2;
+#endif
+}
+
+void HQClassify::classifyGeneric(uint16 *codes, const uint32 *above, const uint32 *row, const uint32 *below, int width) {
+	for (int x = 0; x < width; ++x)
+		codes[x] = hqClassifyPixel(above + x, row + x, below + x);
+}
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (https://web.archive.org/web/20090204033742/http://www.hiend3d.com/hq2x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, HQClassifyFunc classify) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -221,7 +254,21 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	// The YUV values of the rows above, at and below the current one,
+	// including the pixels left and right of the rect
+	Common::Array<uint32> yuv((width + 2) * 3);
+	uint32 *above = &yuv[0];
+	uint32 *row = &yuv[width + 2];
+	uint32 *below = &yuv[(width + 2) * 2];
+	Common::Array<uint16> codes(width);
+
+	convertYUVRow<ColorMask>(above, p - 1 - nextlineSrc, width + 2, RGBtoYUV);
+	convertYUVRow<ColorMask>(row, p - 1, width + 2, RGBtoYUV);
+
 	while (height--) {
+		convertYUVRow<ColorMask>(below, p - 1 + nextlineSrc, width + 2, RGBtoYUV);
+		classify(codes.data(), above, row, below, width);
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -230,6 +277,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w5 = *(p);
 		w8 = *(p + nextlineSrc);
 
+		const uint16 *code = codes.data();
 		int tmpWidth = width;
 		while (tmpWidth--) {
 			p++;
@@ -238,18 +286,9 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *code++;
 
-			switch (pattern) {
+			switch (pattern & 0xFF) {
 			case 0:
 			case 1:
 			case 4:
@@ -382,7 +421,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 18:
 			case 50:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_20
@@ -395,7 +434,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_20
 				PIXEL01_22
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_20
@@ -405,7 +444,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 76:
 				PIXEL00_21
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_20
@@ -414,7 +453,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 10:
 			case 138:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_20
@@ -470,7 +509,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 22:
 			case 54:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -483,7 +522,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_20
 				PIXEL01_22
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -493,7 +532,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 108:
 				PIXEL00_21
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -502,7 +541,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 11:
 			case 139:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -513,7 +552,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 19:
 			case 51:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL00_11
 					PIXEL01_10
 				} else {
@@ -526,7 +565,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 146:
 			case 178:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 					PIXEL11_12
 				} else {
@@ -538,7 +577,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 84:
 			case 85:
 				PIXEL00_20
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL01_11
 					PIXEL11_10
 				} else {
@@ -551,7 +590,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 113:
 				PIXEL00_20
 				PIXEL01_22
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL10_12
 					PIXEL11_10
 				} else {
@@ -563,7 +602,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 204:
 				PIXEL00_21
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 					PIXEL11_11
 				} else {
@@ -573,7 +612,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 73:
 			case 77:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL00_12
 					PIXEL10_10
 				} else {
@@ -585,7 +624,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 42:
 			case 170:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 					PIXEL10_11
 				} else {
@@ -597,7 +636,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 14:
 			case 142:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 					PIXEL01_12
 				} else {
@@ -657,12 +696,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 26:
 			case 31:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -673,13 +712,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 82:
 			case 214:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -689,12 +728,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 248:
 				PIXEL00_21
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -702,13 +741,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 74:
 			case 107:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -716,7 +755,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 27:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -727,7 +766,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 86:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -739,7 +778,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_21
 				PIXEL01_22
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -748,7 +787,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 106:
 				PIXEL00_10
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -757,7 +796,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 30:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -769,7 +808,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_22
 				PIXEL01_10
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -778,7 +817,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 120:
 				PIXEL00_21
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -786,7 +825,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 75:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -868,12 +907,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_12
 				break;
 			case 58:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -883,13 +922,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 83:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -898,25 +937,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 92:
 				PIXEL00_21
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 202:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -924,13 +963,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_11
 				break;
 			case 78:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -938,12 +977,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 154:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -953,13 +992,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 114:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -968,34 +1007,34 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 89:
 				PIXEL00_12
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 90:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1003,7 +1042,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 55:
 			case 23:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL00_11
 					PIXEL01_0
 				} else {
@@ -1016,7 +1055,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 182:
 			case 150:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 					PIXEL11_12
 				} else {
@@ -1028,7 +1067,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 213:
 			case 212:
 				PIXEL00_20
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL01_11
 					PIXEL11_0
 				} else {
@@ -1041,7 +1080,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 240:
 				PIXEL00_20
 				PIXEL01_22
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL10_12
 					PIXEL11_0
 				} else {
@@ -1053,7 +1092,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 232:
 				PIXEL00_21
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 					PIXEL11_11
 				} else {
@@ -1063,7 +1102,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 109:
 			case 105:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL00_12
 					PIXEL10_0
 				} else {
@@ -1075,7 +1114,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 171:
 			case 43:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 					PIXEL10_11
 				} else {
@@ -1087,7 +1126,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 143:
 			case 15:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 					PIXEL01_12
 				} else {
@@ -1100,7 +1139,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 124:
 				PIXEL00_21
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1108,7 +1147,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 203:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -1119,7 +1158,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 62:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1131,7 +1170,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_11
 				PIXEL01_10
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -1139,7 +1178,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 118:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1151,7 +1190,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_12
 				PIXEL01_22
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -1160,7 +1199,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 110:
 				PIXEL00_10
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1168,7 +1207,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 155:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -1228,24 +1267,24 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 220:
 				PIXEL00_21
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 158:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1254,13 +1293,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_12
 				break;
 			case 234:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1269,25 +1308,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 242:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 59:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -1298,12 +1337,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 121:
 				PIXEL00_12
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1311,26 +1350,26 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 87:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 79:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -1338,88 +1377,88 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 122:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 94:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 218:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 91:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1450,12 +1489,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_12
 				break;
 			case 186:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -1465,13 +1504,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 115:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1480,25 +1519,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 93:
 				PIXEL00_12
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 206:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -1509,7 +1548,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 201:
 				PIXEL00_12
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -1518,7 +1557,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 174:
 			case 46:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
@@ -1530,7 +1569,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 179:
 			case 147:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -1543,7 +1582,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_20
 				PIXEL01_11
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1563,12 +1602,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 126:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1576,21 +1615,21 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 219:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_10
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 125:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL00_12
 					PIXEL10_0
 				} else {
@@ -1602,7 +1641,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 221:
 				PIXEL00_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL01_11
 					PIXEL11_0
 				} else {
@@ -1612,7 +1651,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_10
 				break;
 			case 207:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 					PIXEL01_12
 				} else {
@@ -1625,7 +1664,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 238:
 				PIXEL00_10
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 					PIXEL11_11
 				} else {
@@ -1635,7 +1674,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 190:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 					PIXEL11_12
 				} else {
@@ -1645,7 +1684,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_11
 				break;
 			case 187:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 					PIXEL10_11
 				} else {
@@ -1658,7 +1697,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 243:
 				PIXEL00_11
 				PIXEL01_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL10_12
 					PIXEL11_0
 				} else {
@@ -1667,7 +1706,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 119:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL00_11
 					PIXEL01_0
 				} else {
@@ -1681,7 +1720,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 233:
 				PIXEL00_12
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
@@ -1690,7 +1729,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 175:
 			case 47:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
@@ -1702,7 +1741,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 183:
 			case 151:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
@@ -1715,7 +1754,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_20
 				PIXEL01_11
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -1724,25 +1763,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 250:
 				PIXEL00_10
 				PIXEL01_10
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 123:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_10
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1750,12 +1789,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 95:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1765,13 +1804,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 222:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -1780,12 +1819,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 252:
 				PIXEL00_21
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -1794,25 +1833,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 249:
 				PIXEL00_12
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 235:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
@@ -1820,13 +1859,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_11
 				break;
 			case 111:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1834,12 +1873,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 63:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1848,12 +1887,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_21
 				break;
 			case 159:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
@@ -1863,13 +1902,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 215:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
 				}
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -1877,13 +1916,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 246:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -1891,17 +1930,17 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 254:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -1910,43 +1949,43 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 253:
 				PIXEL00_12
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
 				}
 				break;
 			case 251:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_10
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 239:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
@@ -1954,17 +1993,17 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_11
 				break;
 			case 127:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1972,12 +2011,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 191:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
@@ -1986,18 +2025,18 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_12
 				break;
 			case 223:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
 				}
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -2005,35 +2044,35 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 247:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
 				}
 				break;
 			case 255:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -2053,6 +2092,11 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 2;
+
+		uint32 *next = above;
+		above = row;
+		row = below;
+		below = next;
 	}
 }
 
@@ -2116,7 +2160,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, HQClassifyFunc classify) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int  w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -2139,7 +2183,21 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	// The YUV values of the rows above, at and below the current one,
+	// including the pixels left and right of the rect
+	Common::Array<uint32> yuv((width + 2) * 3);
+	uint32 *above = &yuv[0];
+	uint32 *row = &yuv[width + 2];
+	uint32 *below = &yuv[(width + 2) * 2];
+	Common::Array<uint16> codes(width);
+
+	convertYUVRow<ColorMask>(above, p - 1 - nextlineSrc, width + 2, RGBtoYUV);
+	convertYUVRow<ColorMask>(row, p - 1, width + 2, RGBtoYUV);
+
 	while (height--) {
+		convertYUVRow<ColorMask>(below, p - 1 + nextlineSrc, width + 2, RGBtoYUV);
+		classify(codes.data(), above, row, below, width);
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -2148,6 +2206,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w5 = *(p);
 		w8 = *(p + nextlineSrc);
 
+		const uint16 *code = codes.data();
 		int tmpWidth = width;
 		while (tmpWidth--) {
 			p++;
@@ -2156,18 +2215,9 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *code++;
 
-			switch (pattern) {
+			switch (pattern & 0xFF) {
 			case 0:
 			case 1:
 			case 4:
@@ -2365,7 +2415,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 18:
 			case 50:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_1M
 					PIXEL12_C
@@ -2388,7 +2438,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_1M
@@ -2405,7 +2455,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_2
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_1M
 					PIXEL21_C
@@ -2418,7 +2468,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 10:
 			case 138:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 					PIXEL01_C
 					PIXEL10_C
@@ -2511,7 +2561,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 22:
 			case 54:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -2534,7 +2584,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -2551,7 +2601,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_2
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -2564,7 +2614,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 11:
 			case 139:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -2582,7 +2632,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 19:
 			case 51:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL00_1L
 					PIXEL01_C
 					PIXEL02_1M
@@ -2601,7 +2651,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 146:
 			case 178:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_1M
 					PIXEL12_C
@@ -2620,7 +2670,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 84:
 			case 85:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL02_1U
 					PIXEL12_C
 					PIXEL21_C
@@ -2639,7 +2689,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 112:
 			case 113:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL20_1L
 					PIXEL21_C
@@ -2658,7 +2708,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 200:
 			case 204:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_1M
 					PIXEL21_C
@@ -2677,7 +2727,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 73:
 			case 77:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL00_1U
 					PIXEL10_C
 					PIXEL20_1M
@@ -2696,7 +2746,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 42:
 			case 170:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 					PIXEL01_C
 					PIXEL10_C
@@ -2715,7 +2765,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 14:
 			case 142:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 					PIXEL01_C
 					PIXEL02_1R
@@ -2822,7 +2872,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 26:
 			case 31:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL10_C
 				} else {
@@ -2830,7 +2880,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL10_3
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 					PIXEL12_C
 				} else {
@@ -2845,7 +2895,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 82:
 			case 214:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 				} else {
@@ -2856,7 +2906,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				PIXEL12_C
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL21_C
 					PIXEL22_C
 				} else {
@@ -2870,7 +2920,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL01_1
 				PIXEL02_1M
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 				} else {
@@ -2878,7 +2928,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL22_C
 				} else {
@@ -2888,7 +2938,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 74:
 			case 107:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 				} else {
@@ -2899,7 +2949,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 					PIXEL21_C
 				} else {
@@ -2909,7 +2959,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 27:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -2927,7 +2977,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 86:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -2949,7 +2999,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -2965,7 +3015,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -2978,7 +3028,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 30:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3000,7 +3050,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3016,7 +3066,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3028,7 +3078,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 75:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3177,13 +3227,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 58:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3198,7 +3248,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 83:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3208,7 +3258,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1M
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -3221,20 +3271,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 202:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -3244,7 +3294,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -3253,7 +3303,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1R
 				break;
 			case 78:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -3263,7 +3313,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -3272,13 +3322,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 154:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3293,7 +3343,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 114:
 				PIXEL00_1M
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3303,7 +3353,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -3316,26 +3366,26 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 90:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3343,13 +3393,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -3357,7 +3407,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 55:
 			case 23:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL00_1L
 					PIXEL01_C
 					PIXEL02_C
@@ -3376,7 +3426,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 182:
 			case 150:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3395,7 +3445,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 213:
 			case 212:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL02_1U
 					PIXEL12_C
 					PIXEL21_C
@@ -3414,7 +3464,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 241:
 			case 240:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL20_1L
 					PIXEL21_C
@@ -3433,7 +3483,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 236:
 			case 232:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3452,7 +3502,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 109:
 			case 105:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL00_1U
 					PIXEL10_C
 					PIXEL20_C
@@ -3471,7 +3521,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 171:
 			case 43:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3490,7 +3540,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 143:
 			case 15:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL02_1R
@@ -3513,7 +3563,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1U
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3525,7 +3575,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 203:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3543,7 +3593,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 62:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3565,7 +3615,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3577,7 +3627,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 118:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3599,7 +3649,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3615,7 +3665,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1R
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3627,7 +3677,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 155:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3737,12 +3787,12 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1U
 				PIXEL10_C
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3753,12 +3803,12 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 158:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3774,7 +3824,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 234:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -3783,7 +3833,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3797,7 +3847,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 242:
 				PIXEL00_1M
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3805,7 +3855,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1L
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3816,7 +3866,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 59:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3825,7 +3875,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL01_3
 					PIXEL10_3
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3842,7 +3892,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3851,7 +3901,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 					PIXEL21_3
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -3859,7 +3909,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 87:
 				PIXEL00_1L
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3872,14 +3922,14 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				PIXEL20_1M
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 79:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3891,7 +3941,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1R
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -3900,20 +3950,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 122:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
 				}
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3922,19 +3972,19 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 					PIXEL21_3
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 94:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3945,38 +3995,38 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				PIXEL10_C
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 218:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
 				}
 				PIXEL10_C
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3987,7 +4037,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 91:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3996,20 +4046,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL01_3
 					PIXEL10_3
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
 				}
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -4060,13 +4110,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 186:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -4081,7 +4131,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 115:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -4091,7 +4141,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -4104,20 +4154,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 206:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -4127,7 +4177,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -4143,7 +4193,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -4153,7 +4203,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 174:
 			case 46:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -4171,7 +4221,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 147:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -4193,7 +4243,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -4223,7 +4273,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 126:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -4233,7 +4283,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL12_3
 				}
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -4245,7 +4295,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 219:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -4257,7 +4307,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -4268,7 +4318,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 125:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL00_1U
 					PIXEL10_C
 					PIXEL20_C
@@ -4286,7 +4336,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 221:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL02_1U
 					PIXEL12_C
 					PIXEL21_C
@@ -4304,7 +4354,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL20_1M
 				break;
 			case 207:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL02_1R
@@ -4322,7 +4372,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1R
 				break;
 			case 238:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -4340,7 +4390,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_1
 				break;
 			case 190:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -4358,7 +4408,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL21_1
 				break;
 			case 187:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -4376,7 +4426,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 243:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL20_1L
 					PIXEL21_C
@@ -4394,7 +4444,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				break;
 			case 119:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL00_1L
 					PIXEL01_C
 					PIXEL02_C
@@ -4419,7 +4469,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
@@ -4429,7 +4479,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 175:
 			case 47:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
@@ -4447,7 +4497,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 151:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4469,7 +4519,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
@@ -4480,7 +4530,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL01_C
 				PIXEL02_1M
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 				} else {
@@ -4488,7 +4538,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL22_C
 				} else {
@@ -4497,7 +4547,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 123:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 				} else {
@@ -4508,7 +4558,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 					PIXEL21_C
 				} else {
@@ -4518,7 +4568,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 95:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL10_C
 				} else {
@@ -4526,7 +4576,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL10_3
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 					PIXEL12_C
 				} else {
@@ -4540,7 +4590,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 222:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 				} else {
@@ -4551,7 +4601,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				PIXEL12_C
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL21_C
 					PIXEL22_C
 				} else {
@@ -4565,7 +4615,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1U
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 				} else {
@@ -4573,7 +4623,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
@@ -4585,13 +4635,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL10_C
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL22_C
 				} else {
@@ -4600,7 +4650,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 235:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 				} else {
@@ -4611,7 +4661,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
@@ -4620,7 +4670,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1R
 				break;
 			case 111:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
@@ -4630,7 +4680,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 					PIXEL21_C
 				} else {
@@ -4640,13 +4690,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 63:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 					PIXEL12_C
 				} else {
@@ -4660,7 +4710,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 159:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL10_C
 				} else {
@@ -4668,7 +4718,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL10_3
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4682,7 +4732,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 215:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4691,7 +4741,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				PIXEL12_C
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL21_C
 					PIXEL22_C
 				} else {
@@ -4701,7 +4751,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 246:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 				} else {
@@ -4713,7 +4763,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
@@ -4721,7 +4771,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 254:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 				} else {
@@ -4729,14 +4779,14 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL02_4
 				}
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 				} else {
 					PIXEL10_3
 					PIXEL20_4
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -4753,20 +4803,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 251:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 				} else {
@@ -4775,7 +4825,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				PIXEL02_1M
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -4784,7 +4834,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_2
 					PIXEL21_3
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL12_C
 					PIXEL22_C
 				} else {
@@ -4793,7 +4843,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 239:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
@@ -4803,7 +4853,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
@@ -4812,7 +4862,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1R
 				break;
 			case 127:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -4821,7 +4871,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL01_3
 					PIXEL10_3
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 					PIXEL12_C
 				} else {
@@ -4829,7 +4879,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL12_3
 				}
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 					PIXEL21_C
 				} else {
@@ -4839,13 +4889,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 191:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4858,14 +4908,14 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 223:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 					PIXEL10_C
 				} else {
 					PIXEL00_4
 					PIXEL10_3
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -4876,7 +4926,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL21_C
 					PIXEL22_C
 				} else {
@@ -4887,7 +4937,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 247:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4897,20 +4947,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 255:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if ((pattern & kHQDiff42)) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if ((pattern & kHQDiff26)) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4918,13 +4968,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if ((pattern & kHQDiff84)) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if ((pattern & kHQDiff68)) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
@@ -4944,6 +4994,11 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 3;
+
+		uint32 *next = above;
+		above = row;
+		row = below;
+		below = next;
 	}
 }
 
@@ -4954,6 +5009,9 @@ HQScaler::HQScaler(const Graphics::PixelFormat &format) : Scaler(format),
 	_RGBtoYUV(nullptr) {
 	_factor = 2;
 
+	if (!HQClassify::classifyFunc)
+		HQClassify::select();
+
 	if (format.bytesPerPixel == 2) {
 		initLUT(format);
 	} else {
@@ -4987,19 +5045,19 @@ void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 }
 
 void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 	else
 		HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 }
 #endif
 
@@ -5007,15 +5065,15 @@ void HQScaler::HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ2x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 		} else {
 			HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ2x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 	}
 }
 
@@ -5023,15 +5081,15 @@ void HQScaler::HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ3x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 		} else {
 			HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ3x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, HQClassify::classifyFunc);
 	}
 }
 
@@ -5079,6 +5137,7 @@ public:
 
 	bool canDrawCursor() const override { return false; }
 	uint extraPixels() const override { return 1; }
+	bool canScaleInBands() const override { return true; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
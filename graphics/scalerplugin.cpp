@@ -19,6 +19,7 @@
  */
 
 #include "graphics/scalerplugin.h"
+#include "common/thread.h"
 
 namespace {
 /**
@@ -42,8 +43,54 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 }
 } // End of anonymous namespace
 
+// The smallest band worth handing to another thread
+static const int kMinBandHeight = 16;
+
+struct Scaler::BandJob {
+	Scaler *scaler;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height, x, y;
+	int bands;
+};
+
+void Scaler::scaleBand(void *data, int index) {
+	const BandJob &job = *(const BandJob *)data;
+	const int top = job.height * index / job.bands;
+	const int bottom = job.height * (index + 1) / job.bands;
+
+	// The bands only write to their own rows, but read the rows around
+	// them like a single rect would
+	job.scaler->scaleIntern(job.srcPtr + top * job.srcPitch, job.srcPitch,
+	                        job.dstPtr + top * job.scaler->_factor * job.dstPitch, job.dstPitch,
+	                        job.width, bottom - top, job.x, job.y + top);
+}
+
+namespace {
+
+struct ParallelCall {
+	ScalerExecutor::JobFunc func;
+	void *data;
+};
+
+void parallelCallProc(void *data, uint index) {
+	ParallelCall *call = (ParallelCall *)data;
+	call->func(call->data, index);
+}
+
+} // End of anonymous namespace
+
+void ParallelScalerExecutor::run(JobFunc func, void *data, int count) {
+	ParallelCall call = { func, data };
+	Common::runParallel(parallelCallProc, &call, count, _numThreads);
+}
+
 void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                           uint32 dstPitch, int width, int height, int x, int y) {
+	const int bands = _executor ? MIN(_executor->getConcurrency(), height / kMinBandHeight) : 1;
+
 	if (_factor == 1) {
 		if (_format.bytesPerPixel == 1) {
 			Normal1x<uint8>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
@@ -52,6 +99,9 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
+	} else if (bands > 1) {
+		BandJob job = { this, srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y, bands };
+		_executor->run(scaleBand, &job, bands);
 	} else {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	}
@@ -25,9 +25,44 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+/**
+ * Runs the bands of a scale operation. A backend may provide an executor
+ * which spreads them over several threads.
+ */
+class ScalerExecutor {
+public:
+	typedef void (*JobFunc)(void *data, int index);
+
+	virtual ~ScalerExecutor() {}
+
+	/**
+	 * Call @p func for each index from 0 to @p count - 1, and return once
+	 * all calls have finished. The calls may run at the same time.
+	 */
+	virtual void run(JobFunc func, void *data, int count) = 0;
+
+	/** The number of calls which can run at the same time. */
+	virtual int getConcurrency() const = 0;
+};
+
+/**
+ * Executor which runs the bands through Common::runParallel(), so they are
+ * spread over threads created by the backend.
+ */
+class ParallelScalerExecutor : public ScalerExecutor {
+public:
+	ParallelScalerExecutor(int numThreads) : _numThreads(numThreads) {}
+
+	void run(JobFunc func, void *data, int count) override;
+	int getConcurrency() const override { return _numThreads; }
+
+private:
+	int _numThreads;
+};
+
 class Scaler {
 public:
-	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
+	Scaler(const Graphics::PixelFormat &format) : _format(format), _executor(nullptr) {}
 	virtual ~Scaler() {}
 
 	/**
@@ -45,6 +80,17 @@ public:
 	void scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	           uint32 dstPitch, int width, int height, int x, int y);
 
+	/**
+	 * Split rects into horizontal bands, and scale them through
+	 * @p executor. scale() still returns once the whole rect is done.
+	 *
+	 * Only use this if ScalerPluginObject::canScaleInBands() returns true
+	 * for the plugin of this scaler.
+	 *
+	 * @param executor The executor, or nullptr to scale on the calling thread.
+	 */
+	void setExecutor(ScalerExecutor *executor) { _executor = executor; }
+
 	/**
 	 * Increase the factor of scaling.
 	 * @return The new factor
@@ -103,6 +149,12 @@ protected:
 
 	uint _factor;
 	Graphics::PixelFormat _format;
+
+private:
+	struct BandJob;
+	static void scaleBand(void *data, int index);
+
+	ScalerExecutor *_executor;
 };
 
 /**
@@ -199,6 +251,15 @@ public:
 	 */
 	virtual bool useOldSource() const { return false; }
 
+	/**
+	 * Scalers which keep no state while scaling give the same result when
+	 * the bands of a rect are scaled at the same time. If this returns
+	 * true, the backend may give the scaler an executor.
+	 *
+	 * @see Scaler::setExecutor
+	 */
+	virtual bool canScaleInBands() const { return false; }
+
 protected:
 	Common::Array<uint> _factors;
 };
@@ -128,6 +128,11 @@ void setContext(ContextHandle *handle) {
 	gl_ctx = ctx;
 }
 
+GLContext::GLContext() :
+		_drawCallsQueue(Common::PoolAllocator<DrawCall *>(_drawCallNodePool)),
+		_previousFrameDrawCallsQueue(Common::PoolAllocator<DrawCall *>(_drawCallNodePool)) {
+}
+
 void GLContext::initSharedState() {
 	GLSharedState *s = &shared_state;
 	s->lists = (GLList **)gl_zalloc(sizeof(GLList *) * MAX_DISPLAY_LISTS);
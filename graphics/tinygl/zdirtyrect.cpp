@@ -105,17 +105,22 @@ void GLContext::disposeDrawCallLists() {
 	_drawCallsQueue.clear();
 }
 
-static inline void _appendDirtyRectangle(const DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
+typedef Common::List<DirtyRectangle, Common::PoolAllocator<DirtyRectangle> > DirtyRectangleList;
+
+static inline void _appendDirtyRectangle(const DrawCall &call, DirtyRectangleList &rectangles, int r, int g, int b) {
 	Common::Rect dirty_region = call.getDirtyRegion();
 	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
 		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
 }
 
 void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas) {
-	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
-	typedef Common::List<DirtyRectangle>::iterator RectangleIterator;
+	typedef DrawCallList::const_iterator DrawCallIterator;
+	typedef DirtyRectangleList::iterator RectangleIterator;
 
-	Common::List<DirtyRectangle> rectangles;
+	// The rectangles are merged and erased a lot, take their nodes from a
+	// pool which does not need to allocate memory for usual frames
+	Common::ListNodePool<DirtyRectangle> rectanglePool;
+	DirtyRectangleList rectangles((Common::PoolAllocator<DirtyRectangle>(rectanglePool)));
 
 	DrawCallIterator itFrame = _drawCallsQueue.begin();
 	DrawCallIterator endFrame = _drawCallsQueue.end();
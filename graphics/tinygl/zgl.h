@@ -32,6 +32,7 @@
 #include "common/textconsole.h"
 #include "common/array.h"
 #include "common/list.h"
+#include "common/memorypool.h"
 #include "common/scummsys.h"
 
 #include "graphics/pixelformat.h"
@@ -462,8 +463,10 @@ struct GLContext {
 	Common::List<BlitImage *> _blitImages;
 
 	// Draw call queue
-	Common::List<DrawCall *> _drawCallsQueue;
-	Common::List<DrawCall *> _previousFrameDrawCallsQueue;
+	typedef Common::List<DrawCall *, Common::PoolAllocator<DrawCall *> > DrawCallList;
+	Common::ListNodePool<DrawCall *> _drawCallNodePool;
+	DrawCallList _drawCallsQueue;
+	DrawCallList _previousFrameDrawCallsQueue;
 	int _currentAllocatorIndex;
 	LinearAllocator _drawCallAllocator[2];
 	bool _debugRectsEnabled;
@@ -542,6 +545,8 @@ public:
 	TGLboolean gl_IsList(TGLuint list);
 	TGLuint gl_GenLists(TGLsizei range);
 
+	GLContext();
+
 	void initSharedState();
 	void endSharedState();
 
@@ -23,6 +23,7 @@
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/memstream.h"
 #include "common/compression/unzip.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
@@ -47,6 +48,25 @@
 
 namespace GUI {
 
+/*
+ * The theme cache holds a theme as it has been loaded for one resolution
+ * and scale. It is kept in a few slots next to the config file, which are
+ * reused from the least recently written one, so switching between themes
+ * or resolutions does not leave cache files behind. Each slot contains:
+ *   uint32 tag, uint32 version, cache key,
+ *   uint32 bitmap count, bitmaps,
+ *   uint32 file count, (file name, uint32 size, compiled file) for each file
+ * The bitmaps are stored after they have been decoded, converted and
+ * scaled, or rasterized in the case of SVG images. Each one is stored as
+ *   name, uint16 width, uint16 height, pixel format (9 bytes),
+ *   byte has transparent color, uint32 transparent color, pixels
+ * The STX files are compiled with Common::XMLReader. Strings are
+ * null-terminated, numbers are stored in big endian.
+ */
+#define THEME_CACHE_TAG     MKTAG('T', 'H', 'M', 'C')
+#define THEME_CACHE_VERSION 1
+#define THEME_CACHE_SLOTS   4
+
 const char *const ThemeEngine::kImageLogo = "logo.bmp";
 const char *const ThemeEngine::kImageLogoSmall = "logo_small.bmp";
 const char *const ThemeEngine::kImageSearch = "search.bmp";
@@ -789,6 +809,11 @@ void ThemeEngine::unloadTheme() {
 	if (!_themeOk)
 		return;
 
+	clearThemeData();
+	_themeOk = false;
+}
+
+void ThemeEngine::clearThemeData() {
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = nullptr;
@@ -808,7 +833,6 @@ void ThemeEngine::unloadTheme() {
 	}
 
 	_themeEval->reset();
-	_themeOk = false;
 }
 
 void ThemeEngine::unloadExtraFont() {
@@ -886,6 +910,23 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 		return false;
 	}
 
+	//
+	// If enabled, load the theme from its cache. Themes in directories are
+	// usually being edited, so they are not cached.
+	//
+	const Common::FSNode themeNode(_themeFile);
+	Common::String cacheKey;
+	if (ConfMan.getBool("gui_theme_cache") && themeNode.exists() && !themeNode.isDirectory())
+		cacheKey = getThemeCacheKey(themeNode, stxHeader);
+
+	const bool useCache = !cacheKey.empty();
+	int cacheSlot = -1;
+
+	if (useCache && loadThemeCache(cacheKey, members, cacheSlot))
+		return true;
+
+	Common::MemoryWriteStreamDynamic compiledFiles(DisposeAfterUse::YES);
+
 	//
 	// Loop over all STX files, load and parse them
 	//
@@ -904,13 +945,234 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 			return false;
 		}
 
+		if (useCache) {
+			Common::MemoryWriteStreamDynamic compiled(DisposeAfterUse::YES);
+			_parser->compile(compiled);
+
+			compiledFiles.writeString(member->getName());
+			compiledFiles.writeByte(0);
+			compiledFiles.writeUint32BE(compiled.size());
+			compiledFiles.write(compiled.getData(), compiled.size());
+		}
+
 		_parser->close();
 	}
 
+	if (useCache)
+		writeThemeCache(cacheKey, members.size(), compiledFiles, cacheSlot);
+
 	assert(!_themeName.empty());
 	return true;
 }
 
+Common::String ThemeEngine::getThemeCacheKey(const Common::FSNode &themeNode, const Common::String &stxHeader) const {
+	int64 size, modificationTime;
+	if (!themeNode.getSizeAndModificationTime(size, modificationTime))
+		return Common::String();
+
+	// The bitmaps depend on the scale and the overlay format, and the
+	// layouts depend on the resolution as well.
+	return Common::String::format("%s;%s;%lld;%lld;%dx%d;%g;%s", themeNode.getPath().toString().c_str(), stxHeader.c_str(),
+		(long long)size, (long long)modificationTime, _baseWidth, _baseHeight, _scaleFactor, _overlayFormat.toString().c_str());
+}
+
+Common::FSNode ThemeEngine::getThemeCacheNode(int slot) const {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	return Common::FSNode(configFile.getParent().appendComponent(Common::String::format("theme%d.cache", slot)));
+}
+
+bool ThemeEngine::loadThemeCache(const Common::String &key, const Common::ArchiveMemberList &members, int &slot) {
+	// Find the slot with the key. Only the headers are read for that.
+	Common::ScopedPtr<Common::SeekableReadStream> stream;
+	slot = -1;
+	for (int i = 0; i < THEME_CACHE_SLOTS && slot < 0; ++i) {
+		const Common::FSNode node = getThemeCacheNode(i);
+		stream.reset(node.exists() ? node.createReadStream() : nullptr);
+		if (stream && stream->readUint32BE() == THEME_CACHE_TAG && stream->readUint32BE() == THEME_CACHE_VERSION && stream->readString() == key)
+			slot = i;
+	}
+
+	if (slot < 0)
+		return false;
+
+	// Read the whole cache at once. The compiled STX files are parsed
+	// directly from this buffer.
+	Common::Array<byte> data;
+	stream->seek(0);
+	stream->readRemainingData(data);
+	if (stream->err())
+		return false;
+	stream.reset();
+
+	Common::MemoryReadStream cache(data.data(), data.size());
+	cache.skip(8);
+	cache.readString();
+
+	// The bitmaps have to be in place before the theme is parsed, so the
+	// parser does not load them again.
+	Common::StringArray addedBitmaps;
+	bool valid = readThemeCacheBitmaps(cache, addedBitmaps) && cache.readUint32BE() == members.size() && !cache.err();
+
+	for (Common::ArchiveMemberList::const_iterator member = members.begin(); valid && member != members.end(); ++member) {
+		const Common::String name = cache.readString();
+		const uint32 compiledSize = cache.readUint32BE();
+		if (cache.err() || name != (*member)->getName() || compiledSize > cache.size() - cache.pos()) {
+			valid = false;
+			break;
+		}
+
+		// The compiled files have been created from the same STX files, so
+		// they can only fail to parse if the cache is corrupted.
+		if (_parser->loadBuffer(data.data() + cache.pos(), compiledSize) == false || _parser->parse() == false) {
+			warning("Failed to parse cached STX file '%s'", name.c_str());
+			valid = false;
+		}
+
+		_parser->close();
+		cache.skip(compiledSize);
+	}
+
+	if (!valid) {
+		// The caller parses the STX files again, which has to start from
+		// scratch rather than on top of what the cache loaded
+		for (const Common::String &name : addedBitmaps) {
+			Graphics::ManagedSurface *surf = _bitmaps[name];
+			if (surf) {
+				surf->free();
+				delete surf;
+			}
+			_bitmaps.erase(name);
+		}
+
+		clearThemeData();
+		return false;
+	}
+
+	debug(6, "Loaded theme from cache '%s'", getThemeCacheNode(slot).getPath().toString(Common::Path::kNativeSeparator).c_str());
+	return true;
+}
+
+void ThemeEngine::writeThemeCache(const Common::String &key, uint32 fileCount, Common::MemoryWriteStreamDynamic &compiledFiles, int slot) {
+	// Reuse an unused slot, or else the least recently written one
+	if (slot < 0) {
+		int64 oldestTime = 0;
+		for (int i = 0; i < THEME_CACHE_SLOTS; ++i) {
+			int64 size, modificationTime;
+			if (!getThemeCacheNode(i).getSizeAndModificationTime(size, modificationTime)) {
+				slot = i;
+				break;
+			}
+
+			if (slot < 0 || modificationTime < oldestTime) {
+				slot = i;
+				oldestTime = modificationTime;
+			}
+		}
+	}
+
+	const Common::FSNode cacheNode = getThemeCacheNode(slot);
+	Common::ScopedPtr<Common::SeekableWriteStream> cacheFile(cacheNode.createWriteStream());
+	if (!cacheFile)
+		return;
+
+	cacheFile->writeUint32BE(THEME_CACHE_TAG);
+	cacheFile->writeUint32BE(THEME_CACHE_VERSION);
+	cacheFile->writeString(key);
+	cacheFile->writeByte(0);
+	writeThemeCacheBitmaps(*cacheFile);
+	cacheFile->writeUint32BE(fileCount);
+	cacheFile->write(compiledFiles.getData(), compiledFiles.size());
+	cacheFile->finalize();
+
+	if (cacheFile->err())
+		warning("Failed to write theme cache '%s'", cacheNode.getPath().toString(Common::Path::kNativeSeparator).c_str());
+}
+
+void ThemeEngine::writeThemeCacheBitmaps(Common::WriteStream &stream) const {
+	uint32 count = 0;
+	for (const auto &bitmap : _bitmaps) {
+		if (bitmap._value)
+			count++;
+	}
+
+	stream.writeUint32BE(count);
+
+	for (const auto &bitmap : _bitmaps) {
+		const Graphics::ManagedSurface *surf = bitmap._value;
+		if (!surf)
+			continue;
+
+		const Graphics::PixelFormat &format = surf->format;
+		stream.writeString(bitmap._key);
+		stream.writeByte(0);
+		stream.writeUint16BE(surf->w);
+		stream.writeUint16BE(surf->h);
+		stream.writeByte(format.bytesPerPixel);
+		stream.writeByte(format.rLoss);
+		stream.writeByte(format.gLoss);
+		stream.writeByte(format.bLoss);
+		stream.writeByte(format.aLoss);
+		stream.writeByte(format.rShift);
+		stream.writeByte(format.gShift);
+		stream.writeByte(format.bShift);
+		stream.writeByte(format.aShift);
+		stream.writeByte(surf->hasTransparentColor());
+		stream.writeUint32BE(surf->getTransparentColor());
+
+		for (int y = 0; y < surf->h; ++y)
+			stream.write(surf->getBasePtr(0, y), surf->w * format.bytesPerPixel);
+	}
+}
+
+bool ThemeEngine::readThemeCacheBitmaps(Common::SeekableReadStream &stream, Common::StringArray &added) {
+	const uint32 count = stream.readUint32BE();
+
+	for (uint32 i = 0; i < count && !stream.err(); ++i) {
+		const Common::String name = stream.readString();
+		const uint16 w = stream.readUint16BE();
+		const uint16 h = stream.readUint16BE();
+
+		Graphics::PixelFormat format;
+		format.bytesPerPixel = stream.readByte();
+		format.rLoss = stream.readByte();
+		format.gLoss = stream.readByte();
+		format.bLoss = stream.readByte();
+		format.aLoss = stream.readByte();
+		format.rShift = stream.readByte();
+		format.gShift = stream.readByte();
+		format.bShift = stream.readByte();
+		format.aShift = stream.readByte();
+
+		const bool hasTransparentColor = stream.readByte() != 0;
+		const uint32 transparentColor = stream.readUint32BE();
+
+		const uint32 rowSize = w * format.bytesPerPixel;
+		if (stream.err() || format.bytesPerPixel < 1 || format.bytesPerPixel > 4 || (int64)rowSize * h > stream.size() - stream.pos())
+			return false;
+
+		// Bitmaps which are already loaded are kept
+		if (_bitmaps.contains(name) && _bitmaps[name]) {
+			stream.skip(rowSize * h);
+			continue;
+		}
+
+		Graphics::ManagedSurface *surf = new Graphics::ManagedSurface(w, h, format);
+		for (int y = 0; y < h; ++y)
+			stream.read(surf->getBasePtr(0, y), rowSize);
+
+		if (hasTransparentColor)
+			surf->setTransparentColor(transparentColor);
+
+		_bitmaps[name] = surf;
+		added.push_back(name);
+	}
+
+	return !stream.err();
+}
+
 
 
 /**********************************************************
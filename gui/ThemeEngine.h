@@ -29,6 +29,7 @@
 #include "common/language.h"
 #include "common/list.h"
 #include "common/str.h"
+#include "common/str-array.h"
 #include "common/rect.h"
 
 #include "graphics/managed_surface.h"
@@ -40,6 +41,10 @@
 
 class OSystem;
 
+namespace Common {
+class MemoryWriteStreamDynamic;
+}
+
 namespace Graphics {
 struct DrawStep;
 class VectorRenderer;
@@ -675,6 +680,47 @@ protected:
 	 */
 	bool loadThemeXML(const Common::String &themeId);
 
+	/**
+	 * Returns the key which identifies the cache of the current theme. It
+	 * contains the path, size and modification time of the theme archive
+	 * and everything the loaded theme depends on, like the resolution,
+	 * scale and overlay format. Returns an empty string if the file system
+	 * can't tell the size and modification time, and the cache can't be used.
+	 */
+	Common::String getThemeCacheKey(const Common::FSNode &themeNode, const Common::String &stxHeader) const;
+
+	/** Returns the file of the given theme cache slot, in the config directory. */
+	Common::FSNode getThemeCacheNode(int slot) const;
+
+	/**
+	 * Loads the current theme from its cache. If the cache turns out to be
+	 * broken after parts of it have been loaded, the theme data is cleared
+	 * again.
+	 *
+	 * @param key The key the cache must have been created with.
+	 * @param members The STX files of the theme.
+	 * @param slot Set to the cache slot with the given key, or -1 if there
+	 *             is none.
+	 * @returns true if the cache was valid and has been loaded.
+	 */
+	bool loadThemeCache(const Common::String &key, const Common::ArchiveMemberList &members, int &slot);
+
+	/**
+	 * Writes the current theme to a cache slot. Unless a slot is given,
+	 * an unused one or else the least recently written one is replaced.
+	 */
+	void writeThemeCache(const Common::String &key, uint32 fileCount, Common::MemoryWriteStreamDynamic &compiledFiles, int slot);
+
+	/** Writes the loaded bitmaps to a theme cache. */
+	void writeThemeCacheBitmaps(Common::WriteStream &stream) const;
+
+	/**
+	 * Reads the bitmaps from a theme cache and adds them to the loaded ones.
+	 *
+	 * @param added Receives the names of the bitmaps which were added.
+	 */
+	bool readThemeCacheBitmaps(Common::SeekableReadStream &stream, Common::StringArray &added);
+
 	/**
 	 * Loads the default theme file (the embedded XML file found
 	 * in ThemeDefaultXML.cpp).
@@ -688,6 +734,9 @@ protected:
 	 */
 	void unloadTheme();
 
+	/** Deletes the draw data, texts, colors and layouts of the theme. */
+	void clearThemeData();
+
 	/**
 	 * Unload the language specific font loaded via loadExtraFont()
 	*/
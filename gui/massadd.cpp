@@ -46,7 +46,10 @@ enum {
 	// Upper bound (im milliseconds) we want to spend in handleTickle.
 	// Setting this low makes the GUI more responsive but also slows
 	// down the scanning.
-	kMaxScanTime = 50
+	kMaxScanTime = 50,
+
+	// Number of directories listed at the same time
+	kScanBatchSize = 8
 };
 
 enum {
@@ -191,85 +194,93 @@ void MassAddDialog::handleTickle() {
 
 	// Perform a breadth-first scan of the filesystem.
 	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
-
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
-		}
-
-		// Run the detector on the dir
-		DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED | ADGF_ADDON), true);
-
-		if (detectionResults.foundUnknownGames()) {
-			Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
-			g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
-		}
+		// List a few directories at once, which is much faster on network
+		// file systems
+		Common::Array<Common::FSDirectoryListing> batch;
+		while (!_scanStack.empty() && batch.size() < kScanBatchSize)
+			batch.push_back(Common::FSDirectoryListing(_scanStack.pop()));
+		Common::listDirectories(batch);
+
+		for (const auto &listing : batch) {
+			if (!listing.listed)
+				continue;
+
+			const Common::FSNode &dir = listing.node;
+			const Common::FSList &files = listing.files;
+
+			// Run the detector on the dir
+			DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED | ADGF_ADDON), true);
+
+			if (detectionResults.foundUnknownGames()) {
+				Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
+				g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
+			}
 
-		// Just add all detected games / game variants. If we get more than one,
-		// that either means the directory contains multiple games, or the detector
-		// could not fully determine which game variant it was seeing. In either
-		// case, let the user choose which entries he wants to keep.
-		//
-		// However, we only add games which are not already in the config file.
-		DetectedGames candidates = detectionResults.listRecognizedGames();
-		for (const auto &cand : candidates) {
-			const DetectedGame &result = cand;
-
-			Common::Path path = dir.getPath();
-			path.removeTrailingSeparators();
-
-			// Check for existing config entries for this path/engineid/gameid/lang/platform combination
-			if (_pathToTargets.contains(path)) {
-				Common::String resultPlatformCode = Common::getPlatformCode(result.platform);
-				Common::String resultLanguageCode = Common::getLanguageCode(result.language);
-
-				bool duplicate = false;
-				const Common::StringArray &targets = _pathToTargets[path];
-				for (const auto &target : targets) {
-					// If the engineid, gameid, platform and language match -> skip it
-					Common::ConfigManager::Domain *dom = ConfMan.getDomain(target);
-					assert(dom);
-
-					if ((!dom->contains("engineid") || (*dom)["engineid"] == result.engineId) &&
-						(*dom)["gameid"] == result.gameId &&
-					    dom->getValOrDefault("platform") == resultPlatformCode &&
-						parseLanguage(dom->getValOrDefault("language")) == parseLanguage(resultLanguageCode)) {
-						duplicate = true;
-						break;
+			// Just add all detected games / game variants. If we get more than one,
+			// that either means the directory contains multiple games, or the detector
+			// could not fully determine which game variant it was seeing. In either
+			// case, let the user choose which entries he wants to keep.
+			//
+			// However, we only add games which are not already in the config file.
+			DetectedGames candidates = detectionResults.listRecognizedGames();
+			for (const auto &cand : candidates) {
+				const DetectedGame &result = cand;
+
+				Common::Path path = dir.getPath();
+				path.removeTrailingSeparators();
+
+				// Check for existing config entries for this path/engineid/gameid/lang/platform combination
+				if (_pathToTargets.contains(path)) {
+					Common::String resultPlatformCode = Common::getPlatformCode(result.platform);
+					Common::String resultLanguageCode = Common::getLanguageCode(result.language);
+
+					bool duplicate = false;
+					const Common::StringArray &targets = _pathToTargets[path];
+					for (const auto &target : targets) {
+						// If the engineid, gameid, platform and language match -> skip it
+						Common::ConfigManager::Domain *dom = ConfMan.getDomain(target);
+						assert(dom);
+
+						if ((!dom->contains("engineid") || (*dom)["engineid"] == result.engineId) &&
+							(*dom)["gameid"] == result.gameId &&
+						    dom->getValOrDefault("platform") == resultPlatformCode &&
+							parseLanguage(dom->getValOrDefault("language")) == parseLanguage(resultLanguageCode)) {
+							duplicate = true;
+							break;
+						}
+					}
+					if (duplicate) {
+						_oldGamesCount++;
+						continue;	// Skip duplicates
 					}
 				}
-				if (duplicate) {
-					_oldGamesCount++;
-					continue;	// Skip duplicates
-				}
-			}
-			_games.push_back(result);
+				_games.push_back(result);
 
-			_list->append(result.description);
-		}
+				_list->append(result.description);
+			}
 
-		for (DetectedGame &game : _games) {
-			game.isSelected = true;
-		}
+			for (DetectedGame &game : _games) {
+				game.isSelected = true;
+			}
 
-		updateGameList();
+			updateGameList();
 
-		// Recurse into all subdirs
-		for (const auto &file : files) {
-			if (file.isDirectory()) {
-				_scanStack.push(file);
+			// Recurse into all subdirs
+			for (const auto &file : files) {
+				if (file.isDirectory()) {
+					_scanStack.push(file);
 
-				_dirTotal++;
+					_dirTotal++;
+				}
 			}
-		}
 
-		_dirsScanned++;
+			_dirsScanned++;
 
 #if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
-		g_system->getTaskbarManager()->setCount(_games.size());
+			g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
+			g_system->getTaskbarManager()->setCount(_games.size());
 #endif
+		}
 	}
 
 
@@ -277,6 +288,9 @@ void MassAddDialog::handleTickle() {
 	Common::U32String buf;
 
 	if (_scanStack.empty()) {
+		// Write the MD5s which were computed during the scan
+		ADCacheMan.saveFingerprints();
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_stale_handle_after_slot_reuse() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl impl(22050);
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		Audio::SoundHandle first, second;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &first, createSineStream<int16>(22050, 1, nullptr, false, false), 1, 100);
+		mixer.stopHandle(first);
+
+		// The new channel takes over the slot of the stopped one
+		mixer.playStream(Audio::Mixer::kSpeechSoundType, &second, createSineStream<int16>(22050, 1, nullptr, false, false), 2, 200);
+
+		mixer.setChannelVolume(first, 10);
+		mixer.setChannelBalance(first, -50);
+
+		TS_ASSERT(!mixer.isSoundHandleActive(first));
+		TS_ASSERT(mixer.isSoundHandleActive(second));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(first), (byte)0);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(second), (byte)200);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(second), (int8)0);
+		TS_ASSERT_EQUALS(mixer.getSoundID(second), 2);
+		TS_ASSERT(!mixer.isSoundIDActive(1));
+		TS_ASSERT(mixer.isSoundIDActive(2));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kSpeechSoundType));
+#endif
+	}
+
+	void test_parameter_changes_coalesce() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl impl(22050);
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		// The null OSystem cannot report the CPU features
+		Audio::MixKernel::accumulateFunc = Audio::MixKernel::mixGeneric;
+		Audio::MixKernel::clampFunc = Audio::MixKernel::clampGeneric;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(22050, 1, nullptr, false, false));
+
+		// Far more changes than fit between two buffers, none of them blocks
+		for (int i = 0; i < 1000; ++i)
+			mixer.setChannelVolume(handle, i & 0xff);
+		mixer.setChannelVolume(handle, 0);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), (byte)0);
+
+		// The last volume wins, so the buffer is silent
+		int16 buffer[2 * 256];
+		impl.mixCallback((byte *)buffer, sizeof(buffer));
+		bool silent = true;
+		for (uint i = 0; i < ARRAYSIZE(buffer); ++i)
+			silent &= (buffer[i] == 0);
+		TS_ASSERT(silent);
+
+		mixer.setChannelVolume(handle, Audio::Mixer::kMaxChannelVolume);
+		impl.mixCallback((byte *)buffer, sizeof(buffer));
+		silent = true;
+		for (uint i = 0; i < ARRAYSIZE(buffer); ++i)
+			silent &= (buffer[i] == 0);
+		TS_ASSERT(!silent);
+
+		// Stopping does not wait for the next buffer
+		mixer.stopAll();
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+
+		Audio::MixKernel::accumulateFunc = nullptr;
+		Audio::MixKernel::clampFunc = nullptr;
+#endif
+	}
+};
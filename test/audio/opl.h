@@ -0,0 +1,215 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/opl/dbopl.h"
+#include "audio/softsynth/opl/mame.h"
+#include "audio/softsynth/opl/nuked.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class OPLTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Plays a note with a slightly different sound on each of the nine melodic channels
+	template<class F>
+	static void playChord(F writeReg) {
+		static const byte operatorOffsets[9] = { 0, 1, 2, 8, 9, 10, 16, 17, 18 };
+
+		writeReg(0x01, 0x20);
+		writeReg(0xBD, 0xC0);
+		for (int c = 0; c < 9; ++c) {
+			for (int op = 0; op < 2; ++op) {
+				const int offset = operatorOffsets[c] + op * 3;
+				writeReg(0x20 + offset, 0xA0 | (c + op));
+				writeReg(0x40 + offset, op ? 0x00 : 0x10 + c);
+				writeReg(0x60 + offset, 0xF2);
+				writeReg(0x80 + offset, 0x54);
+				writeReg(0xE0 + offset, c & 3);
+			}
+			const int fnum = 0x157 + c * 40;
+			writeReg(0xC0 + c, 0x30 | (c << 1) | (c & 1));
+			writeReg(0xA0 + c, fnum & 0xFF);
+			writeReg(0xB0 + c, 0x20 | (4 << 2) | (fnum >> 8));
+		}
+	}
+
+#ifndef DISABLE_NUKED_OPL
+	struct NukedWriter {
+		OPL::NUKED::opl3_chip *_chip;
+		NukedWriter(OPL::NUKED::opl3_chip *chip) : _chip(chip) {}
+		void operator()(int reg, int val) { OPL::NUKED::OPL3_WriteReg(_chip, reg, val); }
+	};
+#endif
+
+#ifndef DISABLE_DOSBOX_OPL
+	struct DOSBoxWriter {
+		OPL::DOSBox::DBOPL::Chip *_chip;
+		DOSBoxWriter(OPL::DOSBox::DBOPL::Chip *chip) : _chip(chip) {}
+		void operator()(int reg, int val) { _chip->WriteReg(reg, val); }
+	};
+#endif
+
+	struct MAMEWriter {
+		OPL::MAME::FM_OPL *_chip;
+		MAMEWriter(OPL::MAME::FM_OPL *chip) : _chip(chip) {}
+		void operator()(int reg, int val) { OPL::MAME::OPLWriteReg(_chip, reg, val); }
+	};
+
+public:
+	void test_nuked_stream_matches_single_frames() {
+#ifndef DISABLE_NUKED_OPL
+		static const uint32 rates[] = { 11025, 44100, 49716, 96000 };
+		// Chunk sizes around and above the internal block size
+		static const uint32 chunks[] = { 1, 255, 256, 257, 1000, 3 };
+
+		for (uint r = 0; r < ARRAYSIZE(rates); ++r) {
+			OPL::NUKED::opl3_chip *block = new OPL::NUKED::opl3_chip;
+			OPL::NUKED::opl3_chip *single = new OPL::NUKED::opl3_chip;
+			OPL::NUKED::OPL3_Reset(block, rates[r]);
+			OPL::NUKED::OPL3_Reset(single, rates[r]);
+			playChord(NukedWriter(block));
+			playChord(NukedWriter(single));
+
+			int16 blockBuffer[1000 * 2], singleBuffer[1000 * 2];
+			bool equal = true, silent = true;
+			for (int i = 0; i < 20; ++i) {
+				const uint32 numFrames = chunks[i % ARRAYSIZE(chunks)];
+				OPL::NUKED::OPL3_GenerateStream(block, blockBuffer, numFrames);
+				for (uint32 j = 0; j < numFrames; ++j)
+					OPL::NUKED::OPL3_GenerateResampled(single, singleBuffer + j * 2);
+
+				for (uint32 j = 0; j < numFrames * 2; ++j) {
+					equal = equal && blockBuffer[j] == singleBuffer[j];
+					silent = silent && blockBuffer[j] == 0;
+				}
+
+				// Switch to OPL3 mode halfway through
+				if (i == 10) {
+					OPL::NUKED::OPL3_WriteReg(block, 0x105, 1);
+					OPL::NUKED::OPL3_WriteReg(single, 0x105, 1);
+				}
+			}
+			TS_ASSERT(equal);
+			TS_ASSERT(!silent);
+
+			delete block;
+			delete single;
+		}
+#endif
+	}
+
+	void test_nuked_stream_matches_reference() {
+#ifndef DISABLE_NUKED_OPL
+		// FNV-1a hashes of the output of the original per-frame core
+		static const struct {
+			uint32 rate;
+			uint32 hash;
+		} reference[] = {
+			{   100, 0x3252b1f6 },
+			{ 11025, 0xc79459b8 },
+			{ 44100, 0xb6fec957 },
+			{ 49716, 0x599eb5e6 },
+			{ 96000, 0x8885ab27 }
+		};
+		static const uint32 chunks[] = { 1, 255, 256, 257, 1000, 3 };
+
+		for (uint r = 0; r < ARRAYSIZE(reference); ++r) {
+			OPL::NUKED::opl3_chip *chip = new OPL::NUKED::opl3_chip;
+			OPL::NUKED::OPL3_Reset(chip, reference[r].rate);
+			playChord(NukedWriter(chip));
+
+			int16 buffer[1000 * 2];
+			uint32 hash = 2166136261u;
+			for (int i = 0; i < 20; ++i) {
+				const uint32 numFrames = chunks[i % ARRAYSIZE(chunks)];
+				OPL::NUKED::OPL3_GenerateStream(chip, buffer, numFrames);
+				for (uint32 j = 0; j < numFrames * 2; ++j) {
+					hash ^= (uint16)buffer[j];
+					hash *= 16777619u;
+				}
+
+				if (i == 10)
+					OPL::NUKED::OPL3_WriteReg(chip, 0x105, 1);
+			}
+			TS_ASSERT_EQUALS(hash, reference[r].hash);
+
+			delete chip;
+		}
+#endif
+	}
+
+	void test_opl_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 1;
+#endif
+		const int rate = 44100;
+		const int numFrames = 4096;
+
+		int16 *output = new int16[numFrames * 2];
+		uint32 start, time;
+
+#ifndef DISABLE_DOSBOX_OPL
+		{
+			OPL::DOSBox::DBOPL::Chip *chip = new OPL::DOSBox::DBOPL::Chip();
+			chip->Setup(rate);
+			chip->WriteReg(0x105, 1);
+			playChord(DOSBoxWriter(chip));
+
+			const uint bufferLength = 512;
+			int32 tempBuffer[bufferLength * 2];
+			start = g_system->getMillis();
+			for (int i = 0; i < iters; ++i) {
+				for (int j = 0; j < numFrames; j += bufferLength)
+					chip->GenerateBlock3(bufferLength, tempBuffer);
+			}
+			time = MAX<uint32>(g_system->getMillis() - start, 1);
+			debug("OPL DOSBox: %f frames per second", (double)numFrames * iters * 1000 / time);
+
+			delete chip;
+		}
+#endif
+
+		{
+			OPL::MAME::FM_OPL *chip = OPL::MAME::makeAdLibOPL(rate);
+			playChord(MAMEWriter(chip));
+
+			start = g_system->getMillis();
+			for (int i = 0; i < iters; ++i)
+				OPL::MAME::YM3812UpdateOne(chip, output, numFrames);
+			time = MAX<uint32>(g_system->getMillis() - start, 1);
+			debug("OPL MAME: %f frames per second", (double)numFrames * iters * 1000 / time);
+
+			OPL::MAME::OPLDestroy(chip);
+		}
+
+#ifndef DISABLE_NUKED_OPL
+		{
+			OPL::NUKED::opl3_chip *chip = new OPL::NUKED::opl3_chip;
+			OPL::NUKED::OPL3_Reset(chip, rate);
+			OPL::NUKED::OPL3_WriteReg(chip, 0x105, 1);
+			playChord(NukedWriter(chip));
+
+			start = g_system->getMillis();
+			for (int i = 0; i < iters; ++i)
+				OPL::NUKED::OPL3_GenerateStream(chip, output, numFrames);
+			time = MAX<uint32>(g_system->getMillis() - start, 1);
+			debug("OPL Nuked: %f frames per second", (double)numFrames * iters * 1000 / time);
+
+			delete chip;
+		}
+#endif
+
+		delete[] output;
+#endif
+	}
+};
@@ -0,0 +1,100 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/prefetch.h"
+
+#include "helper.h"
+
+class PrefetchingAudioStreamTestSuite : public CxxTest::TestSuite {
+	// Remembers where the stream was last seeked to
+	class SeekRecordingStream : public Audio::SeekableAudioStream {
+	public:
+		SeekRecordingStream(Audio::SeekableAudioStream *parent) : _parent(parent), _lastSeek(-1) {}
+		~SeekRecordingStream() { delete _parent; }
+
+		int readBuffer(int16 *buffer, const int numSamples) override { return _parent->readBuffer(buffer, numSamples); }
+		bool endOfData() const override { return _parent->endOfData(); }
+		bool isStereo() const override { return _parent->isStereo(); }
+		int getRate() const override { return _parent->getRate(); }
+		Audio::Timestamp getLength() const override { return _parent->getLength(); }
+
+		bool seek(const Audio::Timestamp &where) override {
+			_lastSeek = where.convertToFramerate(getRate()).totalNumberOfFrames();
+			return _parent->seek(where);
+		}
+
+		Audio::SeekableAudioStream *_parent;
+		int _lastSeek;
+	};
+
+public:
+	void test_read_and_seek() {
+		const int sampleRate = 11025;
+		const int time = 2;
+		int16 *sine;
+
+		Audio::SeekableAudioStream *parent = createSineStream<int16>(sampleRate, time, &sine, false, true);
+		// Decode directly, as there are no threads to run the worker
+		Audio::PrefetchingAudioStream *stream = new Audio::PrefetchingAudioStream(parent, DisposeAfterUse::YES, 0);
+		TS_ASSERT(stream->isStereo());
+		TS_ASSERT_EQUALS(stream->getRate(), sampleRate);
+		TS_ASSERT_EQUALS(stream->getLength().msecs(), time * 1000);
+
+		const int totalSamples = sampleRate * time * 2;
+		int16 *buffer = new int16[totalSamples];
+
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 1000), 1000);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, 1000 * sizeof(int16)), 0);
+
+		// Reading past the end returns the remaining samples only
+		TS_ASSERT(!stream->endOfData());
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, totalSamples), totalSamples - 1000);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + 1000, (totalSamples - 1000) * sizeof(int16)), 0);
+		TS_ASSERT(stream->endOfData());
+
+		// Seeking starts over at the new position
+		TS_ASSERT(stream->seek(Audio::Timestamp(1000, sampleRate)));
+		TS_ASSERT(!stream->endOfData());
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 1000), 1000);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + sampleRate * 2, 1000 * sizeof(int16)), 0);
+
+		delete[] buffer;
+		delete stream;
+		delete[] sine;
+	}
+
+	void test_loop_prefill() {
+		const int sampleRate = 11025;
+		const int time = 1;
+		int16 *sine;
+
+		SeekRecordingStream *parent = new SeekRecordingStream(createSineStream<int16>(sampleRate, time, &sine, false, true));
+		// Without threads, the buffer is inactive, but still keeps the start
+		Audio::PrefetchingAudioStream *stream = new Audio::PrefetchingAudioStream(parent, DisposeAfterUse::YES, 100);
+		Audio::AudioStream *looping = Audio::makeLoopingAudioStream(stream, 3);
+
+		const int totalSamples = sampleRate * time * 2;
+		int16 *buffer = new int16[totalSamples * 3];
+
+		// Each pass is read across the loop point in odd sized pieces
+		int samplesRead = 0;
+		while (samplesRead < totalSamples * 3) {
+			const int count = looping->readBuffer(buffer + samplesRead, MIN(1234, totalSamples * 3 - samplesRead));
+			if (count <= 0)
+				break;
+			samplesRead += count;
+		}
+		TS_ASSERT_EQUALS(samplesRead, totalSamples * 3);
+		for (int pass = 0; pass < 3; ++pass)
+			TS_ASSERT_EQUALS(memcmp(buffer + pass * totalSamples, sine, totalSamples * sizeof(int16)), 0);
+
+		// The start of the stream was kept on the first pass, so the later
+		// passes only decode the parent after it
+		TS_ASSERT_EQUALS(parent->_lastSeek, sampleRate / 10);
+		TS_ASSERT_EQUALS(looping->readBuffer(buffer, 100), 0);
+		TS_ASSERT(looping->endOfData());
+
+		delete[] buffer;
+		delete looping;
+		delete[] sine;
+	}
+};
@@ -0,0 +1,438 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	typedef Audio::MixKernel::MixFunc MixFunc;
+	typedef Audio::MixKernel::AccumulateFunc AccumulateFunc;
+	typedef Audio::MixKernel::ClampFunc ClampFunc;
+	typedef Audio::SincKernel::ConvolveFunc ConvolveFunc;
+
+	// Collects the SIMD kernels which can be run on this CPU
+	int getSIMDKernels(MixFunc *funcs) {
+		int numFuncs = 0;
+#ifdef SCUMMVM_NEON
+		funcs[numFuncs++] = Audio::MixKernel::mixNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs[numFuncs++] = Audio::MixKernel::mixSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs[numFuncs++] = Audio::MixKernel::mixAVX2;
+#endif
+		return numFuncs;
+	}
+
+	int getSIMDConvolveKernels(ConvolveFunc *funcs) {
+		int numFuncs = 0;
+#ifdef SCUMMVM_NEON
+		funcs[numFuncs++] = Audio::SincKernel::convolveNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs[numFuncs++] = Audio::SincKernel::convolveSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs[numFuncs++] = Audio::SincKernel::convolveAVX2;
+#endif
+		return numFuncs;
+	}
+
+	// Fills the buffer with a deterministic pattern covering the full sample range
+	void fillPattern(int16 *buffer, int numSamples, uint32 seed) {
+		for (int i = 0; i < numSamples; ++i) {
+			seed = seed * 1103515245 + 12345;
+			buffer[i] = (int16)(seed >> 16);
+		}
+	}
+
+	void mixKernelTestTemplate(MixFunc func, bool inStereo, bool outStereo, bool reverseStereo) {
+		const int maxFrames = 131;
+		const Audio::st_volume_t volumes[] = { 0, 1, 64, 127, 255, 256 };
+
+		int16 in[maxFrames * 2];
+		int16 expected[maxFrames * 2];
+		int16 result[maxFrames * 2];
+
+		for (int numFrames = 0; numFrames <= maxFrames; numFrames += 7) {
+			for (uint l = 0; l < ARRAYSIZE(volumes); ++l) {
+				for (uint r = 0; r < ARRAYSIZE(volumes); ++r) {
+					fillPattern(in, maxFrames * 2, numFrames + l);
+					fillPattern(expected, maxFrames * 2, numFrames + r + 1000);
+					memcpy(result, expected, sizeof(result));
+
+					Audio::MixKernel::Args<int16> genericArgs(in, expected, numFrames, volumes[l], volumes[r], inStereo, outStereo, reverseStereo);
+					Audio::MixKernel::mixGeneric(genericArgs);
+					Audio::MixKernel::Args<int16> simdArgs(in, result, numFrames, volumes[l], volumes[r], inStereo, outStereo, reverseStereo);
+					func(simdArgs);
+
+					TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+				}
+			}
+		}
+	}
+
+	int getSIMDAccumulateKernels(AccumulateFunc *funcs, ClampFunc *clampFuncs) {
+		int numFuncs = 0;
+#ifdef SCUMMVM_NEON
+		clampFuncs[numFuncs] = Audio::MixKernel::clampNEON;
+		funcs[numFuncs++] = Audio::MixKernel::mixNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			clampFuncs[numFuncs] = Audio::MixKernel::clampSSE2;
+			funcs[numFuncs++] = Audio::MixKernel::mixSSE2;
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			clampFuncs[numFuncs] = Audio::MixKernel::clampAVX2;
+			funcs[numFuncs++] = Audio::MixKernel::mixAVX2;
+		}
+#endif
+		return numFuncs;
+	}
+
+	void accumulateKernelTestTemplate(AccumulateFunc func, bool inStereo, bool outStereo, bool reverseStereo) {
+		const int maxFrames = 131;
+		const Audio::st_volume_t volumes[] = { 0, 1, 64, 127, 255, 256 };
+
+		int16 in[maxFrames * 2];
+		int32 expected[maxFrames * 2];
+		int32 result[maxFrames * 2];
+
+		for (int numFrames = 0; numFrames <= maxFrames; numFrames += 7) {
+			for (uint l = 0; l < ARRAYSIZE(volumes); ++l) {
+				for (uint r = 0; r < ARRAYSIZE(volumes); ++r) {
+					fillPattern(in, maxFrames * 2, numFrames + l);
+					// Start from values outside of the 16-bit range, which must not be clamped
+					for (int i = 0; i < maxFrames * 2; ++i)
+						expected[i] = (int32)in[maxFrames * 2 - 1 - i] * 3;
+					memcpy(result, expected, sizeof(result));
+
+					Audio::MixKernel::Args<int32> genericArgs(in, expected, numFrames, volumes[l], volumes[r], inStereo, outStereo, reverseStereo);
+					Audio::MixKernel::mixGeneric(genericArgs);
+					Audio::MixKernel::Args<int32> simdArgs(in, result, numFrames, volumes[l], volumes[r], inStereo, outStereo, reverseStereo);
+					func(simdArgs);
+
+					TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+				}
+			}
+		}
+	}
+
+	void convertTestTemplate(MixFunc func, int inRate, int outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+		const int numFrames = 4000;
+		const Audio::st_volume_t volL = 200, volR = 256;
+
+		int16 expected[numFrames * 2];
+		int16 result[numFrames * 2];
+		fillPattern(expected, numFrames * 2, inRate + outRate);
+		memcpy(result, expected, sizeof(result));
+
+		Audio::MixKernel::mixFunc = Audio::MixKernel::mixGeneric;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 1, nullptr, true, inStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+		int expectedFrames = converter->convert(*s, expected, numFrames, volL, volR);
+		delete converter;
+		delete s;
+
+		Audio::MixKernel::mixFunc = func;
+		s = createSineStream<int16>(inRate, 1, nullptr, true, inStereo);
+		converter = Audio::makeRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+		int resultFrames = converter->convert(*s, result, numFrames, volL, volR);
+		delete converter;
+		delete s;
+
+		Audio::MixKernel::mixFunc = nullptr;
+
+		TS_ASSERT_EQUALS(expectedFrames, resultFrames);
+		TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+	}
+
+	void convolveTestTemplate(ConvolveFunc func, uint32 stepInt, uint32 stepFrac, uint outStride) {
+		const uint historyLen = 300;
+		const uint maxFrames = 200;
+		const int numCoefs = Audio::SincKernel::kPhases * Audio::SincKernel::kTaps;
+
+		int16 history[historyLen];
+		int16 *coefs = new int16[numCoefs];
+		int16 expected[maxFrames * 2];
+		int16 result[maxFrames * 2];
+
+		fillPattern(history, historyLen, stepInt + stepFrac);
+		fillPattern(coefs, numCoefs, outStride);
+		// Keep the coefficients in the range of a real filter, so the sums don't overflow
+		for (int i = 0; i < numCoefs; ++i)
+			coefs[i] >>= 4;
+		memset(expected, 0, sizeof(expected));
+		memset(result, 0, sizeof(result));
+
+		uint32 expectedPos = 3, expectedFrac = 0x12345678;
+		Audio::SincKernel::Args genericArgs(history, historyLen, coefs, expectedPos, expectedFrac, stepInt, stepFrac, expected, outStride, maxFrames);
+		uint expectedFrames = Audio::SincKernel::convolveGeneric(genericArgs);
+
+		uint32 resultPos = 3, resultFrac = 0x12345678;
+		Audio::SincKernel::Args simdArgs(history, historyLen, coefs, resultPos, resultFrac, stepInt, stepFrac, result, outStride, maxFrames);
+		uint resultFrames = func(simdArgs);
+
+		delete[] coefs;
+
+		TS_ASSERT_EQUALS(expectedFrames, resultFrames);
+		TS_ASSERT_EQUALS(expectedPos, resultPos);
+		TS_ASSERT_EQUALS(expectedFrac, resultFrac);
+		TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+	}
+
+	void convertTestAllLayouts(MixFunc func, int inRate, int outRate) {
+		convertTestTemplate(func, inRate, outRate, true, true, false);
+		convertTestTemplate(func, inRate, outRate, true, true, true);
+		convertTestTemplate(func, inRate, outRate, true, false, false);
+		convertTestTemplate(func, inRate, outRate, false, true, false);
+		convertTestTemplate(func, inRate, outRate, false, false, false);
+	}
+
+public:
+	void test_mix_kernels_bit_exact() {
+		MixFunc funcs[3];
+		int numFuncs = getSIMDKernels(funcs);
+
+		for (int i = 0; i < numFuncs; ++i) {
+			mixKernelTestTemplate(funcs[i], true, true, false);
+			mixKernelTestTemplate(funcs[i], true, true, true);
+			mixKernelTestTemplate(funcs[i], true, false, false);
+			mixKernelTestTemplate(funcs[i], false, true, false);
+			mixKernelTestTemplate(funcs[i], false, false, false);
+		}
+	}
+
+	void test_copy_convert_bit_exact() {
+		MixFunc funcs[3];
+		int numFuncs = getSIMDKernels(funcs);
+
+		for (int i = 0; i < numFuncs; ++i)
+			convertTestAllLayouts(funcs[i], 22050, 22050);
+	}
+
+	void test_simple_convert_bit_exact() {
+		MixFunc funcs[3];
+		int numFuncs = getSIMDKernels(funcs);
+
+		for (int i = 0; i < numFuncs; ++i)
+			convertTestAllLayouts(funcs[i], 44100, 22050);
+	}
+
+	void test_interpolate_convert_bit_exact() {
+		MixFunc funcs[3];
+		int numFuncs = getSIMDKernels(funcs);
+
+		for (int i = 0; i < numFuncs; ++i) {
+			convertTestAllLayouts(funcs[i], 11025, 48000);
+			convertTestAllLayouts(funcs[i], 48000, 44100);
+		}
+	}
+
+	void test_convolve_kernels_bit_exact() {
+		ConvolveFunc funcs[3];
+		int numFuncs = getSIMDConvolveKernels(funcs);
+
+		for (int i = 0; i < numFuncs; ++i) {
+			// Upsampling 11025 -> 48000, downsampling 48000 -> 44100 and 44100 -> 11025
+			convolveTestTemplate(funcs[i], 0, 0x3acd8a0c, 1);
+			convolveTestTemplate(funcs[i], 1, 0x16bc9b8b, 2);
+			convolveTestTemplate(funcs[i], 4, 0, 2);
+		}
+	}
+
+	void test_sinc_convert_unity_gain() {
+		const int numFrames = 4000;
+		const int16 level = 10000;
+
+		Audio::SincKernel::convolveFunc = Audio::SincKernel::convolveGeneric;
+		Audio::MixKernel::mixFunc = Audio::MixKernel::mixGeneric;
+
+		const int rates[][2] = { { 11025, 48000 }, { 22050, 22050 }, { 48000, 44100 }, { 44100, 11025 } };
+		for (uint r = 0; r < ARRAYSIZE(rates); ++r) {
+			int16 *input = (int16 *)malloc(numFrames * 2 * sizeof(int16));
+			for (int i = 0; i < numFrames * 2; ++i)
+				input[i] = level;
+
+			byte flags = Audio::FLAG_16BITS | Audio::FLAG_STEREO;
+#ifdef SCUMM_LITTLE_ENDIAN
+			flags |= Audio::FLAG_LITTLE_ENDIAN;
+#endif
+			Audio::SeekableAudioStream *s = Audio::makeRawStream((const byte *)input, numFrames * 2 * sizeof(int16), rates[r][0], flags);
+			Audio::RateConverter *converter = Audio::makeRateConverter(rates[r][0], rates[r][1], true, true, false, Audio::kRateConverterHigh);
+
+			int16 output[512 * 2];
+			memset(output, 0, sizeof(output));
+			TS_ASSERT_EQUALS(converter->convert(*s, output, 512, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 512);
+
+			// Skip the step response of the filter, after that a constant input has to stay constant
+			const int settleFrames = Audio::SincKernel::kTaps * rates[r][1] / rates[r][0] + 1;
+			for (int i = settleFrames * 2; i < 512 * 2; ++i)
+				TS_ASSERT_EQUALS(output[i], level);
+
+			delete converter;
+			delete s;
+		}
+
+		Audio::SincKernel::convolveFunc = nullptr;
+		Audio::MixKernel::mixFunc = nullptr;
+	}
+
+	void test_convert_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 2000;
+#else
+		const int iters = 1;
+#endif
+		const int numFrames = 4096;
+
+		// Convert into the mix bus, like the mixer does
+		AccumulateFunc accumulateFuncs[3];
+		ClampFunc clampFuncs[3];
+		ConvolveFunc convolveFuncs[3];
+		int numFuncs = getSIMDAccumulateKernels(accumulateFuncs, clampFuncs);
+		getSIMDConvolveKernels(convolveFuncs);
+		Audio::MixKernel::accumulateFunc = Audio::MixKernel::mixGeneric;
+		Audio::SincKernel::convolveFunc = Audio::SincKernel::convolveGeneric;
+		if (numFuncs) {
+			Audio::MixKernel::accumulateFunc = accumulateFuncs[numFuncs - 1];
+			Audio::SincKernel::convolveFunc = convolveFuncs[numFuncs - 1];
+		}
+
+		static const struct {
+			const char *name;
+			int inRate, outRate;
+			Audio::RateConverterQuality quality;
+		} modes[] = {
+			{ "copy", 44100, 44100, Audio::kRateConverterFast },
+			{ "nearest", 44100, 22050, Audio::kRateConverterFast },
+			{ "linear", 22050, 44100, Audio::kRateConverterFast },
+			{ "sinc", 22050, 44100, Audio::kRateConverterHigh }
+		};
+
+		int32 *output = new int32[numFrames * 2];
+		for (uint m = 0; m < ARRAYSIZE(modes); ++m) {
+			Audio::SeekableAudioStream *sine = createSineStream<int16>(modes[m].inRate, 1, nullptr, true, true);
+			Audio::AudioStream *s = Audio::makeLoopingAudioStream(sine, 0);
+			Audio::RateConverter *converter = Audio::makeRateConverter(modes[m].inRate, modes[m].outRate, true, true, false, modes[m].quality);
+
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iters; ++i) {
+				memset(output, 0, numFrames * 2 * sizeof(int32));
+				converter->convert(*s, output, numFrames, 200, 256);
+			}
+			uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+			debug("RateConverter %s %d -> %d: %f output frames per second\n", modes[m].name, modes[m].inRate, modes[m].outRate,
+			      (double)numFrames * iters * 1000 / time);
+
+			delete converter;
+			delete s;
+		}
+		delete[] output;
+
+		Audio::MixKernel::accumulateFunc = nullptr;
+		Audio::SincKernel::convolveFunc = nullptr;
+#endif
+	}
+
+	void test_accumulate_kernels_bit_exact() {
+		AccumulateFunc funcs[3];
+		ClampFunc clampFuncs[3];
+		int numFuncs = getSIMDAccumulateKernels(funcs, clampFuncs);
+
+		for (int i = 0; i < numFuncs; ++i) {
+			accumulateKernelTestTemplate(funcs[i], true, true, false);
+			accumulateKernelTestTemplate(funcs[i], true, true, true);
+			accumulateKernelTestTemplate(funcs[i], true, false, false);
+			accumulateKernelTestTemplate(funcs[i], false, true, false);
+			accumulateKernelTestTemplate(funcs[i], false, false, false);
+		}
+	}
+
+	void test_clamp_kernels_bit_exact() {
+		AccumulateFunc funcs[3];
+		ClampFunc clampFuncs[3];
+		int numFuncs = getSIMDAccumulateKernels(funcs, clampFuncs);
+
+		const int maxSamples = 131;
+		int32 in[maxSamples];
+		int16 expected[maxSamples];
+		int16 result[maxSamples];
+		for (int i = 0; i < maxSamples; ++i)
+			in[i] = (i - maxSamples / 2) * 1000;
+
+		for (int i = 0; i < numFuncs; ++i) {
+			for (int numSamples = 0; numSamples <= maxSamples; numSamples += 5) {
+				memset(expected, 0, sizeof(expected));
+				memset(result, 0, sizeof(result));
+				Audio::MixKernel::clampGeneric(in, expected, numSamples);
+				clampFuncs[i](in, result, numSamples);
+				TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+			}
+		}
+	}
+
+	void test_convert_mix_bus() {
+		const int numFrames = 1000;
+
+		Audio::MixKernel::mixFunc = Audio::MixKernel::mixGeneric;
+		Audio::MixKernel::accumulateFunc = Audio::MixKernel::mixGeneric;
+		Audio::MixKernel::clampFunc = Audio::MixKernel::clampGeneric;
+
+		int16 expected[numFrames * 2], result[numFrames * 2];
+		int32 bus[numFrames * 2];
+		memset(expected, 0, sizeof(expected));
+		memset(bus, 0, sizeof(bus));
+
+		Audio::SeekableAudioStream *s = createSineStream<int16>(44100, 1, nullptr, true, true);
+		Audio::RateConverter *converter = Audio::makeRateConverter(44100, 48000, true, true, false);
+		TS_ASSERT_EQUALS(converter->convert(*s, expected, numFrames, 256, 256), numFrames);
+		delete converter;
+		delete s;
+
+		// Mixing the same stream three times overflows the 16-bit range, but
+		// the bus only clamps at the end, so removing two of them again
+		// must restore the original samples
+		for (int i = 0; i < 3; ++i) {
+			s = createSineStream<int16>(44100, 1, nullptr, true, true);
+			converter = Audio::makeRateConverter(44100, 48000, true, true, false);
+			TS_ASSERT_EQUALS(converter->convert(*s, bus, numFrames, 256, 256), numFrames);
+			delete converter;
+			delete s;
+		}
+
+		for (int i = 0; i < numFrames * 2; ++i)
+			bus[i] -= 2 * expected[i];
+
+		Audio::MixKernel::clamp(bus, result, numFrames * 2);
+		TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+
+		Audio::MixKernel::mixFunc = nullptr;
+		Audio::MixKernel::accumulateFunc = nullptr;
+		Audio::MixKernel::clampFunc = nullptr;
+	}
+};
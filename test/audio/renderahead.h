@@ -0,0 +1,199 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/renderahead.h"
+
+#include "../null_osystem.h"
+
+class RenderAheadTestSuite : public CxxTest::TestSuite {
+private:
+	// Generates consecutive numbers, so that lost or repeated samples can be detected
+	struct CountingGenerator {
+		int16 _next;
+		int16 _end;
+		int _calls;
+
+		CountingGenerator(int16 end = 0x7FFF) : _next(0), _end(end), _calls(0) {}
+
+		void restart() {
+			_next = 10000;
+		}
+
+		int render(int16 *buffer, int numSamples) {
+			int i;
+			for (i = 0; i < numSamples && _next < _end; ++i)
+				buffer[i] = _next++;
+			_calls++;
+			return i;
+		}
+	};
+
+	Audio::RenderAheadBuffer *createBuffer(CountingGenerator &generator) {
+		return new Audio::RenderAheadBuffer(new Common::Functor2Mem<int16 *, int, int, CountingGenerator>(&generator, &CountingGenerator::render));
+	}
+
+	void fillAll(Audio::RenderAheadBuffer *renderAhead) {
+		while (renderAhead->fillChunk()) {
+		}
+	}
+
+	bool checkSequence(const int16 *buffer, int numSamples, int16 first) {
+		for (int i = 0; i < numSamples; ++i) {
+			if (buffer[i] != (int16)(first + i))
+				return false;
+		}
+		return true;
+	}
+
+	bool checkSilence(const int16 *buffer, int numSamples) {
+		for (int i = 0; i < numSamples; ++i) {
+			if (buffer[i] != 0)
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_inactive_read() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		CountingGenerator generator;
+		Audio::RenderAheadBuffer *renderAhead = createBuffer(generator);
+		TS_ASSERT(!renderAhead->isActive());
+
+		int16 buffer[100];
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 100), 100);
+		TS_ASSERT(checkSequence(buffer, 100, 0));
+		TS_ASSERT_EQUALS(generator._calls, 1);
+
+		delete renderAhead;
+#endif
+	}
+
+	void test_read_ahead() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		CountingGenerator generator;
+		Audio::RenderAheadBuffer *renderAhead = createBuffer(generator);
+
+		// Run the worker by hand instead of on its own thread
+		renderAhead->allocate(2048, true);
+		renderAhead->_active.store(true);
+		fillAll(renderAhead);
+		TS_ASSERT_EQUALS(renderAhead->_ring->size(), 2048u);
+
+		// Everything up to the lookahead comes from the ring buffer
+		int16 buffer[3000];
+		const int calls = generator._calls;
+		renderAhead->read(buffer, 1000);
+		TS_ASSERT(checkSequence(buffer, 1000, 0));
+		TS_ASSERT_EQUALS(generator._calls, calls);
+
+		// The worker only renders whole chunks
+		TS_ASSERT(renderAhead->fillChunk());
+		TS_ASSERT(!renderAhead->fillChunk());
+		TS_ASSERT_EQUALS(renderAhead->_ring->size(), 1560u);
+
+		// An underrun is padded with silence instead of rendering directly
+		int silence;
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 3000, &silence), 3000);
+		TS_ASSERT(checkSequence(buffer, 1560, 1000));
+		TS_ASSERT(checkSilence(buffer + 1560, 1440));
+		TS_ASSERT_EQUALS(silence, 1440);
+		TS_ASSERT_EQUALS(generator._calls, calls + 1);
+		TS_ASSERT(renderAhead->_ring->empty());
+
+		// The worker continues where it left off
+		fillAll(renderAhead);
+		renderAhead->read(buffer, 100, &silence);
+		TS_ASSERT(checkSequence(buffer, 100, 2560));
+		TS_ASSERT_EQUALS(silence, 0);
+
+		renderAhead->_active.store(false);
+		delete renderAhead;
+#endif
+	}
+
+	void test_end_of_data() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		CountingGenerator generator(1500);
+		Audio::RenderAheadBuffer *renderAhead = createBuffer(generator);
+
+		renderAhead->allocate(2048, true);
+		renderAhead->_active.store(true);
+		fillAll(renderAhead);
+		TS_ASSERT_EQUALS(renderAhead->_ring->size(), 1500u);
+		TS_ASSERT(!renderAhead->endOfData());
+
+		// The generator is not called anymore once it has ended
+		int16 buffer[1000];
+		const int calls = generator._calls;
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 1000), 1000);
+		TS_ASSERT(checkSequence(buffer, 1000, 0));
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 1000), 500);
+		TS_ASSERT(checkSequence(buffer, 500, 1000));
+		TS_ASSERT_EQUALS(generator._calls, calls);
+		TS_ASSERT(renderAhead->endOfData());
+
+		// Stopping resets the end, e.g. after the generator was rewound
+		renderAhead->_active.store(false);
+		renderAhead->stop();
+		TS_ASSERT(!renderAhead->endOfData());
+		generator._next = 1400;
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 1000), 100);
+		TS_ASSERT(checkSequence(buffer, 100, 1400));
+		TS_ASSERT(renderAhead->endOfData());
+
+		delete renderAhead;
+#endif
+	}
+
+	void test_reset() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		CountingGenerator generator;
+		Audio::RenderAheadBuffer *renderAhead = new Audio::RenderAheadBuffer(
+			new Common::Functor2Mem<int16 *, int, int, CountingGenerator>(&generator, &CountingGenerator::render),
+			new Common::Functor0Mem<void, CountingGenerator>(&generator, &CountingGenerator::restart));
+
+		renderAhead->allocate(2048, true);
+		renderAhead->_active.store(true);
+		fillAll(renderAhead);
+
+		// The prefill comes first, and the rendered samples are dropped
+		// without read() waiting for the worker
+		int16 buffer[1000];
+		const int16 prefill[4] = { 9996, 9997, 9998, 9999 };
+		renderAhead->reset(prefill, 4);
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 4), 4);
+		TS_ASSERT(checkSequence(buffer, 4, 9996));
+		TS_ASSERT(!renderAhead->endOfData());
+
+		// The worker applies the reset before rendering again
+		TS_ASSERT(renderAhead->fillChunk());
+		TS_ASSERT_EQUALS(renderAhead->_ring->size(), 512u);
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 512), 512);
+		TS_ASSERT(checkSequence(buffer, 512, 10000));
+
+		// Until the worker has applied it, read() returns silence
+		renderAhead->reset();
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 100), 100);
+		TS_ASSERT(checkSilence(buffer, 100));
+		TS_ASSERT(renderAhead->fillChunk());
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 100), 100);
+		TS_ASSERT(checkSequence(buffer, 100, 10000));
+
+		// Without the worker, read() applies it
+		renderAhead->_active.store(false);
+		renderAhead->reset();
+		TS_ASSERT_EQUALS(renderAhead->read(buffer, 100), 100);
+		TS_ASSERT(checkSequence(buffer, 100, 10000));
+
+		delete renderAhead;
+#endif
+	}
+};
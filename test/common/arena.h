@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/arena.h"
+#include "common/array.h"
+#include "common/list.h"
+#include "common/str.h"
+
+class ArenaTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_alignment() {
+		Common::Arena arena(256);
+
+		char *c = (char *)arena.allocate(1, 1);
+		TS_ASSERT(c != nullptr);
+		for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+			arena.allocate(1, 1);
+			void *p = arena.allocate(8, alignment);
+			TS_ASSERT_EQUALS((uintptr)p & (alignment - 1), 0u);
+		}
+
+		double *d = arena.allocateArray<double>(4);
+		TS_ASSERT_EQUALS((uintptr)d % alignof(double), 0u);
+	}
+
+	void test_blocks() {
+		Common::Arena arena(256);
+		TS_ASSERT_EQUALS(arena.getReservedSize(), 0u);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 0u);
+
+		byte *a = (byte *)arena.allocate(100, 1);
+		byte *b = (byte *)arena.allocate(100, 1);
+		TS_ASSERT_EQUALS(b, a + 100);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 200u);
+		TS_ASSERT_EQUALS(arena.getReservedSize(), 256u);
+
+		// Does not fit into the rest of the first block
+		byte *c = (byte *)arena.allocate(100, 1);
+		TS_ASSERT_EQUALS(arena.getReservedSize(), 512u);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 300u);
+
+		// Larger than a block
+		byte *d = (byte *)arena.allocate(1000, 1);
+		TS_ASSERT(arena.getReservedSize() >= 1512u);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 1300u);
+
+		memset(a, 1, 100);
+		memset(b, 2, 100);
+		memset(c, 3, 100);
+		memset(d, 4, 1000);
+		TS_ASSERT_EQUALS(a[99], 1);
+		TS_ASSERT_EQUALS(b[0], 2);
+		TS_ASSERT_EQUALS(c[50], 3);
+		TS_ASSERT_EQUALS(d[999], 4);
+	}
+
+	void test_reset() {
+		Common::Arena arena(256);
+		void *first = arena.allocate(16);
+
+		const Common::Arena::Mark mark = arena.getMark();
+		void *second = arena.allocate(16);
+		for (int i = 0; i < 100; ++i)
+			arena.allocate(64);
+		const size_t reserved = arena.getReservedSize();
+
+		// The memory after the mark is handed out again without allocating
+		// new blocks
+		for (int frame = 0; frame < 10; ++frame) {
+			arena.resetToMark(mark);
+			TS_ASSERT_EQUALS(arena.getUsedSize(), 16u);
+			TS_ASSERT_EQUALS(arena.allocate(16), second);
+			for (int i = 0; i < 100; ++i)
+				arena.allocate(64);
+		}
+		TS_ASSERT_EQUALS(arena.getReservedSize(), reserved);
+
+		arena.reset();
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 0u);
+		TS_ASSERT_EQUALS(arena.allocate(16), first);
+
+		arena.freeUnusedBlocks();
+		TS_ASSERT_EQUALS(arena.getReservedSize(), 256u);
+		arena.reset();
+		arena.freeUnusedBlocks();
+		TS_ASSERT_EQUALS(arena.getReservedSize(), 0u);
+		TS_ASSERT(arena.allocate(16) != nullptr);
+	}
+
+	void test_scope() {
+		Common::Arena arena;
+		arena.allocate(32);
+		{
+			Common::ArenaScope scope(arena);
+			arena.allocate(1000);
+			TS_ASSERT_EQUALS(arena.getUsedSize(), 1032u);
+		}
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 32u);
+	}
+
+	void test_array() {
+		typedef Common::ArenaAllocator<Common::String> Allocator;
+		Common::Arena arena;
+		Allocator allocator(arena);
+
+		Common::Array<Common::String, Allocator> array(allocator);
+		for (int i = 0; i < 100; ++i)
+			array.push_back(Common::String::format("a string that is stored on the heap %d", i));
+		TS_ASSERT_EQUALS(array.size(), 100u);
+		TS_ASSERT_EQUALS(array[42], "a string that is stored on the heap 42");
+		TS_ASSERT(arena.getUsedSize() >= 100 * sizeof(Common::String));
+
+		Common::Array<Common::String, Allocator> copy(array);
+		TS_ASSERT(copy == array);
+		TS_ASSERT(copy.get_allocator() == allocator);
+
+		// Moving between arenas copies the elements
+		Common::Arena otherArena;
+		Common::Array<Common::String, Allocator> other((Allocator(otherArena)));
+		other.push_back("gone");
+		other = Common::move(copy);
+		TS_ASSERT(other == array);
+		TS_ASSERT(copy.empty());
+		TS_ASSERT(other.get_allocator().getArena() == &otherArena);
+
+		// Moving within an arena takes the storage over
+		Common::Array<Common::String, Allocator> moved(Common::move(array));
+		TS_ASSERT(array.empty());
+		TS_ASSERT_EQUALS(moved.size(), 100u);
+		TS_ASSERT_EQUALS(moved[99], "a string that is stored on the heap 99");
+	}
+
+	void test_list() {
+		typedef Common::ArenaAllocator<int> Allocator;
+		Common::Arena arena;
+
+		Common::List<int, Allocator> list((Allocator(arena)));
+		for (int i = 0; i < 10; ++i)
+			list.push_back(i);
+		list.remove(5);
+		list.push_front(-1);
+		TS_ASSERT_EQUALS(list.size(), 10u);
+		TS_ASSERT_EQUALS(list.front(), -1);
+		TS_ASSERT_EQUALS(list.back(), 9);
+		TS_ASSERT(arena.getUsedSize() > 0);
+		TS_ASSERT(list.get_allocator() == Allocator(arena));
+
+		int sum = 0;
+		for (Common::List<int, Allocator>::const_iterator it = list.begin(); it != list.end(); ++it)
+			sum += *it;
+		TS_ASSERT_EQUALS(sum, 45 - 5 - 1);
+
+		Common::List<int, Allocator> copy(list);
+		list.clear();
+		TS_ASSERT_EQUALS(copy.size(), 10u);
+	}
+};
@@ -0,0 +1,74 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atom.h"
+
+class AtomTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_interning() {
+		Common::Atom a("music_volume");
+		Common::Atom b(Common::String("music_") + "volume");
+		Common::Atom c("sfx_volume");
+
+		TS_ASSERT(a == b);
+		TS_ASSERT(a != c);
+		TS_ASSERT_EQUALS(a.c_str(), b.c_str());
+		TS_ASSERT_EQUALS(a.toString(), "music_volume");
+		TS_ASSERT_EQUALS(a.size(), 12u);
+	}
+
+	void test_empty() {
+		Common::Atom a;
+		Common::Atom b("");
+		TS_ASSERT(a.empty());
+		TS_ASSERT(a == b);
+		TS_ASSERT(a != Common::Atom("x"));
+		TS_ASSERT_EQUALS(a.toString(), "");
+	}
+
+	void test_ignore_case() {
+		Common::Atom a("SaveSlot");
+		Common::Atom b("saveslot");
+		Common::Atom c("SAVESLOT");
+
+		TS_ASSERT(a != b);
+		TS_ASSERT(a.equalsIgnoreCase(b));
+		TS_ASSERT(c.equalsIgnoreCase(a));
+		TS_ASSERT(!a.equalsIgnoreCase(Common::Atom("SaveSlots")));
+		TS_ASSERT(a.lowercase() == b);
+		TS_ASSERT(b.lowercase() == b);
+		TS_ASSERT_EQUALS(a.toString(), "SaveSlot");
+	}
+
+	void test_hash() {
+		const Common::String str("Talkie");
+		Common::Atom a(str);
+
+		// The stored hashes match the ones of the String functors
+		TS_ASSERT_EQUALS(a.hash(), str.hash());
+		TS_ASSERT_EQUALS(a.hashIgnoreCase(), Common::IgnoreCase_Hash()(str));
+		TS_ASSERT_EQUALS(a.hashIgnoreCase(), Common::Atom("TALKIE").hashIgnoreCase());
+		TS_ASSERT_EQUALS(Common::Hash<Common::Atom>()(a), str.hash());
+	}
+
+	void test_maps() {
+		Common::AtomStringMap map;
+		map[Common::Atom("Language")] = "de";
+		map[Common::Atom("subtitles")] = "true";
+
+		TS_ASSERT(map.contains(Common::Atom("language")));
+		TS_ASSERT(map.contains(Common::Atom("SUBTITLES")));
+		TS_ASSERT(!map.contains(Common::Atom("platform")));
+		TS_ASSERT_EQUALS(map[Common::Atom("LANGUAGE")], "de");
+
+		map[Common::Atom("LANGUAGE")] = "fr";
+		TS_ASSERT_EQUALS(map.size(), 2u);
+		TS_ASSERT_EQUALS(map[Common::Atom("Language")], "fr");
+
+		Common::HashMap<Common::Atom, int> caseSensitive;
+		caseSensitive[Common::Atom("x")] = 1;
+		caseSensitive[Common::Atom("X")] = 2;
+		TS_ASSERT_EQUALS(caseSensitive.size(), 2u);
+		TS_ASSERT_EQUALS(caseSensitive[Common::Atom("x")], 1);
+	}
+};
@@ -0,0 +1,267 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Simple deterministic pseudo random numbers, so that failures are reproducible
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 8) & 0xFFFF;
+	}
+
+#if BENCHMARK_TIME
+	template<class Map, class Key>
+	static void benchmark(const char *name, const Common::Array<Key> &keys, int iters) {
+		uint32 start, insertTime = 0, lookupTime = 0, iterateTime = 0;
+		uint sum = 0;
+
+		// Look the keys up in a different order than they were inserted in
+		Common::Array<uint> order;
+		uint32 seed = 1;
+		for (uint j = 0; j < keys.size(); ++j)
+			order.push_back(j);
+		for (uint j = order.size() - 1; j > 0; --j)
+			SWAP(order[j], order[(nextRandom(seed) << 16 | nextRandom(seed)) % (j + 1)]);
+
+		for (int i = 0; i < iters; ++i) {
+			Map map;
+
+			start = g_system->getMillis();
+			for (uint j = 0; j < keys.size(); ++j)
+				map[keys[j]] = j;
+			insertTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int pass = 0; pass < 10; ++pass) {
+				for (uint j = 0; j < keys.size(); ++j)
+					sum += map.getValOrDefault(keys[order[j]]);
+			}
+			lookupTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int pass = 0; pass < 10; ++pass) {
+				for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+					sum += it->_value;
+			}
+			iterateTime += g_system->getMillis() - start;
+		}
+
+		const double count = (double)keys.size() * iters;
+		debug("%s: %f inserts, %f lookups, %f iterations per second (%u)\n", name,
+		      count * 1000 / MAX<uint32>(insertTime, 1), count * 10 * 1000 / MAX<uint32>(lookupTime, 1),
+		      count * 10 * 1000 / MAX<uint32>(iterateTime, 1), sum);
+	}
+#endif
+
+public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		TS_ASSERT(container.begin() == container.end());
+		TS_ASSERT(!container.contains(0));
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+		TS_ASSERT(!container.contains(0));
+		container[2] = 45;
+		container.clear(true);
+		TS_ASSERT(container.empty());
+		container[3] = 12;
+		TS_ASSERT_EQUALS(container[3], 12);
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		TS_ASSERT_EQUALS(container.size(), 4u);
+		container[1] = 42;
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		container.erase(container.find(1));
+		container.erase(2);
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+
+		TS_ASSERT_EQUALS(container.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(container.getValOrDefault(1), -1);
+		TS_ASSERT_EQUALS(container.getValOrDefault(2), 0);
+		TS_ASSERT_EQUALS(container.getValOrDefault(2, 5), 5);
+		TS_ASSERT(!container.contains(2));
+
+		int value = 3;
+		TS_ASSERT(!container.tryGetVal(2, value));
+		TS_ASSERT_EQUALS(value, 3);
+		TS_ASSERT(container.tryGetVal(0, value));
+		TS_ASSERT_EQUALS(value, 17);
+	}
+
+	void test_string_keys() {
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container;
+		container["Foo"] = "bar";
+		container.setVal("quux", "blub");
+		TS_ASSERT(container.contains("foo"));
+		TS_ASSERT(container.contains("QUUX"));
+		TS_ASSERT_EQUALS(container["FOO"], "bar");
+		TS_ASSERT_EQUALS(container.getVal("Quux"), "blub");
+
+		// Keys and values survive the relocation when the table grows
+		for (int i = 0; i < 100; ++i)
+			container[Common::String::format("key%d", i)] = Common::String::format("a long value which is not stored inline %d", i);
+		for (int i = 0; i < 100; i += 2)
+			container.erase(Common::String::format("KEY%d", i));
+		TS_ASSERT_EQUALS(container.size(), 52u);
+		TS_ASSERT_EQUALS(container["key51"], "a long value which is not stored inline 51");
+		TS_ASSERT_EQUALS(container["foo"], "bar");
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 50; ++i)
+			container[i * 7] = i;
+
+		int count = 0, sum = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator it = container.begin(); it != container.end(); ++it) {
+			TS_ASSERT_EQUALS(it->_key, it->_value * 7);
+			sum += it->_value;
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, 50);
+		TS_ASSERT_EQUALS(sum, 49 * 50 / 2);
+
+		Common::FlatHashMap<int, int>::iterator it = container.find(21);
+		TS_ASSERT(it != container.end());
+		it->_value = 100;
+		TS_ASSERT_EQUALS(container[21], 100);
+		TS_ASSERT(container.find(22) == container.end());
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<int, Common::String> container1;
+		for (int i = 0; i < 30; ++i)
+			container1[i] = Common::String::format("%d", i);
+
+		Common::FlatHashMap<int, Common::String> container2(container1);
+		Common::FlatHashMap<int, Common::String> container3;
+		container3[100] = "gone";
+		container3 = container1;
+
+		container1[5] = "changed";
+		container1.clear(true);
+		for (int i = 0; i < 30; ++i) {
+			TS_ASSERT_EQUALS(container2[i], Common::String::format("%d", i));
+			TS_ASSERT_EQUALS(container3[i], Common::String::format("%d", i));
+		}
+		TS_ASSERT(!container3.contains(100));
+
+		// Copying an empty map
+		Common::FlatHashMap<int, Common::String> container4(container1);
+		TS_ASSERT(container4.empty());
+		container4[1] = "one";
+		TS_ASSERT_EQUALS(container4[1], "one");
+	}
+
+	void test_reserve() {
+		Common::FlatHashMap<int, int> container;
+		container.reserve(1000);
+		for (int i = 0; i < 1000; ++i)
+			container[i] = i;
+		TS_ASSERT_EQUALS(container.size(), 1000u);
+		TS_ASSERT_EQUALS(container[999], 999);
+	}
+
+	// Compares a random sequence of operations with the pointer based HashMap,
+	// including keys with identical low bits, which end up in long probe sequences
+	void test_matches_hashmap() {
+		Common::FlatHashMap<uint, int> flat;
+		Common::HashMap<uint, int> reference;
+		uint32 seed = 1;
+		bool same = true;
+
+		for (int i = 0; i < 20000; ++i) {
+			const uint32 r = nextRandom(seed);
+			const uint key = (r & 0x1FF) << ((r >> 9) & 1 ? 12 : 0);
+			switch (r % 5) {
+			case 0:
+			case 1:
+			case 2:
+				flat[key] = i;
+				reference[key] = i;
+				break;
+			case 3:
+				flat.erase(key);
+				reference.erase(key);
+				break;
+			default:
+				same = same && flat.getValOrDefault(key, -1) == reference.getValOrDefault(key, -1);
+				break;
+			}
+			same = same && flat.size() == reference.size();
+		}
+		TS_ASSERT(same);
+
+		uint count = 0;
+		for (Common::FlatHashMap<uint, int>::const_iterator it = flat.begin(); it != flat.end(); ++it) {
+			same = same && reference.contains(it->_key) && reference[it->_key] == it->_value;
+			count++;
+		}
+		TS_ASSERT(same);
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+
+	void test_hashmap_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 100;
+#else
+		const int iters = 1;
+#endif
+
+		// Resource ids, and identifier-like keys as used for script symbol tables
+		Common::Array<uint> ids;
+		Common::Array<Common::String> names;
+		for (uint i = 0; i < 10000; ++i) {
+			ids.push_back(i * 7919);
+			names.push_back(Common::String::format("symbol_%u", i * 7919));
+		}
+
+		benchmark<Common::HashMap<uint, uint> >("HashMap<uint>", ids, iters);
+		benchmark<Common::FlatHashMap<uint, uint> >("FlatHashMap<uint>", ids, iters);
+		benchmark<Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >("HashMap<String>", names, iters);
+		benchmark<Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >("FlatHashMap<String>", names, iters);
+#endif
+	}
+};
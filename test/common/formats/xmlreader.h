@@ -0,0 +1,220 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/formats/xmlparser.h"
+#include "common/formats/xmlreader.h"
+#include "common/memstream.h"
+
+#include "../../null_osystem.h"
+
+// Records the events of a document as a string
+class XMLEventRecorder : public Common::XMLReader::Handler {
+public:
+	Common::String events;
+
+	bool declaration(const Common::XMLReader::AttributeList &attributes) override {
+		events += "?";
+		addAttributes(attributes);
+		return true;
+	}
+
+	bool startElement(const Common::StringView &name, const Common::XMLReader::AttributeList &attributes) override {
+		events += "<";
+		events += name;
+		addAttributes(attributes);
+		return true;
+	}
+
+	bool endElement(const Common::StringView &name) override {
+		events += "</";
+		events += name;
+		return true;
+	}
+
+	bool text(const Common::StringView &text) override {
+		events += "\"";
+		events += text;
+		return true;
+	}
+
+private:
+	void addAttributes(const Common::XMLReader::AttributeList &attributes) {
+		for (const Common::XMLReader::Attribute &attribute : attributes) {
+			events += " ";
+			events += attribute.name;
+			events += "=";
+			events += attribute.value;
+		}
+		events += ">";
+	}
+};
+
+class XMLTestParser : public Common::XMLParser {
+public:
+	Common::String log;
+
+protected:
+	CUSTOM_XML_PARSER(XMLTestParser) {
+		XML_KEY(root)
+			XML_PROP(name, true)
+			XML_KEY(item)
+				XML_PROP(value, true)
+				XML_PROP(flag, false)
+			KEY_END()
+		KEY_END()
+	} PARSER_END()
+
+	bool parserCallback_root(ParserNode *node) {
+		log += "root:" + node->values["name"] + ";";
+		return true;
+	}
+
+	bool parserCallback_item(ParserNode *node) {
+		log += "item:" + node->values["value"];
+		if (node->values.contains("flag"))
+			log += "," + node->values["flag"];
+		log += ";";
+		return true;
+	}
+
+	bool closedKeyCallback(ParserNode *node) override {
+		log += "/" + node->name + ";";
+		return true;
+	}
+};
+
+// A stream which cannot tell its size
+class XMLUnsizedReadStream : public Common::MemoryReadStream {
+public:
+	XMLUnsizedReadStream(const char *data) : Common::MemoryReadStream((const byte *)data, strlen(data)) {}
+
+	int64 size() const override { return -1; }
+};
+
+class XMLReaderTestSuite : public CxxTest::TestSuite {
+	static Common::String readEvents(const char *doc, bool allowText = false) {
+		XMLEventRecorder recorder;
+		Common::XMLReader reader(doc, strlen(doc));
+		reader.setAllowText(allowText);
+		if (!reader.parse(recorder))
+			return "error: " + reader.getError();
+		return recorder.events;
+	}
+
+public:
+	void test_events() {
+		const char *doc =
+			"<?xml version = \"1.0\" ?>\n"
+			"<!-- A comment -->\n"
+			"<root name='test' size=10>\n"
+			"\t<item value=\"a b\"/>\n"
+			"\t<item value = \"\" <!-- in a tag --> flag=yes />\n"
+			"</root >\n";
+
+		TS_ASSERT_EQUALS(readEvents(doc),
+			"? version=1.0>"
+			"<root name=test size=10>"
+			"<item value=a b></item"
+			"<item value= flag=yes></item"
+			"</root");
+	}
+
+	void test_text() {
+		const char *doc = "<?xml version=\"1.0\"?><p>Some  text <b>bold</b> </p>";
+		TS_ASSERT_EQUALS(readEvents(doc, true), "? version=1.0><p>\"Some  text <b>\"bold</b</p");
+		TS_ASSERT_EQUALS(readEvents(doc, false), "error: Parser expecting key start.");
+	}
+
+	void test_errors() {
+		TS_ASSERT_EQUALS(readEvents(""), "error: Unexpected end of file.");
+		TS_ASSERT_EQUALS(readEvents("<root/>"), "error: Expecting XML header.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><?xml?>"), "error: Unexpected header. There may only be one XML header per file.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><a></b>"), "error: Unexpected closure.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><a>"), "error: Unexpected end of file.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><a b></a>"), "error: Syntax error after key name.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><a b='c></a>"), "error: Invalid key value.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><a / >"), "error: Expecting key closure after '/' symbol.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><!- x -->"), "error: Malformed comment syntax.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><!-- x"), "error: Comment has no closure.");
+		TS_ASSERT_EQUALS(readEvents("<?xml version='1.0'?><!-- x -- y -->"), "error: Malformed comment (double-hyphen inside comment body).");
+	}
+
+	void test_compile() {
+		const char *doc =
+			"<?xml version='1.0'?>"
+			"<root name='test'><item value='1'/><item value='2'>text</item><item value='1'/></root>";
+
+		Common::XMLReader reader(doc, strlen(doc));
+		reader.setAllowText(true);
+		Common::MemoryWriteStreamDynamic compiled(DisposeAfterUse::YES);
+		TS_ASSERT(reader.compile(compiled));
+
+		const char *data = (const char *)compiled.getData();
+		TS_ASSERT(Common::XMLReader::isCompiled(data, compiled.size()));
+		TS_ASSERT(!Common::XMLReader::isCompiled(doc, strlen(doc)));
+
+		XMLEventRecorder text, binary;
+		TS_ASSERT(reader.parse(text));
+		Common::XMLReader compiledReader(data, compiled.size());
+		TS_ASSERT(compiledReader.parse(binary));
+		TS_ASSERT_EQUALS(text.events, binary.events);
+
+		// Corrupted data must be rejected
+		for (uint32 size = 4; size < compiled.size(); ++size) {
+			XMLEventRecorder recorder;
+			Common::XMLReader truncated(data, size);
+			TS_ASSERT(!truncated.parse(recorder));
+		}
+	}
+
+	void test_parser() {
+		const char *doc =
+			"<?xml version='1.0'?>"
+			"<root name='test'><item value='1'/><ITEM value='2' flag='x'></ITEM></root>";
+
+		XMLTestParser parser;
+		TS_ASSERT(parser.loadBuffer((const byte *)doc, strlen(doc)));
+		TS_ASSERT(parser.parse());
+		TS_ASSERT_EQUALS(parser.log, "root:test;item:1;/item;item:2,x;/ITEM;/root;");
+
+		// The same document, compiled
+		Common::XMLReader reader(doc, strlen(doc));
+		Common::MemoryWriteStreamDynamic compiled(DisposeAfterUse::YES);
+		TS_ASSERT(reader.compile(compiled));
+
+		XMLTestParser compiledParser;
+		TS_ASSERT(compiledParser.loadBuffer(compiled.getData(), compiled.size()));
+		TS_ASSERT(compiledParser.parse());
+		TS_ASSERT_EQUALS(compiledParser.log, parser.log);
+	}
+
+	void test_parser_stream() {
+		const char *doc =
+			"<?xml version='1.0'?>"
+			"<root name='test'><item value='1'/></root>";
+
+		XMLTestParser parser;
+		TS_ASSERT(parser.loadStream(new XMLUnsizedReadStream(doc)));
+		TS_ASSERT(parser.parse());
+		TS_ASSERT_EQUALS(parser.log, "root:test;item:1;/item;/root;");
+	}
+
+	void test_parser_error_recovery() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// Errors are reported through the OSystem
+		Common::install_null_g_system();
+
+		const char *broken = "<?xml version='1.0'?><root name='broken'><item value='1'>";
+		const char *doc = "<?xml version='1.0'?><root name='test'><item value='2'/></root>";
+
+		XMLTestParser parser;
+		TS_ASSERT(parser.loadBuffer((const byte *)broken, strlen(broken)));
+		TS_ASSERT(!parser.parse());
+
+		// The keys left open by the failed parse must not leak into the next one
+		parser.log.clear();
+		TS_ASSERT(parser.loadBuffer((const byte *)doc, strlen(doc)));
+		TS_ASSERT(parser.parse());
+		TS_ASSERT_EQUALS(parser.log, "root:test;item:2;/item;/root;");
+#endif
+	}
+};
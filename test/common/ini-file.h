@@ -5,6 +5,13 @@
 
 
 class IniFileTestSuite : public CxxTest::TestSuite {
+	// A stream which can't tell its size, like a pipe
+	class UnsizedReadStream : public Common::MemoryReadStream {
+	public:
+		UnsizedReadStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size) {}
+		int64 size() const override { return -1; }
+	};
+
 	public:
 	void test_blank_ini_file() {
 		Common::INIFile inifile;
@@ -38,6 +45,23 @@ class IniFileTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT_EQUALS(val, "newval");
 	}
 
+	void test_unsized_ini_file() {
+		// Longer than the chunks the stream is read in
+		Common::String inistr = "[s]\n";
+		for (int i = 0; i < 1000; i++)
+			inistr += Common::String::format("key%d=%d\n", i, i);
+
+		UnsizedReadStream ms((const byte *)inistr.c_str(), inistr.size());
+		Common::INIFile inifile;
+		TS_ASSERT(inifile.loadFromStream(ms));
+
+		Common::String val;
+		TS_ASSERT(inifile.getKey("key0", "s", val));
+		TS_ASSERT_EQUALS(val, "0");
+		TS_ASSERT(inifile.getKey("key999", "s", val));
+		TS_ASSERT_EQUALS(val, "999");
+	}
+
 	void test_multisection_ini_file() {
 		static const unsigned char inistr[] = "[s]\nabc=1\ndef=xyz\n#comment=no\n[empty]\n\n[s2]\n abc = 2  \n ; comment=no";
 		Common::MemoryReadStream ms(inistr, sizeof(inistr));
@@ -1,6 +1,7 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/list.h"
+#include "common/memorypool.h"
 
 class ListTestSuite : public CxxTest::TestSuite
 {
@@ -282,4 +283,38 @@ class ListTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(container.front(), 99);
 		TS_ASSERT_EQUALS(container.back(),  99);
 	}
+
+	void test_pool_allocator() {
+		typedef Common::PoolAllocator<int> Allocator;
+		Common::ListNodePool<int, 4> pool;
+		Allocator allocator(pool);
+
+		// Both lists take their nodes from the same pool
+		Common::List<int, Allocator> container1(allocator);
+		Common::List<int, Allocator> container2(allocator);
+		for (int i = 0; i < 100; ++i) {
+			container1.push_back(i);
+			container2.push_front(i);
+		}
+		container1.remove(50);
+		container2.pop_back();
+
+		TS_ASSERT_EQUALS(container1.size(), 99u);
+		TS_ASSERT_EQUALS(container2.size(), 99u);
+		TS_ASSERT_EQUALS(container1.back(), 99);
+		TS_ASSERT_EQUALS(container2.back(), 1);
+		TS_ASSERT(container1.get_allocator() == allocator);
+
+		Common::List<int, Allocator> container3(container1);
+		container1.clear();
+		container2 = container3;
+		TS_ASSERT_EQUALS(container2.size(), 99u);
+		TS_ASSERT_EQUALS(container2.front(), 0);
+
+		container2.clear();
+		container3.clear();
+		pool.freeUnusedPages();
+		container1.push_back(1);
+		TS_ASSERT_EQUALS(container1.front(), 1);
+	}
 };
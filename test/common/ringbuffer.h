@@ -0,0 +1,54 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/ringbuffer.h"
+
+class RingBufferTestSuite : public CxxTest::TestSuite {
+public:
+	void test_capacity() {
+		Common::RingBuffer<int> ring(5);
+		TS_ASSERT_EQUALS(ring.capacity(), 8u);
+		TS_ASSERT(ring.empty());
+		TS_ASSERT_EQUALS(ring.space(), 8u);
+	}
+
+	void test_push_pop() {
+		Common::RingBuffer<int> ring(4);
+		int value;
+
+		TS_ASSERT(!ring.pop(value));
+
+		for (int i = 0; i < 4; ++i)
+			TS_ASSERT(ring.push(i));
+		TS_ASSERT(!ring.push(4));
+		TS_ASSERT_EQUALS(ring.size(), 4u);
+
+		for (int i = 0; i < 4; ++i) {
+			TS_ASSERT(ring.pop(value));
+			TS_ASSERT_EQUALS(value, i);
+		}
+		TS_ASSERT(ring.empty());
+	}
+
+	void test_read_write_wrap() {
+		Common::RingBuffer<int> ring(8);
+		int in[6] = { 1, 2, 3, 4, 5, 6 };
+		int out[6];
+
+		// Move the positions so that the next writes wrap around
+		TS_ASSERT_EQUALS(ring.write(in, 5), 5u);
+		TS_ASSERT_EQUALS(ring.skip(5), 5u);
+
+		TS_ASSERT_EQUALS(ring.write(in, 6), 6u);
+		TS_ASSERT_EQUALS(ring.write(in, 6), 2u);
+		TS_ASSERT_EQUALS(ring.space(), 0u);
+
+		TS_ASSERT_EQUALS(ring.read(out, 6), 6u);
+		for (int i = 0; i < 6; ++i)
+			TS_ASSERT_EQUALS(out[i], in[i]);
+
+		TS_ASSERT_EQUALS(ring.read(out, 6), 2u);
+		TS_ASSERT_EQUALS(out[0], 1);
+		TS_ASSERT_EQUALS(out[1], 2);
+		TS_ASSERT(ring.empty());
+	}
+};
@@ -70,4 +70,18 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_get_view() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+
+		TS_ASSERT_EQUALS(ssrs.getView(0, 6), contents + 2);
+		TS_ASSERT_EQUALS(ssrs.getView(4, 2), contents + 6);
+		TS_ASSERT(ssrs.getView(4, 3) == nullptr);
+
+		// Views can be taken through several levels of substreams
+		Common::SeekableSubReadStream nested(&ssrs, 1, 3);
+		TS_ASSERT_EQUALS(nested.getView(0, 2), contents + 3);
+	}
 };
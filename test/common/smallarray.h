@@ -0,0 +1,194 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/rect.h"
+#include "common/smallarray.h"
+#include "common/str.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class SmallArrayTestSuite : public CxxTest::TestSuite
+{
+private:
+#if BENCHMARK_TIME
+	// Collects a few rectangles per call, as done for every drawing
+	// operation, and returns something depending on them
+	template<class RectArray>
+	static int collectRects(int i, int count) {
+		RectArray rects;
+		for (int j = 0; j < count; ++j)
+			rects.push_back(Common::Rect(i & 0xFFF, j, (i & 0xFFF) + 16, j + 16));
+
+		int sum = 0;
+		for (typename RectArray::const_iterator it = rects.begin(); it != rects.end(); ++it)
+			sum += it->width() + it->top;
+		return sum;
+	}
+
+	template<class RectArray>
+	static void benchmark(const char *name, int count, int iters) {
+		int sum = 0;
+		const uint32 start = g_system->getMillis();
+		for (int i = 0; i < iters; ++i)
+			sum += collectRects<RectArray>(i, count);
+		const uint32 time = g_system->getMillis() - start;
+
+		debug("%s with %d elements: %f arrays per second (%d)\n", name, count,
+		      (double)iters * 1000 / MAX<uint32>(time, 1), sum);
+	}
+#endif
+
+public:
+	void test_inline_storage() {
+		Common::SmallArray<int, 4> array;
+		TS_ASSERT(array.empty());
+		TS_ASSERT(array.isInline());
+		TS_ASSERT_EQUALS(array.capacity(), 4u);
+
+		for (int i = 0; i < 4; ++i)
+			array.push_back(i);
+		TS_ASSERT(array.isInline());
+		TS_ASSERT_EQUALS(array.size(), 4u);
+
+		// Spills over to the heap
+		array.push_back(4);
+		TS_ASSERT(!array.isInline());
+		TS_ASSERT_EQUALS(array.size(), 5u);
+		for (int i = 0; i < 5; ++i)
+			TS_ASSERT_EQUALS(array[i], i);
+
+		array.clear();
+		TS_ASSERT(array.empty());
+		TS_ASSERT(array.isInline());
+	}
+
+	void test_insert_erase() {
+		Common::SmallArray<Common::String, 3> array = {"a", "c"};
+		array.insert_at(1, "b");
+		TS_ASSERT(array.isInline());
+		array.insert(array.begin(), "0");
+		TS_ASSERT(!array.isInline());
+		array.emplace(array.end(), "ddd", 2);
+
+		TS_ASSERT_EQUALS(array.size(), 5u);
+		TS_ASSERT_EQUALS(array[0], "0");
+		TS_ASSERT_EQUALS(array[1], "a");
+		TS_ASSERT_EQUALS(array[2], "b");
+		TS_ASSERT_EQUALS(array[3], "c");
+		TS_ASSERT_EQUALS(array[4], "dd");
+
+		TS_ASSERT_EQUALS(array.remove_at(0), "0");
+		array.erase(array.begin() + 1, array.begin() + 3);
+		TS_ASSERT_EQUALS(array.size(), 2u);
+		TS_ASSERT_EQUALS(array.front(), "a");
+		TS_ASSERT_EQUALS(array.back(), "dd");
+		array.pop_back();
+		TS_ASSERT_EQUALS(array.size(), 1u);
+
+		// Inserting an element of the array itself
+		Common::SmallArray<Common::String, 4> array2 = {"x", "y"};
+		array2.insert_at(0, array2[1]);
+		array2.insert_at(0, array2[2]);
+		array2.push_back(array2[0]);
+		array2.push_back(array2[0]);
+		TS_ASSERT_EQUALS(array2.size(), 6u);
+		TS_ASSERT_EQUALS(array2[0], "y");
+		TS_ASSERT_EQUALS(array2[1], "y");
+		TS_ASSERT_EQUALS(array2[2], "x");
+		TS_ASSERT_EQUALS(array2[5], "y");
+	}
+
+	void test_copy_move() {
+		Common::SmallArray<Common::String, 2> inlineArray = {"a long string, which is stored on the heap", "b"};
+		Common::SmallArray<Common::String, 2> heapArray = {"1", "2", "3"};
+
+		Common::SmallArray<Common::String, 2> copy1(inlineArray);
+		Common::SmallArray<Common::String, 2> copy2(heapArray);
+		TS_ASSERT(copy1 == inlineArray);
+		TS_ASSERT(copy2 == heapArray);
+		TS_ASSERT(copy1 != copy2);
+
+		copy1 = heapArray;
+		copy2 = inlineArray;
+		TS_ASSERT(copy1 == heapArray);
+		TS_ASSERT(copy2 == inlineArray);
+
+		Common::SmallArray<Common::String, 2> moved1(Common::move(copy1));
+		Common::SmallArray<Common::String, 2> moved2(Common::move(copy2));
+		TS_ASSERT(copy1.empty());
+		TS_ASSERT(copy2.empty());
+		TS_ASSERT(moved1 == heapArray);
+		TS_ASSERT(moved2 == inlineArray);
+
+		moved1 = Common::move(moved2);
+		TS_ASSERT(moved1 == inlineArray);
+		TS_ASSERT(moved2.empty());
+		TS_ASSERT(moved2.isInline());
+
+		moved1.swap(heapArray);
+		TS_ASSERT_EQUALS(moved1.size(), 3u);
+		TS_ASSERT_EQUALS(heapArray[0], "a long string, which is stored on the heap");
+	}
+
+	void test_resize_reserve() {
+		Common::SmallArray<int, 8> array(3, 7);
+		TS_ASSERT_EQUALS(array.size(), 3u);
+		TS_ASSERT_EQUALS(array[2], 7);
+
+		array.resize(5);
+		TS_ASSERT_EQUALS(array[4], 0);
+		array.resize(20, 9);
+		TS_ASSERT_EQUALS(array[19], 9);
+		TS_ASSERT_EQUALS(array[2], 7);
+		array.resize(2);
+		TS_ASSERT_EQUALS(array.size(), 2u);
+
+		Common::SmallArray<int, 8> array2;
+		array2.reserve(8);
+		TS_ASSERT(array2.isInline());
+		array2.reserve(9);
+		TS_ASSERT(!array2.isInline());
+		TS_ASSERT(array2.capacity() >= 9u);
+	}
+
+	void test_algorithms() {
+		const int values[] = {5, 3, 9, 1, 7};
+		Common::SmallArray<int, 8> array(values, ARRAYSIZE(values));
+
+		Common::sort(array.begin(), array.end());
+		TS_ASSERT_EQUALS(array[0], 1);
+		TS_ASSERT_EQUALS(array[4], 9);
+		TS_ASSERT_EQUALS(*Common::find(array.begin(), array.end(), 7), 7);
+		TS_ASSERT(Common::find(array.begin(), array.end(), 4) == array.end());
+
+		// Convert to a regular array to pass it on
+		Common::Array<int> regular(array.data(), array.size());
+		TS_ASSERT_EQUALS(regular.size(), 5u);
+		TS_ASSERT_EQUALS(regular[2], 5);
+	}
+
+	void test_small_array_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 10000000;
+#else
+		const int iters = 100000;
+#endif
+
+		benchmark<Common::Array<Common::Rect> >("Array<Rect>", 4, iters);
+		benchmark<Common::SmallArray<Common::Rect, 8> >("SmallArray<Rect, 8>", 4, iters);
+		benchmark<Common::Array<Common::Rect> >("Array<Rect>", 16, iters / 4);
+		benchmark<Common::SmallArray<Common::Rect, 8> >("SmallArray<Rect, 8>", 16, iters / 4);
+#endif
+	}
+};
@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/str-view.h"
+#include "common/tokenizer.h"
+
+class StringViewTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_construction() {
+		const Common::String str("key = value");
+		Common::StringView view(str);
+		TS_ASSERT_EQUALS(view.size(), str.size());
+		TS_ASSERT_EQUALS(view.data(), str.c_str());
+		TS_ASSERT(view == str);
+		TS_ASSERT(view == "key = value");
+		TS_ASSERT(view != "key");
+
+		Common::StringView empty;
+		TS_ASSERT(empty.empty());
+		TS_ASSERT(empty == "");
+		TS_ASSERT_EQUALS(empty.toString(), "");
+
+		Common::StringView part(str.c_str() + 6, str.c_str() + 11);
+		TS_ASSERT_EQUALS(part.toString(), "value");
+		TS_ASSERT_EQUALS(part.firstChar(), 'v');
+		TS_ASSERT_EQUALS(part.lastChar(), 'e');
+	}
+
+	void test_substr_trim() {
+		Common::StringView view("  key = value \t");
+		TS_ASSERT(view.trimmed() == "key = value");
+		TS_ASSERT(view.trimmedLeft() == "key = value \t");
+		TS_ASSERT(view.trimmedRight() == "  key = value");
+		TS_ASSERT(Common::StringView("   ").trimmed().empty());
+
+		Common::StringView trimmed = view.trimmed();
+		TS_ASSERT(trimmed.substr(0, 3) == "key");
+		TS_ASSERT(trimmed.substr(6) == "value");
+		TS_ASSERT(trimmed.substr(6, 100) == "value");
+		TS_ASSERT(trimmed.substr(100).empty());
+
+		trimmed.removePrefix(4);
+		trimmed.removeSuffix(2);
+		TS_ASSERT(trimmed == "= val");
+	}
+
+	void test_find() {
+		Common::StringView view("a=b=c");
+		TS_ASSERT_EQUALS(view.find('='), 1u);
+		TS_ASSERT_EQUALS(view.find('=', 2), 3u);
+		TS_ASSERT_EQUALS(view.find('x'), Common::StringView::npos);
+		TS_ASSERT_EQUALS(view.rfind('='), 3u);
+		TS_ASSERT_EQUALS(view.find("b=c"), 2u);
+		TS_ASSERT_EQUALS(view.find("c=d"), Common::StringView::npos);
+		TS_ASSERT_EQUALS(view.findFirstOf("cb"), 2u);
+		TS_ASSERT_EQUALS(view.findFirstNotOf("a="), 2u);
+		TS_ASSERT(view.contains('c'));
+		TS_ASSERT(view.hasPrefix("a="));
+		TS_ASSERT(view.hasSuffix("=c"));
+		TS_ASSERT(!view.hasSuffix("xa=b=c"));
+		TS_ASSERT(view.equalsIgnoreCase("A=B=C"));
+
+		Common::StringView rest(view);
+		TS_ASSERT(rest.splitAt('=') == "a");
+		TS_ASSERT(rest.splitAt('=') == "b");
+		TS_ASSERT(rest.splitAt('=') == "c");
+		TS_ASSERT(rest.empty());
+	}
+
+	void test_lines() {
+		Common::StringView text("first\nsecond\r\nthird\rfourth\n\nlast");
+		TS_ASSERT(text.splitLine() == "first");
+		TS_ASSERT(text.splitLine() == "second");
+		TS_ASSERT(text.splitLine() == "third");
+		TS_ASSERT(text.splitLine() == "fourth");
+		TS_ASSERT(text.splitLine().empty());
+		TS_ASSERT(text.splitLine() == "last");
+		TS_ASSERT(text.empty());
+	}
+
+	void test_append() {
+		Common::String str("abc");
+		str += Common::StringView("defgh", 2);
+		TS_ASSERT_EQUALS(str, "abcde");
+
+		// Appending a part of the string itself
+		str += Common::StringView(str).substr(1, 2);
+		TS_ASSERT_EQUALS(str, "abcdebc");
+
+		Common::U32String u32str("xy");
+		u32str += Common::U32StringView(Common::U32String("z"));
+		TS_ASSERT_EQUALS(u32str, Common::U32String("xyz"));
+	}
+
+	void test_tokenizer_view() {
+		Common::StringTokenizer tokenizer("x<=W, y>400", ", ");
+		TS_ASSERT(tokenizer.nextTokenView() == "x<=W");
+		TS_ASSERT(tokenizer.nextTokenView() == "y>400");
+		TS_ASSERT(tokenizer.nextTokenView().empty());
+		TS_ASSERT(tokenizer.empty());
+	}
+};
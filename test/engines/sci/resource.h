@@ -0,0 +1,40 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/file.h"
+#include "common/memstream.h"
+#include "engines/sci/resource/resource.h"
+
+class SciResourceTestSuite : public CxxTest::TestSuite {
+public:
+	void test_mapped_volume_data_is_borrowed() {
+		static const byte volume[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+		Sci::ResourceManager resMan(true);
+
+		// A memory backed file lends views like a memory mapped one
+		Common::File *mappedFile = new Common::File;
+		mappedFile->open(new Common::MemoryReadStream(volume, sizeof(volume)), "resource.aud");
+		resMan._mappedVolumeFiles.push_back(mappedFile);
+
+		Sci::Resource *res = new Sci::Resource(&resMan, Sci::ResourceId(Sci::kResourceTypeAudio, 1));
+		res->_size = 8;
+		mappedFile->seek(4);
+		TS_ASSERT(res->loadFromAudioVolumeSCI1(mappedFile));
+		TS_ASSERT_EQUALS(res->data(), volume + 4);
+		TS_ASSERT_EQUALS(mappedFile->pos(), 12);
+
+		// Borrowed data is not freed
+		res->unalloc();
+		TS_ASSERT(res->data() == nullptr);
+
+		// Other streams are read into a buffer of the resource
+		Common::MemoryReadStream stream(volume, sizeof(volume));
+		stream.seek(4);
+		TS_ASSERT(res->loadFromAudioVolumeSCI1(&stream));
+		TS_ASSERT_DIFFERS(res->data(), volume + 4);
+		TS_ASSERT_EQUALS(memcmp(res->data(), volume + 4, 8), 0);
+		TS_ASSERT_EQUALS(stream.pos(), 12);
+
+		delete res;
+	}
+};
@@ -0,0 +1,196 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/random.h"
+#include "common/rect.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "graphics/blit.h"
+#include "graphics/blit/blit-scale.h"
+#include "graphics/transform_struct.h"
+#include "graphics/transform_tools.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class BilinearBlitTestSuite : public CxxTest::TestSuite {
+	struct Variant {
+		const char *name;
+		Graphics::BilinearFunc func;
+	};
+
+	static Common::Array<Variant> getVariants() {
+		Common::Array<Variant> variants;
+#ifdef SCUMMVM_NEON
+		Variant neon = { "NEON", Graphics::bilinearInterpolateNEON };
+		variants.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			Variant sse2 = { "SSE2", Graphics::bilinearInterpolateSSE2 };
+			variants.push_back(sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			Variant avx2 = { "AVX2", Graphics::bilinearInterpolateAVX2 };
+			variants.push_back(avx2);
+		}
+#endif
+		return variants;
+	}
+
+	static Common::Array<Graphics::PixelFormat> getFormats() {
+		Common::Array<Graphics::PixelFormat> formats;
+		formats.push_back(Graphics::createPixelFormat<8888>());
+		formats.push_back(Graphics::createPixelFormat<888>());
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0));
+		return formats;
+	}
+
+	static void fillRandom(byte *data, uint size, Common::RandomSource &rnd) {
+		for (uint i = 0; i < size; ++i)
+			data[i] = rnd.getRandomNumber(255);
+	}
+
+	// Use the generic blits, or the SIMD interpolation given
+	static void setFunc(Graphics::BilinearFunc func) {
+		Graphics::BilinearSIMD::interpolateFunc = func;
+		Graphics::BilinearSIMD::selected = true;
+	}
+
+	static void resetFunc() {
+		Graphics::BilinearSIMD::interpolateFunc = nullptr;
+		Graphics::BilinearSIMD::selected = false;
+	}
+
+public:
+	void test_scale_bilinear() {
+		const Common::Array<Variant> variants = getVariants();
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+		Common::RandomSource rnd("bilinear");
+
+		// Upscaling, downscaling, and widths which leave pixels after the vectors
+		static const uint sizes[][4] = {
+			{ 13, 7, 37, 19 },
+			{ 40, 30, 17, 11 },
+			{ 5, 9, 5, 23 },
+			{ 64, 2, 129, 3 }
+		};
+
+		for (uint v = 0; v < variants.size(); ++v) {
+			for (uint f = 0; f < formats.size(); ++f) {
+				for (uint s = 0; s < ARRAYSIZE(sizes); ++s) {
+					const uint srcW = sizes[s][0], srcH = sizes[s][1];
+					const uint dstW = sizes[s][2], dstH = sizes[s][3];
+
+					Common::Array<byte> src(srcW * srcH * 4), expected(dstW * dstH * 4), actual(dstW * dstH * 4);
+					fillRandom(src.data(), src.size(), rnd);
+
+					for (byte flip = 0; flip <= (Graphics::FLIP_H | Graphics::FLIP_V); ++flip) {
+						setFunc(nullptr);
+						Graphics::scaleBlitBilinear(expected.data(), src.data(), dstW * 4, srcW * 4, dstW, dstH, srcW, srcH, formats[f], flip);
+						setFunc(variants[v].func);
+						Graphics::scaleBlitBilinear(actual.data(), src.data(), dstW * 4, srcW * 4, dstW, dstH, srcW, srcH, formats[f], flip);
+						TS_ASSERT_EQUALS(memcmp(expected.data(), actual.data(), expected.size()), 0);
+					}
+				}
+			}
+		}
+
+		resetFunc();
+	}
+
+	void test_rotoscale_bilinear() {
+		const Common::Array<Variant> variants = getVariants();
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+		Common::RandomSource rnd("bilinear");
+
+		const uint srcW = 23, srcH = 17;
+		Common::Array<byte> src(srcW * srcH * 4);
+		fillRandom(src.data(), src.size(), rnd);
+
+		static const int transforms[][3] = {
+			{ 150, 100, 30 },
+			{ 70, 130, 135 },
+			{ 100, 100, 270 }
+		};
+
+		for (uint v = 0; v < variants.size(); ++v) {
+			for (uint f = 0; f < formats.size(); ++f) {
+				for (uint t = 0; t < ARRAYSIZE(transforms); ++t) {
+					for (uint flip = 0; flip < 4; ++flip) {
+						Graphics::TransformStruct transform(transforms[t][0], transforms[t][1], transforms[t][2], 5, 3,
+						                                    Graphics::BLEND_NORMAL, 255, flip & 1, flip & 2);
+						Common::Point newHotspot;
+						const Common::Rect rect = Graphics::TransformTools::newRect(Common::Rect(srcW, srcH), transform, &newHotspot);
+						const uint dstW = rect.width(), dstH = rect.height();
+
+						// Pixels outside of the source are left alone
+						Common::Array<byte> expected(dstW * dstH * 4, 0x5A), actual(dstW * dstH * 4, 0x5A);
+
+						setFunc(nullptr);
+						Graphics::rotoscaleBlitBilinear(expected.data(), src.data(), dstW * 4, srcW * 4, dstW, dstH, srcW, srcH, formats[f], transform, newHotspot);
+						setFunc(variants[v].func);
+						Graphics::rotoscaleBlitBilinear(actual.data(), src.data(), dstW * 4, srcW * 4, dstW, dstH, srcW, srcH, formats[f], transform, newHotspot);
+						TS_ASSERT_EQUALS(memcmp(expected.data(), actual.data(), expected.size()), 0);
+					}
+				}
+			}
+		}
+
+		resetFunc();
+	}
+
+	void test_bilinear_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		const Common::Array<Variant> variants = getVariants();
+		const Graphics::PixelFormat format = Graphics::createPixelFormat<8888>();
+		const uint srcW = 320, srcH = 240, dstW = 800, dstH = 600;
+#ifdef SLOW_TESTS
+		const int iters = 50;
+#else
+		const int iters = 1;
+#endif
+		Common::RandomSource rnd("bilinear");
+
+		Common::Array<byte> src(srcW * srcH * 4), dst(dstW * dstH * 4);
+		fillRandom(src.data(), src.size(), rnd);
+
+		Graphics::TransformStruct transform(250, 250, 30, 0, 0);
+		Common::Point newHotspot;
+		const Common::Rect rect = Graphics::TransformTools::newRect(Common::Rect(srcW, srcH), transform, &newHotspot);
+		Common::Array<byte> rotated(rect.width() * rect.height() * 4);
+
+		for (int v = -1; v < (int)variants.size(); ++v) {
+			const char *name = (v < 0) ? "generic" : variants[v].name;
+			setFunc(v < 0 ? nullptr : variants[v].func);
+
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iters; i++)
+				Graphics::scaleBlitBilinear(dst.data(), src.data(), dstW * 4, srcW * 4, dstW, dstH, srcW, srcH, format);
+			debug("scaleBlitBilinear %s: %u ms per %d iters", name, g_system->getMillis() - start, iters);
+
+			start = g_system->getMillis();
+			for (int i = 0; i < iters; i++)
+				Graphics::rotoscaleBlitBilinear(rotated.data(), src.data(), rect.width() * 4, srcW * 4, rect.width(), rect.height(), srcW, srcH, format, transform, newHotspot);
+			debug("rotoscaleBlitBilinear %s: %u ms per %d iters", name, g_system->getMillis() - start, iters);
+		}
+
+		resetFunc();
+#endif
+	}
+};
@@ -0,0 +1,295 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "graphics/blit.h"
+#include "graphics/blit/blit-fast.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class CrossBlitTestSuite : public CxxTest::TestSuite {
+	struct Variant {
+		const char *name;
+		Graphics::FastBlitFunc (*lookup)(const Graphics::PixelFormat &, const Graphics::PixelFormat &);
+		Graphics::FastBlitMapFunc (*lookupMap)(uint);
+	};
+
+	static Common::Array<Variant> getVariants() {
+		Common::Array<Variant> variants;
+#ifdef SCUMMVM_NEON
+		Variant neon = { "NEON", Graphics::getFastBlitFuncNEON, Graphics::getFastBlitMapFuncNEON };
+		variants.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			Variant sse2 = { "SSE2", Graphics::getFastBlitFuncSSE2, Graphics::getFastBlitMapFuncSSE2 };
+			variants.push_back(sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			Variant avx2 = { "AVX2", Graphics::getFastBlitFuncAVX2, Graphics::getFastBlitMapFuncAVX2 };
+			variants.push_back(avx2);
+		}
+#endif
+		return variants;
+	}
+
+	static Common::Array<Graphics::PixelFormat> getFormats() {
+		Common::Array<Graphics::PixelFormat> formats;
+		formats.push_back(Graphics::PixelFormat(2, 5, 6, 5, 0, 11,  5,  0,  0));
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16,  8,  0));
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 16,  8,  0, 24));
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8,  0,  8, 16, 24));
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8,  8, 16, 24,  0));
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 0, 16,  8,  0,  0));
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 0,  0,  8, 16,  0));
+		return formats;
+	}
+
+	static void fillRandom(byte *data, uint size, Common::RandomSource &rnd) {
+		for (uint i = 0; i < size; ++i)
+			data[i] = rnd.getRandomNumber(255);
+	}
+
+	static uint32 readPixel(const byte *p, uint bpp) {
+		return bpp == 2 ? *(const uint16 *)p : *(const uint32 *)p;
+	}
+
+	// The per-pixel conversion of crossBlit()
+	static void convertReference(byte *dst, const byte *src, uint dstPitch, uint srcPitch, uint w, uint h,
+	                             const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
+		for (uint y = 0; y < h; ++y) {
+			for (uint x = 0; x < w; ++x) {
+				byte a, r, g, b;
+				srcFmt.colorToARGB(readPixel(src + y * srcPitch + x * srcFmt.bytesPerPixel, srcFmt.bytesPerPixel), a, r, g, b);
+				*(uint32 *)(dst + y * dstPitch + x * 4) = dstFmt.ARGBToColor(a, r, g, b);
+			}
+		}
+	}
+
+	static bool compareRows(const byte *a, const byte *b, uint pitch, uint rowSize, uint h) {
+		for (uint y = 0; y < h; ++y) {
+			if (memcmp(a + y * pitch, b + y * pitch, rowSize) != 0)
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_simd_formats() {
+		const Common::Array<Variant> variants = getVariants();
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+		const uint widths[] = { 1, 3, 7, 8, 9, 16, 17, 33 };
+		const uint h = 3;
+		Common::RandomSource rnd("crossblit");
+
+		for (uint v = 0; v < variants.size(); ++v) {
+			uint found = 0;
+
+			for (uint s = 0; s < formats.size(); ++s) {
+				for (uint d = 0; d < formats.size(); ++d) {
+					Graphics::FastBlitFunc func = variants[v].lookup(formats[d], formats[s]);
+					if (!func)
+						continue;
+					found++;
+
+					for (uint i = 0; i < ARRAYSIZE(widths); ++i) {
+						const uint w = widths[i];
+						const uint srcPitch = w * formats[s].bytesPerPixel + 6;
+						const uint dstPitch = w * 4 + 12;
+
+						Common::Array<byte> src(srcPitch * h), expected(dstPitch * h), actual(dstPitch * h);
+						fillRandom(src.data(), src.size(), rnd);
+
+						convertReference(expected.data(), src.data(), dstPitch, srcPitch, w, h, formats[d], formats[s]);
+						func(actual.data(), src.data(), dstPitch, srcPitch, w, h);
+						TS_ASSERT(compareRows(expected.data(), actual.data(), dstPitch, w * 4, h));
+					}
+				}
+			}
+
+			// All of RGB565 to the six 32 bpp formats and 16 swizzles
+			TS_ASSERT_EQUALS(found, 22u);
+		}
+	}
+
+	void test_simd_in_place() {
+		const Common::Array<Variant> variants = getVariants();
+		const Graphics::PixelFormat srcFmt(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat dstFmt(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const uint w = 37, h = 5;
+		const uint srcPitch = w * 2, dstPitch = w * 4;
+		Common::RandomSource rnd("crossblit");
+
+		Common::Array<byte> src(dstPitch * h), expected(dstPitch * h);
+		fillRandom(src.data(), srcPitch * h, rnd);
+		convertReference(expected.data(), src.data(), dstPitch, srcPitch, w, h, dstFmt, srcFmt);
+
+		for (uint v = 0; v < variants.size(); ++v) {
+			Common::Array<byte> buffer(src);
+			variants[v].lookup(dstFmt, srcFmt)(buffer.data(), buffer.data(), dstPitch, srcPitch, w, h);
+			TS_ASSERT(compareRows(expected.data(), buffer.data(), dstPitch, dstPitch, h));
+		}
+	}
+
+	void test_simd_map() {
+		const Common::Array<Variant> variants = getVariants();
+		const uint w = 45, h = 4;
+		const uint srcPitch = w + 3;
+		Common::RandomSource rnd("crossblit");
+
+		uint32 map16[256], map32[256];
+		for (uint i = 0; i < 256; ++i) {
+			map16[i] = rnd.getRandomNumber(0xFFFF);
+			map32[i] = rnd.getRandomNumber(0xFFFFFFF) * 16 + i % 16;
+		}
+
+		Common::Array<byte> src(srcPitch * h);
+		fillRandom(src.data(), src.size(), rnd);
+
+		for (uint v = 0; v < variants.size(); ++v) {
+			for (uint bpp = 2; bpp <= 4; bpp += 2) {
+				const uint32 *map = (bpp == 2) ? map16 : map32;
+				const uint dstPitch = w * bpp + 8;
+
+				Common::Array<byte> expected(dstPitch * h), actual(dstPitch * h);
+				for (uint y = 0; y < h; ++y) {
+					for (uint x = 0; x < w; ++x) {
+						byte *p = expected.data() + y * dstPitch + x * bpp;
+						if (bpp == 2)
+							*(uint16 *)p = map[src[y * srcPitch + x]];
+						else
+							*(uint32 *)p = map[src[y * srcPitch + x]];
+					}
+				}
+
+				Graphics::FastBlitMapFunc func = variants[v].lookupMap(bpp);
+				TS_ASSERT(func);
+				func(actual.data(), src.data(), dstPitch, srcPitch, w, h, map);
+				TS_ASSERT(compareRows(expected.data(), actual.data(), dstPitch, w * bpp, h));
+
+				// In place, with the source at the start of the buffer
+				Common::Array<byte> buffer(dstPitch * h);
+				for (uint y = 0; y < h; ++y)
+					memcpy(buffer.data() + y * (dstPitch / bpp), src.data() + y * srcPitch, w);
+				func(buffer.data(), buffer.data(), dstPitch, dstPitch / bpp, w, h, map);
+				TS_ASSERT(compareRows(expected.data(), buffer.data(), dstPitch, w * bpp, h));
+			}
+		}
+	}
+
+	void test_crossblit() {
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+		const uint w = 13, h = 3;
+		Common::RandomSource rnd("crossblit");
+
+		// Check the scalar fast paths, and the dispatch to each SIMD variant
+		Common::Array<Variant> variants = getVariants();
+		Variant none = { "none", Graphics::FastBlitSIMD::lookupNone, Graphics::FastBlitSIMD::lookupMapNone };
+		variants.insert_at(0, none);
+
+		for (uint v = 0; v < variants.size(); ++v) {
+			Graphics::FastBlitSIMD::lookupFunc = variants[v].lookup;
+			Graphics::FastBlitSIMD::lookupMapFunc = variants[v].lookupMap;
+
+			for (uint s = 0; s < formats.size(); ++s) {
+				for (uint d = 1; d < formats.size(); ++d) {
+					const uint srcPitch = w * formats[s].bytesPerPixel;
+					const uint dstPitch = w * 4;
+
+					Common::Array<byte> src(srcPitch * h), expected(dstPitch * h), actual(dstPitch * h);
+					fillRandom(src.data(), src.size(), rnd);
+
+					convertReference(expected.data(), src.data(), dstPitch, srcPitch, w, h, formats[d], formats[s]);
+					TS_ASSERT(Graphics::crossBlit(actual.data(), src.data(), dstPitch, srcPitch, w, h, formats[d], formats[s]));
+					if (formats[s] != formats[d])
+						TS_ASSERT(compareRows(expected.data(), actual.data(), dstPitch, dstPitch, h));
+				}
+			}
+		}
+
+		Graphics::FastBlitSIMD::lookupFunc = nullptr;
+		Graphics::FastBlitSIMD::lookupMapFunc = nullptr;
+	}
+
+	void test_crossblit_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		const Common::Array<Variant> variants = getVariants();
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+		const uint w = 640, h = 480;
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 1;
+#endif
+		Common::RandomSource rnd("crossblit");
+
+		Common::Array<byte> src(w * h * 4), dst(w * h * 4);
+		fillRandom(src.data(), src.size(), rnd);
+
+		for (uint s = 0; s < formats.size(); ++s) {
+			for (uint d = 0; d < formats.size(); ++d) {
+				if (variants.empty() || !variants[0].lookup(formats[d], formats[s]))
+					continue;
+
+				const uint srcPitch = w * formats[s].bytesPerPixel;
+				uint32 start = g_system->getMillis();
+				for (int i = 0; i < iters; i++)
+					convertReference(dst.data(), src.data(), w * 4, srcPitch, w, h, formats[d], formats[s]);
+				debug("%s -> %s generic: %u ms per %d iters", formats[s].toString().c_str(), formats[d].toString().c_str(), g_system->getMillis() - start, iters);
+
+				for (uint v = 0; v < variants.size(); ++v) {
+					Graphics::FastBlitFunc func = variants[v].lookup(formats[d], formats[s]);
+					start = g_system->getMillis();
+					for (int i = 0; i < iters; i++)
+						func(dst.data(), src.data(), w * 4, srcPitch, w, h);
+					debug("%s -> %s %s: %u ms per %d iters", formats[s].toString().c_str(), formats[d].toString().c_str(), variants[v].name, g_system->getMillis() - start, iters);
+				}
+			}
+		}
+
+		uint32 map[256];
+		for (uint i = 0; i < 256; ++i)
+			map[i] = rnd.getRandomNumber(0xFFFF);
+
+		for (uint bpp = 2; bpp <= 4; bpp += 2) {
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iters; i++) {
+				for (uint y = 0; y < h; ++y) {
+					for (uint x = 0; x < w; ++x) {
+						if (bpp == 2)
+							((uint16 *)dst.data())[y * w + x] = map[src[y * w + x]];
+						else
+							((uint32 *)dst.data())[y * w + x] = map[src[y * w + x]];
+					}
+				}
+			}
+			debug("CLUT8 -> %u bpp generic: %u ms per %d iters", bpp, g_system->getMillis() - start, iters);
+
+			for (uint v = 0; v < variants.size(); ++v) {
+				Graphics::FastBlitMapFunc func = variants[v].lookupMap(bpp);
+				start = g_system->getMillis();
+				for (int i = 0; i < iters; i++)
+					func(dst.data(), src.data(), w * bpp, w, w, h, map);
+				debug("CLUT8 -> %u bpp %s: %u ms per %d iters", bpp, variants[v].name, g_system->getMillis() - start, iters);
+			}
+		}
+#endif
+	}
+};
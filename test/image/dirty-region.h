@@ -0,0 +1,117 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/random.h"
+#include "graphics/dirty-region.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+	// Check that the rects of the region cover all pixels which were added,
+	// and none outside of their bounding box
+	static bool checkCoverage(Graphics::DirtyRegion &region, const Common::Array<Common::Rect> &added, uint w, uint h) {
+		Common::Array<byte> expected(w * h), actual(w * h);
+		Common::Rect bounds = added[0];
+		for (uint i = 0; i < added.size(); ++i) {
+			bounds.extend(added[i]);
+			for (int y = added[i].top; y < added[i].bottom; ++y)
+				memset(&expected[y * w + added[i].left], 1, added[i].width());
+		}
+
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		for (uint i = 0; i < rects.size(); ++i) {
+			if (!bounds.contains(rects[i]))
+				return false;
+			for (int y = rects[i].top; y < rects[i].bottom; ++y)
+				memset(&actual[y * w + rects[i].left], 1, rects[i].width());
+		}
+
+		for (uint i = 0; i < w * h; ++i) {
+			if (expected[i] && !actual[i])
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_merge() {
+		// Only merge rects when that does not add any pixels
+		Graphics::DirtyRegion region(0);
+		TS_ASSERT(region.isEmpty());
+
+		// Adjacent and overlapping rects which line up
+		region.add(Common::Rect(0, 0, 10, 10));
+		region.add(Common::Rect(10, 0, 20, 10));
+		region.add(Common::Rect(5, 5, 15, 10));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT(region.getRects()[0] == Common::Rect(0, 0, 20, 10));
+
+		// Rects with a gap are kept apart
+		region.add(Common::Rect(30, 0, 40, 10));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+
+		// A rect filling the gap joins both, since the merged rect then
+		// lines up with the other one
+		region.add(Common::Rect(20, 0, 30, 10));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT(region.getRects()[0] == Common::Rect(0, 0, 40, 10));
+
+		// Empty rects and the parts left of and above the origin are ignored
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+		region.add(Common::Rect(5, 5, 5, 10));
+		TS_ASSERT(region.isEmpty());
+		region.add(Common::Rect(-4, -2, 3, 4));
+		TS_ASSERT(region.getRects()[0] == Common::Rect(0, 0, 3, 4));
+	}
+
+	void test_merge_cost() {
+		// A gap of one column costs 10 pixels
+		Graphics::DirtyRegion cheap(10), expensive(9);
+		cheap.add(Common::Rect(0, 0, 10, 10));
+		cheap.add(Common::Rect(11, 0, 20, 10));
+		expensive.add(Common::Rect(0, 0, 10, 10));
+		expensive.add(Common::Rect(11, 0, 20, 10));
+		TS_ASSERT_EQUALS(cheap.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(expensive.getRects().size(), 2u);
+	}
+
+	void test_tiles() {
+		const uint w = 320, h = 200;
+		Graphics::DirtyRegion region(0, 16);
+		Common::Array<Common::Rect> added;
+
+		// A row of text, one rect per letter
+		for (int x = 8; x < 300; x += 9) {
+			added.push_back(Common::Rect(x, 50, x + 7, 58));
+			region.add(added.back());
+		}
+		TS_ASSERT(region.usesTiles());
+		TS_ASSERT(checkCoverage(region, added, w, h));
+		TS_ASSERT_LESS_THAN_EQUALS(region.getRects().size(), 2u);
+
+		// Rects can be added after the tiles were turned into rects
+		added.push_back(Common::Rect(3, 190, 5, 200));
+		region.add(added.back());
+		TS_ASSERT(checkCoverage(region, added, w, h));
+
+		region.clear();
+		TS_ASSERT(!region.usesTiles());
+		TS_ASSERT(region.isEmpty());
+	}
+
+	void test_random() {
+		const uint w = 320, h = 200;
+		Common::RandomSource rnd("dirty-region");
+
+		for (uint pass = 0; pass < 20; ++pass) {
+			Graphics::DirtyRegion region(rnd.getRandomNumber(1000), 1 + rnd.getRandomNumber(40));
+			Common::Array<Common::Rect> added;
+
+			const uint count = 1 + rnd.getRandomNumber(100);
+			for (uint i = 0; i < count; ++i) {
+				const int16 x = rnd.getRandomNumber(w - 1), y = rnd.getRandomNumber(h - 1);
+				added.push_back(Common::Rect(x, y, x + 1 + rnd.getRandomNumber(w - 1 - x), y + 1 + rnd.getRandomNumber(MIN<uint>(h - 1 - y, 20))));
+				region.add(added.back());
+			}
+			TS_ASSERT(checkCoverage(region, added, w, h));
+		}
+	}
+};
@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/fonts/glyph-atlas.h"
+
+class GlyphAtlasTestSuite : public CxxTest::TestSuite {
+	static void makeGlyph(byte *pixels, uint w, uint h, byte value) {
+		for (uint i = 0; i < w * h; ++i)
+			pixels[i] = value + i;
+	}
+
+	static bool checkGlyph(const Graphics::GlyphAtlas &atlas, const Graphics::GlyphAtlas::Location &loc, uint w, uint h, byte value) {
+		const Graphics::Surface &surface = atlas.getSurface();
+		for (uint y = 0; y < h; ++y) {
+			for (uint x = 0; x < w; ++x) {
+				if (*(const byte *)surface.getBasePtr(loc.x + x, loc.y + y) != (byte)(value + y * w + x))
+					return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	void test_packing() {
+		Graphics::GlyphAtlas atlas;
+		atlas.create(64, 256);
+
+		byte pixels[16 * 16];
+		Graphics::GlyphAtlas::Location locs[20];
+
+		// Glyphs of the same height share shelves
+		for (uint i = 0; i < 20; ++i) {
+			makeGlyph(pixels, 10, 12, i * 7);
+			atlas.add(pixels, 10, 10, 12, locs[i]);
+		}
+
+		for (uint i = 0; i < 20; ++i) {
+			TS_ASSERT(atlas.contains(locs[i]));
+			TS_ASSERT(checkGlyph(atlas, locs[i], 10, 12, i * 7));
+			TS_ASSERT_LESS_THAN_EQUALS(locs[i].x + 10, 64);
+		}
+		TS_ASSERT_EQUALS(locs[0].y, locs[5].y);
+		TS_ASSERT_DIFFERS(locs[0].y, locs[6].y);
+		TS_ASSERT_EQUALS(atlas.getEvictionCount(), 0u);
+
+		// A glyph wider than the atlas starts over with a wider one
+		makeGlyph(pixels, 16, 4, 1);
+		Graphics::GlyphAtlas::Location wide;
+		atlas.create(8, 64);
+		atlas.add(pixels, 16, 16, 4, wide);
+		TS_ASSERT(atlas.contains(wide));
+		TS_ASSERT(checkGlyph(atlas, wide, 16, 4, 1));
+	}
+
+	void test_eviction() {
+		Graphics::GlyphAtlas atlas;
+		atlas.create(16, 16);
+
+		byte pixels[8 * 4];
+		Graphics::GlyphAtlas::Location locs[8];
+
+		// Four shelves with two glyphs each fill the atlas
+		for (uint i = 0; i < 8; ++i) {
+			makeGlyph(pixels, 8, 4, i);
+			atlas.add(pixels, 8, 8, 4, locs[i]);
+		}
+		TS_ASSERT_EQUALS(atlas.getEvictionCount(), 0u);
+
+		// Use all shelves except the one of the third and fourth glyph
+		atlas.touch(locs[0]);
+		atlas.touch(locs[4]);
+		atlas.touch(locs[6]);
+
+		Graphics::GlyphAtlas::Location loc;
+		makeGlyph(pixels, 8, 4, 100);
+		atlas.add(pixels, 8, 8, 4, loc);
+		TS_ASSERT_EQUALS(atlas.getEvictionCount(), 1u);
+		TS_ASSERT(!atlas.contains(locs[2]));
+		TS_ASSERT(!atlas.contains(locs[3]));
+		TS_ASSERT(atlas.contains(loc));
+		TS_ASSERT(checkGlyph(atlas, loc, 8, 4, 100));
+
+		for (uint i = 0; i < 8; ++i) {
+			if (i != 2 && i != 3) {
+				TS_ASSERT(atlas.contains(locs[i]));
+				TS_ASSERT(checkGlyph(atlas, locs[i], 8, 4, i));
+			}
+		}
+
+		// A glyph higher than all shelves clears the atlas
+		byte high[16];
+		makeGlyph(high, 1, 16, 50);
+		atlas.add(high, 1, 1, 16, loc);
+		TS_ASSERT(atlas.contains(loc));
+		TS_ASSERT(checkGlyph(atlas, loc, 1, 16, 50));
+		for (uint i = 0; i < 8; ++i)
+			TS_ASSERT(!atlas.contains(locs[i]));
+	}
+
+	void test_blend_surface() {
+		Graphics::GlyphAtlas atlas;
+		atlas.create(32, 32);
+
+		byte pixels[4 * 4];
+		Graphics::GlyphAtlas::Location first, second;
+		makeGlyph(pixels, 4, 4, 10);
+		atlas.add(pixels, 4, 4, 4, first);
+
+		const Graphics::Surface &blend = atlas.getBlendSurface();
+		TS_ASSERT_EQUALS(blend.w, atlas.getSurface().w);
+		TS_ASSERT_EQUALS(blend.h, atlas.getSurface().h);
+
+		// Glyphs added later are mirrored as well
+		makeGlyph(pixels, 4, 4, 200);
+		atlas.add(pixels, 4, 4, 4, second);
+
+		for (uint y = 0; y < 4; ++y) {
+			for (uint x = 0; x < 4; ++x) {
+				byte a, r, g, b;
+				blend.format.colorToARGB(blend.getPixel(first.x + x, first.y + y), a, r, g, b);
+				TS_ASSERT_EQUALS(a, 10 + y * 4 + x);
+				TS_ASSERT_EQUALS(r & g & b, 255);
+
+				blend.format.colorToARGB(blend.getPixel(second.x + x, second.y + y), a, r, g, b);
+				TS_ASSERT_EQUALS(a, 200 + y * 4 + x);
+			}
+		}
+	}
+};
@@ -0,0 +1,176 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#include "graphics/scaler/hq-classify.h"
+#endif
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class HQScalerTestSuite : public CxxTest::TestSuite {
+#ifdef USE_HQ_SCALERS
+	struct Variant {
+		const char *name;
+		HQClassifyFunc func;
+	};
+
+	static Common::Array<Variant> getVariants() {
+		Common::Array<Variant> variants;
+#ifdef SCUMMVM_NEON
+		Variant neon = { "NEON", hqClassifyNEON };
+		variants.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			Variant sse2 = { "SSE2", hqClassifySSE2 };
+			variants.push_back(sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			Variant avx2 = { "AVX2", hqClassifyAVX2 };
+			variants.push_back(avx2);
+		}
+#endif
+		return variants;
+	}
+
+	// YUV values which are close to the thresholds of diffYUV(), with
+	// random bits in the unused top byte
+	static uint32 randomYUV(Common::RandomSource &rnd) {
+		const uint32 y = 0x50 + rnd.getRandomNumber(0x60);
+		const uint32 u = 0x78 + rnd.getRandomNumber(16);
+		const uint32 v = 0x78 + rnd.getRandomNumber(14);
+		return (rnd.getRandomNumber(255) << 24) | (y << 16) | (u << 8) | v;
+	}
+
+	// Random blocks of few colors, so the scaler finds edges to smooth
+	static void fillBlocks(byte *data, uint size, uint bpp, Common::RandomSource &rnd) {
+		for (uint i = 0; i < size; i += 3 * bpp) {
+			const byte value = rnd.getRandomNumber(7) * 36;
+			for (uint j = i; j < MIN<uint>(i + 3 * bpp, size); ++j)
+				data[j] = value + (j % 3) * rnd.getRandomNumber(3);
+		}
+	}
+#endif
+
+public:
+	void test_hq_classify() {
+#ifdef USE_HQ_SCALERS
+		const Common::Array<Variant> variants = getVariants();
+		Common::RandomSource rnd("hq");
+
+		// Widths which leave pixels after the vectors
+		for (int width = 1; width <= 37; ++width) {
+			Common::Array<uint32> rows((width + 2) * 3);
+			for (uint i = 0; i < rows.size(); ++i)
+				rows[i] = randomYUV(rnd);
+			const uint32 *above = rows.data();
+			const uint32 *row = above + width + 2;
+			const uint32 *below = row + width + 2;
+
+			Common::Array<uint16> expected(width), actual(width);
+			HQClassify::classifyGeneric(expected.data(), above, row, below, width);
+			for (uint v = 0; v < variants.size(); ++v) {
+				variants[v].func(actual.data(), above, row, below, width);
+				TS_ASSERT_EQUALS(memcmp(expected.data(), actual.data(), width * sizeof(uint16)), 0);
+			}
+		}
+#endif
+	}
+
+	void test_hq_scale() {
+#ifdef USE_HQ_SCALERS
+		const Common::Array<Variant> variants = getVariants();
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+		const int w = 77, h = 21;
+		Common::RandomSource rnd("hq");
+
+		for (uint f = 0; f < ARRAYSIZE(formats); ++f) {
+			const uint bpp = formats[f].bytesPerPixel;
+			const uint srcPitch = (w + 2) * bpp;
+			Common::Array<byte> src(srcPitch * (h + 2));
+			fillBlocks(src.data(), src.size(), bpp, rnd);
+			const byte *srcPtr = src.data() + srcPitch + bpp;
+
+			for (uint factor = 2; factor <= 3; ++factor) {
+				const uint dstPitch = w * factor * bpp;
+				Common::Array<byte> expected(dstPitch * h * factor), actual(dstPitch * h * factor);
+
+				HQClassify::classifyFunc = HQClassify::classifyGeneric;
+				HQScaler scaler(formats[f]);
+				scaler.setFactor(factor);
+				scaler.scale(srcPtr, srcPitch, expected.data(), dstPitch, w, h, 0, 0);
+
+				for (uint v = 0; v < variants.size(); ++v) {
+					HQClassify::classifyFunc = variants[v].func;
+					scaler.scale(srcPtr, srcPitch, actual.data(), dstPitch, w, h, 0, 0);
+					TS_ASSERT_EQUALS(memcmp(expected.data(), actual.data(), expected.size()), 0);
+				}
+			}
+		}
+
+		HQClassify::classifyFunc = nullptr;
+#endif
+	}
+
+	void test_hq_speed() {
+#if defined(USE_HQ_SCALERS) && BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		const Common::Array<Variant> variants = getVariants();
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const int w = 320, h = 200;
+#ifdef SLOW_TESTS
+		const int iters = 20;
+#else
+		const int iters = 1;
+#endif
+		Common::RandomSource rnd("hq");
+
+		const uint srcPitch = (w + 2) * 4, dstPitch = w * 3 * 4;
+		Common::Array<byte> src(srcPitch * (h + 2)), dst(dstPitch * h * 3);
+		fillBlocks(src.data(), src.size(), 4, rnd);
+		const byte *srcPtr = src.data() + srcPitch + 4;
+
+		for (int v = -1; v < (int)variants.size(); ++v) {
+			const char *name = (v < 0) ? "generic" : variants[v].name;
+			HQClassify::classifyFunc = (v < 0) ? HQClassify::classifyGeneric : variants[v].func;
+
+			HQScaler scaler(format);
+			for (uint factor = 2; factor <= 3; ++factor) {
+				scaler.setFactor(factor);
+
+				uint32 start = g_system->getMillis();
+				for (int i = 0; i < iters; i++)
+					scaler.scale(srcPtr, srcPitch, dst.data(), dstPitch, w, h, 0, 0);
+				debug("HQ%ux %s: %u ms per %d iters", factor, name, g_system->getMillis() - start, iters);
+			}
+		}
+
+		HQClassify::classifyFunc = nullptr;
+#endif
+	}
+};
@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/random.h"
+#include "graphics/scalerplugin.h"
+
+#include "../null_osystem.h"
+
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#include "graphics/scaler/hq-classify.h"
+#endif
+
+class ScalerBandsTestSuite : public CxxTest::TestSuite {
+	// Runs the bands in reverse order, to catch bands which depend on
+	// the output of the ones above them
+	class ReverseExecutor : public ScalerExecutor {
+	public:
+		ReverseExecutor(int concurrency) : _concurrency(concurrency), _calls(0) {}
+
+		void run(JobFunc func, void *data, int count) override {
+			for (int i = count; i-- > 0;) {
+				func(data, i);
+				_calls++;
+			}
+		}
+
+		int getConcurrency() const override { return _concurrency; }
+
+		int _concurrency;
+		int _calls;
+	};
+
+public:
+	void test_hq_bands() {
+#ifdef USE_HQ_SCALERS
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24)
+		};
+		const int w = 40, h = 70, padding = 1;
+		Common::RandomSource rnd("scaler-bands");
+		HQClassify::classifyFunc = HQClassify::classifyGeneric;
+
+		for (uint f = 0; f < ARRAYSIZE(formats); ++f) {
+			const uint bpp = formats[f].bytesPerPixel;
+			const uint srcPitch = (w + padding * 2) * bpp;
+
+			// Random blocks, so the scaler finds edges to smooth
+			Common::Array<byte> src(srcPitch * (h + padding * 2));
+			for (uint i = 0; i < src.size(); i += 4 * bpp) {
+				const byte value = rnd.getRandomNumber(3) * 85;
+				for (uint j = i; j < MIN<uint>(i + 4 * bpp, src.size()); ++j)
+					src[j] = value;
+			}
+			const byte *srcPtr = src.data() + padding * srcPitch + padding * bpp;
+
+			for (uint factor = 2; factor <= 3; ++factor) {
+				const uint dstPitch = w * factor * bpp;
+				Common::Array<byte> expected(dstPitch * h * factor), actual(dstPitch * h * factor);
+
+				HQScaler scaler(formats[f]);
+				scaler.setFactor(factor);
+				scaler.scale(srcPtr, srcPitch, expected.data(), dstPitch, w, h, 0, 0);
+
+				ReverseExecutor executor(4);
+				scaler.setExecutor(&executor);
+				scaler.scale(srcPtr, srcPitch, actual.data(), dstPitch, w, h, 0, 0);
+				TS_ASSERT_EQUALS(executor._calls, 4);
+				TS_ASSERT_EQUALS(memcmp(expected.data(), actual.data(), expected.size()), 0);
+
+				// Rects too small to split are scaled in one go
+				executor._calls = 0;
+				scaler.scale(srcPtr, srcPitch, actual.data(), dstPitch, w, 20, 0, 0);
+				TS_ASSERT_EQUALS(executor._calls, 0);
+			}
+		}
+		HQClassify::classifyFunc = nullptr;
+#endif
+	}
+
+	static void countCall(void *data, int index) {
+		((int *)data)[index]++;
+	}
+
+	void test_parallel_executor() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		int calls[10] = { 0 };
+		ParallelScalerExecutor executor(4);
+		TS_ASSERT_EQUALS(executor.getConcurrency(), 4);
+		executor.run(countCall, calls, ARRAYSIZE(calls));
+		for (uint i = 0; i < ARRAYSIZE(calls); ++i)
+			TS_ASSERT_EQUALS(calls[i], 1);
+#endif
+	}
+};